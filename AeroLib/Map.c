@@ -4,6 +4,27 @@
 #include "../Core/Log.h"
 #include <string.h>
 
+static AeroOrderedMapNode Map_Leftmost(AeroOrderedMapNode pNode);
+static AeroOrderedMapNode Map_Successor(AeroOrderedMapNode pNode);
+static SAeroOrderedMapIterator Map_MakeIterator(AeroOrderedMap map, AeroOrderedMapNode pNode);
+static void Map_ReplaceChild(AeroOrderedMap map, AeroOrderedMapNode pParent, AeroOrderedMapNode pOld, AeroOrderedMapNode pNew);
+static AeroOrderedMapNode Map_RotateLeft(AeroOrderedMap map, AeroOrderedMapNode pNode);
+static AeroOrderedMapNode Map_RotateRight(AeroOrderedMap map, AeroOrderedMapNode pNode);
+static void Map_Rebalance(AeroOrderedMap map, AeroOrderedMapNode pNode);
+
+static inline int32_t Map_NodeHeight(AeroOrderedMapNode pNode)
+{
+	return (pNode ? pNode->height : 0);
+}
+
+static inline void Map_UpdateHeight(AeroOrderedMapNode pNode)
+{
+	int32_t leftHeight = Map_NodeHeight(pNode->pLeft);
+	int32_t rightHeight = Map_NodeHeight(pNode->pRight);
+
+	pNode->height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+}
+
 bool Map_Initialize(AeroOrderedMap* ppOrderedMap, EMemoryTag tag)
 {
 	if (!ppOrderedMap)
@@ -24,6 +45,14 @@ bool Map_Initialize(AeroOrderedMap* ppOrderedMap, EMemoryTag tag)
 
 	map->tag = tag;
 
+	if (!PoolAllocator_Initialize(&map->pNodePool, "SAeroOrderedMapNode", sizeof(SAeroOrderedMapNode), MAP_NODE_POOL_SLAB_COUNT, tag))
+	{
+		syserr("Failed to Initialize Node Pool for Map (Tag: %s)", MemoryTagNames[tag]);
+		engine_delete(map);
+		*ppOrderedMap = NULL;
+		return (false);
+	}
+
 	return (true);
 }
 
@@ -38,6 +67,8 @@ void Map_Destroy(AeroOrderedMap* ppOrderedMap)
 
 	Map_Clear(map);
 
+	PoolAllocator_Destroy(&map->pNodePool);
+
 	engine_delete(map);
 
 	*ppOrderedMap = NULL;
@@ -50,7 +81,47 @@ void Map_Clear(AeroOrderedMap map)
 		return;
 	}
 
-	Map_ClearRecusive(map, map->pRoot);
+	// Post-order walk through the parent links, no recursion so a deep
+	// tree cannot blow the stack
+	AeroOrderedMapNode pNode = map->pRoot;
+	while (pNode)
+	{
+		if (pNode->pLeft)
+		{
+			pNode = pNode->pLeft;
+			continue;
+		}
+
+		if (pNode->pRight)
+		{
+			pNode = pNode->pRight;
+			continue;
+		}
+
+		// Leaf: clean it up and unhook it so the parent becomes a leaf too
+		AeroOrderedMapNode pParent = pNode->pParent;
+		if (pParent)
+		{
+			if (pParent->pLeft == pNode)
+			{
+				pParent->pLeft = NULL;
+			}
+			else
+			{
+				pParent->pRight = NULL;
+			}
+		}
+
+		if (map->pfnDestructor && pNode->pValue)
+		{
+			map->pfnDestructor(&pNode->pValue);
+		}
+
+		engine_delete(pNode->szKey);
+		pool_delete(map->pNodePool, pNode);
+
+		pNode = pParent;
+	}
 
 	// Reset the map state
 	map->pRoot = NULL;
@@ -70,18 +141,6 @@ bool Map_Insert(AeroOrderedMap map, const char* key, void* value)
 		return (false);
 	}
 
-	// Case 1: The tree is totally empty
-	if (map->pRoot == NULL)
-	{
-		map->pRoot = engine_new_zero(SAeroOrderedMapNode, 1, map->tag);
-		map->pRoot->szKey = engine_strdup(key, map->tag);
-		map->pRoot->pValue = value;
-		map->pRoot->height = 1; // what value should be here?
-		map->pRoot->depth = 1;
-		map->elementCount++;
-		return (true);
-	}
-
 	AeroOrderedMapNode pCurrentNode = map->pRoot;
 	AeroOrderedMapNode pParentNode = NULL;
 	int32_t cmp = 0;
@@ -93,12 +152,12 @@ bool Map_Insert(AeroOrderedMap map, const char* key, void* value)
 		cmp = strcmp(key, pCurrentNode->szKey);
 
 		// we will go to the left
-		if (cmp < 0) 
+		if (cmp < 0)
 		{
 			pCurrentNode = pCurrentNode->pLeft;
 		}
 		// we will go to the right
-		else if (cmp > 0) 
+		else if (cmp > 0)
 		{
 			pCurrentNode = pCurrentNode->pRight;
 		}
@@ -114,7 +173,7 @@ bool Map_Insert(AeroOrderedMap map, const char* key, void* value)
 	}
 
 	// We hit NULL, so create the new node
-	AeroOrderedMapNode newNode = engine_new_zero(SAeroOrderedMapNode, 1, map->tag);
+	AeroOrderedMapNode newNode = pool_new_zero(map->pNodePool, SAeroOrderedMapNode);
 	if (newNode == NULL)
 	{
 		syserr("Failed to Allocate newNode Memory");
@@ -123,12 +182,15 @@ bool Map_Insert(AeroOrderedMap map, const char* key, void* value)
 
 	newNode->szKey = engine_strdup(key, map->tag);
 	newNode->pValue = value;
-	newNode->depth = pParentNode->depth + 1;
 	newNode->height = 1;			// New nodes are always height 1 (they are leaves)
-	newNode->pParent = pParentNode;	// Useful for iterators later!
+	newNode->pParent = pParentNode;
 
 	// ATTACH it to the parent we remembered
-	if (cmp < 0)
+	if (!pParentNode)
+	{
+		map->pRoot = newNode;
+	}
+	else if (cmp < 0)
 	{
 		pParentNode->pLeft = newNode;
 	}
@@ -137,11 +199,8 @@ bool Map_Insert(AeroOrderedMap map, const char* key, void* value)
 		pParentNode->pRight = newNode;
 	}
 
-	// 4. Update the Parent's height (Optional but good for future Balancing)
-	uint32_t rightHeight = pParentNode->pRight ? pParentNode->pRight->height : 0;
-	uint32_t leftHeight = pParentNode->pLeft ? pParentNode->pLeft->height : 0;
-
-	pParentNode->height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+	// Walk back up fixing heights, rotating where a side got 2 taller
+	Map_Rebalance(map, pParentNode);
 
 	map->elementCount++;
 	return (true);
@@ -177,14 +236,16 @@ void Map_Remove(AeroOrderedMap map, const char* key)
 		return;
 	}
 
+	// Find the node
 	SAeroOrderedMapNode* pCurrent = map->pRoot;
-	SAeroOrderedMapNode* pParent = NULL;
-
-	// Find the node and its parent
-	while (pCurrent != NULL && strcmp(key, pCurrent->szKey) != 0)
+	while (pCurrent != NULL)
 	{
-		pParent = pCurrent;
 		int32_t cmp = strcmp(key, pCurrent->szKey);
+		if (cmp == 0)
+		{
+			break;
+		}
+
 		pCurrent = (cmp > 0) ? pCurrent->pRight : pCurrent->pLeft;
 	}
 
@@ -193,107 +254,320 @@ void Map_Remove(AeroOrderedMap map, const char* key)
 		return; // Key not found
 	}
 
+	// The removed entry's data goes away in every scenario
+	if (map->pfnDestructor && pCurrent->pValue)
+	{
+		map->pfnDestructor(&pCurrent->pValue);
+	}
+	engine_delete(pCurrent->szKey);
+
 	// 2. Scenario: Two Children
 	if (pCurrent->pLeft && pCurrent->pRight)
 	{
-		// Find the In-Order Successor (Smallest in the Right Subtree)
-		SAeroOrderedMapNode* pSuccessor = pCurrent->pRight;
-		SAeroOrderedMapNode* pSuccessorParent = pCurrent;
+		// Take over the In-Order Successor's key and value (no copy, the
+		// pointers just move) and unlink the successor node instead
+		SAeroOrderedMapNode* pSuccessor = Map_Leftmost(pCurrent->pRight);
 
-		while (pSuccessor->pLeft)
+		pCurrent->szKey = pSuccessor->szKey;
+		pCurrent->pValue = pSuccessor->pValue;
+
+		pCurrent = pSuccessor;
+	}
+
+	// 3. Scenario: One Child or Leaf
+	SAeroOrderedMapNode* pChild = (pCurrent->pLeft) ? pCurrent->pLeft : pCurrent->pRight;
+	SAeroOrderedMapNode* pParent = pCurrent->pParent;
+
+	Map_ReplaceChild(map, pParent, pCurrent, pChild);
+	if (pChild)
+	{
+		pChild->pParent = pParent;
+	}
+
+	// 4. Final Cleanup
+	pool_delete(map->pNodePool, pCurrent);
+	map->elementCount--;
+
+	Map_Rebalance(map, pParent);
+}
+
+void Map_ForEach(AeroOrderedMap map, void(*pfnCallback)(const char* key, void* value))
+{
+	Map_ForEachRange(map, NULL, NULL, pfnCallback);
+}
+
+void Map_ForEachRange(AeroOrderedMap map, const char* szFrom, const char* szTo, void (*pfnCallback)(const char* key, void* value))
+{
+	if (!map || !map->pRoot || !pfnCallback)
+	{
+		return;
+	}
+
+	// An empty or reversed range, the end bound would come before the first node and never be reached
+	if (szFrom && szTo && strcmp(szFrom, szTo) >= 0)
+	{
+		return;
+	}
+
+	AeroOrderedMapNode pNode = (szFrom) ? Map_LowerBound(map, szFrom).node : Map_Leftmost(map->pRoot);
+	AeroOrderedMapNode pEnd = (szTo) ? Map_LowerBound(map, szTo).node : NULL;
+
+	while (pNode && pNode != pEnd)
+	{
+		AeroOrderedMapNode pNext = Map_Successor(pNode);
+		pfnCallback(pNode->szKey, pNode->pValue);
+		pNode = pNext;
+	}
+}
+
+SAeroOrderedMapIterator Map_Begin(AeroOrderedMap map)
+{
+	if (!map)
+	{
+		syserr("did you forget to initialize the map?!");
+		return (SAeroOrderedMapIterator){ 0 };
+	}
+
+	return (Map_MakeIterator(map, Map_Leftmost(map->pRoot)));
+}
+
+SAeroOrderedMapIterator Map_End(AeroOrderedMap map)
+{
+	return (Map_MakeIterator(map, NULL));
+}
+
+SAeroOrderedMapIterator Map_LowerBound(AeroOrderedMap map, const char* key)
+{
+	if (!map || !key)
+	{
+		return (Map_MakeIterator(map, NULL));
+	}
+
+	// Remember the last node that was not smaller than the key
+	AeroOrderedMapNode pBound = NULL;
+	AeroOrderedMapNode pNode = map->pRoot;
+	while (pNode)
+	{
+		if (strcmp(pNode->szKey, key) >= 0)
+		{
+			pBound = pNode;
+			pNode = pNode->pLeft;
+		}
+		else
 		{
-			pSuccessorParent = pSuccessor;
-			pSuccessor = pSuccessor->pLeft;
+			pNode = pNode->pRight;
 		}
+	}
+
+	return (Map_MakeIterator(map, pBound));
+}
 
-		// Swap the data (Key and Value)
-		// We strdup the successor key and free the old one to be safe
-		char* oldKey = pCurrent->szKey;
-		pCurrent->szKey = engine_strdup(pSuccessor->szKey, map->tag);
-		engine_delete(oldKey);
+SAeroOrderedMapIterator Map_UpperBound(AeroOrderedMap map, const char* key)
+{
+	if (!map || !key)
+	{
+		return (Map_MakeIterator(map, NULL));
+	}
 
-		// Move the value
-		if (map->pfnDestructor && pCurrent->pValue)
+	AeroOrderedMapNode pBound = NULL;
+	AeroOrderedMapNode pNode = map->pRoot;
+	while (pNode)
+	{
+		if (strcmp(pNode->szKey, key) > 0)
+		{
+			pBound = pNode;
+			pNode = pNode->pLeft;
+		}
+		else
 		{
-			map->pfnDestructor(&pCurrent->pValue);
+			pNode = pNode->pRight;
 		}
+	}
 
-		pCurrent->pValue = pSuccessor->pValue;
+	return (Map_MakeIterator(map, pBound));
+}
 
-		// Now we prepare to delete the successor node instead
-		pCurrent = pSuccessor;
-		pParent = pSuccessorParent;
+bool Map_IterCompare(SAeroOrderedMapIterator a, SAeroOrderedMapIterator b)
+{
+	return (a.node == b.node);
+}
+
+bool Map_IteratorNext(AeroOrderedMapIterator iterator)
+{
+	if (!iterator || !iterator->node)
+	{
+		return (false);
 	}
 
-	// 3. Scenario: One Child or Leaf
-	SAeroOrderedMapNode* pChild = (pCurrent->pLeft) ? pCurrent->pLeft : pCurrent->pRight;
+	*iterator = Map_MakeIterator(iterator->_map, Map_Successor(iterator->node));
+	return (iterator->node != NULL);
+}
 
-	if (!pParent) // Deleting the Root
+uint32_t Map_Count(AeroOrderedMap map)
+{
+	if (!map)
 	{
-		map->pRoot = pChild;
+		return (0);
 	}
-	else if (pParent->pLeft == pCurrent)
+
+	return (map->elementCount);
+}
+
+uint32_t Map_Height(AeroOrderedMap map)
+{
+	if (!map)
 	{
-		pParent->pLeft = pChild;
+		return (0);
 	}
-	else
+
+	return ((uint32_t)Map_NodeHeight(map->pRoot));
+}
+
+bool Map_IsEmpty(AeroOrderedMap map)
+{
+	return (Map_Count(map) == 0);
+}
+
+static AeroOrderedMapNode Map_Leftmost(AeroOrderedMapNode pNode)
+{
+	while (pNode && pNode->pLeft)
 	{
-		pParent->pRight = pChild;
+		pNode = pNode->pLeft;
 	}
 
-	// 4. Final Cleanup
-	engine_delete(pCurrent->szKey);
-	engine_delete(pCurrent);
-	map->elementCount--;
+	return (pNode);
+}
+
+static AeroOrderedMapNode Map_Successor(AeroOrderedMapNode pNode)
+{
+	if (pNode->pRight)
+	{
+		return (Map_Leftmost(pNode->pRight));
+	}
+
+	// Climb until we come up from a left subtree
+	AeroOrderedMapNode pParent = pNode->pParent;
+	while (pParent && pNode == pParent->pRight)
+	{
+		pNode = pParent;
+		pParent = pParent->pParent;
+	}
 
-	return;
+	return (pParent);
 }
 
-void Map_ForEach(AeroOrderedMap map, void(*pfnCallback)(const char* key, void* value))
+static SAeroOrderedMapIterator Map_MakeIterator(AeroOrderedMap map, AeroOrderedMapNode pNode)
 {
-	if (!map || !map->pRoot || !pfnCallback)
+	SAeroOrderedMapIterator it = { 0 }; // Zero out everything
+	it._map = map;
+	it.node = pNode;
+	if (pNode)
 	{
-		return;
+		it.key = pNode->szKey;
+		it.value = pNode->pValue;
 	}
 
-	Map_ForEachRecursive(map->pRoot, pfnCallback);
+	return (it);
 }
 
-void Map_ClearRecusive(AeroOrderedMap map, SAeroOrderedMapNode* pNode)
+static void Map_ReplaceChild(AeroOrderedMap map, AeroOrderedMapNode pParent, AeroOrderedMapNode pOld, AeroOrderedMapNode pNew)
 {
-	if (pNode == NULL)
+	if (!pParent)
 	{
-		return;
+		map->pRoot = pNew;
 	}
+	else if (pParent->pLeft == pOld)
+	{
+		pParent->pLeft = pNew;
+	}
+	else
+	{
+		pParent->pRight = pNew;
+	}
+}
 
-	// Visit children first (Recursion)
-	Map_ClearRecusive(map, pNode->pLeft);
-	Map_ClearRecusive(map, pNode->pRight);
+// Right child becomes the subtree root, the old root becomes its left child
+static AeroOrderedMapNode Map_RotateLeft(AeroOrderedMap map, AeroOrderedMapNode pNode)
+{
+	AeroOrderedMapNode pPivot = pNode->pRight;
 
-	// Now clean up this node's data
-	if (map->pfnDestructor && pNode->pValue)
+	pNode->pRight = pPivot->pLeft;
+	if (pPivot->pLeft)
 	{
-		// Remember the double-pointer trick from before if needed!
-		map->pfnDestructor(&pNode->pValue);
+		pPivot->pLeft->pParent = pNode;
 	}
 
-	engine_delete(pNode->szKey);
-	engine_delete(pNode);
+	pPivot->pParent = pNode->pParent;
+	Map_ReplaceChild(map, pNode->pParent, pNode, pPivot);
+
+	pPivot->pLeft = pNode;
+	pNode->pParent = pPivot;
+
+	Map_UpdateHeight(pNode);
+	Map_UpdateHeight(pPivot);
+
+	return (pPivot);
 }
 
-void Map_ForEachRecursive(AeroOrderedMapNode pNode, void(*pfnCallback)(const char* key, void* value))
+// Mirror of Map_RotateLeft
+static AeroOrderedMapNode Map_RotateRight(AeroOrderedMap map, AeroOrderedMapNode pNode)
 {
-	if (pNode == NULL)
+	AeroOrderedMapNode pPivot = pNode->pLeft;
+
+	pNode->pLeft = pPivot->pRight;
+	if (pPivot->pRight)
 	{
-		return;
+		pPivot->pRight->pParent = pNode;
 	}
 
-	// Go Left
-	Map_ForEachRecursive(pNode->pLeft, pfnCallback);
+	pPivot->pParent = pNode->pParent;
+	Map_ReplaceChild(map, pNode->pParent, pNode, pPivot);
+
+	pPivot->pRight = pNode;
+	pNode->pParent = pPivot;
+
+	Map_UpdateHeight(pNode);
+	Map_UpdateHeight(pPivot);
+
+	return (pPivot);
+}
+
+static void Map_Rebalance(AeroOrderedMap map, AeroOrderedMapNode pNode)
+{
+	while (pNode)
+	{
+		int32_t oldHeight = pNode->height;
+		int32_t balance = Map_NodeHeight(pNode->pLeft) - Map_NodeHeight(pNode->pRight);
+
+		if (balance > 1)
+		{
+			// Left-Right case becomes Left-Left first
+			if (Map_NodeHeight(pNode->pLeft->pLeft) < Map_NodeHeight(pNode->pLeft->pRight))
+			{
+				Map_RotateLeft(map, pNode->pLeft);
+			}
+			pNode = Map_RotateRight(map, pNode);
+		}
+		else if (balance < -1)
+		{
+			// Right-Left case becomes Right-Right first
+			if (Map_NodeHeight(pNode->pRight->pRight) < Map_NodeHeight(pNode->pRight->pLeft))
+			{
+				Map_RotateRight(map, pNode->pRight);
+			}
+			pNode = Map_RotateLeft(map, pNode);
+		}
+		else
+		{
+			Map_UpdateHeight(pNode);
 
-	// Process the function
-	pfnCallback(pNode->szKey, pNode->pValue);
+			// Nothing above can change once a balanced subtree keeps its height
+			if (pNode->height == oldHeight)
+			{
+				return;
+			}
+		}
 
-	// Go Right
-	Map_ForEachRecursive(pNode->pRight, pfnCallback);
+		pNode = pNode->pParent;
+	}
 }
@@ -1,10 +1,13 @@
 #ifndef __MAP_H__
-#define __MAH_H__
+#define __MAP_H__
 
 #include <stdint.h>
 #include <stdbool.h>
 
 #include "../Resources/MemoryTags.h"
+#include "../Resources/PoolAllocator.h"
+
+#define MAP_NODE_POOL_SLAB_COUNT 32 // Nodes per pool slab
 
 typedef void (*AeroOrderedMapDestructor)(void* pValue);
 
@@ -15,12 +18,8 @@ typedef struct SAeroOrderedMapNode
 
     struct SAeroOrderedMapNode* pLeft;  // Alphabetically smaller
     struct SAeroOrderedMapNode* pRight; // Alphabetically larger
-
-    // Pro-Tip: Storing the 'height' or 'parent' helps later 
-    // if you want to make it an AVL or Red-Black tree (balanced)
-    struct SAeroOrderedMapNode* pParent;
-    uint32_t height;
-    uint32_t depth;
+    struct SAeroOrderedMapNode* pParent; // Lets iterators and rebalancing walk up without a stack
+    int32_t height; // AVL height, leaves are 1
 } SAeroOrderedMapNode;
 
 typedef struct SAeroOrderedMapNode* AeroOrderedMapNode;
@@ -31,10 +30,24 @@ typedef struct SAeroOrderedMap
     uint32_t elementCount;
     uint32_t tag; // Memory tracking
     AeroOrderedMapDestructor pfnDestructor;
+    PoolAllocator pNodePool; // Nodes come from here instead of one heap block each
 } SAeroOrderedMap;
 
 typedef struct SAeroOrderedMap* AeroOrderedMap;
 
+// In-order iterator, Map_End (node == NULL) is one past the last key
+typedef struct SAeroOrderedMapIterator
+{
+    AeroOrderedMap _map;
+    AeroOrderedMapNode node;
+
+    // Publicly accessible data
+    const char* key;
+    void* value;
+} SAeroOrderedMapIterator;
+
+typedef SAeroOrderedMapIterator* AeroOrderedMapIterator;
+
 bool Map_Initialize(AeroOrderedMap* ppOrderedMap, EMemoryTag tag);
 void Map_Destroy(AeroOrderedMap* ppOrderedMap);
 
@@ -44,8 +57,22 @@ void* Map_Find(AeroOrderedMap map, const char* key);
 void Map_Remove(AeroOrderedMap map, const char* key);
 void Map_ForEach(AeroOrderedMap map, void (*pfnCallback)(const char* key, void* value));
 
-// Private Class stuff
-void Map_ClearRecusive(AeroOrderedMap map, SAeroOrderedMapNode* pNode);
-void Map_ForEachRecursive(AeroOrderedMapNode pNode, void (*pfnCallback)(const char* key, void* value));
+/**
+ * @brief Calls pfnCallback for every key in [szFrom, szTo), in order.
+ * A NULL bound means unbounded on that side.
+ */
+void Map_ForEachRange(AeroOrderedMap map, const char* szFrom, const char* szTo, void (*pfnCallback)(const char* key, void* value));
+
+// Removing while iterating invalidates the iterator
+SAeroOrderedMapIterator Map_Begin(AeroOrderedMap map);
+SAeroOrderedMapIterator Map_End(AeroOrderedMap map);
+SAeroOrderedMapIterator Map_LowerBound(AeroOrderedMap map, const char* key); // First key >= key
+SAeroOrderedMapIterator Map_UpperBound(AeroOrderedMap map, const char* key); // First key > key
+bool Map_IterCompare(SAeroOrderedMapIterator a, SAeroOrderedMapIterator b);
+bool Map_IteratorNext(AeroOrderedMapIterator iterator);
+
+uint32_t Map_Count(AeroOrderedMap map);
+uint32_t Map_Height(AeroOrderedMap map);
+bool Map_IsEmpty(AeroOrderedMap map);
 
 #endif // __MAP_H__
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "SlotMap.h"
+#include "../Resources/MemoryManager.h"
+#include "../Core/Log.h"
+#include <string.h>
+
+static bool SlotMap_GrowSlots(AeroSlotMap slotMap);
+
+bool SlotMap_Initialize(AeroSlotMap* ppSlotMap, size_t elementSize, uint32_t initialCapacity, EMemoryTag tag)
+{
+	if (!ppSlotMap)
+	{
+		syserr("ppSlotMap is NULL (invalid address)");
+		return (false);
+	}
+
+	if (elementSize == 0)
+	{
+		syserr("SlotMap element size must be greater than 0");
+		return (false);
+	}
+
+	*ppSlotMap = engine_new_zero(SAeroSlotMap, 1, tag);
+	if (!(*ppSlotMap))
+	{
+		syserr("Failed to Allocate Memory for SlotMap");
+		return (false);
+	}
+
+	AeroSlotMap slotMap = *ppSlotMap;
+	slotMap->elementSize = elementSize;
+	slotMap->freeHead = slot_map_free_end;
+	slotMap->tag = tag;
+
+	if (!SlotMap_Reserve(slotMap, (initialCapacity > slot_map_min_capacity) ? initialCapacity : slot_map_min_capacity))
+	{
+		SlotMap_Destroy(ppSlotMap);
+		return (false);
+	}
+
+	return (true);
+}
+
+void SlotMap_Destroy(AeroSlotMap* ppSlotMap)
+{
+	if (!ppSlotMap || !(*ppSlotMap))
+	{
+		return;
+	}
+
+	AeroSlotMap slotMap = *ppSlotMap;
+
+	if (slotMap->pDense)
+	{
+		engine_delete(slotMap->pDense);
+	}
+	if (slotMap->pDenseToSlot)
+	{
+		engine_delete(slotMap->pDenseToSlot);
+	}
+	if (slotMap->pSlots)
+	{
+		engine_delete(slotMap->pSlots);
+	}
+
+	engine_delete(slotMap);
+
+	*ppSlotMap = NULL;
+}
+
+/**
+ * @brief Removes every element, all handles handed out so far go stale.
+ */
+void SlotMap_Clear(AeroSlotMap slotMap)
+{
+	if (!slotMap)
+	{
+		return;
+	}
+
+	while (slotMap->count > 0)
+	{
+		SlotMap_Remove(slotMap, SlotMap_HandleAt(slotMap, slotMap->count - 1));
+	}
+}
+
+bool SlotMap_Reserve(AeroSlotMap slotMap, uint32_t capacity)
+{
+	if (!slotMap || capacity <= slotMap->capacity)
+	{
+		return (slotMap != NULL);
+	}
+
+	if (capacity > AERO_HANDLE_MAX_SLOTS)
+	{
+		capacity = AERO_HANDLE_MAX_SLOTS;
+		if (capacity <= slotMap->capacity)
+		{
+			syserr("SlotMap is full (%u elements)", slotMap->capacity);
+			return (false);
+		}
+	}
+
+	uint8_t* pDense = (slotMap->pDense)
+		? (uint8_t*)tracked_realloc_internal(slotMap->pDense, slotMap->elementSize * capacity, __FILE__, __LINE__, "SlotMapDense")
+		: (uint8_t*)tracked_malloc_internal(slotMap->elementSize * capacity, __FILE__, __LINE__, "SlotMapDense", slotMap->tag);
+	if (!pDense)
+	{
+		syserr("Failed to grow SlotMap dense array to %u elements", capacity);
+		return (false);
+	}
+	slotMap->pDense = pDense;
+
+	uint32_t* pDenseToSlot = (slotMap->pDenseToSlot)
+		? (uint32_t*)tracked_realloc_internal(slotMap->pDenseToSlot, sizeof(uint32_t) * capacity, __FILE__, __LINE__, "SlotMapDenseToSlot")
+		: (uint32_t*)tracked_malloc_internal(sizeof(uint32_t) * capacity, __FILE__, __LINE__, "SlotMapDenseToSlot", slotMap->tag);
+	if (!pDenseToSlot)
+	{
+		syserr("Failed to grow SlotMap dense index to %u elements", capacity);
+		return (false);
+	}
+	slotMap->pDenseToSlot = pDenseToSlot;
+	slotMap->capacity = capacity;
+
+	return (true);
+}
+
+static bool SlotMap_GrowSlots(AeroSlotMap slotMap)
+{
+	if (slotMap->slotCapacity >= AERO_HANDLE_MAX_SLOTS)
+	{
+		syserr("SlotMap ran out of handle slots (%u)", AERO_HANDLE_MAX_SLOTS);
+		return (false);
+	}
+
+	uint32_t capacity = (slotMap->slotCapacity == 0) ? slot_map_min_capacity : slotMap->slotCapacity * 2;
+	if (capacity > AERO_HANDLE_MAX_SLOTS)
+	{
+		capacity = AERO_HANDLE_MAX_SLOTS;
+	}
+
+	SAeroSlotMapSlot* pSlots = (slotMap->pSlots)
+		? (SAeroSlotMapSlot*)tracked_realloc_internal(slotMap->pSlots, sizeof(SAeroSlotMapSlot) * capacity, __FILE__, __LINE__, "SAeroSlotMapSlot[]")
+		: (SAeroSlotMapSlot*)tracked_malloc_internal(sizeof(SAeroSlotMapSlot) * capacity, __FILE__, __LINE__, "SAeroSlotMapSlot[]", slotMap->tag);
+	if (!pSlots)
+	{
+		syserr("Failed to grow SlotMap slots to %u", capacity);
+		return (false);
+	}
+
+	slotMap->pSlots = pSlots;
+	slotMap->slotCapacity = capacity;
+	return (true);
+}
+
+void* SlotMap_Emplace(AeroSlotMap slotMap, AeroHandle* pHandle)
+{
+	if (pHandle)
+	{
+		*pHandle = AERO_HANDLE_INVALID;
+	}
+
+	if (!slotMap)
+	{
+		return (NULL);
+	}
+
+	if (slotMap->count == slotMap->capacity && !SlotMap_Reserve(slotMap, slotMap->capacity * 2))
+	{
+		return (NULL);
+	}
+
+	// Reuse a freed slot first, it already carries its next generation
+	uint32_t slotIndex = slotMap->freeHead;
+	if (slotIndex != slot_map_free_end)
+	{
+		slotMap->freeHead = slotMap->pSlots[slotIndex].denseIndex;
+	}
+	else
+	{
+		if (slotMap->slotCount == slotMap->slotCapacity && !SlotMap_GrowSlots(slotMap))
+		{
+			return (NULL);
+		}
+
+		slotIndex = slotMap->slotCount++;
+		slotMap->pSlots[slotIndex].generation = 1;
+	}
+
+	uint32_t denseIndex = slotMap->count++;
+	slotMap->pSlots[slotIndex].denseIndex = denseIndex;
+	slotMap->pDenseToSlot[denseIndex] = slotIndex;
+
+	void* pElement = SlotMap_DenseAt(slotMap, denseIndex);
+	memset(pElement, 0, slotMap->elementSize);
+
+	if (pHandle)
+	{
+		*pHandle = AeroHandle_Make(slotIndex, slotMap->pSlots[slotIndex].generation);
+	}
+
+	return (pElement);
+}
+
+AeroHandle SlotMap_Insert(AeroSlotMap slotMap, const void* pElement)
+{
+	AeroHandle handle = AERO_HANDLE_INVALID;
+	void* pDest = SlotMap_Emplace(slotMap, &handle);
+
+	if (pDest && pElement)
+	{
+		memcpy(pDest, pElement, slotMap->elementSize);
+	}
+
+	return (handle);
+}
+
+bool SlotMap_Remove(AeroSlotMap slotMap, AeroHandle handle)
+{
+	if (!SlotMap_IsValid(slotMap, handle))
+	{
+		return (false);
+	}
+
+	uint32_t slotIndex = AeroHandle_Index(handle);
+	SAeroSlotMapSlot* pSlot = &slotMap->pSlots[slotIndex];
+	uint32_t denseIndex = pSlot->denseIndex;
+	uint32_t lastIndex = slotMap->count - 1;
+
+	// Keep the dense array packed, move the last element into the hole
+	if (denseIndex != lastIndex)
+	{
+		memcpy(SlotMap_DenseAt(slotMap, denseIndex), SlotMap_DenseAt(slotMap, lastIndex), slotMap->elementSize);
+
+		uint32_t movedSlot = slotMap->pDenseToSlot[lastIndex];
+		slotMap->pDenseToSlot[denseIndex] = movedSlot;
+		slotMap->pSlots[movedSlot].denseIndex = denseIndex;
+	}
+	slotMap->count--;
+
+	// A slot whose generation would wrap is retired, so old handles can never alias it
+	pSlot->generation = (pSlot->generation + 1) & AERO_HANDLE_GENERATION_MASK;
+	if (pSlot->generation != 0)
+	{
+		pSlot->denseIndex = slotMap->freeHead;
+		slotMap->freeHead = slotIndex;
+	}
+
+	return (true);
+}
+
+AeroHandle SlotMap_HandleAt(AeroSlotMap slotMap, uint32_t denseIndex)
+{
+	if (!slotMap || denseIndex >= slotMap->count)
+	{
+		return (AERO_HANDLE_INVALID);
+	}
+
+	uint32_t slotIndex = slotMap->pDenseToSlot[denseIndex];
+	return (AeroHandle_Make(slotIndex, slotMap->pSlots[slotIndex].generation));
+}
+
+uint32_t SlotMap_Count(AeroSlotMap slotMap)
+{
+	return ((slotMap) ? slotMap->count : 0);
+}
+
+bool SlotMap_IsEmpty(AeroSlotMap slotMap)
+{
+	return (SlotMap_Count(slotMap) == 0);
+}
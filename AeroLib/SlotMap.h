@@ -0,0 +1,118 @@
+#ifndef __SLOT_MAP_H__
+#define __SLOT_MAP_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../Resources/MemoryTags.h"
+
+/**
+ * @brief Generational handle: slot index in the low bits, generation above.
+ *
+ * A handle outlives the element it names safely, once the element is removed
+ * the slot generation moves on and every old handle resolves to NULL.
+ * Generation 0 is never handed out, so 0 is always an invalid handle.
+ */
+typedef uint32_t AeroHandle;
+
+#define AERO_HANDLE_INVALID			((AeroHandle)0)
+#define AERO_HANDLE_INDEX_BITS		20
+#define AERO_HANDLE_INDEX_MASK		((1u << AERO_HANDLE_INDEX_BITS) - 1u)
+#define AERO_HANDLE_GENERATION_MASK	((1u << (32 - AERO_HANDLE_INDEX_BITS)) - 1u)
+#define AERO_HANDLE_MAX_SLOTS		(AERO_HANDLE_INDEX_MASK + 1u)
+
+static inline AeroHandle AeroHandle_Make(uint32_t index, uint32_t generation)
+{
+	return ((AeroHandle)((generation << AERO_HANDLE_INDEX_BITS) | (index & AERO_HANDLE_INDEX_MASK)));
+}
+
+static inline uint32_t AeroHandle_Index(AeroHandle handle)
+{
+	return (handle & AERO_HANDLE_INDEX_MASK);
+}
+
+static inline uint32_t AeroHandle_Generation(AeroHandle handle)
+{
+	return (handle >> AERO_HANDLE_INDEX_BITS);
+}
+
+// Sparse slot, names where the element sits in the dense array
+typedef struct SAeroSlotMapSlot
+{
+	uint32_t denseIndex;	// Next free slot while the slot is unused
+	uint32_t generation;	// Bumped on remove, 0 = retired for good
+} SAeroSlotMapSlot;
+
+/**
+ * @brief Slot map (sparse slots -> packed dense array) of fixed size elements.
+ *
+ * Insert, remove and lookup are O(1). Elements stay packed so iterating the
+ * dense array touches only live data, removal swaps the last element into
+ * the hole. Element pointers are only valid until the next insert or remove,
+ * hold the handle instead.
+ */
+typedef struct SAeroSlotMap
+{
+	uint8_t* pDense;				// count * elementSize bytes of live elements
+	uint32_t* pDenseToSlot;			// Dense index -> owning slot, to patch on swap-remove
+	SAeroSlotMapSlot* pSlots;
+
+	size_t elementSize;
+	uint32_t count;					// Live elements
+	uint32_t capacity;				// Dense capacity
+	uint32_t slotCount;				// Slots ever handed out
+	uint32_t slotCapacity;
+	uint32_t freeHead;				// UINT32_MAX when no slot can be reused
+	EMemoryTag tag;
+} SAeroSlotMap;
+
+typedef SAeroSlotMap* AeroSlotMap;
+
+static const uint32_t slot_map_min_capacity = 16;
+static const uint32_t slot_map_free_end = UINT32_MAX;
+
+bool SlotMap_Initialize(AeroSlotMap* ppSlotMap, size_t elementSize, uint32_t initialCapacity, EMemoryTag tag);
+void SlotMap_Destroy(AeroSlotMap* ppSlotMap);
+void SlotMap_Clear(AeroSlotMap slotMap);
+
+/**
+ * @brief Adds a zeroed element, writes its handle and returns it for filling.
+ */
+void* SlotMap_Emplace(AeroSlotMap slotMap, AeroHandle* pHandle);
+AeroHandle SlotMap_Insert(AeroSlotMap slotMap, const void* pElement);
+bool SlotMap_Remove(AeroSlotMap slotMap, AeroHandle handle);
+
+/**
+ * @brief Resolves a handle, NULL when the handle is stale or invalid.
+ */
+static inline void* SlotMap_Get(AeroSlotMap slotMap, AeroHandle handle)
+{
+	uint32_t index = AeroHandle_Index(handle);
+	uint32_t generation = AeroHandle_Generation(handle);
+
+	if (!slotMap || generation == 0 || index >= slotMap->slotCount || slotMap->pSlots[index].generation != generation)
+	{
+		return (NULL);
+	}
+
+	return (slotMap->pDense + (size_t)slotMap->pSlots[index].denseIndex * slotMap->elementSize);
+}
+
+static inline bool SlotMap_IsValid(AeroSlotMap slotMap, AeroHandle handle)
+{
+	return (SlotMap_Get(slotMap, handle) != NULL);
+}
+
+// Dense access, index in [0, count)
+static inline void* SlotMap_DenseAt(AeroSlotMap slotMap, uint32_t denseIndex)
+{
+	return (slotMap->pDense + (size_t)denseIndex * slotMap->elementSize);
+}
+
+AeroHandle SlotMap_HandleAt(AeroSlotMap slotMap, uint32_t denseIndex);
+bool SlotMap_Reserve(AeroSlotMap slotMap, uint32_t capacity);
+
+uint32_t SlotMap_Count(AeroSlotMap slotMap);
+bool SlotMap_IsEmpty(AeroSlotMap slotMap);
+
+#endif // __SLOT_MAP_H__
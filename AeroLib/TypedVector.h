@@ -0,0 +1,128 @@
+#ifndef __TYPED_VECTOR_H__
+#define __TYPED_VECTOR_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "../Resources/MemoryManager.h"
+#include "../Core/Log.h"
+
+/**
+ * @brief Typed, header-only counterpart of Vector for hot loops.
+ *
+ * AERO_VECTOR_DEFINE(T) generates SAeroVector_T plus static inline
+ * AeroVector_T_* functions. Elements are stored by value, pushes compile
+ * to a compare and a store, and grown memory is NOT zero-filled.
+ * The struct is meant to be embedded (zero it or call _Init), not allocated.
+ *
+ * Define each T once per translation unit (next to the type it stores).
+ */
+#define AERO_VECTOR_DEFINE(T)																		\
+typedef struct SAeroVector_##T																		\
+{																									\
+	T* pData;																						\
+	size_t count;																					\
+	size_t capacity;																				\
+	EMemoryTag tag;																					\
+} SAeroVector_##T;																					\
+																									\
+static inline void AeroVector_##T##_Init(SAeroVector_##T* pVector, EMemoryTag tag)					\
+{																									\
+	pVector->pData = NULL;																			\
+	pVector->count = 0;																				\
+	pVector->capacity = 0;																			\
+	pVector->tag = tag;																				\
+}																									\
+																									\
+static inline bool AeroVector_##T##_Reserve(SAeroVector_##T* pVector, size_t capacity)				\
+{																									\
+	if (capacity <= pVector->capacity)																\
+	{																								\
+		return (true);																				\
+	}																								\
+																									\
+	T* pNewData = (pVector->pData)																	\
+		? (T*)tracked_realloc_internal(pVector->pData, sizeof(T) * capacity, __FILE__, __LINE__, #T "[]")	\
+		: (T*)tracked_malloc_internal(sizeof(T) * capacity, __FILE__, __LINE__, #T "[]", pVector->tag);	\
+	if (!pNewData)																					\
+	{																								\
+		syserr("AeroVector<" #T "> failed to reserve %zu elements", capacity);						\
+		return (false);																				\
+	}																								\
+																									\
+	pVector->pData = pNewData;																		\
+	pVector->capacity = capacity;																	\
+	return (true);																					\
+}																									\
+																									\
+static inline bool AeroVector_##T##_Grow(SAeroVector_##T* pVector, size_t minCapacity)				\
+{																									\
+	size_t capacity = (pVector->capacity == 0) ? 4 : pVector->capacity * 2;							\
+	return (AeroVector_##T##_Reserve(pVector, (capacity > minCapacity) ? capacity : minCapacity));	\
+}																									\
+																									\
+static inline void AeroVector_##T##_Destroy(SAeroVector_##T* pVector)								\
+{																									\
+	if (pVector->pData)																				\
+	{																								\
+		engine_delete(pVector->pData);																\
+	}																								\
+	pVector->pData = NULL;																			\
+	pVector->count = 0;																				\
+	pVector->capacity = 0;																			\
+}																									\
+																									\
+static inline void AeroVector_##T##_Clear(SAeroVector_##T* pVector)								\
+{																									\
+	pVector->count = 0; /* keeps the capacity, nothing is wiped */									\
+}																									\
+																									\
+static inline void AeroVector_##T##_PushBack(SAeroVector_##T* pVector, T value)					\
+{																									\
+	if (pVector->count == pVector->capacity && !AeroVector_##T##_Grow(pVector, pVector->count + 1))	\
+	{																								\
+		return;																						\
+	}																								\
+	pVector->pData[pVector->count++] = value;														\
+}																									\
+																									\
+/* Returns an uninitialized slot at the back, write it in place */									\
+static inline T* AeroVector_##T##_EmplaceBack(SAeroVector_##T* pVector)							\
+{																									\
+	if (pVector->count == pVector->capacity && !AeroVector_##T##_Grow(pVector, pVector->count + 1))	\
+	{																								\
+		return (NULL);																				\
+	}																								\
+	return (&pVector->pData[pVector->count++]);														\
+}																									\
+																									\
+/* Appends count elements with one capacity check and one memcpy */									\
+static inline T* AeroVector_##T##_AppendRange(SAeroVector_##T* pVector, const T* pElements, size_t count)	\
+{																									\
+	if (pVector->count + count > pVector->capacity && !AeroVector_##T##_Grow(pVector, pVector->count + count))	\
+	{																								\
+		return (NULL);																				\
+	}																								\
+	T* pDest = pVector->pData + pVector->count;														\
+	memcpy(pDest, pElements, sizeof(T) * count);													\
+	pVector->count += count;																		\
+	return (pDest);																					\
+}																									\
+																									\
+static inline void AeroVector_##T##_PopBack(SAeroVector_##T* pVector)								\
+{																									\
+	if (pVector->count > 0)																			\
+	{																								\
+		pVector->count--;																			\
+	}																								\
+}																									\
+																									\
+static inline T* AeroVector_##T##_Get(SAeroVector_##T* pVector, size_t index)						\
+{																									\
+	return ((index < pVector->count) ? &pVector->pData[index] : NULL);								\
+}
+
+// Shared instantiations (index buffers, id lists)
+AERO_VECTOR_DEFINE(uint32_t)
+
+#endif // __TYPED_VECTOR_H__
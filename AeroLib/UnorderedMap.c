@@ -4,35 +4,50 @@
 #include "../Core/Log.h"
 #include <string.h>
 
-bool UnorderedMap_Initialize(AeroUnorderedMap* ppUnorderedMap, EMemoryTag tag)
+// Key being looked up, hashed once up front
+typedef struct SUnorderedMapKeyRef
 {
-	// Initialize Elements and everything inside struct to NULL / 0
-	*ppUnorderedMap = engine_new_zero(SAeroUnorderedMap, 1, tag);
-
-	AeroUnorderedMap map = *ppUnorderedMap;
-
-	if (map == NULL)
-	{
-		syserr("Failed to Allocate Memory for UnorderedMap with tag %s", MemoryTagNames[tag]);
-		return (false);
-	}
-
-	map->ppBuckets = engine_new_zero(AeroUnorderedMapNode, unordered_map_init_val, tag);
+	const char* szKey;
+	uint64_t intKey;
+	uint32_t length;	// String keys, without the terminator
+	uint32_t hash;
+} SUnorderedMapKeyRef;
+
+static bool UnorderedMap_InitializeInternal(AeroUnorderedMap* ppUnorderedMap, EAeroUnorderedMapKeyType keyType, EMemoryTag tag);
+static bool UnorderedMap_InsertInternal(AeroUnorderedMap map, const SUnorderedMapKeyRef* pKey, void* value);
+static int64_t UnorderedMap_FindSlot(AeroUnorderedMap map, const SUnorderedMapKeyRef* pKey);
+static void UnorderedMap_RemoveSlot(AeroUnorderedMap map, uint32_t index);
+static bool UnorderedMap_Rehash(AeroUnorderedMap map, uint32_t newSlotCount);
+static void UnorderedMap_PlaceSlot(SAeroUnorderedMapSlot* pSlots, uint32_t slotMask, SAeroUnorderedMapSlot entry);
+static char* UnorderedMap_CopyKey(SAeroUnorderedMapKeyChunk** ppChunks, const char* key, uint32_t length, EMemoryTag tag);
+static void UnorderedMap_FreeKeyChunks(SAeroUnorderedMapKeyChunk* pChunk);
+static uint32_t UnorderedMap_SlotsForCount(uint32_t elementCount);
+
+static SUnorderedMapKeyRef UnorderedMap_StringKey(const char* key)
+{
+	SUnorderedMapKeyRef ref = { 0 };
+	ref.szKey = key;
+	ref.length = (uint32_t)strlen(key);
+	ref.hash = fnv1a_32(key, ref.length);
+	return (ref);
+}
 
-	if (map->ppBuckets == NULL)
-	{
-		syserr("Failed to Allocate Buckets for UnorderedMap (Tag: %s)", MemoryTagNames[tag]);
-		// Clean up the header so we don't leak it on partial failure
-		engine_delete(map);
-		return false;
-	}
+static SUnorderedMapKeyRef UnorderedMap_IntKey(uint64_t key)
+{
+	SUnorderedMapKeyRef ref = { 0 };
+	ref.intKey = key;
+	ref.hash = hash_u64(key);
+	return (ref);
+}
 
-	// Set Metadata
-	map->bucketCount = unordered_map_init_val;
-	map->tag = tag;
-	map->elementCount = 0;
+bool UnorderedMap_Initialize(AeroUnorderedMap* ppUnorderedMap, EMemoryTag tag)
+{
+	return (UnorderedMap_InitializeInternal(ppUnorderedMap, UNORDERED_MAP_KEY_STRING, tag));
+}
 
-	return (true);
+bool UnorderedMap_InitializeWithKeys(AeroUnorderedMap* ppUnorderedMap, EAeroUnorderedMapKeyType keyType, EMemoryTag tag)
+{
+	return (UnorderedMap_InitializeInternal(ppUnorderedMap, keyType, tag));
 }
 
 void UnoderedMap_Destroy(AeroUnorderedMap* ppUnorderedMap)
@@ -44,13 +59,12 @@ void UnoderedMap_Destroy(AeroUnorderedMap* ppUnorderedMap)
 
 	AeroUnorderedMap map = *ppUnorderedMap;
 
-	// Remove all nodes, keys, and values
+	// Remove all values and keys
 	UnorderedMap_Clear(map);
 
-	// Delete the array of bucket pointers (the "parking lot" pavement)
-	if (map->ppBuckets)
+	if (map->pSlots)
 	{
-		engine_delete(map->ppBuckets);
+		engine_delete(map->pSlots);
 	}
 
 	engine_delete(map);
@@ -60,39 +74,34 @@ void UnoderedMap_Destroy(AeroUnorderedMap* ppUnorderedMap)
 
 void UnorderedMap_Clear(AeroUnorderedMap map)
 {
-	for (size_t i = 0; i < map->bucketCount; i++)
+	if (!map)
 	{
-		// Get the head of the list for this bucket
-		SAeroUnorderedMapNode* pCurrentNode = map->ppBuckets[i];
+		return;
+	}
 
-		// Walk the linked list
-		while (pCurrentNode != NULL)
+	for (uint32_t i = 0; i < map->slotCount && map->elementCount > 0; i++)
+	{
+		SAeroUnorderedMapSlot* pSlot = &map->pSlots[i];
+		if (pSlot->distance == 0)
 		{
-			// Store the next node BEFORE we delete the current one
-			SAeroUnorderedMapNode* pNextNode = pCurrentNode->next;
-
-			// Call the destructor for the user's data (if provided)
-			if (map->pfnDestructor && pCurrentNode->pValue)
-			{
-				map->pfnDestructor(&pCurrentNode->pValue);
-			}
-
-			// Free the key (since we used engine_strdup)
-			if (pCurrentNode->szKey)
-			{
-				engine_delete(pCurrentNode->szKey);
-			}
-
-			// Free the node itself
-			engine_delete(pCurrentNode);
+			continue;
+		}
 
-			// Move to the next node in the chain
-			pCurrentNode = pNextNode;
+		// Call the destructor for the user's data (if provided)
+		if (map->pfnDestructor && pSlot->pValue)
+		{
+			map->pfnDestructor(&pSlot->pValue);
 		}
 
-		// Set the bucket head to NULL so the map is safe to use again
-		map->ppBuckets[i] = NULL;
+		map->elementCount--;
 	}
+
+	// Keys live in the arena, dropping the chunks frees all of them at once
+	memset(map->pSlots, 0, sizeof(SAeroUnorderedMapSlot) * map->slotCount);
+	UnorderedMap_FreeKeyChunks(map->pKeyChunks);
+	map->pKeyChunks = NULL;
+	map->liveKeyBytes = 0;
+	map->deadKeyBytes = 0;
 	map->elementCount = 0;
 }
 
@@ -103,186 +112,160 @@ bool UnorderedMap_Insert(AeroUnorderedMap map, const char* key, void* value)
 		return (false);
 	}
 
-	if (!key || !value)
+	if (!key || !value || map->keyType != UNORDERED_MAP_KEY_STRING)
 	{
 		syserr("Trying to Insert invalid data into the map");
 		return (false);
 	}
 
-	if (map->elementCount >= map->bucketCount)
+	SUnorderedMapKeyRef ref = UnorderedMap_StringKey(key);
+	return (UnorderedMap_InsertInternal(map, &ref, value));
+}
+
+void* UnorderedMap_Find(AeroUnorderedMap map, const char* key)
+{
+	if (!map)
 	{
-		// A simple way is to double and then find the next prime, 
-		// or just multiply by 2 + 1 to keep it odd (cheap version)
-		uint32_t newSize = (map->bucketCount * 2) + 1;
-		UnorderedMap_Resize(map, newSize);
+		return (NULL);
 	}
 
-	uint32_t hash = fnv1a_str(key);
-	uint32_t index = hash % map->bucketCount;
-
-	// Search for existing key to update it
-	SAeroUnorderedMapNode* pCurrentNode = map->ppBuckets[index];
-	while (pCurrentNode != NULL)
+	if (!key || map->keyType != UNORDERED_MAP_KEY_STRING)
 	{
-		// Compare hashes FIRST (fast integer check)
-		// Only call strcmp (slow string check) if hashes match!
-		if (pCurrentNode->hash == hash && strcmp(key, pCurrentNode->szKey) == 0) 
-		{
-			if (map->pfnDestructor)
-			{
-				map->pfnDestructor(&pCurrentNode->pValue); // Free Memory
-			}
-			pCurrentNode->pValue = value;
-			return (true);
-		}
+		syserr("Trying to Find invalid key into the map");
+		return (NULL);
+	}
 
-		pCurrentNode = pCurrentNode->next;
+	SUnorderedMapKeyRef ref = UnorderedMap_StringKey(key);
+	int64_t index = UnorderedMap_FindSlot(map, &ref);
+
+	return ((index >= 0) ? map->pSlots[index].pValue : NULL);
+}
+
+void UnorderedMap_Remove(AeroUnorderedMap map, const char* key)
+{
+	if (!map)
+	{
+		return;
 	}
 
-	// Not found, create a NEW node
-	AeroUnorderedMapNode newNode = engine_new_zero(SAeroUnorderedMapNode, 1, map->tag);
-	if (newNode == NULL)
+	if (!key || map->keyType != UNORDERED_MAP_KEY_STRING)
 	{
-		syserr("Failed to Allocate newNode Memory");
-		return (false);
+		syserr("Trying to Remove invalid key from the map");
+		return;
 	}
 
-	// Setup the node
-	newNode->hash = hash;
-	newNode->szKey = engine_strdup(key, map->tag);
-	newNode->pValue = value;
+	SUnorderedMapKeyRef ref = UnorderedMap_StringKey(key);
+	int64_t index = UnorderedMap_FindSlot(map, &ref);
+	if (index >= 0)
+	{
+		UnorderedMap_RemoveSlot(map, (uint32_t)index);
+	}
+}
 
-	// Link it into the head of the bucket list
-	newNode->next = map->ppBuckets[index];
-	map->ppBuckets[index] = newNode;
+bool UnorderedMap_InsertInt(AeroUnorderedMap map, uint64_t key, void* value)
+{
+	if (!map)
+	{
+		return (false);
+	}
 
+	if (!value || map->keyType == UNORDERED_MAP_KEY_STRING)
+	{
+		syserr("Trying to Insert invalid data into the map");
+		return (false);
+	}
 
-	map->elementCount++;
-	return (true);
+	SUnorderedMapKeyRef ref = UnorderedMap_IntKey(key);
+	return (UnorderedMap_InsertInternal(map, &ref, value));
 }
 
-void* UnorderedMap_Find(AeroUnorderedMap map, const char* key)
+void* UnorderedMap_FindInt(AeroUnorderedMap map, uint64_t key)
 {
 	if (!map)
 	{
 		return (NULL);
 	}
 
-	if (!key)
+	if (map->keyType == UNORDERED_MAP_KEY_STRING)
 	{
-		syserr("Trying to Find invalid key into the map");
+		syserr("Trying to Find an integer key in a string map");
 		return (NULL);
 	}
 
-	uint32_t hash = fnv1a_str(key);
-	uint32_t index = hash % map->bucketCount;
-
-	// Search for existing key to update it
-	SAeroUnorderedMapNode* pCurrentNode = map->ppBuckets[index];
-	while (pCurrentNode != NULL)
-	{
-		// Compare hashes FIRST (fast integer check)
-		// Only call strcmp (slow string check) if hashes match!
-		if (pCurrentNode->hash == hash && strcmp(key, pCurrentNode->szKey) == 0)
-		{
-			return (pCurrentNode->pValue);
-		}
-
-		pCurrentNode = pCurrentNode->next;
-	}
+	SUnorderedMapKeyRef ref = UnorderedMap_IntKey(key);
+	int64_t index = UnorderedMap_FindSlot(map, &ref);
 
-	return (NULL);
+	return ((index >= 0) ? map->pSlots[index].pValue : NULL);
 }
 
-void UnorderedMap_Remove(AeroUnorderedMap map, const char* key)
+void UnorderedMap_RemoveInt(AeroUnorderedMap map, uint64_t key)
 {
 	if (!map)
 	{
 		return;
 	}
 
-	if (!key)
+	if (map->keyType == UNORDERED_MAP_KEY_STRING)
 	{
-		syserr("Trying to Find invalid key into the map");
+		syserr("Trying to Remove an integer key from a string map");
 		return;
 	}
 
-	uint32_t hash = fnv1a_str(key);
-	uint32_t index = hash % map->bucketCount;
-	// Search for existing key to update it
-	SAeroUnorderedMapNode* pCurrentNode = map->ppBuckets[index];
-	SAeroUnorderedMapNode* pPreviousNode = NULL;
-	while (pCurrentNode != NULL)
+	SUnorderedMapKeyRef ref = UnorderedMap_IntKey(key);
+	int64_t index = UnorderedMap_FindSlot(map, &ref);
+	if (index >= 0)
 	{
-		// Compare hashes FIRST (fast integer check)
-		// Only call strcmp (slow string check) if hashes match!
-		if (pCurrentNode->hash == hash && strcmp(key, pCurrentNode->szKey) == 0)
-		{
-			// "Unplug" the node from the chain
-			if (pPreviousNode == NULL)
-			{
-				// This was the first node in the bucket
-				map->ppBuckets[index] = pCurrentNode->next;
-			}
-			else
-			{
-				// Link the previous node to the one after the current one
-				pPreviousNode->next = pCurrentNode->next;
-			}
+		UnorderedMap_RemoveSlot(map, (uint32_t)index);
+	}
+}
 
-			// Cleanup the data
-			if (map->pfnDestructor)
-			{
-				map->pfnDestructor(&pCurrentNode->pValue);
-			}
+bool UnorderedMap_InsertPtr(AeroUnorderedMap map, const void* key, void* value)
+{
+	return (UnorderedMap_InsertInt(map, (uint64_t)(uintptr_t)key, value));
+}
 
-			engine_delete(pCurrentNode->szKey);
-			engine_delete(pCurrentNode);
+void* UnorderedMap_FindPtr(AeroUnorderedMap map, const void* key)
+{
+	return (UnorderedMap_FindInt(map, (uint64_t)(uintptr_t)key));
+}
 
-			map->elementCount--;
+void UnorderedMap_RemovePtr(AeroUnorderedMap map, const void* key)
+{
+	UnorderedMap_RemoveInt(map, (uint64_t)(uintptr_t)key);
+}
 
-			return; // We found it and deleted it, we can stop now
-		}
+void UnorderedMap_Reserve(AeroUnorderedMap map, uint32_t elementCount)
+{
+	if (!map)
+	{
+		return;
+	}
 
-		// Move pointers forward
-		pPreviousNode = pCurrentNode;
-		pCurrentNode = pCurrentNode->next;
+	uint32_t newSlotCount = UnorderedMap_SlotsForCount(elementCount);
+	if (newSlotCount > map->slotCount)
+	{
+		UnorderedMap_Rehash(map, newSlotCount);
 	}
 }
 
 void UnorderedMap_Resize(AeroUnorderedMap map, uint32_t newSize)
 {
-	AeroUnorderedMapNode* pNewBuckets = engine_new_zero(AeroUnorderedMapNode, 1, map->tag);
-	if (!pNewBuckets)
+	if (!map)
 	{
-		return; // Fail gracefully
+		return;
 	}
 
-	// Iterate through old buckets
-	for (uint32_t i = 0; i < map->bucketCount; i++)
+	// Round up to a power of two, never below what the current elements need
+	uint32_t newSlotCount = UnorderedMap_SlotsForCount(map->elementCount);
+	while (newSlotCount < newSize && newSlotCount < (1u << 31))
 	{
-		AeroUnorderedMapNode pNode = map->ppBuckets[i];
-
-		while (pNode)
-		{
-			// Save the next node in the OLD bucket before we move the current one
-			SAeroUnorderedMapNode* pNext = pNode->next;
-
-			// Calculate new index using the cached hash
-			uint32_t newIndex = pNode->hash % newSize;
-
-			// Insert at the head of the NEW bucket
-			pNode->next = pNewBuckets[newIndex];
-			pNewBuckets[newIndex] = pNode;
-
-			pNode = pNext;
-		}
+		newSlotCount <<= 1;
 	}
 
-	// Swap the arrays and update metadata
-	engine_delete(map->ppBuckets);
-	map->ppBuckets = pNewBuckets;
-	map->bucketCount = newSize;
+	if (newSlotCount != map->slotCount)
+	{
+		UnorderedMap_Rehash(map, newSlotCount);
+	}
 }
 
 SAeroUnorderedMapIterator UnorderedMap_Begin(AeroUnorderedMap map)
@@ -295,27 +278,15 @@ SAeroUnorderedMapIterator UnorderedMap_Begin(AeroUnorderedMap map)
 
 	SAeroUnorderedMapIterator it = { 0 }; // Zero out everything
 	it._map = map;
-	it._bucketIndex = -1;
-	it.node = NULL;
+	it._slotIndex = -1;
+	it.slot = NULL;
 
-	if (!map || map->elementCount == 0)
+	if (map->elementCount == 0)
 	{
-		return it;
-	}
-
-	// Find the first non-empty bucket
-	for (uint32_t i = 0; i < map->bucketCount; i++)
-	{
-		if (map->ppBuckets[i] != NULL)
-		{
-			it.node = map->ppBuckets[i];
-			it._bucketIndex = i;
-			it.key = it.node->szKey;
-			it.value = it.node->pValue;
-			break;
-		}
+		return (it);
 	}
 
+	UnorderedMap_IteratorNext(&it);
 	return (it);
 }
 
@@ -323,49 +294,50 @@ SAeroUnorderedMapIterator UnorderedMap_End(AeroUnorderedMap map)
 {
 	SAeroUnorderedMapIterator it = { 0 }; // Zero out everything
 	it._map = map;
-	it._bucketIndex = -1;
-	it.node = NULL;
+	it._slotIndex = -1;
+	it.slot = NULL;
 	return (it);
 }
 
 bool UnorderedMap_IterCompare(SAeroUnorderedMapIterator a, SAeroUnorderedMapIterator b)
 {
-	// If both nodes are NULL, they are both "End" iterators and therefore equal
-	return a.node == b.node;
+	// If both slots are NULL, they are both "End" iterators and therefore equal
+	return (a.slot == b.slot);
 }
 
 bool UnorderedMap_IteratorNext(AeroUnorderedMapIterator iterator)
 {
-	if (!iterator || !iterator->node)
+	if (!iterator || !iterator->_map)
 	{
 		return (false);
 	}
 
-	// Try to move to the next node in the current linked list
-	if (iterator->node->next != NULL)
+	// Begin starts at -1 with no slot, anything else past the end is done
+	if (!iterator->slot && iterator->_slotIndex != -1)
 	{
-		iterator->node = iterator->node->next;
-		iterator->key = iterator->node->szKey;
-		iterator->value = iterator->node->pValue;
-		return (true);
+		return (false);
 	}
 
-	// If we hit the end of a list, find the next non-empty bucket
-	for (uint32_t i = iterator->_bucketIndex + 1; i < iterator->_map->bucketCount; i++)
+	AeroUnorderedMap map = iterator->_map;
+	for (uint32_t i = (uint32_t)(iterator->_slotIndex + 1); i < map->slotCount; i++)
 	{
-		if (iterator->_map->ppBuckets[i] != NULL)
+		SAeroUnorderedMapSlot* pSlot = &map->pSlots[i];
+		if (pSlot->distance != 0)
 		{
-			iterator->_bucketIndex = i;
-			iterator->node = iterator->_map->ppBuckets[i];
-			iterator->key = iterator->node->szKey;
-			iterator->value = iterator->node->pValue;
+			iterator->_slotIndex = (int32_t)i;
+			iterator->slot = pSlot;
+			iterator->key = (map->keyType == UNORDERED_MAP_KEY_STRING) ? pSlot->szKey : NULL;
+			iterator->intKey = (map->keyType == UNORDERED_MAP_KEY_STRING) ? 0 : pSlot->intKey;
+			iterator->value = pSlot->pValue;
 			return (true);
 		}
 	}
 
 	// No more items found
-	iterator->node = NULL;
+	iterator->_slotIndex = (int32_t)map->slotCount;
+	iterator->slot = NULL;
 	iterator->key = NULL;
+	iterator->intKey = 0;
 	iterator->value = NULL;
 	return (false);
 }
@@ -387,10 +359,304 @@ uint32_t UnorderedMap_Capactiy(AeroUnorderedMap map)
 		return (0);
 	}
 
-	return (map->bucketCount);
+	return (map->slotCount);
 }
 
 bool UnorderedMap_IsEmpty(AeroUnorderedMap map)
 {
 	return (UnorderedMap_Count(map) == 0);
-}
\ No newline at end of file
+}
+
+static bool UnorderedMap_InitializeInternal(AeroUnorderedMap* ppUnorderedMap, EAeroUnorderedMapKeyType keyType, EMemoryTag tag)
+{
+	if (ppUnorderedMap == NULL)
+	{
+		syserr("ppUnorderedMap is NULL (invalid address)");
+		return (false);
+	}
+
+	// Initialize Elements and everything inside struct to NULL / 0
+	*ppUnorderedMap = engine_new_zero(SAeroUnorderedMap, 1, tag);
+
+	AeroUnorderedMap map = *ppUnorderedMap;
+
+	if (map == NULL)
+	{
+		syserr("Failed to Allocate Memory for UnorderedMap with tag %s", MemoryTagNames[tag]);
+		return (false);
+	}
+
+	map->pSlots = engine_new_count_zero(SAeroUnorderedMapSlot, unordered_map_min_capacity, tag);
+
+	if (map->pSlots == NULL)
+	{
+		syserr("Failed to Allocate Slots for UnorderedMap (Tag: %s)", MemoryTagNames[tag]);
+		// Clean up the header so we don't leak it on partial failure
+		engine_delete(map);
+		*ppUnorderedMap = NULL;
+		return (false);
+	}
+
+	// Set Metadata
+	map->slotCount = unordered_map_min_capacity;
+	map->slotMask = unordered_map_min_capacity - 1;
+	map->keyType = keyType;
+	map->tag = tag;
+	map->elementCount = 0;
+
+	return (true);
+}
+
+static bool UnorderedMap_InsertInternal(AeroUnorderedMap map, const SUnorderedMapKeyRef* pKey, void* value)
+{
+	// Search for existing key to update it
+	int64_t index = UnorderedMap_FindSlot(map, pKey);
+	if (index >= 0)
+	{
+		SAeroUnorderedMapSlot* pSlot = &map->pSlots[index];
+		if (map->pfnDestructor)
+		{
+			map->pfnDestructor(&pSlot->pValue); // Free Memory
+		}
+		pSlot->pValue = value;
+		return (true);
+	}
+
+	if ((uint64_t)(map->elementCount + 1) * unordered_map_max_load_den > (uint64_t)map->slotCount * unordered_map_max_load_num)
+	{
+		if (!UnorderedMap_Rehash(map, map->slotCount * 2))
+		{
+			syserr("Failed to grow UnorderedMap to %u slots", map->slotCount * 2);
+			return (false);
+		}
+	}
+
+	SAeroUnorderedMapSlot entry = { 0 };
+	entry.pValue = value;
+	entry.hash = pKey->hash;
+	entry.distance = 1;
+
+	if (map->keyType == UNORDERED_MAP_KEY_STRING)
+	{
+		entry.szKey = UnorderedMap_CopyKey(&map->pKeyChunks, pKey->szKey, pKey->length, map->tag);
+		if (!entry.szKey)
+		{
+			syserr("Failed to Allocate key Memory");
+			return (false);
+		}
+		entry.keyLength = pKey->length;
+		map->liveKeyBytes += pKey->length + 1;
+	}
+	else
+	{
+		entry.intKey = pKey->intKey;
+	}
+
+	UnorderedMap_PlaceSlot(map->pSlots, map->slotMask, entry);
+	map->elementCount++;
+
+	return (true);
+}
+
+static int64_t UnorderedMap_FindSlot(AeroUnorderedMap map, const SUnorderedMapKeyRef* pKey)
+{
+	uint32_t index = pKey->hash & map->slotMask;
+
+	// Robin Hood invariant: once we meet a slot closer to its home than we
+	// are to ours, the key cannot be further down the run
+	for (uint32_t distance = 1;; distance++)
+	{
+		const SAeroUnorderedMapSlot* pSlot = &map->pSlots[index];
+		if (pSlot->distance < distance)
+		{
+			return (-1);
+		}
+
+		// Compare hashes FIRST (fast integer check)
+		// Only compare the bytes (slow string check) if hashes and lengths match!
+		if (pSlot->hash == pKey->hash)
+		{
+			if (map->keyType == UNORDERED_MAP_KEY_STRING)
+			{
+				if (pSlot->keyLength == pKey->length && memcmp(pSlot->szKey, pKey->szKey, pKey->length) == 0)
+				{
+					return (index);
+				}
+			}
+			else if (pSlot->intKey == pKey->intKey)
+			{
+				return (index);
+			}
+		}
+
+		index = (index + 1) & map->slotMask;
+	}
+}
+
+static void UnorderedMap_RemoveSlot(AeroUnorderedMap map, uint32_t index)
+{
+	SAeroUnorderedMapSlot* pSlots = map->pSlots;
+
+	// Cleanup the data
+	if (map->pfnDestructor)
+	{
+		map->pfnDestructor(&pSlots[index].pValue);
+	}
+
+	if (map->keyType == UNORDERED_MAP_KEY_STRING)
+	{
+		size_t keyBytes = (size_t)pSlots[index].keyLength + 1;
+		map->liveKeyBytes -= keyBytes;
+		map->deadKeyBytes += keyBytes;
+	}
+
+	// Backward shift: pull the rest of the run one slot closer to home,
+	// so no tombstones are ever left behind
+	uint32_t next = (index + 1) & map->slotMask;
+	while (pSlots[next].distance > 1)
+	{
+		pSlots[index] = pSlots[next];
+		pSlots[index].distance--;
+
+		index = next;
+		next = (next + 1) & map->slotMask;
+	}
+
+	memset(&pSlots[index], 0, sizeof(SAeroUnorderedMapSlot));
+	map->elementCount--;
+
+	// Compact the key arena once the garbage outweighs both the live keys
+	// and the table, so the rehash cost stays amortized over the removes
+	if (map->deadKeyBytes > map->liveKeyBytes && map->deadKeyBytes >= unordered_map_key_chunk_size &&
+		map->deadKeyBytes > (size_t)map->slotCount * sizeof(SAeroUnorderedMapSlot))
+	{
+		UnorderedMap_Rehash(map, map->slotCount);
+	}
+}
+
+static bool UnorderedMap_Rehash(AeroUnorderedMap map, uint32_t newSlotCount)
+{
+	SAeroUnorderedMapSlot* pNewSlots = engine_new_count_zero(SAeroUnorderedMapSlot, newSlotCount, map->tag);
+	if (!pNewSlots)
+	{
+		return (false); // Fail gracefully, the old table is untouched
+	}
+
+	uint32_t newMask = newSlotCount - 1;
+	SAeroUnorderedMapKeyChunk* pNewChunks = NULL;
+
+	for (uint32_t i = 0; i < map->slotCount; i++)
+	{
+		SAeroUnorderedMapSlot entry = map->pSlots[i];
+		if (entry.distance == 0)
+		{
+			continue;
+		}
+
+		// String keys move into a fresh arena, which drops removed keys
+		if (map->keyType == UNORDERED_MAP_KEY_STRING)
+		{
+			entry.szKey = UnorderedMap_CopyKey(&pNewChunks, entry.szKey, entry.keyLength, map->tag);
+			if (!entry.szKey)
+			{
+				UnorderedMap_FreeKeyChunks(pNewChunks);
+				engine_delete(pNewSlots);
+				return (false);
+			}
+		}
+
+		entry.distance = 1;
+		UnorderedMap_PlaceSlot(pNewSlots, newMask, entry);
+	}
+
+	// Swap the arrays and update metadata
+	engine_delete(map->pSlots);
+	map->pSlots = pNewSlots;
+	map->slotCount = newSlotCount;
+	map->slotMask = newMask;
+
+	if (map->keyType == UNORDERED_MAP_KEY_STRING)
+	{
+		UnorderedMap_FreeKeyChunks(map->pKeyChunks);
+		map->pKeyChunks = pNewChunks;
+		map->deadKeyBytes = 0;
+	}
+
+	return (true);
+}
+
+static void UnorderedMap_PlaceSlot(SAeroUnorderedMapSlot* pSlots, uint32_t slotMask, SAeroUnorderedMapSlot entry)
+{
+	uint32_t index = entry.hash & slotMask;
+
+	for (;;)
+	{
+		SAeroUnorderedMapSlot* pSlot = &pSlots[index];
+		if (pSlot->distance == 0)
+		{
+			*pSlot = entry;
+			return;
+		}
+
+		// Take from the rich: whoever is closer to home gives up the slot
+		if (pSlot->distance < entry.distance)
+		{
+			SAeroUnorderedMapSlot displaced = *pSlot;
+			*pSlot = entry;
+			entry = displaced;
+		}
+
+		entry.distance++;
+		index = (index + 1) & slotMask;
+	}
+}
+
+static char* UnorderedMap_CopyKey(SAeroUnorderedMapKeyChunk** ppChunks, const char* key, uint32_t length, EMemoryTag tag)
+{
+	uint32_t size = length + 1;
+	SAeroUnorderedMapKeyChunk* pChunk = *ppChunks;
+
+	if (!pChunk || pChunk->capacity - pChunk->used < size)
+	{
+		// Oversized keys get a chunk of their own
+		uint32_t capacity = (size > unordered_map_key_chunk_size) ? size : unordered_map_key_chunk_size;
+
+		pChunk = (SAeroUnorderedMapKeyChunk*)engine_malloc(sizeof(SAeroUnorderedMapKeyChunk) + capacity, tag);
+		if (!pChunk)
+		{
+			return (NULL);
+		}
+
+		pChunk->used = 0;
+		pChunk->capacity = capacity;
+		pChunk->next = *ppChunks;
+		*ppChunks = pChunk;
+	}
+
+	char* szKey = pChunk->data + pChunk->used;
+	memcpy(szKey, key, size);
+	pChunk->used += size;
+
+	return (szKey);
+}
+
+static void UnorderedMap_FreeKeyChunks(SAeroUnorderedMapKeyChunk* pChunk)
+{
+	while (pChunk)
+	{
+		SAeroUnorderedMapKeyChunk* pNext = pChunk->next;
+		engine_delete(pChunk);
+		pChunk = pNext;
+	}
+}
+
+static uint32_t UnorderedMap_SlotsForCount(uint32_t elementCount)
+{
+	uint32_t slotCount = unordered_map_min_capacity;
+	while ((uint64_t)slotCount * unordered_map_max_load_num < (uint64_t)elementCount * unordered_map_max_load_den && slotCount < (1u << 31))
+	{
+		slotCount <<= 1;
+	}
+
+	return (slotCount);
+}
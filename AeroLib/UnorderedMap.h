@@ -16,7 +16,7 @@ static const uint32_t FNV_OFFSET_BASIS_32 = 0x811c9dc5; // 2166136261u
 // during the multiplication step.
 static const uint32_t FNV_PRIME_32 = 0x01000193; // 16777619u
 
-static uint32_t fnv1a_32(const char* buf, size_t buf_size)
+static inline uint32_t fnv1a_32(const char* buf, size_t buf_size)
 {
 	// Initialize our hash with the starting offset
 	uint32_t hash = FNV_OFFSET_BASIS_32;
@@ -39,7 +39,7 @@ static uint32_t fnv1a_32(const char* buf, size_t buf_size)
 	return (hash);
 }
 
-static uint32_t fnv1a_str(const char* str)
+static inline uint32_t fnv1a_str(const char* str)
 {
 	uint32_t hash = FNV_OFFSET_BASIS_32;
 	while (*str)
@@ -60,53 +60,117 @@ static uint32_t fnv1a_str(const char* str)
 	return (hash);
 }
 
+// Integer / pointer keys go through a 64-bit finalizer (murmur3 fmix64)
+// so sequential ids and aligned addresses still spread over every slot.
+static inline uint32_t hash_u64(uint64_t key)
+{
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	key *= 0xc4ceb9fe1a85ec53ULL;
+	key ^= key >> 33;
+
+	return ((uint32_t)key);
+}
+
 typedef void (*AeroUnorderedMapDestructor)(void* pValue);
 
-typedef struct SAeroUnorderedMapNode
+typedef enum EAeroUnorderedMapKeyType
 {
-	char* szKey;
+	UNORDERED_MAP_KEY_STRING,	// Keys are copied into the map's key arena
+	UNORDERED_MAP_KEY_INT,		// uint64_t keys, stored inline
+	UNORDERED_MAP_KEY_POINTER,	// Pointer identity, stored inline (never dereferenced)
+} EAeroUnorderedMapKeyType;
+
+// One slot of the open-addressing table (Robin Hood, linear probing)
+typedef struct SAeroUnorderedMapSlot
+{
+	union
+	{
+		char* szKey;
+		uint64_t intKey;
+	};
 	void* pValue;
-	uint32_t hash;							// Cache the hash for fast resizing/comparisons
-	struct SAeroUnorderedMapNode* next;		// pointer to the next node element
-} SAeroUnorderedMapNode;
+	uint32_t hash;							// Full hash, compared before the key
+	uint32_t distance;						// Probe distance + 1, 0 = empty slot
+	uint32_t keyLength;						// String keys, without the terminator, compared before the bytes
+} SAeroUnorderedMapSlot;
 
-typedef SAeroUnorderedMapNode* AeroUnorderedMapNode;
+typedef SAeroUnorderedMapSlot* AeroUnorderedMapSlot;
+
+// String keys are bump allocated from chunks owned by the map, so an
+// insert costs no allocation besides the occasional chunk or rehash.
+typedef struct SAeroUnorderedMapKeyChunk
+{
+	struct SAeroUnorderedMapKeyChunk* next;
+	uint32_t used;
+	uint32_t capacity;
+	char data[];
+} SAeroUnorderedMapKeyChunk;
 
 typedef struct SAeroUnorderedMap
 {
-	SAeroUnorderedMapNode** ppBuckets;			// Double pointer for the array of linked lists
-	uint32_t bucketCount;
+	SAeroUnorderedMapSlot* pSlots;				// Power of two array, probed linearly
+	uint32_t slotCount;
+	uint32_t slotMask;							// slotCount - 1
 	uint32_t elementCount;
+	EAeroUnorderedMapKeyType keyType;
 	EMemoryTag tag;								// The "Blame" tag, to locate the leaks
 	AeroUnorderedMapDestructor pfnDestructor;	// function to clean up pValue
+
+	SAeroUnorderedMapKeyChunk* pKeyChunks;		// Head is the chunk being filled
+	size_t liveKeyBytes;
+	size_t deadKeyBytes;						// Removed keys, reclaimed on the next rehash
 } SAeroUnorderedMap;
 
 typedef SAeroUnorderedMap* AeroUnorderedMap;
 
 typedef struct SAeroUnorderedMapIterator {
 	AeroUnorderedMap _map;      // The map we are walking through
-	int32_t _bucketIndex;        // Which bucket are we currently in?
-	AeroUnorderedMapNode node;  // The current node we are looking at
+	int32_t _slotIndex;         // Which slot are we currently in?
+	AeroUnorderedMapSlot slot;  // The current slot we are looking at
 
 	// Publicly accessible data
-	char* key;
+	char* key;                  // String maps only
+	uint64_t intKey;            // Integer and pointer maps only
 	void* value;
 } SAeroUnorderedMapIterator;
 
 typedef SAeroUnorderedMapIterator* AeroUnorderedMapIterator;
 
-static const int32_t unordered_map_init_val = 11; // Prime number
+static const uint32_t unordered_map_min_capacity = 16; // Power of two
+static const uint32_t unordered_map_max_load_num = 7; // Grow past 7/8 full
+static const uint32_t unordered_map_max_load_den = 8;
+static const uint32_t unordered_map_key_chunk_size = 4096; // Bytes per key arena chunk
 
 bool UnorderedMap_Initialize(AeroUnorderedMap* ppUnorderedMap, EMemoryTag tag);
+bool UnorderedMap_InitializeWithKeys(AeroUnorderedMap* ppUnorderedMap, EAeroUnorderedMapKeyType keyType, EMemoryTag tag);
 void UnoderedMap_Destroy(AeroUnorderedMap* ppUnorderedMap);
 
 void UnorderedMap_Clear(AeroUnorderedMap map);
-bool UnorderedMap_Insert(AeroUnorderedMap map, const char* key, void* value);
 
+// String keys
+bool UnorderedMap_Insert(AeroUnorderedMap map, const char* key, void* value);
 void* UnorderedMap_Find(AeroUnorderedMap map, const char* key);
 void UnorderedMap_Remove(AeroUnorderedMap map, const char* key);
+
+// Integer keys
+bool UnorderedMap_InsertInt(AeroUnorderedMap map, uint64_t key, void* value);
+void* UnorderedMap_FindInt(AeroUnorderedMap map, uint64_t key);
+void UnorderedMap_RemoveInt(AeroUnorderedMap map, uint64_t key);
+
+// Pointer keys
+bool UnorderedMap_InsertPtr(AeroUnorderedMap map, const void* key, void* value);
+void* UnorderedMap_FindPtr(AeroUnorderedMap map, const void* key);
+void UnorderedMap_RemovePtr(AeroUnorderedMap map, const void* key);
+
+/**
+ * @brief Grows the table so elementCount elements fit without a rehash.
+ */
+void UnorderedMap_Reserve(AeroUnorderedMap map, uint32_t elementCount);
 void UnorderedMap_Resize(AeroUnorderedMap map, uint32_t newSize);
 
+// Removing while iterating invalidates the iterator (slots shift back)
 SAeroUnorderedMapIterator UnorderedMap_Begin(AeroUnorderedMap map);
 SAeroUnorderedMapIterator UnorderedMap_End(AeroUnorderedMap map);
 bool UnorderedMap_IterCompare(SAeroUnorderedMapIterator a, SAeroUnorderedMapIterator b);
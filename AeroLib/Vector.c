@@ -233,6 +233,37 @@ void Vector_PushBack(Vector pVector, const void* element)
 	pVector->count++;
 }
 
+void Vector_AppendRange(Vector pVector, const void* pElements, size_t count)
+{
+	if (!pVector || !pElements || count == 0)
+	{
+		return;
+	}
+
+	if (pVector->count + count > pVector->capacity)
+	{
+		// Same doubling as Vector_PushBack, but jump straight to what fits
+		size_t newCapacity = (pVector->capacity == 0) ? 4 : pVector->capacity * 2;
+		if (newCapacity < pVector->count + count)
+		{
+			newCapacity = pVector->count + count;
+		}
+
+		Vector_Reserve(pVector, newCapacity);
+		if (pVector->capacity < pVector->count + count)
+		{
+			return; // Vector_Reserve already reported it
+		}
+	}
+
+	// Smart vectors store pointers, so pElements is an array of pointers
+	// and the element bytes are copied the same way in both modes
+	unsigned char* pDest = (unsigned char*)pVector->pData + (pVector->count * pVector->elemSize);
+	memcpy(pDest, pElements, count * pVector->elemSize);
+
+	pVector->count += count;
+}
+
 void Vector_PopBack(Vector pVector)
 {
 	// Safety check: index must be within the active count
@@ -32,6 +32,7 @@ void Vector_Resize(Vector pVector, size_t newCount);
 void Vector_Clear(Vector pVector);
 
 void Vector_PushBack(Vector pVector, const void* element);
+void Vector_AppendRange(Vector pVector, const void* pElements, size_t count); // count contiguous elements, one grow + one memcpy
 void Vector_PopBack(Vector pVector);
 void Vector_RemoveAt(Vector pVector, size_t index);
 void Vector_Swap(Vector pVector, size_t indexA, size_t indexB);
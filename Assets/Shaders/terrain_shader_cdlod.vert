@@ -0,0 +1,134 @@
+
+// CDLOD (TerrainRenderer_SetCDLOD): one (PATCH_SIZE + 1)^2 grid drawn once per quadtree node.
+// The node places and scales the grid, the heights come from the heightmap SSBO of whichever
+// terrain the vertex falls in, and vertices morph into the next level before the node is swapped.
+
+struct TerrainData
+{
+    uint heightOffset;      // First float of the terrain in the heightmap SSBO
+    uint padding;
+    ivec2 terrainCoords;
+};
+
+struct CDLODNode
+{
+    vec2 origin;            // World x, z of grid vertex (0, 0)
+    float vertexSpacing;
+    float level;            // Level the vertices morph by, half nodes use their parent's
+};
+
+layout (std430, binding = 0) readonly buffer TerrainBuffer
+{
+    TerrainData terrains[];
+};
+
+layout (std430, binding = 2) readonly buffer HeightMapBuffer
+{
+    float heights[];
+};
+
+layout (std430, binding = 7) readonly buffer CDLODNodeBuffer
+{
+    CDLODNode nodes[];
+};
+
+layout (std430, binding = 8) readonly buffer CDLODSlotBuffer
+{
+    int terrainSlots[];     // GPU slot of every map terrain, -1 when not resident
+};
+
+uniform float ENGINE_CELL_SIZE;
+uniform vec2 TERRAIN_SIZE;
+uniform int TERRAIN_HEIGHTMAP_RAW_XSIZE;
+uniform int PATCH_SIZE;
+
+uniform int u_cdlodFirstNode;       // Full and half nodes are drawn as two instance ranges
+uniform vec2 u_cdlodMapSize;        // Terrains along x and z
+uniform int u_cdlodTopLevel;
+uniform float u_cdlodLeafRange;
+uniform float u_cdlodMorphStart;
+uniform vec3 u_cdlodCamera;
+
+// Camera UBO (works on OpenGL 3.1+)
+layout (std140, binding = 0) uniform CameraData
+{
+    mat4 View;
+    mat4 Projection;
+    mat4 ViewProjection;
+    mat4 Billboard;
+} camera;
+
+out vec3 v3Position;
+out vec3 v3Normals;
+out vec2 v2TexCoord;
+out vec4 v4Color;
+
+// Map grid sample, a point on a shared edge reads the terrain before it (the border samples match)
+float GetMapHeight(ivec2 grid)
+{
+    ivec2 terrainCells = ivec2(TERRAIN_SIZE / ENGINE_CELL_SIZE);
+    ivec2 mapSize = ivec2(u_cdlodMapSize);
+    ivec2 terrain = clamp((grid - 1) / terrainCells, ivec2(0), mapSize - 1);
+    ivec2 local = clamp(grid - terrain * terrainCells, ivec2(-1), terrainCells + 1);
+
+    int slot = terrainSlots[terrain.y * mapSize.x + terrain.x];
+    if (slot < 0)
+    {
+        return (0.0);
+    }
+
+    // The heightmap keeps a one sample border, vertex (x, z) sits at (x + 1, z + 1)
+    return (heights[terrains[slot].heightOffset + uint((local.y + 1) * TERRAIN_HEIGHTMAP_RAW_XSIZE + local.x + 1)]);
+}
+
+// Morphing vertices sit between samples
+float SampleHeight(vec2 grid)
+{
+    ivec2 base = ivec2(floor(grid));
+    vec2 f = grid - vec2(base);
+
+    float h00 = GetMapHeight(base);
+    float h10 = GetMapHeight(base + ivec2(1, 0));
+    float h01 = GetMapHeight(base + ivec2(0, 1));
+    float h11 = GetMapHeight(base + ivec2(1, 1));
+    return (mix(mix(h00, h10, f.x), mix(h01, h11, f.x), f.y));
+}
+
+void main()
+{
+    CDLODNode node = nodes[u_cdlodFirstNode + gl_InstanceID];
+
+    ivec2 local = ivec2(gl_VertexID % (PATCH_SIZE + 1), gl_VertexID / (PATCH_SIZE + 1));
+    vec2 worldXZ = node.origin + vec2(local) * node.vertexSpacing;
+
+    // The level's range band is [range / 2, range], morphing takes its far end
+    float range = u_cdlodLeafRange * exp2(node.level);
+    float morphEnd = range;
+    float morphStart = mix((node.level > 0.0) ? range * 0.5 : 0.0, range, u_cdlodMorphStart);
+
+    float height = SampleHeight(worldXZ / ENGINE_CELL_SIZE);
+    float distance = length(vec3(worldXZ.x, height, worldXZ.y) - u_cdlodCamera);
+    float morph = (int(node.level) < u_cdlodTopLevel) ? clamp((distance - morphStart) / (morphEnd - morphStart), 0.0, 1.0) : 0.0;
+
+    // Odd vertices of the level's grid slide onto the even ones, fully morphed they match the next level
+    float levelCell = ENGINE_CELL_SIZE * exp2(node.level);
+    vec2 odd = mod(worldXZ / levelCell, 2.0);
+    worldXZ -= odd * morph * levelCell;
+
+    vec2 grid = worldXZ / ENGINE_CELL_SIZE;
+    height = SampleHeight(grid);
+    v3Position = vec3(worldXZ.x, height, worldXZ.y);
+    gl_Position = camera.ViewProjection * vec4(v3Position, 1.0);
+
+    float hL = SampleHeight(grid - vec2(1.0, 0.0));
+    float hR = SampleHeight(grid + vec2(1.0, 0.0));
+    float hD = SampleHeight(grid - vec2(0.0, 1.0));
+    float hU = SampleHeight(grid + vec2(0.0, 1.0));
+    v3Normals = normalize(vec3(hL - hR, 2.0 * ENGINE_CELL_SIZE, hD - hU));
+
+    v2TexCoord = grid / float(PATCH_SIZE);
+
+    // Tinted by level, like the patch colors of the other terrain shaders
+    float level = node.level;
+    v4Color = vec4(mod(level, 3.0) / 3.0, mod(level, 5.0) / 5.0, 0.5 + 0.5 * sin(level * 0.9), 1.0);
+}
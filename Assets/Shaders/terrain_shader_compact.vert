@@ -0,0 +1,99 @@
+
+#extension GL_ARB_shader_draw_parameters : enable
+
+// Compact terrain vertex (TERRAIN_COMPACT_VERTEX), 8 bytes:
+// grid position inside the terrain and an octahedral normal, the height comes from the heightmap SSBO
+layout (location = 0) in uvec2 m_u2Grid;
+layout (location = 1) in vec2 m_v2OctNormal;
+
+struct TerrainData
+{
+    uint heightOffset;      // First float of the terrain in the heightmap SSBO
+    uint padding;
+    ivec2 terrainCoords;
+};
+
+struct PatchData
+{
+    int terrainIndex;
+    int localPatchID;
+};
+
+layout (std430, binding = 0) readonly buffer TerrainBuffer
+{
+    TerrainData terrains[];
+};
+
+layout (std430, binding = 1) readonly buffer PatchBuffer
+{
+    PatchData patches[];
+};
+
+layout (std430, binding = 2) readonly buffer HeightMapBuffer
+{
+    float heights[];
+};
+
+uniform float ENGINE_CELL_SIZE;
+uniform vec2 TERRAIN_SIZE;
+uniform int TERRAIN_HEIGHTMAP_RAW_XSIZE;
+uniform int PATCH_SIZE;
+uniform int u_vertex_DrawID;
+
+// Camera UBO (works on OpenGL 3.1+)
+layout (std140, binding = 0) uniform CameraData
+{
+    mat4 View;
+    mat4 Projection;
+    mat4 ViewProjection;
+    mat4 Billboard;
+} camera;
+
+out vec3 v3Position;
+out vec3 v3Normals;
+out vec2 v2TexCoord;
+out vec4 v4Color;
+
+out flat int vertex_DrawID;
+
+vec3 DecodeOctNormal(vec2 e)
+{
+    vec3 n = vec3(e.x, 1.0 - abs(e.x) - abs(e.y), e.y);
+    if (n.y < 0.0)
+    {
+        n.xz = (1.0 - abs(n.zx)) * vec2((n.x >= 0.0) ? 1.0 : -1.0, (n.z >= 0.0) ? 1.0 : -1.0);
+    }
+    return (normalize(n));
+}
+
+void main()
+{
+    // The legacy path draws one patch at a time and sets u_vertex_DrawID, indirect draws leave it at -1
+#ifdef GL_ARB_shader_draw_parameters
+    int index = (u_vertex_DrawID >= 0) ? u_vertex_DrawID : gl_BaseInstanceARB;
+#else
+    int index = u_vertex_DrawID;
+#endif
+
+    PatchData patchData = patches[index];
+    TerrainData terrain = terrains[patchData.terrainIndex];
+
+    // The heightmap keeps a one sample border, vertex (x, z) sits at (x + 1, z + 1)
+    ivec2 grid = ivec2(m_u2Grid);
+    float height = heights[terrain.heightOffset + uint((grid.y + 1) * TERRAIN_HEIGHTMAP_RAW_XSIZE + grid.x + 1)];
+
+    vec2 worldXZ = vec2(terrain.terrainCoords) * TERRAIN_SIZE + vec2(grid) * ENGINE_CELL_SIZE;
+    v3Position = vec3(worldXZ.x, height, worldXZ.y);
+    gl_Position = camera.ViewProjection * vec4(v3Position, 1.0);
+
+    // Same UVs and debug color the full vertex layout stores
+    int patchCount = int(TERRAIN_SIZE.x / ENGINE_CELL_SIZE) / PATCH_SIZE;
+    ivec2 patchStart = ivec2(patchData.localPatchID % patchCount, patchData.localPatchID / patchCount) * PATCH_SIZE;
+    float patchID = float(patchData.localPatchID);
+
+    v3Normals = DecodeOctNormal(m_v2OctNormal);
+    v2TexCoord = vec2(grid - patchStart) / float(PATCH_SIZE);
+    v4Color = vec4(mod(patchID, 8.0) / 8.0, mod(floor(patchID / 8.0), 8.0) / 8.0, 0.5 + 0.5 * sin(patchID * 0.3), 1.0);
+
+    vertex_DrawID = index;
+}
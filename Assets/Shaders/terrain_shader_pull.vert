@@ -0,0 +1,98 @@
+
+#extension GL_ARB_shader_draw_parameters : enable
+
+// Vertex pulling (TERRAIN_VERTEX_PULLING): there is no vertex buffer.
+// The shared patch indices run over the (PATCH_SIZE + 1)^2 grid and are drawn with baseVertex 0,
+// so gl_VertexID is the vertex inside the patch, everything else comes from the SSBOs.
+
+struct TerrainData
+{
+    uint heightOffset;      // First float of the terrain in the heightmap SSBO
+    uint padding;
+    ivec2 terrainCoords;
+};
+
+struct PatchData
+{
+    int terrainIndex;
+    int localPatchID;
+};
+
+layout (std430, binding = 0) readonly buffer TerrainBuffer
+{
+    TerrainData terrains[];
+};
+
+layout (std430, binding = 1) readonly buffer PatchBuffer
+{
+    PatchData patches[];
+};
+
+layout (std430, binding = 2) readonly buffer HeightMapBuffer
+{
+    float heights[];
+};
+
+uniform float ENGINE_CELL_SIZE;
+uniform vec2 TERRAIN_SIZE;
+uniform int TERRAIN_HEIGHTMAP_RAW_XSIZE;
+uniform int PATCH_SIZE;
+uniform int u_vertex_DrawID;
+
+// Camera UBO (works on OpenGL 3.1+)
+layout (std140, binding = 0) uniform CameraData
+{
+    mat4 View;
+    mat4 Projection;
+    mat4 ViewProjection;
+    mat4 Billboard;
+} camera;
+
+out vec3 v3Position;
+out vec3 v3Normals;
+out vec2 v2TexCoord;
+out vec4 v4Color;
+
+out flat int vertex_DrawID;
+
+// The heightmap keeps a one sample border, vertex (x, z) sits at (x + 1, z + 1)
+float GetHeight(uint heightOffset, ivec2 grid)
+{
+    return (heights[heightOffset + uint((grid.y + 1) * TERRAIN_HEIGHTMAP_RAW_XSIZE + grid.x + 1)]);
+}
+
+void main()
+{
+    // The legacy path draws one patch at a time and sets u_vertex_DrawID, indirect draws leave it at -1
+#ifdef GL_ARB_shader_draw_parameters
+    int index = (u_vertex_DrawID >= 0) ? u_vertex_DrawID : gl_BaseInstanceARB;
+#else
+    int index = u_vertex_DrawID;
+#endif
+
+    PatchData patchData = patches[index];
+    TerrainData terrain = terrains[patchData.terrainIndex];
+
+    int patchCount = int(TERRAIN_SIZE.x / ENGINE_CELL_SIZE) / PATCH_SIZE;
+    ivec2 patchStart = ivec2(patchData.localPatchID % patchCount, patchData.localPatchID / patchCount) * PATCH_SIZE;
+    ivec2 local = ivec2(gl_VertexID % (PATCH_SIZE + 1), gl_VertexID / (PATCH_SIZE + 1));
+    ivec2 grid = patchStart + local;
+
+    float height = GetHeight(terrain.heightOffset, grid);
+    vec2 worldXZ = vec2(terrain.terrainCoords) * TERRAIN_SIZE + vec2(grid) * ENGINE_CELL_SIZE;
+    v3Position = vec3(worldXZ.x, height, worldXZ.y);
+    gl_Position = camera.ViewProjection * vec4(v3Position, 1.0);
+
+    // Central differences, the border samples keep the neighbours in range at the terrain edges
+    float hL = GetHeight(terrain.heightOffset, grid - ivec2(1, 0));
+    float hR = GetHeight(terrain.heightOffset, grid + ivec2(1, 0));
+    float hD = GetHeight(terrain.heightOffset, grid - ivec2(0, 1));
+    float hU = GetHeight(terrain.heightOffset, grid + ivec2(0, 1));
+    v3Normals = normalize(vec3(hL - hR, 2.0 * ENGINE_CELL_SIZE, hD - hU));
+
+    float patchID = float(patchData.localPatchID);
+    v2TexCoord = vec2(local) / float(PATCH_SIZE);
+    v4Color = vec4(mod(patchID, 8.0) / 8.0, mod(floor(patchID / 8.0), 8.0) / 8.0, 0.5 + 0.5 * sin(patchID * 0.3), 1.0);
+
+    vertex_DrawID = index;
+}
@@ -21,7 +21,8 @@ bool IndirectBufferObject_Initialize(IndirectBufferObject* ppIndirectBuffer, GLs
 		return (false);
 	}
 
-	if (!Vector_InitCapacity(&pIndirectBuf->commands, sizeof(SIndirectDrawCommand), initialCapacity, false))
+	AeroVector_SIndirectDrawCommand_Init(&pIndirectBuf->commands, MEM_TAG_GPU_BUFFER);
+	if (!AeroVector_SIndirectDrawCommand_Reserve(&pIndirectBuf->commands, (size_t)initialCapacity))
 	{
 		syserr("Failed to create command vector");
 		IndirectBufferObject_Destroy(&pIndirectBuf);
@@ -65,22 +66,24 @@ void IndirectBufferObject_AddCommand(IndirectBufferObject pIndirectBuf, GLuint c
 		return;
 	}
 
-	// Build command
-	SIndirectDrawCommand cmd;
-	cmd.count = count;
-	cmd.instanceCount = instanceCount;
-	cmd.firstIndex = firstIndex;
-	cmd.baseVertex = baseVertex;
-	cmd.baseInstance = baseInstance;
-
 	// Store old capacity
-	size_t oldCapacity = pIndirectBuf->commands->capacity;
+	size_t oldCapacity = pIndirectBuf->commands.capacity;
+
+	// Build command in place (auto-grows if needed)
+	IndirectDrawCommand cmd = AeroVector_SIndirectDrawCommand_EmplaceBack(&pIndirectBuf->commands);
+	if (!cmd)
+	{
+		return;
+	}
 
-	// Push to vector (auto-grows if needed)
-	Vector_PushBackValue(pIndirectBuf->commands, cmd);
+	cmd->count = count;
+	cmd->instanceCount = instanceCount;
+	cmd->firstIndex = firstIndex;
+	cmd->baseVertex = baseVertex;
+	cmd->baseInstance = baseInstance;
 
 	// Check if vector grew
-	size_t newCapacity = pIndirectBuf->commands->capacity;
+	size_t newCapacity = pIndirectBuf->commands.capacity;
 	if (newCapacity > oldCapacity)
 	{
 		GLsizeiptr bufferSize = newCapacity * sizeof(SIndirectDrawCommand);
@@ -102,7 +105,7 @@ void IndirectBufferObject_Upload(IndirectBufferObject pIndirectBuf)
 		return;
 	}
 
-	size_t count = pIndirectBuf->commands->count;
+	size_t count = pIndirectBuf->commands.count;
 	if (count == 0)
 	{
 		return; // no commands to upload
@@ -113,18 +116,16 @@ void IndirectBufferObject_Upload(IndirectBufferObject pIndirectBuf)
 
 	if (IsGLVersionHigher(4, 5))
 	{
-		glNamedBufferSubData(pIndirectBuf->bufferID, 0, usedSize, pIndirectBuf->commands->pData);
+		glNamedBufferSubData(pIndirectBuf->bufferID, 0, usedSize, pIndirectBuf->commands.pData);
 	}
 	else
 	{
 		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, pIndirectBuf->bufferID);
-		glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, usedSize, pIndirectBuf->commands->pData); // Offset 0
+		glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, usedSize, pIndirectBuf->commands.pData); // Offset 0
 		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
 	}
 
 	pIndirectBuf->bDirty = false;
-
-	syslog("Uploaded %zu commands (%lld bytes) to GPU", count, (long long)usedSize);
 }
 
 /**
@@ -139,7 +140,7 @@ void IndirectBufferObject_Draw(IndirectBufferObject pIndirectBuf, GLenum primiti
 		return;
 	}
 
-	size_t count = pIndirectBuf->commands->count;
+	size_t count = pIndirectBuf->commands.count;
 	if (count == 0)
 	{
 		return;  // Nothing to draw
@@ -166,18 +167,79 @@ void IndirectBufferObject_Draw(IndirectBufferObject pIndirectBuf, GLenum primiti
 
 }
 
+/**
+ * @brief Draws commands straight from the GPU buffer, the count is the GLuint at drawCountOffset in the parameter buffer.
+ *
+ * For buffers written on the GPU, the CPU command list is not used. Needs IndirectBufferObject_HasDrawCount.
+ */
+void IndirectBufferObject_DrawCount(IndirectBufferObject pIndirectBuf, GLenum primitiveType, GLuint parameterBufferID, GLintptr drawCountOffset, GLsizei maxDrawCount)
+{
+	if (!pIndirectBuf || maxDrawCount <= 0)
+	{
+		return;
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, pIndirectBuf->bufferID);
+	glBindBuffer(GL_PARAMETER_BUFFER, parameterBufferID);
+
+	// Core in 4.6, the ARB entry point has the same signature
+	if (glad_glMultiDrawElementsIndirectCount)
+	{
+		glMultiDrawElementsIndirectCount(primitiveType, GL_UNSIGNED_INT, (void*)0, drawCountOffset, maxDrawCount, 0);
+	}
+	else
+	{
+		glMultiDrawElementsIndirectCountARB(primitiveType, GL_UNSIGNED_INT, (void*)0, drawCountOffset, maxDrawCount, 0);
+	}
+
+	glBindBuffer(GL_PARAMETER_BUFFER, 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+bool IndirectBufferObject_HasDrawCount()
+{
+	return (glad_glMultiDrawElementsIndirectCount != NULL || glad_glMultiDrawElementsIndirectCountARB != NULL);
+}
+
 /**
  * @brief Modifies a command at specific index.
  */
 void IndirectBufferObject_SetCommand(IndirectBufferObject pIndirectBuf, size_t index, const IndirectDrawCommand cmd)
 {
-	if (!pIndirectBuf || !cmd || index >= pIndirectBuf->commands->count)
+	if (!pIndirectBuf || !cmd || index >= pIndirectBuf->commands.count)
 	{
 		return;
 	}
 
-	IndirectDrawCommand commands = (IndirectDrawCommand)pIndirectBuf->commands->pData;
-	commands[index] = *cmd;
+	pIndirectBuf->commands.pData[index] = *cmd;
+
+	pIndirectBuf->bDirty = true;
+}
+
+/**
+ * @brief Replaces the whole command list (per-frame lists such as culled draws).
+ */
+void IndirectBufferObject_SetCommands(IndirectBufferObject pIndirectBuf, const SIndirectDrawCommand* pCommands, size_t count)
+{
+	if (!pIndirectBuf || (!pCommands && count > 0))
+	{
+		return;
+	}
+
+	size_t oldCapacity = pIndirectBuf->commands.capacity;
+
+	AeroVector_SIndirectDrawCommand_Clear(&pIndirectBuf->commands);
+	if (count > 0 && !AeroVector_SIndirectDrawCommand_AppendRange(&pIndirectBuf->commands, pCommands, count))
+	{
+		syserr("Failed to set %zu indirect commands", count);
+		return;
+	}
+
+	size_t newCapacity = pIndirectBuf->commands.capacity;
+	if (newCapacity > oldCapacity)
+	{
+		IndirectBufferObject_GenerateGL(pIndirectBuf, (GLsizeiptr)(newCapacity * sizeof(SIndirectDrawCommand)));
+	}
 
 	pIndirectBuf->bDirty = true;
 }
@@ -192,7 +254,7 @@ void IndirectBufferObject_Clear(IndirectBufferObject pIndirectBuf)
 		return;
 	}
 
-	Vector_Clear(pIndirectBuf->commands);  // Using Vector API
+	AeroVector_SIndirectDrawCommand_Clear(&pIndirectBuf->commands);
 	pIndirectBuf->bDirty = false;
 
 	// GPU buffer still allocated - just reset count
@@ -224,7 +286,7 @@ void IndirectBufferObject_Destroy(IndirectBufferObject* ppIndirectBuffer)
 
 	GL_DeleteBuffer(&pBuf->bufferID); // Clear GPU Resources
 
-	Vector_Destroy(&pBuf->commands); // Clear CPU Resources
+	AeroVector_SIndirectDrawCommand_Destroy(&pBuf->commands); // Clear CPU Resources
 
 	engine_delete(pBuf);
 
@@ -4,7 +4,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <glad/glad.h>
-#include "AeroLib/Vector.h"
+#include "AeroLib/TypedVector.h"
 
 #define MAX_INSTANCE_DATA_COUNT 8192
 #define MAX_INDIRECT_DRAW_COMMAND_COUNT 4096
@@ -20,11 +20,13 @@ typedef struct SIndirectDrawCommand
 
 typedef struct SIndirectDrawCommand* IndirectDrawCommand;
 
+AERO_VECTOR_DEFINE(SIndirectDrawCommand)
+
 typedef struct SIndirectBufferObject
 {
 	// GPU buffer handle
 	GLuint bufferID;         // GPU buffer handle
-	Vector commands;         // Dynamic array of commands
+	SAeroVector_SIndirectDrawCommand commands; // Dynamic array of commands
 	bool bDirty;             // Upload/Update flag
 } SIndirectBufferObject;
 
@@ -37,11 +39,14 @@ void IndirectBufferObject_GenerateGL(IndirectBufferObject pIndirectBuf, GLsizeip
 void IndirectBufferObject_AddCommand(IndirectBufferObject pIndirectBuf, GLuint count, GLuint instanceCount, GLuint firstIndex, GLuint baseVertex, GLuint baseInstance);
 void IndirectBufferObject_Upload(IndirectBufferObject pIndirectBuf);
 void IndirectBufferObject_Draw(IndirectBufferObject pIndirectBuf, GLenum primitiveType);
+void IndirectBufferObject_DrawCount(IndirectBufferObject pIndirectBuf, GLenum primitiveType, GLuint parameterBufferID, GLintptr drawCountOffset, GLsizei maxDrawCount);
+bool IndirectBufferObject_HasDrawCount();
 void IndirectBufferObject_Clear(IndirectBufferObject pIndirectBuf);
 void IndirectBufferObject_Bind(IndirectBufferObject pIndirectBuf);
 void IndirectBufferObject_UnBind();
 
 void IndirectBufferObject_SetCommand(IndirectBufferObject pIndirectBuf, size_t index, const IndirectDrawCommand cmd);
+void IndirectBufferObject_SetCommands(IndirectBufferObject pIndirectBuf, const SIndirectDrawCommand* pCommands, size_t count);
 
 void IndirectBufferObject_Destroy(IndirectBufferObject* ppIndirectBuffer);
 
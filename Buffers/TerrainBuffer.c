@@ -81,18 +81,24 @@ void TerrainBuffer_Clear(TerrainGLBuffer buffer)
 	// Reset CPU values
 	TerrainBuffer_Reset(buffer);
 
-	// Zero GPU memory (expensive!)
+	// Zero GPU memory (expensive!), a VBO without storage (vertex pulling) has nothing to clear
 	if (IsGLVersionHigher(4, 3))
 	{
 		// Use R8 to clear byte-by-byte (works for any data structure)
-		glClearNamedBufferSubData(buffer->uiVBO, GL_R8, 0, buffer->vboSize, GL_RED, GL_UNSIGNED_BYTE, NULL); // buffer->vboSize is Total Size (capacity * sizeof(element))
+		if (buffer->vboSize > 0)
+		{
+			glClearNamedBufferSubData(buffer->uiVBO, GL_R8, 0, buffer->vboSize, GL_RED, GL_UNSIGNED_BYTE, NULL); // buffer->vboSize is Total Size (capacity * sizeof(element))
+		}
 		glClearNamedBufferSubData(buffer->uiEBO, GL_R32UI, 0, buffer->eboSize, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
 	}
 	else
 	{
 		// Use R8 to clear byte-by-byte (works for any data structure)
-		glBindBuffer(GL_ARRAY_BUFFER, buffer->uiVBO);
-		glClearBufferSubData(GL_ARRAY_BUFFER, GL_R8, 0, buffer->vboSize, GL_RED, GL_UNSIGNED_BYTE, NULL);
+		if (buffer->vboSize > 0)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, buffer->uiVBO);
+			glClearBufferSubData(GL_ARRAY_BUFFER, GL_R8, 0, buffer->vboSize, GL_RED, GL_UNSIGNED_BYTE, NULL);
+		}
 
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->uiEBO);
 		glClearBufferSubData(GL_ELEMENT_ARRAY_BUFFER, GL_R32UI, 0, buffer->eboSize, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
@@ -107,7 +113,7 @@ void TerrainBuffer_Clear(TerrainGLBuffer buffer)
 #endif
 }
 
-bool TerrainBuffer_Initialize(TerrainGLBuffer* ppTerrainBuffer, GLsizeiptr capacity)
+bool TerrainBuffer_Initialize(TerrainGLBuffer* ppTerrainBuffer, GLsizeiptr vertexCapacity, GLsizeiptr indexCapacity)
 {
 	if (ppTerrainBuffer == NULL)
 	{
@@ -131,8 +137,8 @@ bool TerrainBuffer_Initialize(TerrainGLBuffer* ppTerrainBuffer, GLsizeiptr capac
 		return (false);
 	}
 
-	buffer->vboCapacity = capacity * 1024;
-	buffer->eboCapacity = capacity * 1536;
+	buffer->vboCapacity = vertexCapacity;
+	buffer->eboCapacity = indexCapacity;
 
 	buffer->vboSize = buffer->vboCapacity * sizeof(STerrainVertex);
 	buffer->eboSize = buffer->eboCapacity * sizeof(GLuint);
@@ -183,16 +189,23 @@ bool TerrainBuffer_AllocateGPUStorage(TerrainGLBuffer pTerrainBuffer)
 		return (false);
 	}
 
+	// Zero sized storage is an error, with vertex pulling the VBO stays empty
 	if (IsGLVersionHigher(4, 5))
 	{
 		// Immutable Storage !
-		glNamedBufferStorage(pTerrainBuffer->uiVBO, pTerrainBuffer->vboSize, NULL, pTerrainBuffer->bufferStorageType);
+		if (pTerrainBuffer->vboSize > 0)
+		{
+			glNamedBufferStorage(pTerrainBuffer->uiVBO, pTerrainBuffer->vboSize, NULL, pTerrainBuffer->bufferStorageType);
+		}
 		glNamedBufferStorage(pTerrainBuffer->uiEBO, pTerrainBuffer->eboSize, NULL, pTerrainBuffer->bufferStorageType);
 	}
 	else
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, pTerrainBuffer->uiVBO);
-		glBufferData(GL_ARRAY_BUFFER, pTerrainBuffer->vboSize, NULL, pTerrainBuffer->bufferStorageType);
+		if (pTerrainBuffer->vboSize > 0)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, pTerrainBuffer->uiVBO);
+			glBufferData(GL_ARRAY_BUFFER, pTerrainBuffer->vboSize, NULL, pTerrainBuffer->bufferStorageType);
+		}
 
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pTerrainBuffer->uiEBO);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, pTerrainBuffer->eboSize, NULL, pTerrainBuffer->bufferStorageType);
@@ -230,6 +243,53 @@ bool TerrainBuffer_AllocateVertexBuffer(TerrainGLBuffer pTerrainBuffer)
 
 	GLuint byteOffset = 0;
 
+#if TERRAIN_VERTEX_PULLING
+	// No attributes, the shader builds every vertex from gl_VertexID
+	(void)iPosition;
+	(void)iNormals;
+	(void)iTexCoord;
+	(void)iColors;
+	(void)byteOffset;
+#elif TERRAIN_COMPACT_VERTEX
+	// Grid position stays integer (read as uvec2), the octahedral normal is normalized to [-1, 1]
+	(void)iTexCoord;
+	(void)iColors;
+
+	if (IsGLVersionHigher(4, 5))
+	{
+		glEnableVertexArrayAttrib(pTerrainBuffer->uiVAO, iPosition);
+		glVertexArrayAttribIFormat(pTerrainBuffer->uiVAO, iPosition, 2, GL_UNSIGNED_SHORT, byteOffset);
+		glVertexArrayAttribBinding(pTerrainBuffer->uiVAO, iPosition, 0);
+
+		byteOffset += 2 * sizeof(GLushort);
+
+		glEnableVertexArrayAttrib(pTerrainBuffer->uiVAO, iNormals);
+		glVertexArrayAttribFormat(pTerrainBuffer->uiVAO, iNormals, 2, GL_SHORT, GL_TRUE, byteOffset);
+		glVertexArrayAttribBinding(pTerrainBuffer->uiVAO, iNormals, 0);
+	}
+	else if (IsGLVersionHigher(4, 3))
+	{
+		glEnableVertexAttribArray(iPosition);
+		glVertexAttribIFormat(iPosition, 2, GL_UNSIGNED_SHORT, byteOffset);
+		glVertexAttribBinding(iPosition, 0);
+
+		byteOffset += 2 * sizeof(GLushort);
+
+		glEnableVertexAttribArray(iNormals);
+		glVertexAttribFormat(iNormals, 2, GL_SHORT, GL_TRUE, byteOffset);
+		glVertexAttribBinding(iNormals, 0);
+	}
+	else
+	{
+		glEnableVertexAttribArray(iPosition);
+		glVertexAttribIPointer(iPosition, 2, GL_UNSIGNED_SHORT, sizeof(STerrainVertex), (const void*)((GLsizeiptr)byteOffset));
+
+		byteOffset += 2 * sizeof(GLushort);
+
+		glEnableVertexAttribArray(iNormals);
+		glVertexAttribPointer(iNormals, 2, GL_SHORT, GL_TRUE, sizeof(STerrainVertex), (const void*)((GLsizeiptr)byteOffset));
+	}
+#else
 	if (IsGLVersionHigher(4, 5))
 	{
 		glEnableVertexArrayAttrib(pTerrainBuffer->uiVAO, iPosition);
@@ -304,6 +364,7 @@ bool TerrainBuffer_AllocateVertexBuffer(TerrainGLBuffer pTerrainBuffer)
 
 		byteOffset += 4 * sizeof(GLfloat); // Move by 16 BYTES for alignment (SIMD)
 	}
+#endif
 
 	return (true);
 }
@@ -378,13 +439,19 @@ bool TerrainBuffer_Reallocate(TerrainGLBuffer pTerrainBuffer, GLsizeiptr newVboC
 	if (IsGLVersionHigher(4, 5))
 	{
 		// Immutable Storage !
-		glNamedBufferStorage(newBuffers[0], pTerrainBuffer->vboSize, NULL, pTerrainBuffer->bufferStorageType);
+		if (pTerrainBuffer->vboSize > 0)
+		{
+			glNamedBufferStorage(newBuffers[0], pTerrainBuffer->vboSize, NULL, pTerrainBuffer->bufferStorageType);
+		}
 		glNamedBufferStorage(newBuffers[1], pTerrainBuffer->eboSize, NULL, pTerrainBuffer->bufferStorageType);
 	}
 	else
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, newBuffers[0]);
-		glBufferData(GL_ARRAY_BUFFER, pTerrainBuffer->vboSize, NULL, pTerrainBuffer->bufferStorageType);
+		if (pTerrainBuffer->vboSize > 0)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, newBuffers[0]);
+			glBufferData(GL_ARRAY_BUFFER, pTerrainBuffer->vboSize, NULL, pTerrainBuffer->bufferStorageType);
+		}
 
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, newBuffers[1]);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, pTerrainBuffer->eboSize, NULL, pTerrainBuffer->bufferStorageType);
@@ -462,71 +529,138 @@ bool TerrainBuffer_UploadData(TerrainGLBuffer pTerrainBuffer, TerrainMesh pTerra
 	}
 #endif
 
-	if (!pTerrainBuffer || !pTerrainMesh || !pTerrainMesh->pVertices || !pTerrainMesh->pIndices)
+	if (!pTerrainBuffer)
+	{
+		syserr("Terrain Buffer or Data is NULL");
+		return false;
+	}
+
+	// Appends, the write below advances the offsets past the mesh
+	return (TerrainBuffer_UploadDataAt(pTerrainBuffer, pTerrainMesh, pTerrainBuffer->vertexOffset, pTerrainBuffer->indexOffset));
+}
+
+static bool TerrainBuffer_EnsureCapacity(TerrainGLBuffer pTerrainBuffer, GLsizeiptr requiredVboCapacity, GLsizeiptr requiredEboCapacity)
+{
+	if (pTerrainBuffer->vboCapacity >= requiredVboCapacity && pTerrainBuffer->eboCapacity >= requiredEboCapacity)
+	{
+		return (true);
+	}
+
+	// Reallocate with extra space to avoid frequent reallocations
+	GLsizeiptr newVboCapacity = (requiredVboCapacity > pTerrainBuffer->vboCapacity) ? requiredVboCapacity * 2 : pTerrainBuffer->vboCapacity;
+	GLsizeiptr newEboCapacity = (requiredEboCapacity > pTerrainBuffer->eboCapacity) ? requiredEboCapacity * 2 : pTerrainBuffer->eboCapacity;
+	if (!TerrainBuffer_Reallocate(pTerrainBuffer, newVboCapacity, newEboCapacity, true))
+	{
+		syserr("Failed to Reallocate Terrain Buffer");
+		return (false);
+	}
+
+	syslog("Attemp to reallocate buffer .. new VBO size: %zu - new VEO size: %zu", newVboCapacity, newEboCapacity);
+	return (true);
+}
+
+// The write offsets only move forward, they stay the high-water mark Reallocate copies up to
+static void TerrainBuffer_AdvanceOffsets(TerrainGLBuffer pTerrainBuffer, GLsizeiptr vertexEnd, GLsizeiptr indexEnd)
+{
+	if (vertexEnd > pTerrainBuffer->vertexOffset)
+	{
+		pTerrainBuffer->vertexOffset = vertexEnd;
+	}
+	if (indexEnd > pTerrainBuffer->indexOffset)
+	{
+		pTerrainBuffer->indexOffset = indexEnd;
+	}
+
+	// Update total counts
+	pTerrainBuffer->vertexCount = (GLuint)pTerrainBuffer->vertexOffset;
+	pTerrainBuffer->indexCount = (GLuint)pTerrainBuffer->indexOffset;
+}
+
+/**
+ * @brief Writes a mesh at fixed offsets (in vertices / indices).
+ *
+ * Meshes without indices (terrain patches draw a shared pattern) only write vertices.
+ */
+bool TerrainBuffer_UploadDataAt(TerrainGLBuffer pTerrainBuffer, TerrainMesh pTerrainMesh, GLsizeiptr vertexOffset, GLsizeiptr indexOffset)
+{
+	if (!pTerrainBuffer || !pTerrainMesh || !pTerrainMesh->vertices.pData)
 	{
 		syserr("Terrain Buffer or Data is NULL");
 		return false;
 	}
 
 	// Update Counts and Offsets
-	pTerrainMesh->indexOffset = TerrainBuffer_GetIndexOffset(pTerrainBuffer);
-	pTerrainMesh->vertexOffset = TerrainBuffer_GetVertexOffset(pTerrainBuffer);
+	pTerrainMesh->indexOffset = indexOffset;
+	pTerrainMesh->vertexOffset = vertexOffset;
 
-	const STerrainVertex* pVertices = (STerrainVertex*)pTerrainMesh->pVertices->pData;
-	const GLuint* pIndices = (GLuint*)pTerrainMesh->pIndices->pData;
+	const STerrainVertex* pVertices = pTerrainMesh->vertices.pData;
 	GLsizeiptr vertexCount = pTerrainMesh->vertexCount;
-	GLsizeiptr indexCount = pTerrainMesh->indexCount;
+	GLsizeiptr indexCount = (pTerrainMesh->indices.pData) ? pTerrainMesh->indexCount : 0;
 
 	// Check Capacity
-	GLsizeiptr requiredVboCapacity = pTerrainBuffer->vertexOffset + vertexCount; // total VBO size after upload
-	GLsizeiptr requiredEboCapacity = pTerrainBuffer->indexOffset + indexCount;   // total EBO size after upload
+	GLsizeiptr requiredVboCapacity = vertexOffset + vertexCount; // total VBO size after upload
+	GLsizeiptr requiredEboCapacity = indexOffset + indexCount;   // total EBO size after upload
 
-	if (pTerrainBuffer->vboCapacity < requiredVboCapacity || pTerrainBuffer->eboCapacity < requiredEboCapacity)
+	if (!TerrainBuffer_EnsureCapacity(pTerrainBuffer, requiredVboCapacity, requiredEboCapacity))
 	{
-		// Reallocate with extra space to avoid frequent reallocations
-		GLsizeiptr newVboCapacity = (requiredVboCapacity > pTerrainBuffer->vboCapacity) ? requiredVboCapacity * 2 : pTerrainBuffer->vboCapacity;
-		GLsizeiptr newEboCapacity = (requiredEboCapacity > pTerrainBuffer->eboCapacity) ? requiredEboCapacity * 2 : pTerrainBuffer->eboCapacity;
-		if (!TerrainBuffer_Reallocate(pTerrainBuffer, newVboCapacity, newEboCapacity, true))
-		{
-			syserr("Failed to Reallocate Terrain Buffer");
-			return (false);
-		}
-		else
-		{
-			syslog("Attemp to reallocate buffer .. new VBO size: %zu - new VEO size: %zu", newVboCapacity, newEboCapacity);
-		}
+		return (false);
 	}
 
 	// Calculate byte offsets for glBufferSubData
-	GLsizeiptr vertexByteOffset = pTerrainBuffer->vertexOffset * sizeof(STerrainVertex);
-	GLsizeiptr indexByteOffset = pTerrainBuffer->indexOffset * sizeof(GLuint);
-
+	GLsizeiptr vertexByteOffset = vertexOffset * sizeof(STerrainVertex);
 	GLsizeiptr vertexByteSize = vertexCount * sizeof(STerrainVertex);
-	GLsizeiptr indexByteSize = indexCount * sizeof(GLuint);
 
 	// Upload Vertex Data
 	if (IsGLVersionHigher(4, 5))
 	{
 		glNamedBufferSubData(pTerrainBuffer->uiVBO, vertexByteOffset, vertexByteSize, pVertices);
-		glNamedBufferSubData(pTerrainBuffer->uiEBO, indexByteOffset, indexByteSize, pIndices);
 	}
 	else
 	{
 		glBindBuffer(GL_ARRAY_BUFFER, pTerrainBuffer->uiVBO);
 		glBufferSubData(GL_ARRAY_BUFFER, vertexByteOffset, vertexByteSize, pVertices);
+	}
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pTerrainBuffer->uiEBO);
-		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexByteOffset, indexByteSize, pIndices);
+	if (indexCount > 0 && !TerrainBuffer_UploadIndicesAt(pTerrainBuffer, pTerrainMesh->indices.pData, indexCount, indexOffset))
+	{
+		return (false);
 	}
 
-	// Update Offsets
-	pTerrainBuffer->vertexOffset += vertexCount;
-	pTerrainBuffer->indexOffset += indexCount;
+	TerrainBuffer_AdvanceOffsets(pTerrainBuffer, requiredVboCapacity, requiredEboCapacity);
+	return (true);
+}
 
-	// Update total counts
-	pTerrainBuffer->vertexCount = (GLuint)pTerrainBuffer->vertexOffset;
-	pTerrainBuffer->indexCount = (GLuint)pTerrainBuffer->indexOffset;
+/**
+ * @brief Writes raw indices at a fixed offset (in indices), for index lists shared by many meshes.
+ */
+bool TerrainBuffer_UploadIndicesAt(TerrainGLBuffer pTerrainBuffer, const GLuint* pIndices, GLsizeiptr indexCount, GLsizeiptr indexOffset)
+{
+	if (!pTerrainBuffer || !pIndices)
+	{
+		syserr("Terrain Buffer or Data is NULL");
+		return false;
+	}
+
+	GLsizeiptr requiredEboCapacity = indexOffset + indexCount;
+	if (!TerrainBuffer_EnsureCapacity(pTerrainBuffer, pTerrainBuffer->vboCapacity, requiredEboCapacity))
+	{
+		return (false);
+	}
+
+	GLsizeiptr indexByteOffset = indexOffset * sizeof(GLuint);
+	GLsizeiptr indexByteSize = indexCount * sizeof(GLuint);
+
+	if (IsGLVersionHigher(4, 5))
+	{
+		glNamedBufferSubData(pTerrainBuffer->uiEBO, indexByteOffset, indexByteSize, pIndices);
+	}
+	else
+	{
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pTerrainBuffer->uiEBO);
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexByteOffset, indexByteSize, pIndices);
+	}
 
+	TerrainBuffer_AdvanceOffsets(pTerrainBuffer, pTerrainBuffer->vertexOffset, requiredEboCapacity);
 	return (true);
 }
 
@@ -36,7 +36,7 @@ void TerrainBuffer_Delete(TerrainGLBuffer buffer);
 void TerrainBuffer_Reset(TerrainGLBuffer buffer);
 void TerrainBuffer_Clear(TerrainGLBuffer buffer);
 
-bool TerrainBuffer_Initialize(TerrainGLBuffer* ppTerrainBuffer, GLsizeiptr capacity);
+bool TerrainBuffer_Initialize(TerrainGLBuffer* ppTerrainBuffer, GLsizeiptr vertexCapacity, GLsizeiptr indexCapacity);
 void TerrainBuffer_Destroy(TerrainGLBuffer* ppTerrainBuffer);
 
 bool TerrainBuffer_AllocateGPUStorage(TerrainGLBuffer pTerrainBuffer);
@@ -45,6 +45,8 @@ bool TerrainBuffer_LinkBuffers(TerrainGLBuffer pTerrainBuffer);
 
 bool TerrainBuffer_Reallocate(TerrainGLBuffer pTerrainBuffer, GLsizeiptr newVboCapacity, GLsizeiptr newEboCapacity, bool copyOldData);
 bool TerrainBuffer_UploadData(TerrainGLBuffer pTerrainBuffer, TerrainMesh pTerrainMesh);
+bool TerrainBuffer_UploadDataAt(TerrainGLBuffer pTerrainBuffer, TerrainMesh pTerrainMesh, GLsizeiptr vertexOffset, GLsizeiptr indexOffset);
+bool TerrainBuffer_UploadIndicesAt(TerrainGLBuffer pTerrainBuffer, const GLuint* pIndices, GLsizeiptr indexCount, GLsizeiptr indexOffset);
 
 GLsizeiptr TerrainBuffer_GetVertexOffset(TerrainGLBuffer pTerrainBuffer);
 GLsizeiptr TerrainBuffer_GetIndexOffset(TerrainGLBuffer pTerrainBuffer);
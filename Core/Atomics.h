@@ -0,0 +1,101 @@
+#ifndef __ATOMICS_H__
+#define __ATOMICS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Minimal portable atomics used by the engine's lock-free paths.
+ * MSVC's C compiler still ships <stdatomic.h> behind an experimental flag,
+ * so we wrap the Interlocked intrinsics there and the __atomic builtins elsewhere.
+ * All operations are sequentially consistent unless the name says otherwise.
+ */
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+	#define AERO_THREAD_LOCAL __declspec(thread)
+	#define AeroAtomic_Pause() _mm_pause()
+#else
+	#include <xmmintrin.h>
+	#define AERO_THREAD_LOCAL _Thread_local
+	#if defined(__x86_64__) || defined(__i386__)
+		#define AeroAtomic_Pause() _mm_pause()
+	#else
+		#define AeroAtomic_Pause() ((void)0)
+	#endif
+#endif
+
+// Keeps hot atomics on their own cache line to avoid false sharing between threads
+#define AERO_CACHE_LINE_SIZE 64
+
+#if defined(_MSC_VER)
+
+static inline int32_t AeroAtomic_Load32(volatile int32_t* pTarget) { return _InterlockedOr((volatile long*)pTarget, 0); }
+static inline void AeroAtomic_Store32(volatile int32_t* pTarget, int32_t value) { _InterlockedExchange((volatile long*)pTarget, value); }
+static inline int32_t AeroAtomic_Add32(volatile int32_t* pTarget, int32_t value) { return _InterlockedExchangeAdd((volatile long*)pTarget, value) + value; }
+static inline int32_t AeroAtomic_Exchange32(volatile int32_t* pTarget, int32_t value) { return _InterlockedExchange((volatile long*)pTarget, value); }
+static inline bool AeroAtomic_CompareExchange32(volatile int32_t* pTarget, int32_t expected, int32_t desired) { return _InterlockedCompareExchange((volatile long*)pTarget, desired, expected) == expected; }
+
+static inline int64_t AeroAtomic_Load64(volatile int64_t* pTarget) { return _InterlockedOr64((volatile long long*)pTarget, 0); }
+static inline void AeroAtomic_Store64(volatile int64_t* pTarget, int64_t value) { _InterlockedExchange64((volatile long long*)pTarget, value); }
+static inline int64_t AeroAtomic_Add64(volatile int64_t* pTarget, int64_t value) { return _InterlockedExchangeAdd64((volatile long long*)pTarget, value) + value; }
+static inline int64_t AeroAtomic_Exchange64(volatile int64_t* pTarget, int64_t value) { return _InterlockedExchange64((volatile long long*)pTarget, value); }
+static inline bool AeroAtomic_CompareExchange64(volatile int64_t* pTarget, int64_t expected, int64_t desired) { return _InterlockedCompareExchange64((volatile long long*)pTarget, desired, expected) == expected; }
+
+static inline void* AeroAtomic_LoadPtr(void* volatile* ppTarget) { return _InterlockedCompareExchangePointer(ppTarget, NULL, NULL); }
+static inline void AeroAtomic_StorePtr(void* volatile* ppTarget, void* pValue) { _InterlockedExchangePointer(ppTarget, pValue); }
+static inline void* AeroAtomic_ExchangePtr(void* volatile* ppTarget, void* pValue) { return _InterlockedExchangePointer(ppTarget, pValue); }
+static inline bool AeroAtomic_CompareExchangePtr(void* volatile* ppTarget, void* pExpected, void* pDesired) { return _InterlockedCompareExchangePointer(ppTarget, pDesired, pExpected) == pExpected; }
+
+#else
+
+static inline int32_t AeroAtomic_Load32(volatile int32_t* pTarget) { return __atomic_load_n(pTarget, __ATOMIC_SEQ_CST); }
+static inline void AeroAtomic_Store32(volatile int32_t* pTarget, int32_t value) { __atomic_store_n(pTarget, value, __ATOMIC_SEQ_CST); }
+static inline int32_t AeroAtomic_Add32(volatile int32_t* pTarget, int32_t value) { return __atomic_add_fetch(pTarget, value, __ATOMIC_SEQ_CST); }
+static inline int32_t AeroAtomic_Exchange32(volatile int32_t* pTarget, int32_t value) { return __atomic_exchange_n(pTarget, value, __ATOMIC_SEQ_CST); }
+static inline bool AeroAtomic_CompareExchange32(volatile int32_t* pTarget, int32_t expected, int32_t desired) { return __atomic_compare_exchange_n(pTarget, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); }
+
+static inline int64_t AeroAtomic_Load64(volatile int64_t* pTarget) { return __atomic_load_n(pTarget, __ATOMIC_SEQ_CST); }
+static inline void AeroAtomic_Store64(volatile int64_t* pTarget, int64_t value) { __atomic_store_n(pTarget, value, __ATOMIC_SEQ_CST); }
+static inline int64_t AeroAtomic_Add64(volatile int64_t* pTarget, int64_t value) { return __atomic_add_fetch(pTarget, value, __ATOMIC_SEQ_CST); }
+static inline int64_t AeroAtomic_Exchange64(volatile int64_t* pTarget, int64_t value) { return __atomic_exchange_n(pTarget, value, __ATOMIC_SEQ_CST); }
+static inline bool AeroAtomic_CompareExchange64(volatile int64_t* pTarget, int64_t expected, int64_t desired) { return __atomic_compare_exchange_n(pTarget, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); }
+
+static inline void* AeroAtomic_LoadPtr(void* volatile* ppTarget) { return __atomic_load_n(ppTarget, __ATOMIC_SEQ_CST); }
+static inline void AeroAtomic_StorePtr(void* volatile* ppTarget, void* pValue) { __atomic_store_n(ppTarget, pValue, __ATOMIC_SEQ_CST); }
+static inline void* AeroAtomic_ExchangePtr(void* volatile* ppTarget, void* pValue) { return __atomic_exchange_n(ppTarget, pValue, __ATOMIC_SEQ_CST); }
+static inline bool AeroAtomic_CompareExchangePtr(void* volatile* ppTarget, void* pExpected, void* pDesired) { return __atomic_compare_exchange_n(ppTarget, &pExpected, pDesired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST); }
+
+#endif
+
+/**
+ * @brief Tiny test-and-set spin lock.
+ *
+ * Only meant for locks that are almost never contended (e.g. a per-thread
+ * structure that another thread inspects once in a while).
+ */
+typedef volatile int32_t AeroSpinLock;
+
+static inline void AeroSpinLock_Lock(AeroSpinLock* pLock)
+{
+	while (AeroAtomic_Exchange32(pLock, 1) != 0)
+	{
+		while (AeroAtomic_Load32(pLock) != 0)
+		{
+			AeroAtomic_Pause();
+		}
+	}
+}
+
+static inline bool AeroSpinLock_TryLock(AeroSpinLock* pLock)
+{
+	return (AeroAtomic_Exchange32(pLock, 1) == 0);
+}
+
+static inline void AeroSpinLock_Unlock(AeroSpinLock* pLock)
+{
+	AeroAtomic_Store32(pLock, 0);
+}
+
+#endif // __ATOMICS_H__
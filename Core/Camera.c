@@ -287,6 +287,16 @@ Matrix4 Camera_GetViewBillboardMatrix(GLCamera pCamera)
 	return (pCamera->ViewMatrixBillboard);
 }
 
+Vector3 Camera_GetPosition(GLCamera pCamera)
+{
+	return (pCamera->v3Position);
+}
+
+float Camera_GetViewportHeight(GLCamera pCamera)
+{
+	return (pCamera->Height);
+}
+
 void Camera_ProcessCameraKeboardInput(GLCamera pCamera, ECameraDirections cameraDir, float deltaTime)
 {
 	GLfloat fVelocity = pCamera->CameraSpeed * deltaTime;
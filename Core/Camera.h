@@ -54,6 +54,8 @@ Matrix4 Camera_GetViewMatrix(GLCamera pCamera);
 Matrix4 Camera_GetProjectionMatrix(GLCamera pCamera);
 Matrix4 Camera_GetViewProjectionMatrix(GLCamera pCamera);
 Matrix4 Camera_GetViewBillboardMatrix(GLCamera pCamera);
+Vector3 Camera_GetPosition(GLCamera pCamera);
+float Camera_GetViewportHeight(GLCamera pCamera);
 
 void Camera_UpdateProjections(GLCamera pCamera);
 
@@ -249,6 +249,8 @@ void Input_HandleKeys(Input pInput)
     if (Input_IsKeyDown(pInput, GLFW_KEY_J))
     {
         MemoryManager_PrintTagReport();
+        FrameAllocator_PrintReport();
+        PoolAllocator_PrintReport();
     }
 
     if (Input_IsKeyDown(pInput, GLFW_KEY_L))
@@ -0,0 +1,975 @@
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // clock_gettime, sysconf with CMAKE_C_EXTENSIONS OFF
+#endif
+
+#include "JobSystem.h"
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+#include "Stdafx.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+typedef HANDLE ThreadHandle;
+typedef CRITICAL_SECTION MutexHandle;
+typedef CONDITION_VARIABLE ConditionHandle;
+#else
+typedef pthread_t ThreadHandle;
+typedef pthread_mutex_t MutexHandle;
+typedef pthread_cond_t ConditionHandle;
+#endif
+
+#define JOB_DEQUE_MASK (JOB_DEQUE_CAPACITY - 1)
+#define JOB_SPIN_COUNT 256 // Idle spins before a worker goes to sleep
+
+// Deque slots are read by thieves while the owner may write them, every field goes through atomics
+typedef struct SJobSlot
+{
+	void* volatile pfnJob;
+	void* volatile pUserData;
+	void* volatile pCounter;
+} SJobSlot;
+
+/**
+ * @brief Chase-Lev work-stealing deque of fixed capacity.
+ *
+ * The owner pushes and pops at the bottom (LIFO, cache warm), other threads
+ * steal from the top (FIFO, oldest and usually largest work).
+ */
+typedef struct SJobDeque
+{
+	volatile int64_t top;
+	char padTop[AERO_CACHE_LINE_SIZE - sizeof(int64_t)];
+	volatile int64_t bottom;
+	char padBottom[AERO_CACHE_LINE_SIZE - sizeof(int64_t)];
+	SJobSlot slots[JOB_DEQUE_CAPACITY];
+} SJobDeque;
+
+// Mutex guarded ring, for threads without a deque and for main-thread jobs
+typedef struct SJobQueue
+{
+	MutexHandle lock;
+	SJob* pJobs;
+	uint32_t head;
+	uint32_t capacity;
+	volatile int32_t count;		// Written under the lock, read without it as a hint
+} SJobQueue;
+
+typedef struct SJobWorker
+{
+	SJobDeque deque;
+	struct SJobSystem* pSystem;
+	ThreadHandle thread;
+	uint32_t index;
+	uint32_t rng;				// Victim selection, xorshift
+} SJobWorker;
+
+struct SJobContinuation
+{
+	SJob job;
+	struct SJobContinuation* next;
+};
+
+typedef struct SJobSystem
+{
+	SJobWorker* pWorkers;		// [threadCount], 0 is the main thread
+	uint32_t threadCount;
+	volatile int32_t isRunning;
+
+	SJobQueue sharedQueue;		// Submits from foreign threads and deque overflow
+	SJobQueue mainQueue;		// Only drained on the main thread
+
+	// Idle workers sleep here until queuedCount goes up
+	MutexHandle sleepLock;
+	ConditionHandle sleepCondition;
+	volatile int32_t sleepingCount;
+	volatile int32_t queuedCount;	// Jobs sitting in deques or the shared queue
+
+	volatile int64_t jobsExecuted;
+	volatile int64_t jobsStolen;
+	volatile int64_t jobsOverflowed;
+} SJobSystem;
+
+static JobSystem psJobSystem = NULL;
+static AERO_THREAD_LOCAL int32_t s_iThreadIndex = -1;
+
+// Platform
+static void JobSystem_MutexInit(MutexHandle* pMutex);
+static void JobSystem_MutexDestroy(MutexHandle* pMutex);
+static void JobSystem_MutexLock(MutexHandle* pMutex);
+static void JobSystem_MutexUnlock(MutexHandle* pMutex);
+static uint32_t JobSystem_GetCoreCount();
+static void JobSystem_Yield();
+
+// Queues
+static bool JobDeque_Push(SJobDeque* pDeque, const SJob* pJob);
+static bool JobDeque_Pop(SJobDeque* pDeque, SJob* pJob);
+static bool JobDeque_Steal(SJobDeque* pDeque, SJob* pJob);
+static bool JobQueue_Initialize(SJobQueue* pQueue, uint32_t capacity);
+static void JobQueue_Destroy(SJobQueue* pQueue);
+static bool JobQueue_Push(SJobQueue* pQueue, const SJob* pJob);
+static bool JobQueue_Pop(SJobQueue* pQueue, SJob* pJob);
+
+// Scheduling
+static void JobSystem_PushJob(JobSystem pSystem, const SJob* pJob);
+static bool JobSystem_FindJob(JobSystem pSystem, int32_t threadIndex, SJob* pJob);
+static void JobSystem_ExecuteJob(const SJob* pJob);
+static void JobSystem_FinishJob(SJobCounter* pCounter);
+static void JobSystem_WakeWorkers(JobSystem pSystem, bool bAll);
+
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI JobSystem_WorkerThread(LPVOID pParam);
+#else
+static void* JobSystem_WorkerThread(void* pParam);
+#endif
+
+bool JobSystem_Initialize(JobSystem* ppJobSystem, uint32_t workerCount)
+{
+	if (ppJobSystem == NULL)
+	{
+		syserr("ppJobSystem is NULL (invalid address)");
+		return (false);
+	}
+
+	if (psJobSystem)
+	{
+		syserr("JobSystem is already running");
+		return (false);
+	}
+
+	if (workerCount == 0)
+	{
+		uint32_t coreCount = JobSystem_GetCoreCount();
+		workerCount = (coreCount > 1) ? coreCount - 1 : 1;
+	}
+	if (workerCount > JOB_SYSTEM_MAX_THREADS - 1)
+	{
+		workerCount = JOB_SYSTEM_MAX_THREADS - 1;
+	}
+
+	*ppJobSystem = engine_new_zero(SJobSystem, 1, MEM_TAG_ENGINE);
+
+	JobSystem pSystem = *ppJobSystem;
+	if (!pSystem)
+	{
+		syserr("Failed to Allocate Memory for JobSystem");
+		return (false);
+	}
+
+	pSystem->threadCount = workerCount + 1;
+	pSystem->pWorkers = engine_new_zero(SJobWorker, pSystem->threadCount, MEM_TAG_ENGINE);
+	if (!pSystem->pWorkers)
+	{
+		syserr("Failed to Allocate %u JobSystem workers", pSystem->threadCount);
+		engine_delete(pSystem);
+		*ppJobSystem = NULL;
+		return (false);
+	}
+
+	if (!JobQueue_Initialize(&pSystem->sharedQueue, 256) || !JobQueue_Initialize(&pSystem->mainQueue, 64))
+	{
+		syserr("Failed to Allocate JobSystem queues");
+		JobQueue_Destroy(&pSystem->sharedQueue);
+		JobQueue_Destroy(&pSystem->mainQueue);
+		engine_delete(pSystem->pWorkers);
+		engine_delete(pSystem);
+		*ppJobSystem = NULL;
+		return (false);
+	}
+
+	JobSystem_MutexInit(&pSystem->sleepLock);
+#if defined(_WIN32) || defined(_WIN64)
+	InitializeConditionVariable(&pSystem->sleepCondition);
+#else
+	pthread_cond_init(&pSystem->sleepCondition, NULL);
+#endif
+
+	for (uint32_t i = 0; i < pSystem->threadCount; i++)
+	{
+		pSystem->pWorkers[i].pSystem = pSystem;
+		pSystem->pWorkers[i].index = i;
+		pSystem->pWorkers[i].rng = 0x9E3779B9u * (i + 1);
+	}
+
+	// Publish before the workers start looking for it
+	s_iThreadIndex = 0;
+	psJobSystem = pSystem;
+	AeroAtomic_Store32(&pSystem->isRunning, 1);
+
+	for (uint32_t i = 1; i < pSystem->threadCount; i++)
+	{
+		SJobWorker* pWorker = &pSystem->pWorkers[i];
+#if defined(_WIN32) || defined(_WIN64)
+		pWorker->thread = CreateThread(NULL, 0, JobSystem_WorkerThread, pWorker, 0, NULL);
+		bool bCreated = (pWorker->thread != NULL);
+#else
+		bool bCreated = (pthread_create(&pWorker->thread, NULL, JobSystem_WorkerThread, pWorker) == 0);
+#endif
+		if (!bCreated)
+		{
+			syserr("Failed to start JobSystem worker %u", i);
+			pSystem->threadCount = i; // Destroy joins the ones that did start
+			JobSystem_Destroy(ppJobSystem);
+			return (false);
+		}
+	}
+
+	syslog("JobSystem started with %u threads (%u workers + main)", pSystem->threadCount, pSystem->threadCount - 1);
+	return (true);
+}
+
+void JobSystem_Destroy(JobSystem* ppJobSystem)
+{
+	if (!ppJobSystem || !*ppJobSystem)
+	{
+		return;
+	}
+
+	JobSystem pSystem = *ppJobSystem;
+
+	AeroAtomic_Store32(&pSystem->isRunning, 0);
+	JobSystem_WakeWorkers(pSystem, true);
+
+	for (uint32_t i = 1; i < pSystem->threadCount; i++)
+	{
+#if defined(_WIN32) || defined(_WIN64)
+		WaitForSingleObject(pSystem->pWorkers[i].thread, INFINITE);
+		CloseHandle(pSystem->pWorkers[i].thread);
+#else
+		pthread_join(pSystem->pWorkers[i].thread, NULL);
+#endif
+	}
+
+	// Nothing is left behind, whatever is still queued runs here
+	SJob job;
+	while (JobSystem_FindJob(pSystem, 0, &job) || JobQueue_Pop(&pSystem->mainQueue, &job))
+	{
+		JobSystem_ExecuteJob(&job);
+	}
+
+	JobQueue_Destroy(&pSystem->sharedQueue);
+	JobQueue_Destroy(&pSystem->mainQueue);
+	JobSystem_MutexDestroy(&pSystem->sleepLock);
+#if !defined(_WIN32) && !defined(_WIN64)
+	pthread_cond_destroy(&pSystem->sleepCondition);
+#endif
+
+	engine_delete(pSystem->pWorkers);
+
+	if (psJobSystem == pSystem)
+	{
+		psJobSystem = NULL;
+	}
+	s_iThreadIndex = -1;
+
+	engine_delete(pSystem);
+	*ppJobSystem = NULL;
+}
+
+void JobSystem_Submit(JobFunction pfnJob, void* pUserData, SJobCounter* pCounter)
+{
+	if (!pfnJob)
+	{
+		return;
+	}
+
+	SJob job = { pfnJob, pUserData, pCounter };
+	if (pCounter)
+	{
+		AeroAtomic_Add32(&pCounter->value, 1);
+	}
+
+	if (!psJobSystem)
+	{
+		JobSystem_ExecuteJob(&job);
+		return;
+	}
+
+	JobSystem_PushJob(psJobSystem, &job);
+}
+
+void JobSystem_SubmitAfter(SJobCounter* pDependency, JobFunction pfnJob, void* pUserData, SJobCounter* pCounter)
+{
+	if (!pDependency)
+	{
+		JobSystem_Submit(pfnJob, pUserData, pCounter);
+		return;
+	}
+
+	if (!pfnJob)
+	{
+		return;
+	}
+
+	// Count it now, so waiting on pCounter also covers the part spent held back
+	if (pCounter)
+	{
+		AeroAtomic_Add32(&pCounter->value, 1);
+	}
+
+	SJob job = { pfnJob, pUserData, pCounter };
+
+	AeroSpinLock_Lock(&pDependency->lock);
+	if (AeroAtomic_Load32(&pDependency->value) > 0)
+	{
+		SJobContinuation* pContinuation = engine_new(SJobContinuation, MEM_TAG_ENGINE);
+		if (pContinuation)
+		{
+			pContinuation->job = job;
+			pContinuation->next = pDependency->pContinuations;
+			pDependency->pContinuations = pContinuation;
+			AeroSpinLock_Unlock(&pDependency->lock);
+			return;
+		}
+
+		syserr("Failed to hold back a job, waiting for its dependency instead");
+		AeroSpinLock_Unlock(&pDependency->lock);
+		JobSystem_Wait(pDependency);
+	}
+	else
+	{
+		AeroSpinLock_Unlock(&pDependency->lock);
+	}
+
+	if (psJobSystem)
+	{
+		JobSystem_PushJob(psJobSystem, &job);
+	}
+	else
+	{
+		JobSystem_ExecuteJob(&job);
+	}
+}
+
+bool JobSystem_IsDone(SJobCounter* pCounter)
+{
+	// The lock is checked too: the last finisher still holds it right after the count hits zero
+	return (!pCounter || (AeroAtomic_Load32(&pCounter->value) <= 0 && AeroAtomic_Load32(&pCounter->lock) == 0));
+}
+
+void JobSystem_Wait(SJobCounter* pCounter)
+{
+	uint32_t idleSpins = 0;
+	bool bIsMainThread = JobSystem_IsMainThread();
+
+	while (!JobSystem_IsDone(pCounter))
+	{
+		SJob job;
+		if (psJobSystem && (JobSystem_FindJob(psJobSystem, s_iThreadIndex, &job) || (bIsMainThread && JobQueue_Pop(&psJobSystem->mainQueue, &job))))
+		{
+			JobSystem_ExecuteJob(&job);
+			idleSpins = 0;
+			continue;
+		}
+
+		if (++idleSpins < JOB_SPIN_COUNT)
+		{
+			AeroAtomic_Pause();
+		}
+		else
+		{
+			JobSystem_Yield();
+		}
+	}
+}
+
+typedef struct SJobParallelForBatch
+{
+	JobRangeFunction pfnRange;
+	void* pUserData;
+	uint32_t begin;
+	uint32_t end;
+} SJobParallelForBatch;
+
+static void JobSystem_ParallelForJob(void* pUserData)
+{
+	SJobParallelForBatch* pBatch = (SJobParallelForBatch*)pUserData;
+	pBatch->pfnRange(pBatch->pUserData, pBatch->begin, pBatch->end);
+}
+
+void JobSystem_ParallelFor(uint32_t count, uint32_t minBatchSize, JobRangeFunction pfnRange, void* pUserData)
+{
+	if (count == 0 || !pfnRange)
+	{
+		return;
+	}
+
+	if (minBatchSize == 0)
+	{
+		minBatchSize = 1;
+	}
+
+	// A few batches per thread so stealing can even out uneven work
+	uint32_t batchCount = (count + minBatchSize - 1) / minBatchSize;
+	uint32_t maxBatches = JobSystem_GetThreadCount() * 4;
+	if (batchCount > maxBatches)
+	{
+		batchCount = maxBatches;
+	}
+	if (batchCount > JOB_PARALLEL_FOR_MAX_BATCHES)
+	{
+		batchCount = JOB_PARALLEL_FOR_MAX_BATCHES;
+	}
+
+	if (batchCount <= 1 || !psJobSystem)
+	{
+		pfnRange(pUserData, 0, count);
+		return;
+	}
+
+	SJobParallelForBatch batches[JOB_PARALLEL_FOR_MAX_BATCHES];
+	SJobCounter counter = { 0 };
+
+	for (uint32_t i = 0; i < batchCount; i++)
+	{
+		batches[i].pfnRange = pfnRange;
+		batches[i].pUserData = pUserData;
+		batches[i].begin = (uint32_t)(((uint64_t)count * i) / batchCount);
+		batches[i].end = (uint32_t)(((uint64_t)count * (i + 1)) / batchCount);
+	}
+
+	// The caller takes the first batch itself instead of idling
+	for (uint32_t i = 1; i < batchCount; i++)
+	{
+		JobSystem_Submit(JobSystem_ParallelForJob, &batches[i], &counter);
+	}
+	JobSystem_ParallelForJob(&batches[0]);
+
+	JobSystem_Wait(&counter);
+}
+
+void JobSystem_SubmitMainThread(JobFunction pfnJob, void* pUserData, SJobCounter* pCounter)
+{
+	if (!pfnJob)
+	{
+		return;
+	}
+
+	SJob job = { pfnJob, pUserData, pCounter };
+	if (pCounter)
+	{
+		AeroAtomic_Add32(&pCounter->value, 1);
+	}
+
+	if (!psJobSystem)
+	{
+		JobSystem_ExecuteJob(&job);
+		return;
+	}
+
+	if (!JobQueue_Push(&psJobSystem->mainQueue, &job))
+	{
+		syserr("Failed to queue a main thread job, the job is dropped");
+		if (pCounter)
+		{
+			JobSystem_FinishJob(pCounter);
+		}
+	}
+}
+
+uint32_t JobSystem_RunMainThreadJobs(double budgetMs)
+{
+	if (!psJobSystem)
+	{
+		return (0);
+	}
+
+	if (!JobSystem_IsMainThread())
+	{
+		syserr("Main thread jobs can only run on the main thread");
+		return (0);
+	}
+
+	double startTime = (budgetMs > 0.0) ? JobSystem_GetTimeMs() : 0.0;
+	uint32_t jobsRun = 0;
+	SJob job;
+
+	// Always runs at least one job so a small budget cannot starve the queue
+	while (JobQueue_Pop(&psJobSystem->mainQueue, &job))
+	{
+		JobSystem_ExecuteJob(&job);
+		jobsRun++;
+
+		if (budgetMs > 0.0 && JobSystem_GetTimeMs() - startTime >= budgetMs)
+		{
+			break;
+		}
+	}
+
+	return (jobsRun);
+}
+
+uint32_t JobSystem_GetThreadCount()
+{
+	return ((psJobSystem) ? psJobSystem->threadCount : 1);
+}
+
+int32_t JobSystem_GetThreadIndex()
+{
+	return (s_iThreadIndex);
+}
+
+bool JobSystem_IsMainThread()
+{
+	return (!psJobSystem || s_iThreadIndex == 0);
+}
+
+void JobSystem_GetStats(SJobSystemStats* pStats)
+{
+	if (!pStats)
+	{
+		return;
+	}
+
+	memset(pStats, 0, sizeof(SJobSystemStats));
+	pStats->threadCount = JobSystem_GetThreadCount();
+
+	if (psJobSystem)
+	{
+		pStats->jobsExecuted = AeroAtomic_Load64(&psJobSystem->jobsExecuted);
+		pStats->jobsStolen = AeroAtomic_Load64(&psJobSystem->jobsStolen);
+		pStats->jobsOverflowed = AeroAtomic_Load64(&psJobSystem->jobsOverflowed);
+	}
+}
+
+double JobSystem_GetTimeMs()
+{
+#if defined(_WIN32) || defined(_WIN64)
+	static LARGE_INTEGER frequency = { 0 };
+	if (frequency.QuadPart == 0)
+	{
+		QueryPerformanceFrequency(&frequency);
+	}
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return ((double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart);
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1000000.0);
+#endif
+}
+
+JobSystem GetJobSystem()
+{
+	return (psJobSystem);
+}
+
+// --- Scheduling ---
+
+static void JobSystem_PushJob(JobSystem pSystem, const SJob* pJob)
+{
+	int32_t threadIndex = s_iThreadIndex;
+
+	if (threadIndex < 0 || !JobDeque_Push(&pSystem->pWorkers[threadIndex].deque, pJob))
+	{
+		if (threadIndex >= 0)
+		{
+			AeroAtomic_Add64(&pSystem->jobsOverflowed, 1);
+		}
+
+		if (!JobQueue_Push(&pSystem->sharedQueue, pJob))
+		{
+			syserr("JobSystem shared queue is full, running the job inline");
+			JobSystem_ExecuteJob(pJob);
+			return;
+		}
+	}
+
+	AeroAtomic_Add32(&pSystem->queuedCount, 1);
+	JobSystem_WakeWorkers(pSystem, false);
+}
+
+static bool JobSystem_FindJob(JobSystem pSystem, int32_t threadIndex, SJob* pJob)
+{
+	// Own work first, newest job is the one most likely still in cache
+	if (threadIndex >= 0 && JobDeque_Pop(&pSystem->pWorkers[threadIndex].deque, pJob))
+	{
+		AeroAtomic_Add32(&pSystem->queuedCount, -1);
+		return (true);
+	}
+
+	if (AeroAtomic_Load32(&pSystem->sharedQueue.count) > 0 && JobQueue_Pop(&pSystem->sharedQueue, pJob))
+	{
+		AeroAtomic_Add32(&pSystem->queuedCount, -1);
+		return (true);
+	}
+
+	if (AeroAtomic_Load32(&pSystem->queuedCount) <= 0)
+	{
+		return (false);
+	}
+
+	// Steal, starting from a random victim so thieves spread out
+	uint32_t start = 0;
+	if (threadIndex >= 0)
+	{
+		uint32_t rng = pSystem->pWorkers[threadIndex].rng;
+		rng ^= rng << 13;
+		rng ^= rng >> 17;
+		rng ^= rng << 5;
+		pSystem->pWorkers[threadIndex].rng = rng;
+		start = rng % pSystem->threadCount;
+	}
+
+	for (uint32_t i = 0; i < pSystem->threadCount; i++)
+	{
+		uint32_t victim = (start + i) % pSystem->threadCount;
+		if ((int32_t)victim == threadIndex)
+		{
+			continue;
+		}
+
+		if (JobDeque_Steal(&pSystem->pWorkers[victim].deque, pJob))
+		{
+			AeroAtomic_Add32(&pSystem->queuedCount, -1);
+			AeroAtomic_Add64(&pSystem->jobsStolen, 1);
+			return (true);
+		}
+	}
+
+	return (false);
+}
+
+static void JobSystem_ExecuteJob(const SJob* pJob)
+{
+	pJob->pfnJob(pJob->pUserData);
+
+	if (psJobSystem)
+	{
+		AeroAtomic_Add64(&psJobSystem->jobsExecuted, 1);
+	}
+
+	if (pJob->pCounter)
+	{
+		JobSystem_FinishJob(pJob->pCounter);
+	}
+}
+
+static void JobSystem_FinishJob(SJobCounter* pCounter)
+{
+	// Decrement under the lock, the counter may live on a waiter's stack and
+	// must not be touched once the waiter can see it done
+	AeroSpinLock_Lock(&pCounter->lock);
+	SJobContinuation* pContinuation = NULL;
+	if (AeroAtomic_Add32(&pCounter->value, -1) == 0)
+	{
+		pContinuation = pCounter->pContinuations;
+		pCounter->pContinuations = NULL;
+	}
+	AeroSpinLock_Unlock(&pCounter->lock);
+
+	while (pContinuation)
+	{
+		SJobContinuation* pNext = pContinuation->next;
+		SJob job = pContinuation->job;
+		engine_delete(pContinuation);
+
+		if (psJobSystem)
+		{
+			JobSystem_PushJob(psJobSystem, &job);
+		}
+		else
+		{
+			JobSystem_ExecuteJob(&job);
+		}
+
+		pContinuation = pNext;
+	}
+}
+
+static void JobSystem_WakeWorkers(JobSystem pSystem, bool bAll)
+{
+	if (!bAll && AeroAtomic_Load32(&pSystem->sleepingCount) == 0)
+	{
+		return;
+	}
+
+	JobSystem_MutexLock(&pSystem->sleepLock);
+#if defined(_WIN32) || defined(_WIN64)
+	if (bAll)
+	{
+		WakeAllConditionVariable(&pSystem->sleepCondition);
+	}
+	else
+	{
+		WakeConditionVariable(&pSystem->sleepCondition);
+	}
+#else
+	if (bAll)
+	{
+		pthread_cond_broadcast(&pSystem->sleepCondition);
+	}
+	else
+	{
+		pthread_cond_signal(&pSystem->sleepCondition);
+	}
+#endif
+	JobSystem_MutexUnlock(&pSystem->sleepLock);
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI JobSystem_WorkerThread(LPVOID pParam)
+#else
+static void* JobSystem_WorkerThread(void* pParam)
+#endif
+{
+	SJobWorker* pWorker = (SJobWorker*)pParam;
+	JobSystem pSystem = pWorker->pSystem;
+	s_iThreadIndex = (int32_t)pWorker->index;
+
+	uint32_t idleSpins = 0;
+	while (AeroAtomic_Load32(&pSystem->isRunning))
+	{
+		SJob job;
+		if (JobSystem_FindJob(pSystem, s_iThreadIndex, &job))
+		{
+			JobSystem_ExecuteJob(&job);
+			idleSpins = 0;
+			continue;
+		}
+
+		if (++idleSpins < JOB_SPIN_COUNT)
+		{
+			AeroAtomic_Pause();
+			continue;
+		}
+		idleSpins = 0;
+
+		// Sleep until a push bumps queuedCount, checked under the lock the pusher signals with
+		JobSystem_MutexLock(&pSystem->sleepLock);
+		AeroAtomic_Add32(&pSystem->sleepingCount, 1);
+		while (AeroAtomic_Load32(&pSystem->isRunning) && AeroAtomic_Load32(&pSystem->queuedCount) <= 0)
+		{
+#if defined(_WIN32) || defined(_WIN64)
+			SleepConditionVariableCS(&pSystem->sleepCondition, &pSystem->sleepLock, INFINITE);
+#else
+			pthread_cond_wait(&pSystem->sleepCondition, &pSystem->sleepLock);
+#endif
+		}
+		AeroAtomic_Add32(&pSystem->sleepingCount, -1);
+		JobSystem_MutexUnlock(&pSystem->sleepLock);
+	}
+
+	// Hand the size-class cache back before the tracking slot goes
+	MemoryManager_ReleaseThreadCache();
+	s_iThreadIndex = -1;
+#if defined(_WIN32) || defined(_WIN64)
+	return (0);
+#else
+	return (NULL);
+#endif
+}
+
+// --- Work-stealing deque ---
+
+static void JobSlot_Write(SJobSlot* pSlot, const SJob* pJob)
+{
+	AeroAtomic_StorePtr(&pSlot->pfnJob, (void*)pJob->pfnJob);
+	AeroAtomic_StorePtr(&pSlot->pUserData, pJob->pUserData);
+	AeroAtomic_StorePtr(&pSlot->pCounter, (void*)pJob->pCounter);
+}
+
+static void JobSlot_Read(SJobSlot* pSlot, SJob* pJob)
+{
+	pJob->pfnJob = (JobFunction)AeroAtomic_LoadPtr(&pSlot->pfnJob);
+	pJob->pUserData = AeroAtomic_LoadPtr(&pSlot->pUserData);
+	pJob->pCounter = (SJobCounter*)AeroAtomic_LoadPtr(&pSlot->pCounter);
+}
+
+static bool JobDeque_Push(SJobDeque* pDeque, const SJob* pJob)
+{
+	int64_t bottom = AeroAtomic_Load64(&pDeque->bottom);
+	int64_t top = AeroAtomic_Load64(&pDeque->top);
+
+	if (bottom - top >= JOB_DEQUE_CAPACITY)
+	{
+		return (false);
+	}
+
+	JobSlot_Write(&pDeque->slots[bottom & JOB_DEQUE_MASK], pJob);
+	AeroAtomic_Store64(&pDeque->bottom, bottom + 1);
+	return (true);
+}
+
+static bool JobDeque_Pop(SJobDeque* pDeque, SJob* pJob)
+{
+	int64_t bottom = AeroAtomic_Load64(&pDeque->bottom) - 1;
+	AeroAtomic_Store64(&pDeque->bottom, bottom);
+	int64_t top = AeroAtomic_Load64(&pDeque->top);
+
+	if (top > bottom)
+	{
+		// Empty, undo the reservation
+		AeroAtomic_Store64(&pDeque->bottom, bottom + 1);
+		return (false);
+	}
+
+	JobSlot_Read(&pDeque->slots[bottom & JOB_DEQUE_MASK], pJob);
+	if (top != bottom)
+	{
+		return (true);
+	}
+
+	// Last job, race the thieves for it
+	bool bWon = AeroAtomic_CompareExchange64(&pDeque->top, top, top + 1);
+	AeroAtomic_Store64(&pDeque->bottom, bottom + 1);
+	return (bWon);
+}
+
+static bool JobDeque_Steal(SJobDeque* pDeque, SJob* pJob)
+{
+	int64_t top = AeroAtomic_Load64(&pDeque->top);
+	int64_t bottom = AeroAtomic_Load64(&pDeque->bottom);
+
+	if (top >= bottom)
+	{
+		return (false);
+	}
+
+	// The slot may be overwritten once another thief moves top, the CAS throws that read away
+	JobSlot_Read(&pDeque->slots[top & JOB_DEQUE_MASK], pJob);
+	return (AeroAtomic_CompareExchange64(&pDeque->top, top, top + 1));
+}
+
+// --- Locked queue ---
+
+static bool JobQueue_Initialize(SJobQueue* pQueue, uint32_t capacity)
+{
+	JobSystem_MutexInit(&pQueue->lock);
+	pQueue->pJobs = engine_new_zero(SJob, capacity, MEM_TAG_ENGINE);
+	pQueue->capacity = (pQueue->pJobs) ? capacity : 0;
+	pQueue->head = 0;
+	pQueue->count = 0;
+	return (pQueue->pJobs != NULL);
+}
+
+static void JobQueue_Destroy(SJobQueue* pQueue)
+{
+	if (pQueue->pJobs)
+	{
+		engine_delete(pQueue->pJobs);
+		pQueue->pJobs = NULL;
+		JobSystem_MutexDestroy(&pQueue->lock);
+	}
+	pQueue->capacity = 0;
+	pQueue->count = 0;
+}
+
+static bool JobQueue_Push(SJobQueue* pQueue, const SJob* pJob)
+{
+	JobSystem_MutexLock(&pQueue->lock);
+
+	uint32_t count = (uint32_t)pQueue->count;
+	if (count == pQueue->capacity)
+	{
+		// Unwrap into a buffer twice the size
+		SJob* pJobs = engine_new_zero(SJob, pQueue->capacity * 2, MEM_TAG_ENGINE);
+		if (!pJobs)
+		{
+			JobSystem_MutexUnlock(&pQueue->lock);
+			return (false);
+		}
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			pJobs[i] = pQueue->pJobs[(pQueue->head + i) % pQueue->capacity];
+		}
+
+		engine_delete(pQueue->pJobs);
+		pQueue->pJobs = pJobs;
+		pQueue->capacity *= 2;
+		pQueue->head = 0;
+	}
+
+	pQueue->pJobs[(pQueue->head + count) % pQueue->capacity] = *pJob;
+	AeroAtomic_Store32(&pQueue->count, (int32_t)count + 1);
+
+	JobSystem_MutexUnlock(&pQueue->lock);
+	return (true);
+}
+
+static bool JobQueue_Pop(SJobQueue* pQueue, SJob* pJob)
+{
+	if (AeroAtomic_Load32(&pQueue->count) == 0)
+	{
+		return (false);
+	}
+
+	JobSystem_MutexLock(&pQueue->lock);
+
+	bool bFound = (pQueue->count > 0);
+	if (bFound)
+	{
+		*pJob = pQueue->pJobs[pQueue->head];
+		pQueue->head = (pQueue->head + 1) % pQueue->capacity;
+		AeroAtomic_Store32(&pQueue->count, pQueue->count - 1);
+	}
+
+	JobSystem_MutexUnlock(&pQueue->lock);
+	return (bFound);
+}
+
+// --- Platform ---
+
+static void JobSystem_MutexInit(MutexHandle* pMutex)
+{
+#if defined(_WIN32) || defined(_WIN64)
+	InitializeCriticalSection(pMutex);
+#else
+	pthread_mutex_init(pMutex, NULL);
+#endif
+}
+
+static void JobSystem_MutexDestroy(MutexHandle* pMutex)
+{
+#if defined(_WIN32) || defined(_WIN64)
+	DeleteCriticalSection(pMutex);
+#else
+	pthread_mutex_destroy(pMutex);
+#endif
+}
+
+static void JobSystem_MutexLock(MutexHandle* pMutex)
+{
+#if defined(_WIN32) || defined(_WIN64)
+	EnterCriticalSection(pMutex);
+#else
+	pthread_mutex_lock(pMutex);
+#endif
+}
+
+static void JobSystem_MutexUnlock(MutexHandle* pMutex)
+{
+#if defined(_WIN32) || defined(_WIN64)
+	LeaveCriticalSection(pMutex);
+#else
+	pthread_mutex_unlock(pMutex);
+#endif
+}
+
+static uint32_t JobSystem_GetCoreCount()
+{
+#if defined(_WIN32) || defined(_WIN64)
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	return ((uint32_t)systemInfo.dwNumberOfProcessors);
+#else
+	long coreCount = sysconf(_SC_NPROCESSORS_ONLN);
+	return ((coreCount > 0) ? (uint32_t)coreCount : 1);
+#endif
+}
+
+static void JobSystem_Yield()
+{
+#if defined(_WIN32) || defined(_WIN64)
+	SwitchToThread();
+#else
+	sched_yield();
+#endif
+}
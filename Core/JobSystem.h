@@ -0,0 +1,93 @@
+#ifndef __JOB_SYSTEM_H__
+#define __JOB_SYSTEM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Atomics.h"
+
+#define JOB_SYSTEM_MAX_THREADS 64			// Workers + the main thread
+#define JOB_DEQUE_CAPACITY 4096				// Jobs per worker deque (power of two), overflow goes to the shared queue
+#define JOB_PARALLEL_FOR_MAX_BATCHES 256	// Upper bound on jobs one ParallelFor call submits
+#define JOB_MAIN_THREAD_BUDGET_MS 2.0		// Per-frame time Engine_Update gives queued main-thread jobs
+
+typedef void (*JobFunction)(void* pUserData);
+typedef void (*JobRangeFunction)(void* pUserData, uint32_t begin, uint32_t end);
+
+typedef struct SJobContinuation SJobContinuation;
+
+/**
+ * @brief Counts unfinished jobs, jobs submitted with it add one and remove one when done.
+ *
+ * Zero it before use. Jobs submitted "after" a counter are held on it and
+ * released when it reaches zero.
+ */
+typedef struct SJobCounter
+{
+	volatile int32_t value;
+	AeroSpinLock lock;						// Guards pContinuations
+	SJobContinuation* pContinuations;
+} SJobCounter;
+
+typedef struct SJob
+{
+	JobFunction pfnJob;
+	void* pUserData;
+	SJobCounter* pCounter;					// Optional
+} SJob;
+
+typedef struct SJobSystemStats
+{
+	uint32_t threadCount;					// Workers + the main thread
+	int64_t jobsExecuted;
+	int64_t jobsStolen;
+	int64_t jobsOverflowed;					// Pushed to the shared queue because a deque was full
+} SJobSystemStats;
+
+typedef struct SJobSystem* JobSystem;
+
+/**
+ * @brief Starts the worker pool, the calling thread becomes thread 0 (the main thread).
+ *
+ * @param workerCount Worker threads to spawn, 0 = one per core minus the main thread.
+ */
+bool JobSystem_Initialize(JobSystem* ppJobSystem, uint32_t workerCount);
+void JobSystem_Destroy(JobSystem* ppJobSystem);
+
+// Without a job system every submit runs inline, so tools can call these unconditionally
+void JobSystem_Submit(JobFunction pfnJob, void* pUserData, SJobCounter* pCounter);
+void JobSystem_SubmitAfter(SJobCounter* pDependency, JobFunction pfnJob, void* pUserData, SJobCounter* pCounter);
+
+/**
+ * @brief Blocks until the counter reaches zero, running other jobs meanwhile.
+ */
+void JobSystem_Wait(SJobCounter* pCounter);
+bool JobSystem_IsDone(SJobCounter* pCounter);
+
+/**
+ * @brief Calls pfnRange over [0, count) split in batches of at least minBatchSize, returns when all are done.
+ */
+void JobSystem_ParallelFor(uint32_t count, uint32_t minBatchSize, JobRangeFunction pfnRange, void* pUserData);
+
+/**
+ * @brief Queues a job for the main thread (GL calls), any thread may call it.
+ */
+void JobSystem_SubmitMainThread(JobFunction pfnJob, void* pUserData, SJobCounter* pCounter);
+
+/**
+ * @brief Runs queued main-thread jobs until the queue is empty or budgetMs is spent.
+ *
+ * @param budgetMs Time budget in milliseconds, 0 or less = no limit.
+ * @return Number of jobs run.
+ */
+uint32_t JobSystem_RunMainThreadJobs(double budgetMs);
+
+uint32_t JobSystem_GetThreadCount();
+int32_t JobSystem_GetThreadIndex();			// -1 for threads the job system did not start
+bool JobSystem_IsMainThread();
+void JobSystem_GetStats(SJobSystemStats* pStats);
+
+double JobSystem_GetTimeMs();				// Monotonic clock for budgets and profiling
+
+JobSystem GetJobSystem();
+
+#endif // __JOB_SYSTEM_H__
@@ -0,0 +1,161 @@
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE // madvise with CMAKE_C_EXTENSIONS OFF
+#endif
+
+#include "MappedFile.h"
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "Stdafx.h"
+
+bool MappedFile_Open(SMappedFile* pFile, const char* szPath)
+{
+	if (!pFile || !szPath)
+	{
+		syserr("pFile is NULL (invalid address)");
+		return (false);
+	}
+
+	memset(pFile, 0, sizeof(SMappedFile));
+
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE hFile = CreateFileA(szPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		syserr("Failed to open %s (error %lu)", szPath, GetLastError());
+		return (false);
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0)
+	{
+		syserr("Cannot map empty file %s", szPath);
+		CloseHandle(hFile);
+		return (false);
+	}
+
+	HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	if (!hMapping)
+	{
+		syserr("Failed to create a mapping for %s (error %lu)", szPath, GetLastError());
+		CloseHandle(hFile);
+		return (false);
+	}
+
+	void* pView = MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0);
+	if (!pView)
+	{
+		syserr("Failed to map %s (error %lu)", szPath, GetLastError());
+		CloseHandle(hMapping);
+		CloseHandle(hFile);
+		return (false);
+	}
+
+	pFile->hFile = hFile;
+	pFile->hMapping = hMapping;
+	pFile->pData = (uint8_t*)pView;
+	pFile->size = (size_t)fileSize.QuadPart;
+#else
+	int fd = open(szPath, O_RDONLY);
+	if (fd < 0)
+	{
+		syserr("Failed to open %s (%s)", szPath, strerror(errno));
+		return (false);
+	}
+
+	struct stat stats;
+	if (fstat(fd, &stats) != 0 || stats.st_size == 0)
+	{
+		syserr("Cannot map empty file %s", szPath);
+		close(fd);
+		return (false);
+	}
+
+	// Private + writable: edits copy only the touched pages, the file is never written
+	void* pView = mmap(NULL, (size_t)stats.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+	// The mapping keeps the file alive, the descriptor is not needed anymore
+	close(fd);
+
+	if (pView == MAP_FAILED)
+	{
+		syserr("Failed to map %s (%s)", szPath, strerror(errno));
+		return (false);
+	}
+
+	pFile->pData = (uint8_t*)pView;
+	pFile->size = (size_t)stats.st_size;
+#endif
+
+	return (true);
+}
+
+void MappedFile_Close(SMappedFile* pFile)
+{
+	if (!pFile || !pFile->pData)
+	{
+		return;
+	}
+
+#if defined(_WIN32) || defined(_WIN64)
+	UnmapViewOfFile(pFile->pData);
+	CloseHandle((HANDLE)pFile->hMapping);
+	CloseHandle((HANDLE)pFile->hFile);
+#else
+	munmap(pFile->pData, pFile->size);
+#endif
+
+	memset(pFile, 0, sizeof(SMappedFile));
+}
+
+bool MappedFile_IsOpen(const SMappedFile* pFile)
+{
+	return (pFile && pFile->pData);
+}
+
+void MappedFile_Advise(SMappedFile* pFile, size_t offset, size_t size, EMappedFileAdvice eAdvice)
+{
+	if (!MappedFile_IsOpen(pFile) || offset >= pFile->size)
+	{
+		return;
+	}
+
+	if (size == 0 || size > pFile->size - offset)
+	{
+		size = pFile->size - offset;
+	}
+
+#if defined(_WIN32) || defined(_WIN64)
+	// FILE_FLAG_SEQUENTIAL_SCAN already drives the read-ahead, the rest has no cheap equivalent
+	(void)eAdvice;
+#else
+	// madvise wants a page aligned start
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	size_t alignedOffset = offset & ~(pageSize - 1);
+	size += offset - alignedOffset;
+
+	int advice = MADV_NORMAL;
+	switch (eAdvice)
+	{
+	case MAPPED_FILE_ADVICE_SEQUENTIAL:
+		advice = MADV_SEQUENTIAL;
+		break;
+	case MAPPED_FILE_ADVICE_WILLNEED:
+		advice = MADV_WILLNEED;
+		break;
+	case MAPPED_FILE_ADVICE_DONTNEED:
+		advice = MADV_DONTNEED;
+		break;
+	default:
+		break;
+	}
+
+	// Only a hint, a failure changes nothing
+	madvise(pFile->pData + alignedOffset, size, advice);
+#endif
+}
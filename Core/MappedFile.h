@@ -0,0 +1,41 @@
+#ifndef __MAPPED_FILE_H__
+#define __MAPPED_FILE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum EMappedFileAdvice
+{
+	MAPPED_FILE_ADVICE_NORMAL,
+	MAPPED_FILE_ADVICE_SEQUENTIAL,	// Read front to back, aggressive read-ahead
+	MAPPED_FILE_ADVICE_WILLNEED,	// Start paging the range in now
+	MAPPED_FILE_ADVICE_DONTNEED,	// Range can leave memory, pages are read again on access (private edits are dropped)
+} EMappedFileAdvice;
+
+/**
+ * @brief A whole file mapped copy-on-write, writes stay private to the process.
+ *
+ * Clean pages are shared with the OS page cache, so mapping the same file again
+ * costs no read at all while it is cached.
+ */
+typedef struct SMappedFile
+{
+	uint8_t* pData;
+	size_t size;
+#if defined(_WIN32) || defined(_WIN64)
+	void* hFile;
+	void* hMapping;
+#endif
+} SMappedFile;
+
+bool MappedFile_Open(SMappedFile* pFile, const char* szPath);
+void MappedFile_Close(SMappedFile* pFile);
+bool MappedFile_IsOpen(const SMappedFile* pFile);
+
+/**
+ * @brief Paging hint for [offset, offset + size), size 0 = to the end of the file.
+ */
+void MappedFile_Advise(SMappedFile* pFile, size_t offset, size_t size, EMappedFileAdvice eAdvice);
+
+#endif // __MAPPED_FILE_H__
@@ -64,6 +64,12 @@ bool Engine_Initialize(Engine pEngine)
 		return (false);
 	}
 
+	if (!TexturesManager_Initialize(&pEngine->texturesManager))
+	{
+		Engine_Destroy(pEngine);
+		return (false);
+	}
+
 	if (!TerrainManager_Initialize(&pEngine->terrainManager))
 	{
 		Engine_Destroy(pEngine);
@@ -125,6 +131,13 @@ void Engine_HandleInput(Engine pEngine)
 
 void Engine_Update(Engine pEngine)
 {
+	// Recycle last-but-one frame's scratch memory before anything allocates
+	FrameAllocator_BeginFrame();
+	MemoryManager_BeginFrame();
+
+	// GL work queued by the workers (uploads, deletes)
+	JobSystem_RunMainThreadJobs(JOB_MAIN_THREAD_BUDGET_MS);
+
 	// 1. Time Update
 	float currentFrame = (float)glfwGetTime();
 	pEngine->deltaTime = currentFrame - pEngine->lastFrame;
@@ -176,6 +189,9 @@ void Engine_Destroy(Engine pEngine)
 
 	TerrainManager_Destroy(&pEngine->terrainManager);
 
+	// After every owner released its handles
+	TexturesManager_Destroy(&pEngine->texturesManager);
+
 	StateManager_Destroy(&pEngine->stateManager);
 
 	Camera_Destroy(&pEngine->camera);
@@ -17,6 +17,7 @@ typedef struct SInput* Input;
 typedef struct SDebugRenderer* DebugRenderer;
 typedef struct SStateManager* StateManager;
 typedef struct STerrainManager* TerrainManager;
+typedef struct STexturesManager* TexturesManager;
 
 typedef struct SEngine
 {
@@ -25,6 +26,7 @@ typedef struct SEngine
 	Input Input;
 	DebugRenderer debugRenderer;
 	StateManager stateManager;
+	TexturesManager texturesManager;
 	TerrainManager terrainManager;
 	float deltaTime;
 	float lastFrame;
@@ -19,6 +19,21 @@ int main(int argc, char* argv[])
 		return (false);
 	}
 
+	FrameAllocator frameAllocator;
+	if (!FrameAllocator_Initialize(&frameAllocator, FRAME_ARENA_DEFAULT_SIZE))
+	{
+		syserr("Failed to Initialize Frame Allocator");
+		return (false);
+	}
+
+	// Workers start before the engine so loading can already use them
+	JobSystem jobSystem;
+	if (!JobSystem_Initialize(&jobSystem, 0))
+	{
+		syserr("Failed to Initialize Job System");
+		return (false);
+	}
+
 	Engine engine = engine_new(SEngine, MEM_TAG_ENGINE);
 
 	if (!Engine_Initialize(engine))
@@ -34,6 +49,9 @@ int main(int argc, char* argv[])
 	Engine_Destroy(engine);
 	engine_delete(engine);
 
+	JobSystem_Destroy(&jobSystem);
+	FrameAllocator_Destroy(&frameAllocator);
+
 	MemoryManager_DumpLeaks();
 	MemoryManager_Destroy(&memoryManager);
 
@@ -45,6 +45,40 @@ bool FloatGrid_Initialize(FloatGrid* ppFloatGrid, int32_t width, int32_t height,
 	return (true);
 }
 
+bool FloatGrid_InitializeView(FloatGrid* ppFloatGrid, int32_t width, int32_t height, float* pData, EMemoryTag tag)
+{
+	if (width <= 0 || height <= 0 || !pData)
+	{
+		syserr("Cannot Create a view on 0 sized or NULL data");
+		return false;
+	}
+
+	if (ppFloatGrid == NULL)
+	{
+		syserr("ppFloatGrid is NULL (invalid address)");
+		return false;
+	}
+
+	*ppFloatGrid = engine_new_zero(SFloatGrid, 1, tag);
+
+	if (!(*ppFloatGrid))
+	{
+		syserr("Failed to Allocate Memory for Float Grid");
+		return false;
+	}
+
+	FloatGrid pFloatGrid = *ppFloatGrid;
+	pFloatGrid->width = width;
+	pFloatGrid->height = height;
+	pFloatGrid->size = width * height;
+	pFloatGrid->pArray = pData;
+	pFloatGrid->isView = true;
+
+	pFloatGrid->isInitialized = true;
+	pFloatGrid->isDirty = true;
+	return (true);
+}
+
 void FloatGrid_Destroy(FloatGrid* ppFloatGrid)
 {
 	if (!ppFloatGrid || !*ppFloatGrid)
@@ -54,13 +88,36 @@ void FloatGrid_Destroy(FloatGrid* ppFloatGrid)
 
 	FloatGrid pFloatGrid = *ppFloatGrid;
 
-	engine_delete(pFloatGrid->pArray);
+	if (!pFloatGrid->isView)
+	{
+		engine_delete(pFloatGrid->pArray);
+	}
 	pFloatGrid->pArray = NULL;
 
 	engine_delete(pFloatGrid);
 	*ppFloatGrid = NULL;
 }
 
+bool FloatGrid_MakeOwned(FloatGrid pFloatGrid, EMemoryTag tag)
+{
+	if (!pFloatGrid || !pFloatGrid->isView)
+	{
+		return (true);
+	}
+
+	float* pArray = (float*)engine_malloc(FloatGrid_GetBytesSize(pFloatGrid), tag);
+	if (!pArray)
+	{
+		syserr("Failed to Allocate Floats Array for Float Grid");
+		return (false);
+	}
+
+	memcpy(pArray, pFloatGrid->pArray, FloatGrid_GetBytesSize(pFloatGrid));
+	pFloatGrid->pArray = pArray;
+	pFloatGrid->isView = false;
+	return (true);
+}
+
 void FloatGrid_Clear(FloatGrid pFloatGrid)
 {
 	if (!pFloatGrid || !pFloatGrid->pArray)
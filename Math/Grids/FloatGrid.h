@@ -22,12 +22,15 @@ typedef struct SFloatGrid
 	int32_t size;
 	bool isInitialized;
 	bool isDirty;
+	bool isView; // pArray is borrowed (e.g. a file mapping) and is not freed with the grid
 } SFloatGrid;
 
 typedef struct SFloatGrid* FloatGrid;
 
 bool FloatGrid_Initialize(FloatGrid* ppFloatGrid, int32_t width, int32_t height, EMemoryTag tag);
+bool FloatGrid_InitializeView(FloatGrid* ppFloatGrid, int32_t width, int32_t height, float* pData, EMemoryTag tag);
 void FloatGrid_Destroy(FloatGrid* ppFloatGrid);
+bool FloatGrid_MakeOwned(FloatGrid pFloatGrid, EMemoryTag tag); // Copies a view into memory of its own, the backing can go away after
 void FloatGrid_Clear(FloatGrid pFloatGrid);
 void FloatGrid_FillValue(FloatGrid pFloatGrid, float fValue);
 float FloatGrid_GetAt(FloatGrid pFloatGrid, int32_t y, int32_t x);
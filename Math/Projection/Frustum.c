@@ -0,0 +1,58 @@
+#include "Frustum.h"
+
+SFrustum Frustum_FromViewProjection(Matrix4 viewProjection)
+{
+	// Row r of a column major matrix is m[r], m[4 + r], m[8 + r], m[12 + r]
+	const float* m = viewProjection.m;
+	float row[4][4];
+	for (int32_t r = 0; r < 4; r++)
+	{
+		row[r][0] = m[r];
+		row[r][1] = m[4 + r];
+		row[r][2] = m[8 + r];
+		row[r][3] = m[12 + r];
+	}
+
+	// Gribb / Hartmann: -w <= x, y, z <= w gives row3 +/- row0, row1, row2
+	SFrustum frustum;
+	for (int32_t iPlane = 0; iPlane < FRUSTUM_PLANE_COUNT; iPlane++)
+	{
+		const float* axis = row[iPlane / 2];
+		float sign = (iPlane % 2 == 0) ? 1.0f : -1.0f;
+
+		float a = row[3][0] + sign * axis[0];
+		float b = row[3][1] + sign * axis[1];
+		float c = row[3][2] + sign * axis[2];
+		float d = row[3][3] + sign * axis[3];
+
+		float length = sqrtf(a * a + b * b + c * c);
+		float invLength = (length > 0.0f) ? 1.0f / length : 0.0f;
+
+		frustum.planes[iPlane].x = a * invLength;
+		frustum.planes[iPlane].y = b * invLength;
+		frustum.planes[iPlane].z = c * invLength;
+		frustum.planes[iPlane].w = d * invLength;
+	}
+
+	return (frustum);
+}
+
+bool Frustum_IsBoxVisible(const SFrustum* pFrustum, Vector3 v3Min, Vector3 v3Max)
+{
+	for (int32_t iPlane = 0; iPlane < FRUSTUM_PLANE_COUNT; iPlane++)
+	{
+		const Vector4 plane = pFrustum->planes[iPlane];
+
+		// The corner furthest along the normal
+		float x = (plane.x >= 0.0f) ? v3Max.x : v3Min.x;
+		float y = (plane.y >= 0.0f) ? v3Max.y : v3Min.y;
+		float z = (plane.z >= 0.0f) ? v3Max.z : v3Min.z;
+
+		if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f)
+		{
+			return (false);
+		}
+	}
+
+	return (true);
+}
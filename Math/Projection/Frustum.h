@@ -0,0 +1,41 @@
+#ifndef __FRUSTUM_H__
+#define __FRUSTUM_H__
+
+#include <stdbool.h>
+#include "Math/Vectors/Vector3.h"
+#include "Math/Vectors/Vector4.h"
+#include "Math/Matrix/Matrix4.h"
+
+typedef enum EFrustumPlane
+{
+	FRUSTUM_PLANE_LEFT,
+	FRUSTUM_PLANE_RIGHT,
+	FRUSTUM_PLANE_BOTTOM,
+	FRUSTUM_PLANE_TOP,
+	FRUSTUM_PLANE_NEAR,
+	FRUSTUM_PLANE_FAR,
+	FRUSTUM_PLANE_COUNT
+} EFrustumPlane;
+
+/**
+ * Frustum: the six clip planes of a view projection, in world space.
+ *
+ * Each plane is (normal.xyz, distance) with the normal pointing inside and
+ * normalized, a point p is inside when dot(normal, p) + distance >= 0.
+ */
+typedef struct SFrustum
+{
+	Vector4 planes[FRUSTUM_PLANE_COUNT];
+} SFrustum;
+
+/**
+ * @brief Extracts the planes from a column major view projection (OpenGL clip space, z in [-w, w]).
+ */
+SFrustum Frustum_FromViewProjection(Matrix4 viewProjection);
+
+/**
+ * @brief Conservative box test, false only when the box is fully behind one plane.
+ */
+bool Frustum_IsBoxVisible(const SFrustum* pFrustum, Vector3 v3Min, Vector3 v3Max);
+
+#endif // __FRUSTUM_H__
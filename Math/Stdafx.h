@@ -17,6 +17,7 @@
 // Projections (Camera/Rendering)
 #include "Projection/OrthographicProjection.h"
 #include "Projection/PerspectiveProjection.h"
+#include "Projection/Frustum.h"
 
 // Spatial structures
 #include "Grids/FloatGrid.h"
@@ -1,5 +1,10 @@
 #include "TerrainMesh.h"
 #include "Stdafx.h"
+#include "Resources/PoolAllocator.h"
+
+#define TERRAIN_MESH_POOL_SLAB_COUNT 64 // one terrain worth of patch meshes
+
+static PoolAllocator s_pTerrainMeshPool = NULL;
 
 /**
  * @brief Creates a 3D mesh with reasonable initial capacity.
@@ -22,7 +27,12 @@ TerrainMesh TerrainMesh_Create(GLenum primitiveType)
 TerrainMesh TerrainMesh_CreateWithCapacity(GLenum primitiveType, GLsizeiptr vertexHint, GLsizeiptr indexHint)
 {
     // 1. Allocate and zero-initialize the struct
-    TerrainMesh mesh = engine_new_zero(STerrainMesh, 1, MEM_TAG_RESOURCES);
+    if (!TerrainMesh_InitializePool())
+    {
+        return NULL;
+    }
+
+    TerrainMesh mesh = pool_new_zero(s_pTerrainMeshPool, STerrainMesh);
 
     if (!mesh)
     {
@@ -30,11 +40,11 @@ TerrainMesh TerrainMesh_CreateWithCapacity(GLenum primitiveType, GLsizeiptr vert
         return NULL;
     }
 
-    // 2. Initialize dynamic arrays (Vector)
-    Vector_InitCapacity(&mesh->pVertices, sizeof(STerrainVertex), vertexHint, false);  // Initial capacity
-    Vector_InitCapacity(&mesh->pIndices, sizeof(GLuint), indexHint, false);    // Initial capacity
+    // 2. Initialize dynamic arrays (typed vectors embedded in the mesh)
+    AeroVector_STerrainVertex_Init(&mesh->vertices, MEM_TAG_RESOURCES);
+    AeroVector_uint32_t_Init(&mesh->indices, MEM_TAG_RESOURCES);
 
-    if (!mesh->pVertices || !mesh->pIndices)
+    if (!AeroVector_STerrainVertex_Reserve(&mesh->vertices, (size_t)vertexHint) || !AeroVector_uint32_t_Reserve(&mesh->indices, (size_t)indexHint))
     {
         syserr("Failed to create vertex/index vectors");
         TerrainMesh_Destroy(&mesh);  // Cleanup on failure
@@ -65,22 +75,35 @@ void TerrainMesh_Destroy(TerrainMesh* ppMesh)
     TerrainMesh mesh = *ppMesh;
 
     // 1. Free dynamic arrays
-    if (mesh->pVertices)
-    {
-        Vector_Destroy(&mesh->pVertices);
-    }
-    if (mesh->pIndices)
-    {
-        Vector_Destroy(&mesh->pIndices);
-    }
+    AeroVector_STerrainVertex_Destroy(&mesh->vertices);
+    AeroVector_uint32_t_Destroy(&mesh->indices);
 
     // 2. Free the struct itself
-    engine_delete(mesh);
+    pool_delete(s_pTerrainMeshPool, mesh);
 
     // 3. Set pointer to NULL (prevent double-free)
     *ppMesh = NULL;
 }
 
+/**
+ * @brief Creates the mesh pool up front, call it on one thread before meshes are built in parallel.
+ */
+bool TerrainMesh_InitializePool()
+{
+    if (!s_pTerrainMeshPool && !PoolAllocator_Initialize(&s_pTerrainMeshPool, "STerrainMesh", sizeof(STerrainMesh), TERRAIN_MESH_POOL_SLAB_COUNT, MEM_TAG_RESOURCES))
+    {
+        syserr("Failed to Initialize TerrainMesh Pool");
+        return (false);
+    }
+
+    return (true);
+}
+
+void TerrainMesh_DestroyPool()
+{
+    PoolAllocator_Destroy(&s_pTerrainMeshPool);
+}
+
 void TerrainMesh_PtrDestroy(TerrainMesh pTerrainMesh)
 {
     TerrainMesh* pMesh = *(TerrainMesh**)pTerrainMesh;  // Deref void* -> TerrainMesh*
@@ -90,16 +113,32 @@ void TerrainMesh_PtrDestroy(TerrainMesh pTerrainMesh)
     }
 }
 
-void TerrainMesh_AddVertex(TerrainMesh TerrainMesh, const STerrainVertex vertex)
+void TerrainMesh_Clear(TerrainMesh mesh)
 {
-    TerrainMesh->vertexCount += 1;
+    AeroVector_STerrainVertex_Clear(&mesh->vertices);
+    AeroVector_uint32_t_Clear(&mesh->indices);
 
-    Vector_PushBackValue(TerrainMesh->pVertices, vertex);
+    mesh->vertexCount = 0;
+    mesh->indexCount = 0;
 }
 
-void TerrainMesh_AddIndex(TerrainMesh TerrainMesh, const GLuint index)
+void TerrainVertex_EncodeNormal(Vector3 v3Normal, int16_t octNormal[2])
 {
-    TerrainMesh->indexCount += 1;
+    float sum = fabsf(v3Normal.x) + fabsf(v3Normal.y) + fabsf(v3Normal.z);
+    float u = (sum > 0.0f) ? v3Normal.x / sum : 0.0f;
+    float v = (sum > 0.0f) ? v3Normal.z / sum : 0.0f;
+
+    // The lower hemisphere folds over the diagonals (terrain normals rarely go there)
+    if (v3Normal.y < 0.0f)
+    {
+        float foldedU = (1.0f - fabsf(v)) * ((u >= 0.0f) ? 1.0f : -1.0f);
+        float foldedV = (1.0f - fabsf(u)) * ((v >= 0.0f) ? 1.0f : -1.0f);
+        u = foldedU;
+        v = foldedV;
+    }
 
-    Vector_PushBackValue(TerrainMesh->pIndices, index);
-}
\ No newline at end of file
+    u = (u > 1.0f) ? 1.0f : ((u < -1.0f) ? -1.0f : u);
+    v = (v > 1.0f) ? 1.0f : ((v < -1.0f) ? -1.0f : v);
+    octNormal[0] = (int16_t)(u * 32767.0f + ((u >= 0.0f) ? 0.5f : -0.5f));
+    octNormal[1] = (int16_t)(v * 32767.0f + ((v >= 0.0f) ? 0.5f : -0.5f));
+}
@@ -6,8 +6,32 @@
 #include "../Math/Vectors/Vector2.h"
 #include "../Math/Vectors/Vector3.h"
 #include "../Math/Vectors/Vector4.h"
-#include "AeroLib/Vector.h"
+#include "AeroLib/TypedVector.h"
 
+// Layout compiled in, see the AERO_TERRAIN_COMPACT_VERTEX CMake option
+#ifndef TERRAIN_COMPACT_VERTEX
+#define TERRAIN_COMPACT_VERTEX 1
+#endif
+
+// Patches keep no vertices, terrain_shader_pull.vert rebuilds them (AERO_TERRAIN_VERTEX_PULLING)
+#ifndef TERRAIN_VERTEX_PULLING
+#define TERRAIN_VERTEX_PULLING 1
+#endif
+
+#if TERRAIN_COMPACT_VERTEX
+/**
+ * @brief 8 bytes, everything else comes from the terrain and patch SSBOs.
+ *
+ * The shader reads the height from the heightmap SSBO and derives the world
+ * position, UVs and debug color from the grid position and the patch.
+ */
+typedef struct STerrainVertex
+{
+	uint16_t gridX;			// Vertex column inside the terrain (0..XSIZE)
+	uint16_t gridZ;			// Vertex row inside the terrain (0..ZSIZE)
+	int16_t octNormal[2];	// Octahedral normal around +Y, snorm16
+} STerrainVertex;
+#else
 typedef struct STerrainVertex
 {
 	Vector3 v3Position;		// World position
@@ -15,6 +39,9 @@ typedef struct STerrainVertex
 	Vector2 v2TexCoords;	// UVs (For Texturing)
 	Vector4 v4Color;		// Color
 } STerrainVertex;
+#endif
+
+AERO_VECTOR_DEFINE(STerrainVertex)
 
 typedef struct STerrainMesh
 {
@@ -35,9 +62,9 @@ typedef struct STerrainMesh
 	bool bDirty;			// True when vertices/indices modified, needs GPU upload
 	int32_t meshMatrixIndex;
 
-	// Shape Data
-	Vector pVertices;
-	Vector pIndices;
+	// Shape Data (typed, so the per-patch push loops stay inline)
+	SAeroVector_STerrainVertex vertices;
+	SAeroVector_uint32_t indices;
 } STerrainMesh;
 
 typedef struct STerrainMesh* TerrainMesh;
@@ -60,8 +87,28 @@ TerrainMesh TerrainMesh_Create(GLenum primitiveType);
 TerrainMesh TerrainMesh_CreateWithCapacity(GLenum primitiveType, GLsizeiptr vertexHint, GLsizeiptr indexHint);
 void TerrainMesh_Destroy(TerrainMesh* ppMesh);
 void TerrainMesh_PtrDestroy(TerrainMesh pTerrainMesh);
+bool TerrainMesh_InitializePool();
+void TerrainMesh_DestroyPool(); // call once every terrain mesh is gone
 
-void TerrainMesh_AddVertex(TerrainMesh TerrainMesh, const STerrainVertex vertex);
-void TerrainMesh_AddIndex(TerrainMesh TerrainMesh, const GLuint index);
+void TerrainMesh_Clear(TerrainMesh mesh);
+
+/**
+ * @brief Folds a normal onto the octahedron around +Y (x, z in the plane), snorm16 per axis.
+ *
+ * The projection divides by the L1 length, so the normal does not need to be normalized first.
+ */
+void TerrainVertex_EncodeNormal(Vector3 v3Normal, int16_t octNormal[2]);
+
+static inline void TerrainMesh_AddVertex(TerrainMesh mesh, const STerrainVertex vertex)
+{
+	AeroVector_STerrainVertex_PushBack(&mesh->vertices, vertex);
+	mesh->vertexCount = (GLsizeiptr)mesh->vertices.count;
+}
+
+static inline void TerrainMesh_AddIndex(TerrainMesh mesh, const GLuint index)
+{
+	AeroVector_uint32_t_PushBack(&mesh->indices, index);
+	mesh->indexCount = (GLsizeiptr)mesh->indices.count;
+}
 
 #endif // __TERRAIN_MESH__
@@ -187,6 +187,8 @@ bool Texture_LoadImage(Texture pTexture, const char* szTexturePath)
 	{
 		engine_delete(pTexture->imageData.szTexturePath);
 		engine_delete(pTexture->imageData.szTextureName);
+		pTexture->imageData.szTexturePath = NULL; // Texture_Destroy runs next
+		pTexture->imageData.szTextureName = NULL;
 
 		syserr("Failed to load stb image");
 		return (false);
@@ -232,7 +232,7 @@ void InitializeDebuggingMeshes(DebugRenderer pDebugRenderer, EDebugPrimitiveType
 	// Upload indirect commands
 	IndirectBufferObject_Upload(group->pIndirectBuffer);
 
-	syslog("Initialized %d debug meshes", (GLint)group->pIndirectBuffer->commands->count);
+	syslog("Initialized %d debug meshes", (GLint)group->pIndirectBuffer->commands.count);
 
 	// reset back to white
 	SetRenderColor(pDebugRenderer, Vector4D(1.0f, 1.0f, 1.0f, 1.0f));
@@ -0,0 +1,208 @@
+#include "HiZBuffer.h"
+#include "Stdafx.h"
+#include "../PipeLine/Utils.h"
+#include "../PipeLine/StateManager.h"
+
+bool HiZBuffer_Initialize(HiZBuffer* ppHiZBuffer)
+{
+	if (ppHiZBuffer == NULL)
+	{
+		syserr("ppHiZBuffer is NULL (invalid address)");
+		return (false);
+	}
+
+	*ppHiZBuffer = engine_new_zero(SHiZBuffer, 1, MEM_TAG_RENDERING);
+
+	HiZBuffer pHiZBuffer = *ppHiZBuffer;
+	if (!pHiZBuffer)
+	{
+		syserr("Failed to Allocate HiZ Buffer");
+		return (false);
+	}
+
+	if (!Shader_Initialize(&pHiZBuffer->pBuildShader, "HiZ Build Shader"))
+	{
+		syserr("Failed to Create HiZ Build Shader");
+		HiZBuffer_Destroy(ppHiZBuffer);
+		return (false);
+	}
+
+	Shader_SetInjection(pHiZBuffer->pBuildShader, true);
+	Shader_AttachShader(pHiZBuffer->pBuildShader, "Assets/Shaders/hiz_build.comp");
+	Shader_LinkProgram(pHiZBuffer->pBuildShader);
+
+	glCreateQueries(GL_TIME_ELAPSED, 2, pHiZBuffer->timerQueries);
+
+	return (true);
+}
+
+void HiZBuffer_Destroy(HiZBuffer* ppHiZBuffer)
+{
+	if (!ppHiZBuffer || !*ppHiZBuffer)
+	{
+		return;
+	}
+
+	HiZBuffer pHiZBuffer = *ppHiZBuffer;
+
+	if (pHiZBuffer->pBuildShader)
+	{
+		Shader_Destroy(&pHiZBuffer->pBuildShader);
+	}
+	if (pHiZBuffer->timerQueries[0])
+	{
+		glDeleteQueries(2, pHiZBuffer->timerQueries);
+	}
+	GL_DeleteTexture(&pHiZBuffer->depthTexture);
+	GL_DeleteTexture(&pHiZBuffer->pyramidTexture);
+
+	engine_delete(pHiZBuffer);
+
+	*ppHiZBuffer = NULL;
+}
+
+/**
+ * @brief Recreates the depth copy and the pyramid for a new viewport size.
+ */
+static bool HiZBuffer_Resize(HiZBuffer pHiZBuffer, int32_t width, int32_t height)
+{
+	pHiZBuffer->bValid = false;
+	pHiZBuffer->width = 0;
+	pHiZBuffer->height = 0;
+
+	int32_t levelCount = 1;
+	while (((width | height) >> levelCount) > 0)
+	{
+		levelCount++;
+	}
+
+	if (!GL_CreateTexture(&pHiZBuffer->depthTexture, GL_TEXTURE_2D) ||
+		!GL_CreateTexture(&pHiZBuffer->pyramidTexture, GL_TEXTURE_2D))
+	{
+		syserr("Failed to Create HiZ Textures");
+		return (false);
+	}
+
+	glTextureStorage2D(pHiZBuffer->depthTexture, 1, GL_DEPTH_COMPONENT32F, width, height);
+	glTextureParameteri(pHiZBuffer->depthTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTextureParameteri(pHiZBuffer->depthTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glTextureStorage2D(pHiZBuffer->pyramidTexture, levelCount, GL_R32F, width, height);
+	glTextureParameteri(pHiZBuffer->pyramidTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTextureParameteri(pHiZBuffer->pyramidTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	pHiZBuffer->width = width;
+	pHiZBuffer->height = height;
+	pHiZBuffer->levelCount = levelCount;
+
+	return (true);
+}
+
+// Takes the GPU time of the build that last used the current query, if it finished
+static void HiZBuffer_ReadTimer(HiZBuffer pHiZBuffer)
+{
+	int32_t index = pHiZBuffer->queryIndex;
+	if (!pHiZBuffer->bQueryPending[index])
+	{
+		return;
+	}
+
+	GLint available = 0;
+	glGetQueryObjectiv(pHiZBuffer->timerQueries[index], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (available)
+	{
+		GLuint64 elapsedNs = 0;
+		glGetQueryObjectui64v(pHiZBuffer->timerQueries[index], GL_QUERY_RESULT, &elapsedNs);
+		pHiZBuffer->buildMs = (double)elapsedNs / 1000000.0;
+	}
+
+	pHiZBuffer->bQueryPending[index] = false;
+}
+
+void HiZBuffer_Build(HiZBuffer pHiZBuffer, Matrix4 viewProjection)
+{
+	if (!pHiZBuffer)
+	{
+		return;
+	}
+
+	double startMs = JobSystem_GetTimeMs();
+
+	GLint viewport[4] = { 0, 0, 0, 0 };
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	if (viewport[2] <= 0 || viewport[3] <= 0)
+	{
+		return;
+	}
+
+	if ((viewport[2] != pHiZBuffer->width || viewport[3] != pHiZBuffer->height) && !HiZBuffer_Resize(pHiZBuffer, viewport[2], viewport[3]))
+	{
+		return;
+	}
+
+	HiZBuffer_ReadTimer(pHiZBuffer);
+	glBeginQuery(GL_TIME_ELAPSED, pHiZBuffer->timerQueries[pHiZBuffer->queryIndex]);
+
+	// The depth of the framebuffer the frame was drawn into
+	GLint drawFramebuffer = 0;
+	GLint readFramebuffer = 0;
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFramebuffer);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)drawFramebuffer);
+	glCopyTextureSubImage2D(pHiZBuffer->depthTexture, 0, 0, 0, viewport[0], viewport[1], viewport[2], viewport[3]);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)readFramebuffer);
+
+	// Level 0 copies the depth, every level after reduces the one below
+	StateManager_BindShader(GetStateManager(), pHiZBuffer->pBuildShader);
+	for (int32_t iLevel = 0; iLevel < pHiZBuffer->levelCount; iLevel++)
+	{
+		GLuint levelWidth = (GLuint)(pHiZBuffer->width >> iLevel);
+		GLuint levelHeight = (GLuint)(pHiZBuffer->height >> iLevel);
+		levelWidth = (levelWidth > 0) ? levelWidth : 1;
+		levelHeight = (levelHeight > 0) ? levelHeight : 1;
+
+		glBindTextureUnit(HIZ_TEXTURE_UNIT, (iLevel == 0) ? pHiZBuffer->depthTexture : pHiZBuffer->pyramidTexture);
+		glBindImageTexture(0, pHiZBuffer->pyramidTexture, iLevel, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+		Shader_SetInt(pHiZBuffer->pBuildShader, "u_hizSourceLevel", iLevel - 1);
+
+		glDispatchCompute((levelWidth + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, (levelHeight + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, 1);
+		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+	}
+
+	glEndQuery(GL_TIME_ELAPSED);
+	pHiZBuffer->bQueryPending[pHiZBuffer->queryIndex] = true;
+	pHiZBuffer->queryIndex ^= 1;
+
+	pHiZBuffer->viewProjection = viewProjection;
+	pHiZBuffer->bValid = true;
+	pHiZBuffer->submitMs = JobSystem_GetTimeMs() - startMs;
+}
+
+void HiZBuffer_Invalidate(HiZBuffer pHiZBuffer)
+{
+	if (!pHiZBuffer)
+	{
+		return;
+	}
+
+	pHiZBuffer->bValid = false;
+}
+
+void HiZBuffer_Bind(HiZBuffer pHiZBuffer, GLShader pShader)
+{
+	if (!pHiZBuffer || !pShader)
+	{
+		return;
+	}
+
+	if (!pHiZBuffer->bValid)
+	{
+		Shader_SetInt(pShader, "u_hizLevelCount", 0);
+		return;
+	}
+
+	glBindTextureUnit(HIZ_TEXTURE_UNIT, pHiZBuffer->pyramidTexture);
+	Shader_SetInt(pShader, "u_hizLevelCount", pHiZBuffer->levelCount);
+	Shader_SetVec2(pShader, "u_hizSize", Vector2Di(pHiZBuffer->width, pHiZBuffer->height));
+	Shader_SetMat4(pShader, "u_hizViewProjection", pHiZBuffer->viewProjection);
+}
@@ -0,0 +1,59 @@
+#ifndef __HIZ_BUFFER_H__
+#define __HIZ_BUFFER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <glad/glad.h>
+#include "../PipeLine/Shader.h"
+#include "../Math/Matrix/Matrix4.h"
+
+#define HIZ_GROUP_SIZE 8		// local_size_x and local_size_y of Assets/Shaders/hiz_build.comp
+#define HIZ_TEXTURE_UNIT 7		// Sampler binding of u_hizPyramid in the shaders testing against the pyramid
+
+/**
+ * @brief A depth pyramid (Hi-Z) of the last frame, for occlusion tests against it.
+ *
+ * HiZBuffer_Build copies the depth of the bound framebuffer once the frame is
+ * drawn, level 0 is that depth and every level above keeps the farthest depth
+ * of the 2x2 (3x3 on odd edges) texels under it. A box whose nearest depth is
+ * behind the farthest depth of the texels covering it was hidden last frame.
+ */
+typedef struct SHiZBuffer
+{
+	GLShader pBuildShader;
+	GLuint depthTexture;		// Copy of the framebuffer depth, level 0 is built from it
+	GLuint pyramidTexture;		// R32F, full mip chain
+	int32_t width;
+	int32_t height;
+	int32_t levelCount;
+
+	Matrix4 viewProjection;		// Camera the pyramid was built with, the tests project the boxes with it
+	bool bValid;				// Cleared on resize and by HiZBuffer_Invalidate, the tests pass everything until the next build
+
+	// Build cost, the GPU time is read two frames later without waiting
+	GLuint timerQueries[2];
+	int32_t queryIndex;
+	bool bQueryPending[2];
+	double buildMs;				// GPU time of the last build that finished
+	double submitMs;			// CPU time of the last build call
+} SHiZBuffer;
+
+typedef struct SHiZBuffer* HiZBuffer;
+
+bool HiZBuffer_Initialize(HiZBuffer* ppHiZBuffer);
+void HiZBuffer_Destroy(HiZBuffer* ppHiZBuffer);
+
+/**
+ * @brief Rebuilds the pyramid from the depth of the bound draw framebuffer (viewport sized).
+ */
+void HiZBuffer_Build(HiZBuffer pHiZBuffer, Matrix4 viewProjection);
+void HiZBuffer_Invalidate(HiZBuffer pHiZBuffer);
+
+/**
+ * @brief Binds the pyramid to HIZ_TEXTURE_UNIT and sets the u_hiz uniforms of a shader testing against it.
+ *
+ * u_hizLevelCount is 0 while the pyramid is not valid, the shader must then treat everything as visible.
+ */
+void HiZBuffer_Bind(HiZBuffer pHiZBuffer, GLShader pShader);
+
+#endif // __HIZ_BUFFER_H__
@@ -0,0 +1,374 @@
+#include "TerrainCDLOD.h"
+#include "Stdafx.h"
+#include "../Terrain/Terrain/Terrain.h"
+#include "../Terrain/TerrainPatch.h"
+#include <float.h>
+
+// Distance ranges of every level for one selection, the root takes whatever is left
+typedef struct STerrainCDLODSelection
+{
+	Vector3 v3Camera;
+	const SFrustum* pFrustum;
+	float ranges[TERRAIN_CDLOD_MAX_LEVELS];
+	bool bFull;
+} STerrainCDLODSelection;
+
+bool TerrainCDLOD_Initialize(STerrainCDLOD* pTree, int32_t terrainsXCount, int32_t terrainsZCount)
+{
+	if (!pTree)
+	{
+		syserr("pTree is NULL (invalid address)");
+		return (false);
+	}
+
+	memset(pTree, 0, sizeof(STerrainCDLOD));
+
+	if (terrainsXCount <= 0 || terrainsZCount <= 0)
+	{
+		syserr("Invalid CDLOD map size %dx%d", terrainsXCount, terrainsZCount);
+		return (false);
+	}
+
+	pTree->terrainsXCount = terrainsXCount;
+	pTree->terrainsZCount = terrainsZCount;
+	pTree->leafRange = TERRAIN_CDLOD_LEAF_RANGE;
+
+	// Halve the leaf grid until one root covers it
+	uint32_t nodeCount = 0;
+	int32_t xCount = terrainsXCount * PATCH_XCOUNT;
+	int32_t zCount = terrainsZCount * PATCH_ZCOUNT;
+	for (;;)
+	{
+		if (pTree->levelCount == TERRAIN_CDLOD_MAX_LEVELS)
+		{
+			syserr("CDLOD map %dx%d needs more than %d levels", terrainsXCount, terrainsZCount, TERRAIN_CDLOD_MAX_LEVELS);
+			return (false);
+		}
+
+		pTree->levelXCount[pTree->levelCount] = xCount;
+		pTree->levelZCount[pTree->levelCount] = zCount;
+		pTree->levelOffset[pTree->levelCount] = nodeCount;
+		pTree->levelCount++;
+		nodeCount += (uint32_t)(xCount * zCount);
+
+		if (xCount == 1 && zCount == 1)
+		{
+			break;
+		}
+
+		xCount = (xCount + 1) / 2;
+		zCount = (zCount + 1) / 2;
+	}
+
+	pTree->pMinHeights = engine_new_zero(float, nodeCount, MEM_TAG_RENDERING);
+	pTree->pMaxHeights = engine_new_zero(float, nodeCount, MEM_TAG_RENDERING);
+	pTree->pResidentLeaves = engine_new_zero(uint32_t, nodeCount, MEM_TAG_RENDERING);
+	pTree->pTerrainSlots = engine_new_zero(int32_t, terrainsXCount * terrainsZCount, MEM_TAG_RENDERING);
+	pTree->pNodes = engine_new_zero(STerrainCDLODNode, TERRAIN_CDLOD_MAX_NODES, MEM_TAG_RENDERING);
+	if (!pTree->pMinHeights || !pTree->pMaxHeights || !pTree->pResidentLeaves || !pTree->pTerrainSlots || !pTree->pNodes)
+	{
+		syserr("Failed to Allocate %u CDLOD Nodes", nodeCount);
+		TerrainCDLOD_Destroy(pTree);
+		return (false);
+	}
+
+	TerrainCDLOD_Clear(pTree);
+	return (true);
+}
+
+void TerrainCDLOD_Destroy(STerrainCDLOD* pTree)
+{
+	if (!pTree)
+	{
+		return;
+	}
+
+	if (pTree->pMinHeights)
+	{
+		engine_delete(pTree->pMinHeights);
+	}
+	if (pTree->pMaxHeights)
+	{
+		engine_delete(pTree->pMaxHeights);
+	}
+	if (pTree->pResidentLeaves)
+	{
+		engine_delete(pTree->pResidentLeaves);
+	}
+	if (pTree->pTerrainSlots)
+	{
+		engine_delete(pTree->pTerrainSlots);
+	}
+	if (pTree->pNodes)
+	{
+		engine_delete(pTree->pNodes);
+	}
+
+	memset(pTree, 0, sizeof(STerrainCDLOD));
+}
+
+void TerrainCDLOD_Clear(STerrainCDLOD* pTree)
+{
+	if (!pTree || !pTree->pMinHeights)
+	{
+		return;
+	}
+
+	uint32_t nodeCount = pTree->levelOffset[pTree->levelCount - 1] + 1;
+	for (uint32_t i = 0; i < nodeCount; i++)
+	{
+		pTree->pMinHeights[i] = FLT_MAX;
+		pTree->pMaxHeights[i] = -FLT_MAX;
+	}
+	memset(pTree->pResidentLeaves, 0, nodeCount * sizeof(uint32_t));
+
+	for (int32_t i = 0; i < pTree->terrainsXCount * pTree->terrainsZCount; i++)
+	{
+		pTree->pTerrainSlots[i] = -1;
+	}
+	pTree->bSlotsDirty = true;
+
+	pTree->fullCount = 0;
+	pTree->halfCount = 0;
+}
+
+// Rebuilds the nodes above the leaves [x0, x1] x [z0, z1] from their children
+static void TerrainCDLOD_UpdateParents(STerrainCDLOD* pTree, int32_t x0, int32_t z0, int32_t x1, int32_t z1)
+{
+	for (int32_t level = 1; level < pTree->levelCount; level++)
+	{
+		x0 >>= 1;
+		z0 >>= 1;
+		x1 >>= 1;
+		z1 >>= 1;
+
+		int32_t childXCount = pTree->levelXCount[level - 1];
+		int32_t childZCount = pTree->levelZCount[level - 1];
+		uint32_t childOffset = pTree->levelOffset[level - 1];
+
+		for (int32_t z = z0; z <= z1; z++)
+		{
+			for (int32_t x = x0; x <= x1; x++)
+			{
+				float minHeight = FLT_MAX;
+				float maxHeight = -FLT_MAX;
+				uint32_t residentLeaves = 0;
+
+				for (int32_t iChild = 0; iChild < 4; iChild++)
+				{
+					int32_t childX = x * 2 + (iChild & 1);
+					int32_t childZ = z * 2 + (iChild >> 1);
+					if (childX >= childXCount || childZ >= childZCount)
+					{
+						continue;
+					}
+
+					uint32_t child = childOffset + (uint32_t)(childZ * childXCount + childX);
+					minHeight = fminf(minHeight, pTree->pMinHeights[child]);
+					maxHeight = fmaxf(maxHeight, pTree->pMaxHeights[child]);
+					residentLeaves += pTree->pResidentLeaves[child];
+				}
+
+				uint32_t node = pTree->levelOffset[level] + (uint32_t)(z * pTree->levelXCount[level] + x);
+				pTree->pMinHeights[node] = minHeight;
+				pTree->pMaxHeights[node] = maxHeight;
+				pTree->pResidentLeaves[node] = residentLeaves;
+			}
+		}
+	}
+}
+
+void TerrainCDLOD_SetTerrain(STerrainCDLOD* pTree, const struct STerrain* pTerrain)
+{
+	if (!pTree || !pTree->pMinHeights || !pTerrain)
+	{
+		return;
+	}
+
+	int32_t iTerrainX = pTerrain->terrainXCoord;
+	int32_t iTerrainZ = pTerrain->terrainZCoord;
+	if (iTerrainX < 0 || iTerrainZ < 0 || iTerrainX >= pTree->terrainsXCount || iTerrainZ >= pTree->terrainsZCount)
+	{
+		return;
+	}
+
+	int32_t leafX = iTerrainX * PATCH_XCOUNT;
+	int32_t leafZ = iTerrainZ * PATCH_ZCOUNT;
+	for (int32_t iPatchZ = 0; iPatchZ < PATCH_ZCOUNT; iPatchZ++)
+	{
+		for (int32_t iPatchX = 0; iPatchX < PATCH_XCOUNT; iPatchX++)
+		{
+			TerrainPatch pPatch = Vector_GetPtr(pTerrain->terrainPatches, iPatchZ * PATCH_XCOUNT + iPatchX);
+			uint32_t leaf = (uint32_t)((leafZ + iPatchZ) * pTree->levelXCount[0] + leafX + iPatchX);
+
+			pTree->pMinHeights[leaf] = (pPatch) ? pPatch->minHeight : FLT_MAX;
+			pTree->pMaxHeights[leaf] = (pPatch) ? pPatch->maxHeight : -FLT_MAX;
+			pTree->pResidentLeaves[leaf] = (pPatch) ? 1u : 0u;
+		}
+	}
+
+	pTree->pTerrainSlots[iTerrainZ * pTree->terrainsXCount + iTerrainX] = pTerrain->gpuSlot;
+	pTree->bSlotsDirty = true;
+
+	TerrainCDLOD_UpdateParents(pTree, leafX, leafZ, leafX + PATCH_XCOUNT - 1, leafZ + PATCH_ZCOUNT - 1);
+}
+
+void TerrainCDLOD_ClearTerrain(STerrainCDLOD* pTree, int32_t iTerrainX, int32_t iTerrainZ)
+{
+	if (!pTree || !pTree->pMinHeights || iTerrainX < 0 || iTerrainZ < 0 || iTerrainX >= pTree->terrainsXCount || iTerrainZ >= pTree->terrainsZCount)
+	{
+		return;
+	}
+
+	int32_t leafX = iTerrainX * PATCH_XCOUNT;
+	int32_t leafZ = iTerrainZ * PATCH_ZCOUNT;
+	for (int32_t iPatchZ = 0; iPatchZ < PATCH_ZCOUNT; iPatchZ++)
+	{
+		for (int32_t iPatchX = 0; iPatchX < PATCH_XCOUNT; iPatchX++)
+		{
+			uint32_t leaf = (uint32_t)((leafZ + iPatchZ) * pTree->levelXCount[0] + leafX + iPatchX);
+			pTree->pMinHeights[leaf] = FLT_MAX;
+			pTree->pMaxHeights[leaf] = -FLT_MAX;
+			pTree->pResidentLeaves[leaf] = 0;
+		}
+	}
+
+	pTree->pTerrainSlots[iTerrainZ * pTree->terrainsXCount + iTerrainX] = -1;
+	pTree->bSlotsDirty = true;
+
+	TerrainCDLOD_UpdateParents(pTree, leafX, leafZ, leafX + PATCH_XCOUNT - 1, leafZ + PATCH_ZCOUNT - 1);
+}
+
+int32_t TerrainCDLOD_GetTerrainSlot(const STerrainCDLOD* pTree, int32_t iTerrainX, int32_t iTerrainZ)
+{
+	if (!pTree || !pTree->pTerrainSlots || iTerrainX < 0 || iTerrainZ < 0 || iTerrainX >= pTree->terrainsXCount || iTerrainZ >= pTree->terrainsZCount)
+	{
+		return (-1);
+	}
+
+	return (pTree->pTerrainSlots[iTerrainZ * pTree->terrainsXCount + iTerrainX]);
+}
+
+static void TerrainCDLOD_GetNodeBox(const STerrainCDLOD* pTree, int32_t level, int32_t x, int32_t z, Vector3* pMin, Vector3* pMax)
+{
+	uint32_t node = pTree->levelOffset[level] + (uint32_t)(z * pTree->levelXCount[level] + x);
+	float nodeSize = (float)(PATCH_SIZE * ENGINE_CELL_SIZE * (1 << level));
+
+	*pMin = Vector3D((float)x * nodeSize, pTree->pMinHeights[node], (float)z * nodeSize);
+	*pMax = Vector3D((float)(x + 1) * nodeSize, pTree->pMaxHeights[node], (float)(z + 1) * nodeSize);
+}
+
+static bool TerrainCDLOD_IsBoxInRange(Vector3 v3Min, Vector3 v3Max, Vector3 v3Camera, float range)
+{
+	float dx = fmaxf(fmaxf(v3Min.x - v3Camera.x, v3Camera.x - v3Max.x), 0.0f);
+	float dy = fmaxf(fmaxf(v3Min.y - v3Camera.y, v3Camera.y - v3Max.y), 0.0f);
+	float dz = fmaxf(fmaxf(v3Min.z - v3Camera.z, v3Camera.z - v3Max.z), 0.0f);
+	return (dx * dx + dy * dy + dz * dz <= range * range);
+}
+
+// Full nodes grow from the front of pNodes, half nodes from the back, TerrainCDLOD_Select packs them
+static void TerrainCDLOD_AddNode(STerrainCDLOD* pTree, STerrainCDLODSelection* pSelection, int32_t level, int32_t x, int32_t z, int32_t drawLevel)
+{
+	if (pTree->fullCount + pTree->halfCount >= TERRAIN_CDLOD_MAX_NODES)
+	{
+		pSelection->bFull = true;
+		return;
+	}
+
+	float nodeSize = (float)(PATCH_SIZE * ENGINE_CELL_SIZE * (1 << level));
+	STerrainCDLODNode* pNode = (drawLevel == level) ? &pTree->pNodes[pTree->fullCount++] : &pTree->pNodes[TERRAIN_CDLOD_MAX_NODES - ++pTree->halfCount];
+
+	pNode->originX = (float)x * nodeSize;
+	pNode->originZ = (float)z * nodeSize;
+	pNode->vertexSpacing = nodeSize / (float)PATCH_SIZE;
+	pNode->level = (float)drawLevel;
+}
+
+// False when a complete node is out of its level's range, its parent then draws the area at the parent's resolution
+static bool TerrainCDLOD_SelectNode(STerrainCDLOD* pTree, STerrainCDLODSelection* pSelection, int32_t level, int32_t x, int32_t z)
+{
+	if (x >= pTree->levelXCount[level] || z >= pTree->levelZCount[level])
+	{
+		return (true);
+	}
+
+	uint32_t node = pTree->levelOffset[level] + (uint32_t)(z * pTree->levelXCount[level] + x);
+	uint32_t residentLeaves = pTree->pResidentLeaves[node];
+	if (residentLeaves == 0)
+	{
+		return (true);
+	}
+
+	// Incomplete nodes (map edge or terrains still streaming) are always split down to what is resident
+	bool bComplete = (residentLeaves == 1u << (2 * level));
+
+	Vector3 v3Min, v3Max;
+	TerrainCDLOD_GetNodeBox(pTree, level, x, z, &v3Min, &v3Max);
+
+	if (bComplete && !TerrainCDLOD_IsBoxInRange(v3Min, v3Max, pSelection->v3Camera, pSelection->ranges[level]))
+	{
+		return (false);
+	}
+
+	if (!Frustum_IsBoxVisible(pSelection->pFrustum, v3Min, v3Max))
+	{
+		return (true);
+	}
+
+	if (bComplete && (level == 0 || !TerrainCDLOD_IsBoxInRange(v3Min, v3Max, pSelection->v3Camera, pSelection->ranges[level - 1])))
+	{
+		TerrainCDLOD_AddNode(pTree, pSelection, level, x, z, level);
+		return (true);
+	}
+
+	for (int32_t iChild = 0; iChild < 4; iChild++)
+	{
+		int32_t childX = x * 2 + (iChild & 1);
+		int32_t childZ = z * 2 + (iChild >> 1);
+		if (TerrainCDLOD_SelectNode(pTree, pSelection, level - 1, childX, childZ))
+		{
+			continue;
+		}
+
+		Vector3 v3ChildMin, v3ChildMax;
+		TerrainCDLOD_GetNodeBox(pTree, level - 1, childX, childZ, &v3ChildMin, &v3ChildMax);
+		if (Frustum_IsBoxVisible(pSelection->pFrustum, v3ChildMin, v3ChildMax))
+		{
+			TerrainCDLOD_AddNode(pTree, pSelection, level - 1, childX, childZ, level);
+		}
+	}
+
+	return (true);
+}
+
+uint32_t TerrainCDLOD_Select(STerrainCDLOD* pTree, Vector3 v3Camera, const SFrustum* pFrustum)
+{
+	if (!pTree || !pTree->pMinHeights || !pFrustum)
+	{
+		return (0);
+	}
+
+	STerrainCDLODSelection selection;
+	selection.v3Camera = v3Camera;
+	selection.pFrustum = pFrustum;
+	selection.bFull = false;
+	for (int32_t level = 0; level < pTree->levelCount; level++)
+	{
+		selection.ranges[level] = pTree->leafRange * (float)(1 << level);
+	}
+	selection.ranges[pTree->levelCount - 1] = FLT_MAX;
+
+	pTree->fullCount = 0;
+	pTree->halfCount = 0;
+	TerrainCDLOD_SelectNode(pTree, &selection, pTree->levelCount - 1, 0, 0);
+
+	if (selection.bFull)
+	{
+		syslog("CDLOD selection is over %d nodes, the rest is not drawn", TERRAIN_CDLOD_MAX_NODES);
+	}
+
+	// Half nodes right after the full ones, one instance range each
+	memmove(&pTree->pNodes[pTree->fullCount], &pTree->pNodes[TERRAIN_CDLOD_MAX_NODES - pTree->halfCount], pTree->halfCount * sizeof(STerrainCDLODNode));
+
+	return (pTree->fullCount + pTree->halfCount);
+}
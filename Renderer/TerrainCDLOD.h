@@ -0,0 +1,77 @@
+#ifndef __TERRAIN_CDLOD_H__
+#define __TERRAIN_CDLOD_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../Math/Projection/Frustum.h"
+#include "../Terrain/TerrainData.h"
+
+#define TERRAIN_CDLOD_MAX_LEVELS 16
+#define TERRAIN_CDLOD_MAX_NODES 4096		// Instances drawn per frame, full and half nodes together
+#define TERRAIN_CDLOD_LEAF_RANGE 64.0f		// Distance the leaves (one patch, full detail) are drawn to, doubles every level
+#define TERRAIN_CDLOD_MORPH_START 0.66f		// Part of a level's range band before it starts morphing into the next level
+
+struct STerrain;
+
+/**
+ * @brief One instance of the grid mesh, std430 vec4 in Assets/Shaders/terrain_shader_cdlod.vert.
+ *
+ * Full nodes draw the (PATCH_SIZE + 1)^2 grid, half nodes are a quarter of
+ * their parent drawn with the parent's resolution (the LOD 1 patch indices).
+ */
+typedef struct STerrainCDLODNode
+{
+	float originX;			// World x, z of grid vertex (0, 0)
+	float originZ;
+	float vertexSpacing;	// World distance between two grid vertices
+	float level;			// Quadtree level the vertices morph by, 0 at the leaves
+} STerrainCDLODNode;
+
+/**
+ * @brief A min/max height quadtree over the whole TerrainMap, stored as one grid per level.
+ *
+ * The leaves are the terrain patches (PATCH_SIZE cells), every level above
+ * doubles the node size up to one root. Each node also counts the resident
+ * leaves under it, only nodes with all of them (so inside the map) are drawn.
+ */
+typedef struct STerrainCDLOD
+{
+	int32_t terrainsXCount;
+	int32_t terrainsZCount;
+	int32_t levelCount;
+	int32_t levelXCount[TERRAIN_CDLOD_MAX_LEVELS];
+	int32_t levelZCount[TERRAIN_CDLOD_MAX_LEVELS];
+	uint32_t levelOffset[TERRAIN_CDLOD_MAX_LEVELS];	// First node of each level in the arrays below
+
+	float* pMinHeights;
+	float* pMaxHeights;
+	uint32_t* pResidentLeaves;	// 4^level when the node is complete
+	int32_t* pTerrainSlots;		// GPU slot of every map terrain for the shader, -1 when not resident
+	bool bSlotsDirty;
+
+	float leafRange;
+
+	// Filled by TerrainCDLOD_Select, full nodes first then half nodes
+	STerrainCDLODNode* pNodes;
+	uint32_t fullCount;
+	uint32_t halfCount;
+} STerrainCDLOD;
+
+bool TerrainCDLOD_Initialize(STerrainCDLOD* pTree, int32_t terrainsXCount, int32_t terrainsZCount);
+void TerrainCDLOD_Destroy(STerrainCDLOD* pTree);
+
+void TerrainCDLOD_SetTerrain(STerrainCDLOD* pTree, const struct STerrain* pTerrain); // Takes the patch heights of a resident terrain
+void TerrainCDLOD_ClearTerrain(STerrainCDLOD* pTree, int32_t iTerrainX, int32_t iTerrainZ);
+int32_t TerrainCDLOD_GetTerrainSlot(const STerrainCDLOD* pTree, int32_t iTerrainX, int32_t iTerrainZ); // -1 when not resident or outside the map
+void TerrainCDLOD_Clear(STerrainCDLOD* pTree);
+
+/**
+ * @brief Walks the tree from the root and keeps the coarsest nodes the camera distance allows.
+ *
+ * A node is split while the camera is within the range of the level below,
+ * children out of that range are drawn as half nodes of the parent.
+ * @return Number of nodes written to pNodes (fullCount + halfCount).
+ */
+uint32_t TerrainCDLOD_Select(STerrainCDLOD* pTree, Vector3 v3Camera, const SFrustum* pFrustum);
+
+#endif // __TERRAIN_CDLOD_H__
@@ -0,0 +1,138 @@
+#include "TerrainCulling.h"
+#include "Stdafx.h"
+#include <float.h>
+#include <xmmintrin.h> // SSE
+
+bool TerrainPatchBounds_Initialize(STerrainPatchBounds* pBounds, uint32_t count)
+{
+	if (!pBounds)
+	{
+		syserr("pBounds is NULL (invalid address)");
+		return (false);
+	}
+
+	memset(pBounds, 0, sizeof(STerrainPatchBounds));
+
+	// One block, six arrays
+	uint32_t capacity = (count + 3u) & ~3u;
+	float* pData = (float*)engine_malloc((size_t)capacity * 6 * sizeof(float), MEM_TAG_RENDERING);
+	if (!pData)
+	{
+		syserr("Failed to Allocate %u Terrain Patch Bounds", count);
+		return (false);
+	}
+
+	pBounds->pMinX = pData;
+	pBounds->pMinY = pData + capacity;
+	pBounds->pMinZ = pData + capacity * 2;
+	pBounds->pMaxX = pData + capacity * 3;
+	pBounds->pMaxY = pData + capacity * 4;
+	pBounds->pMaxZ = pData + capacity * 5;
+	pBounds->count = count;
+	pBounds->capacity = capacity;
+
+	TerrainPatchBounds_Clear(pBounds);
+	return (true);
+}
+
+void TerrainPatchBounds_Destroy(STerrainPatchBounds* pBounds)
+{
+	if (!pBounds || !pBounds->pMinX)
+	{
+		return;
+	}
+
+	engine_delete(pBounds->pMinX);
+	memset(pBounds, 0, sizeof(STerrainPatchBounds));
+}
+
+void TerrainPatchBounds_Set(STerrainPatchBounds* pBounds, uint32_t index, Vector3 v3Min, Vector3 v3Max)
+{
+	if (index >= pBounds->count)
+	{
+		return;
+	}
+
+	pBounds->pMinX[index] = v3Min.x;
+	pBounds->pMinY[index] = v3Min.y;
+	pBounds->pMinZ[index] = v3Min.z;
+	pBounds->pMaxX[index] = v3Max.x;
+	pBounds->pMaxY[index] = v3Max.y;
+	pBounds->pMaxZ[index] = v3Max.z;
+}
+
+void TerrainPatchBounds_SetEmpty(STerrainPatchBounds* pBounds, uint32_t index)
+{
+	if (index >= pBounds->capacity)
+	{
+		return;
+	}
+
+	// Inverted: the corner picked for any plane lies at -FLT_MAX along its normal
+	pBounds->pMinX[index] = FLT_MAX;
+	pBounds->pMinY[index] = FLT_MAX;
+	pBounds->pMinZ[index] = FLT_MAX;
+	pBounds->pMaxX[index] = -FLT_MAX;
+	pBounds->pMaxY[index] = -FLT_MAX;
+	pBounds->pMaxZ[index] = -FLT_MAX;
+}
+
+void TerrainPatchBounds_Clear(STerrainPatchBounds* pBounds)
+{
+	for (uint32_t i = 0; i < pBounds->capacity; i++)
+	{
+		TerrainPatchBounds_SetEmpty(pBounds, i);
+	}
+}
+
+uint32_t TerrainPatchBounds_Cull(const STerrainPatchBounds* pBounds, const SFrustum* pFrustum, uint32_t* pVisible)
+{
+	// The plane signs are the same for every box, so the corner is picked once per plane, not per lane
+	const float* pCornerX[FRUSTUM_PLANE_COUNT];
+	const float* pCornerY[FRUSTUM_PLANE_COUNT];
+	const float* pCornerZ[FRUSTUM_PLANE_COUNT];
+	__m128 planeX[FRUSTUM_PLANE_COUNT];
+	__m128 planeY[FRUSTUM_PLANE_COUNT];
+	__m128 planeZ[FRUSTUM_PLANE_COUNT];
+	__m128 planeW[FRUSTUM_PLANE_COUNT];
+
+	for (int32_t iPlane = 0; iPlane < FRUSTUM_PLANE_COUNT; iPlane++)
+	{
+		const Vector4 plane = pFrustum->planes[iPlane];
+		pCornerX[iPlane] = (plane.x >= 0.0f) ? pBounds->pMaxX : pBounds->pMinX;
+		pCornerY[iPlane] = (plane.y >= 0.0f) ? pBounds->pMaxY : pBounds->pMinY;
+		pCornerZ[iPlane] = (plane.z >= 0.0f) ? pBounds->pMaxZ : pBounds->pMinZ;
+		planeX[iPlane] = _mm_set1_ps(plane.x);
+		planeY[iPlane] = _mm_set1_ps(plane.y);
+		planeZ[iPlane] = _mm_set1_ps(plane.z);
+		planeW[iPlane] = _mm_set1_ps(plane.w);
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+	uint32_t visibleCount = 0;
+
+	for (uint32_t i = 0; i < pBounds->count; i += 4)
+	{
+		// Lanes that end up negative for any plane are outside
+		__m128 outside = zero;
+		for (int32_t iPlane = 0; iPlane < FRUSTUM_PLANE_COUNT; iPlane++)
+		{
+			__m128 distance = _mm_mul_ps(_mm_loadu_ps(pCornerX[iPlane] + i), planeX[iPlane]);
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_loadu_ps(pCornerY[iPlane] + i), planeY[iPlane]));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_loadu_ps(pCornerZ[iPlane] + i), planeZ[iPlane]));
+			distance = _mm_add_ps(distance, planeW[iPlane]);
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, zero));
+		}
+
+		int visibleMask = ~_mm_movemask_ps(outside) & 0xF;
+		for (uint32_t lane = 0; visibleMask != 0 && lane < 4; lane++)
+		{
+			if ((visibleMask & (1 << lane)) && i + lane < pBounds->count)
+			{
+				pVisible[visibleCount++] = i + lane;
+			}
+		}
+	}
+
+	return (visibleCount);
+}
@@ -0,0 +1,64 @@
+#ifndef __TERRAIN_CULLING_H__
+#define __TERRAIN_CULLING_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../Math/Projection/Frustum.h"
+
+#define TERRAIN_CULL_GROUP_SIZE 64	// local_size_x of Assets/Shaders/terrain_cull.comp
+
+typedef enum ETerrainCullMode
+{
+	TERRAIN_CULL_NONE,			// Every resident patch is drawn
+	TERRAIN_CULL_CPU,			// TerrainPatchBounds_Cull, the visible commands are uploaded every frame
+	TERRAIN_CULL_GPU,			// terrain_cull.comp writes the indirect buffer and the draw count
+	TERRAIN_CULL_MODE_COUNT
+} ETerrainCullMode;
+
+typedef struct STerrainCullStats
+{
+	uint32_t visibleCount;		// Patches drawn last frame (CDLOD nodes in CDLOD mode)
+	uint32_t totalCount;		// Patches resident in a GPU slot
+	uint64_t triangleCount;		// Triangles in the drawn commands
+	uint32_t occludedCount;		// Patches in the frustum hidden behind the depth pyramid (GPU culling only)
+	double hizBuildMs;			// GPU time of the depth pyramid build, 0 without occlusion culling
+	double cullMs;				// Bounds test and command compaction (CPU), or reset and dispatch (GPU), last frame
+	double lodMs;				// LOD and stitch selection, on the CPU in every cull mode, last frame (0 in CDLOD mode)
+	ETerrainCullMode mode;
+	bool bCDLOD;				// Last frame came from the CDLOD quadtree, the counts are nodes and resident patches
+} STerrainCullStats;
+
+/**
+ * @brief Patch AABBs as a structure of arrays, one lane per patch command (slot * TERRAIN_PATCH_COUNT + patch).
+ *
+ * The capacity is rounded up to 4 so the SSE test never needs a scalar tail,
+ * unused lanes hold an inverted box that every plane rejects.
+ */
+typedef struct STerrainPatchBounds
+{
+	float* pMinX;
+	float* pMinY;
+	float* pMinZ;
+	float* pMaxX;
+	float* pMaxY;
+	float* pMaxZ;
+	uint32_t count;
+	uint32_t capacity;
+} STerrainPatchBounds;
+
+bool TerrainPatchBounds_Initialize(STerrainPatchBounds* pBounds, uint32_t count);
+void TerrainPatchBounds_Destroy(STerrainPatchBounds* pBounds);
+
+void TerrainPatchBounds_Set(STerrainPatchBounds* pBounds, uint32_t index, Vector3 v3Min, Vector3 v3Max);
+void TerrainPatchBounds_SetEmpty(STerrainPatchBounds* pBounds, uint32_t index);
+void TerrainPatchBounds_Clear(STerrainPatchBounds* pBounds);
+
+/**
+ * @brief Tests four boxes per step against the frustum planes.
+ *
+ * @param pVisible Receives the indices of the boxes that may be visible, in order, room for count entries.
+ * @return Number of indices written.
+ */
+uint32_t TerrainPatchBounds_Cull(const STerrainPatchBounds* pBounds, const SFrustum* pFrustum, uint32_t* pVisible);
+
+#endif // __TERRAIN_CULLING_H__
@@ -4,8 +4,9 @@
 #include "../PipeLine/StateManager.h"
 #include "../Terrain/TerrainPatch.h"
 #include "../PipeLine/Texture.h"
+#include "../PipeLine/Utils.h"
 
-bool TerrainRenderer_Initialize(TerrainRenderer* ppTerrainRenderer, const char* szRendererName, int32_t iTerrainX, int32_t iTerrainZ)
+bool TerrainRenderer_Initialize(TerrainRenderer* ppTerrainRenderer, const char* szRendererName, int32_t gpuSlotCount)
 {
 	if (ppTerrainRenderer == NULL)
 	{
@@ -27,8 +28,8 @@ bool TerrainRenderer_Initialize(TerrainRenderer* ppTerrainRenderer, const char*
 	pRenderer->szRendererName = engine_strdup(szRendererName, MEM_TAG_STRINGS);
 	pRenderer->pCamera = GetEngine()->camera;
 
-	// will Initialize it to render Triangles, with TERRAIN_PATCH_COUNT meshes as base Num
-	if (!TerrainRenderer_InitGLBuffers(pRenderer, GL_TRIANGLES, iTerrainX, iTerrainZ))
+	// will Initialize it to render Triangles, with TERRAIN_PATCH_COUNT meshes per terrain slot
+	if (!TerrainRenderer_InitGLBuffers(pRenderer, GL_TRIANGLES, gpuSlotCount))
 	{
 		// Clean Up Memory
 		TerrainRenderer_Destroy(&pRenderer);
@@ -61,7 +62,117 @@ void TerrainRenderer_Destroy(TerrainRenderer* ppTerrainRenderer)
 	*ppTerrainRenderer = NULL;
 }
 
-bool TerrainRenderer_InitGLBuffers(TerrainRenderer pTerrainRenderer, GLenum glType, GLint iTerrainX, GLint iTerrainZ)
+/**
+ * @brief The compute pass and its SSBOs, the indirect buffer it writes already exists.
+ */
+static bool TerrainRenderer_InitGPUCulling(TerrainRenderer pTerrainRenderer, GLsizeiptr capacity)
+{
+	if (!Shader_Initialize(&pTerrainRenderer->pCullShader, "Terrain Cull Shader"))
+	{
+		syserr("Failed to Create Terrain Cull Shader");
+		return (false);
+	}
+
+	Shader_SetInjection(pTerrainRenderer->pCullShader, true);
+	Shader_AttachShader(pTerrainRenderer->pCullShader, "Assets/Shaders/terrain_cull.comp");
+	Shader_LinkProgram(pTerrainRenderer->pCullShader);
+
+	// The command SSBO holds exactly one entry per patch, the shader takes its count from the length
+	if (!ShaderStorageBufferObject_Initialize(&pTerrainRenderer->pCullBoundsSSBO, capacity * sizeof(SPatchGPUBounds), SSBO_BP_CULL_BOUNDS, "Terrain Cull Bounds SSBO") ||
+		!ShaderStorageBufferObject_Initialize(&pTerrainRenderer->pCullCommandsSSBO, capacity * sizeof(SIndirectDrawCommand), SSBO_BP_CULL_COMMANDS, "Terrain Cull Commands SSBO") ||
+		!ShaderStorageBufferObject_Initialize(&pTerrainRenderer->pDrawCountSSBO, TERRAIN_CULL_COUNTER_COUNT * sizeof(GLuint), SSBO_BP_CULL_DRAW_COUNT, "Terrain Draw Count SSBO"))
+	{
+		syserr("Failed to Create Terrain Cull Buffers");
+		return (false);
+	}
+
+	// The stats never read the counters directly, that would wait for the frame's cull passes
+	GLbitfield readbackFlags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(TERRAIN_CULL_READBACK_COUNT, pTerrainRenderer->cullReadbackBuffers);
+	for (int32_t i = 0; i < TERRAIN_CULL_READBACK_COUNT; i++)
+	{
+		glNamedBufferStorage(pTerrainRenderer->cullReadbackBuffers[i], TERRAIN_CULL_COUNTER_COUNT * sizeof(GLuint), NULL, readbackFlags);
+		pTerrainRenderer->pCullReadbackData[i] = (GLuint*)glMapNamedBufferRange(pTerrainRenderer->cullReadbackBuffers[i], 0, TERRAIN_CULL_COUNTER_COUNT * sizeof(GLuint), readbackFlags);
+		if (!pTerrainRenderer->pCullReadbackData[i])
+		{
+			syserr("Failed to Map Terrain Cull Readback Buffer %d", i);
+			return (false);
+		}
+	}
+
+	return (pTerrainRenderer->pCullBoundsSSBO->isPersistent && pTerrainRenderer->pCullCommandsSSBO->isPersistent);
+}
+
+/**
+ * @brief The depth pyramid and what the second cull pass reads and writes.
+ */
+static bool TerrainRenderer_InitOcclusion(TerrainRenderer pTerrainRenderer, GLsizeiptr capacity)
+{
+	if (!HiZBuffer_Initialize(&pTerrainRenderer->pHiZBuffer) ||
+		!IndirectBufferObject_Initialize(&pTerrainRenderer->pLateIndirectBuffer, capacity) ||
+		!ShaderStorageBufferObject_Initialize(&pTerrainRenderer->pOccludedSSBO, capacity * sizeof(GLuint), SSBO_BP_CULL_OCCLUDED, "Terrain Occluded Patches SSBO"))
+	{
+		return (false);
+	}
+
+	return (true);
+}
+
+/**
+ * @brief The CDLOD grid shader and its node SSBO, the quadtree and the slot SSBO follow the map size.
+ */
+static bool TerrainRenderer_InitCDLOD(TerrainRenderer pTerrainRenderer)
+{
+	if (!Shader_Initialize(&pTerrainRenderer->pCDLODShader, "Terrain CDLOD Shader"))
+	{
+		syserr("Failed to Create Terrain CDLOD Shader");
+		return (false);
+	}
+
+	Shader_SetInjection(pTerrainRenderer->pCDLODShader, true);
+	Shader_AttachShader(pTerrainRenderer->pCDLODShader, "Assets/Shaders/terrain_shader_cdlod.vert");
+	Shader_AttachShader(pTerrainRenderer->pCDLODShader, "Assets/Shaders/terrain_shader.frag");
+	Shader_LinkProgram(pTerrainRenderer->pCDLODShader);
+
+	if (!ShaderStorageBufferObject_Initialize(&pTerrainRenderer->pCDLODNodesSSBO, TERRAIN_CDLOD_MAX_NODES * sizeof(STerrainCDLODNode), SSBO_BP_CDLOD_NODES, "Terrain CDLOD Nodes SSBO"))
+	{
+		syserr("Failed to Create Terrain CDLOD Buffers");
+		return (false);
+	}
+
+	return (true);
+}
+
+// The quadtree and the slot table are sized for the map, a map of another size rebuilds them
+static bool TerrainRenderer_PrepareCDLOD(TerrainRenderer pTerrainRenderer, TerrainMap pTerrainMap)
+{
+	STerrainCDLOD* pTree = &pTerrainRenderer->cdlod;
+	if (!pTerrainRenderer->pCDLODNodesSSBO || !pTerrainMap)
+	{
+		return (false);
+	}
+
+	if (pTree->pMinHeights && pTree->terrainsXCount == pTerrainMap->terrainsXCount && pTree->terrainsZCount == pTerrainMap->terrainsZCount)
+	{
+		return (true);
+	}
+
+	TerrainCDLOD_Destroy(pTree);
+	ShaderStorageBufferObject_Destroy(&pTerrainRenderer->pCDLODSlotsSSBO);
+
+	GLsizeiptr slotsSize = (GLsizeiptr)pTerrainMap->terrainsXCount * pTerrainMap->terrainsZCount * sizeof(int32_t);
+	if (!TerrainCDLOD_Initialize(pTree, pTerrainMap->terrainsXCount, pTerrainMap->terrainsZCount) ||
+		!ShaderStorageBufferObject_Initialize(&pTerrainRenderer->pCDLODSlotsSSBO, slotsSize, SSBO_BP_CDLOD_TERRAIN_SLOTS, "Terrain CDLOD Slots SSBO"))
+	{
+		syserr("Failed to Create the CDLOD Quadtree for a %dx%d Map", pTerrainMap->terrainsXCount, pTerrainMap->terrainsZCount);
+		TerrainCDLOD_Destroy(pTree);
+		return (false);
+	}
+
+	return (true);
+}
+
+bool TerrainRenderer_InitGLBuffers(TerrainRenderer pTerrainRenderer, GLenum glType, GLint gpuSlotCount)
 {
 	// Shader Initialization
 	if (!Shader_Initialize(&pTerrainRenderer->pTerrainShader, "Terrain Shader"))
@@ -74,13 +185,21 @@ bool TerrainRenderer_InitGLBuffers(TerrainRenderer pTerrainRenderer, GLenum glTy
 	}
 
 	Shader_SetInjection(pTerrainRenderer->pTerrainShader, true);
+#if TERRAIN_VERTEX_PULLING
+	Shader_AttachShader(pTerrainRenderer->pTerrainShader, "Assets/Shaders/terrain_shader_pull.vert");
+#elif TERRAIN_COMPACT_VERTEX
+	Shader_AttachShader(pTerrainRenderer->pTerrainShader, "Assets/Shaders/terrain_shader_compact.vert");
+#else
 	Shader_AttachShader(pTerrainRenderer->pTerrainShader, "Assets/Shaders/terrain_shader.vert");
+#endif
 	Shader_AttachShader(pTerrainRenderer->pTerrainShader, "Assets/Shaders/terrain_shader.frag");
 	Shader_LinkProgram(pTerrainRenderer->pTerrainShader);
 
-	// Initialize GPU Buffers
-	GLsizeiptr capacity = TERRAIN_PATCH_COUNT * iTerrainX * iTerrainZ;
-	if (!TerrainBuffer_Initialize(&pTerrainRenderer->pTerrainBuffer, capacity))
+	// Initialize GPU Buffers, a fixed vertex range per patch of every slot (none with vertex pulling) and one shared copy of the indices
+	GLsizeiptr capacity = TERRAIN_PATCH_COUNT * gpuSlotCount;
+	const STerrainPatchIndices* pSharedIndices = TerrainPatch_GetSharedIndices();
+	GLsizeiptr vertexCapacity = (TERRAIN_VERTEX_PULLING) ? 0 : capacity * PATCH_VERTEX_COUNT;
+	if (!TerrainBuffer_Initialize(&pTerrainRenderer->pTerrainBuffer, vertexCapacity, pSharedIndices->totalCount))
 	{
 		// Clean Up Memory
 		TerrainRenderer_Destroy(&pTerrainRenderer);
@@ -97,7 +216,7 @@ bool TerrainRenderer_InitGLBuffers(TerrainRenderer pTerrainRenderer, GLenum glTy
 		return (false);
 	}
 
-	int32_t totalTerrains = iTerrainX * iTerrainZ;
+	int32_t totalTerrains = gpuSlotCount;
 	GLsizeiptr terrainSSBOSize = totalTerrains * sizeof(STerrainGPUData);
 	if (!ShaderStorageBufferObject_Initialize(&pTerrainRenderer->pTerrainRendererSSBO, terrainSSBOSize, SSBO_BP_TERRAIN_DATA, "Terrain SSBO"))
 	{
@@ -123,19 +242,127 @@ bool TerrainRenderer_InitGLBuffers(TerrainRenderer pTerrainRenderer, GLenum glTy
 		return (false);
 	}
 
+	// CPU side of the patch commands, culled into the indirect buffer every frame
+	pTerrainRenderer->pPatchCommands = engine_new_zero(SIndirectDrawCommand, capacity, MEM_TAG_RENDERING);
+	pTerrainRenderer->pPatchLODErrors = engine_new_zero(float, capacity * PATCH_LOD_COUNT, MEM_TAG_RENDERING);
+	pTerrainRenderer->pPatchLODs = engine_new_zero(uint8_t, capacity, MEM_TAG_RENDERING);
+	pTerrainRenderer->pSlotCoords = engine_new_zero(int32_t, gpuSlotCount * 2, MEM_TAG_RENDERING);
+	pTerrainRenderer->pSlotNeighbours = engine_new_zero(int32_t, gpuSlotCount * 4, MEM_TAG_RENDERING);
+	if (!pTerrainRenderer->pPatchCommands || !pTerrainRenderer->pPatchLODErrors || !pTerrainRenderer->pPatchLODs || !pTerrainRenderer->pSlotCoords || !pTerrainRenderer->pSlotNeighbours ||
+		!TerrainPatchBounds_Initialize(&pTerrainRenderer->patchBounds, (uint32_t)capacity))
+	{
+		syserr("Failed to Allocate Terrain Patch Culling Data");
+		TerrainRenderer_Destroy(&pTerrainRenderer);
+		return (false);
+	}
+
+	// GPU culling draws with glMultiDrawElementsIndirectCount (GL 4.6 or ARB_indirect_parameters)
+	pTerrainRenderer->bGPUCulling = IsGLVersionHigher(4, 5) && IndirectBufferObject_HasDrawCount();
+	if (pTerrainRenderer->bGPUCulling && !TerrainRenderer_InitGPUCulling(pTerrainRenderer, capacity))
+	{
+		syserr("GPU Terrain Culling is not available, using CPU culling");
+		pTerrainRenderer->bGPUCulling = false;
+	}
+
+	// The depth pyramid is only tested by terrain_cull.comp
+	if (pTerrainRenderer->bGPUCulling && !TerrainRenderer_InitOcclusion(pTerrainRenderer, capacity))
+	{
+		syserr("Terrain Occlusion Culling is not available");
+		HiZBuffer_Destroy(&pTerrainRenderer->pHiZBuffer);
+	}
+
+	if (!TerrainRenderer_InitCDLOD(pTerrainRenderer))
+	{
+		syserr("CDLOD Terrain is not available");
+		ShaderStorageBufferObject_Destroy(&pTerrainRenderer->pCDLODNodesSSBO);
+	}
+
 	pTerrainRenderer->primitiveType = glType;
+	pTerrainRenderer->gpuSlotCount = gpuSlotCount;
+	pTerrainRenderer->cullMode = TERRAIN_CULL_CPU;
+	pTerrainRenderer->lodPixelError = TERRAIN_LOD_PIXEL_ERROR;
+	pTerrainRenderer->bLOD = true;
+
+	TerrainRenderer_UploadSharedIndices(pTerrainRenderer);
+	TerrainRenderer_ResetSlots(pTerrainRenderer);
 
 	return (true);
 }
 
+/**
+ * @brief Writes the patch index patterns at the start of the EBO, every draw command points into them.
+ */
+void TerrainRenderer_UploadSharedIndices(TerrainRenderer pTerrainRenderer)
+{
+	const STerrainPatchIndices* pSharedIndices = TerrainPatch_GetSharedIndices();
+	if (!TerrainBuffer_UploadIndicesAt(pTerrainRenderer->pTerrainBuffer, pSharedIndices->indices, pSharedIndices->totalCount, 0))
+	{
+		syserr("Failed to Upload Terrain Patch Indices");
+	}
+}
+
 void TerrainRenderer_DestroyGLBuffers(TerrainRenderer pTerrainRenderer)
 {
 	IndirectBufferObject_Destroy(&pTerrainRenderer->pIndirectBuffer);
 	ShaderStorageBufferObject_Destroy(&pTerrainRenderer->pTerrainRendererSSBO);
 	ShaderStorageBufferObject_Destroy(&pTerrainRenderer->pPatchRendererSSBO);
 	ShaderStorageBufferObject_Destroy(&pTerrainRenderer->pHeightMapSSBO);
+	ShaderStorageBufferObject_Destroy(&pTerrainRenderer->pCullBoundsSSBO);
+	ShaderStorageBufferObject_Destroy(&pTerrainRenderer->pCullCommandsSSBO);
+	ShaderStorageBufferObject_Destroy(&pTerrainRenderer->pDrawCountSSBO);
+	for (int32_t i = 0; i < TERRAIN_CULL_READBACK_COUNT; i++)
+	{
+		if (pTerrainRenderer->cullReadbackFences[i])
+		{
+			glDeleteSync(pTerrainRenderer->cullReadbackFences[i]);
+			pTerrainRenderer->cullReadbackFences[i] = NULL;
+		}
+		pTerrainRenderer->pCullReadbackData[i] = NULL;
+	}
+	GL_DeleteBuffers(pTerrainRenderer->cullReadbackBuffers, TERRAIN_CULL_READBACK_COUNT);
+	ShaderStorageBufferObject_Destroy(&pTerrainRenderer->pCDLODNodesSSBO);
+	ShaderStorageBufferObject_Destroy(&pTerrainRenderer->pCDLODSlotsSSBO);
+	if (pTerrainRenderer->pCullShader)
+	{
+		Shader_Destroy(&pTerrainRenderer->pCullShader);
+	}
+	if (pTerrainRenderer->pCDLODShader)
+	{
+		Shader_Destroy(&pTerrainRenderer->pCDLODShader);
+	}
+	HiZBuffer_Destroy(&pTerrainRenderer->pHiZBuffer);
+	IndirectBufferObject_Destroy(&pTerrainRenderer->pLateIndirectBuffer);
+	ShaderStorageBufferObject_Destroy(&pTerrainRenderer->pOccludedSSBO);
 	Shader_Destroy(&pTerrainRenderer->pTerrainShader);
 	TerrainBuffer_Destroy(&pTerrainRenderer->pTerrainBuffer);
+
+	if (pTerrainRenderer->pPatchCommands)
+	{
+		engine_delete(pTerrainRenderer->pPatchCommands);
+		pTerrainRenderer->pPatchCommands = NULL;
+	}
+	if (pTerrainRenderer->pPatchLODErrors)
+	{
+		engine_delete(pTerrainRenderer->pPatchLODErrors);
+		pTerrainRenderer->pPatchLODErrors = NULL;
+	}
+	if (pTerrainRenderer->pPatchLODs)
+	{
+		engine_delete(pTerrainRenderer->pPatchLODs);
+		pTerrainRenderer->pPatchLODs = NULL;
+	}
+	if (pTerrainRenderer->pSlotCoords)
+	{
+		engine_delete(pTerrainRenderer->pSlotCoords);
+		pTerrainRenderer->pSlotCoords = NULL;
+	}
+	if (pTerrainRenderer->pSlotNeighbours)
+	{
+		engine_delete(pTerrainRenderer->pSlotNeighbours);
+		pTerrainRenderer->pSlotNeighbours = NULL;
+	}
+	TerrainPatchBounds_Destroy(&pTerrainRenderer->patchBounds);
+	TerrainCDLOD_Destroy(&pTerrainRenderer->cdlod);
 }
 
 void TerrainRenderer_UploadGPUData(TerrainRenderer pTerrainRenderer)
@@ -148,112 +375,213 @@ void TerrainRenderer_UploadGPUData(TerrainRenderer pTerrainRenderer)
 
 	TerrainMap pTerrainMap = GetTerrainManager()->pTerrainMap;
 
-	// Reset buffer and commands
-	IndirectBufferObject_Clear(pTerrainRenderer->pIndirectBuffer);
+	// Reset commands, every terrain holding a slot is written again
+	TerrainRenderer_ResetSlots(pTerrainRenderer);
+
+	for (int32_t iTerrNumZ = 0; iTerrNumZ < pTerrainMap->terrainsZCount; iTerrNumZ++)
+	{
+		for (int32_t iTerrNumX = 0; iTerrNumX < pTerrainMap->terrainsXCount; iTerrNumX++)
+		{
+			// Terrains still loading are uploaded on their own when they arrive
+			Terrain pTerrain = TerrainMap_GetTerrain(pTerrainMap, iTerrNumX, iTerrNumZ);
+			if (pTerrain && pTerrain->gpuSlot >= 0)
+			{
+				TerrainRenderer_UploadTerrain(pTerrainRenderer, pTerrain);
+			}
+		}
+	}
 
+	// The indirect buffer is filled with the visible commands when the frame renders
+}
+
+/**
+ * @brief Copies a patch command and its bounds into the GPU culling SSBOs, a zero count marks an empty patch.
+ */
+static void TerrainRenderer_WriteCullPatch(TerrainRenderer pTerrainRenderer, uint32_t index)
+{
+	if (!pTerrainRenderer->bGPUCulling)
+	{
+		return;
+	}
+
+	SIndirectDrawCommand* pGPUCommands = (SIndirectDrawCommand*)pTerrainRenderer->pCullCommandsSSBO->pBufferData;
+	SPatchGPUBounds* pGPUBounds = (SPatchGPUBounds*)pTerrainRenderer->pCullBoundsSSBO->pBufferData;
+	const STerrainPatchBounds* pBounds = &pTerrainRenderer->patchBounds;
+
+	pGPUCommands[index] = pTerrainRenderer->pPatchCommands[index];
+
+	SPatchGPUBounds bounds = { { pBounds->pMinX[index], pBounds->pMinY[index], pBounds->pMinZ[index], 0.0f }, { pBounds->pMaxX[index], pBounds->pMaxY[index], pBounds->pMaxZ[index], 0.0f } };
+	pGPUBounds[index] = bounds;
+}
+
+void TerrainRenderer_UploadTerrain(TerrainRenderer pTerrainRenderer, Terrain pTerrain)
+{
+	int32_t iSlot = pTerrain->gpuSlot;
+	if (iSlot < 0 || iSlot >= pTerrainRenderer->gpuSlotCount)
+	{
+		syserr("Terrain (%d, %d) has no valid GPU slot (%d)", pTerrain->terrainXCoord, pTerrain->terrainZCoord, iSlot);
+		return;
+	}
+
+	const STerrainPatchIndices* pSharedIndices = TerrainPatch_GetSharedIndices();
 	STerrainGPUData* terrainGPUData = (STerrainGPUData*)pTerrainRenderer->pTerrainRendererSSBO->pBufferData;
 	SPatchGPUData* patchGPUData = (SPatchGPUData*)pTerrainRenderer->pPatchRendererSSBO->pBufferData;
 	GLfloat* heightMapGPUData = (GLfloat*)pTerrainRenderer->pHeightMapSSBO->pBufferData;
 
-	int32_t terrainsZNum = pTerrainMap->terrainsZCount;
-	int32_t terrainsXNum = pTerrainMap->terrainsXCount;
+	// A slot taken over without TerrainRenderer_ReleaseSlot still has the old terrain in the quadtree
+	if (pTerrainRenderer->pSlotCoords[iSlot * 2] != INT32_MIN &&
+		(pTerrainRenderer->pSlotCoords[iSlot * 2] != pTerrain->terrainXCoord || pTerrainRenderer->pSlotCoords[iSlot * 2 + 1] != pTerrain->terrainZCoord))
+	{
+		TerrainRenderer_ReleaseSlot(pTerrainRenderer, iSlot);
+	}
 
-	uint32_t globalPatchIndex = 0;
-	GLsizeiptr heightMapOffset = 0; // height map offset in the global .. per terrain
+	// Everything a terrain owns on the GPU sits at a fixed place for its slot, so slots are reused in place
+	pTerrain->baseGlobalPatchIndex = iSlot * TERRAIN_PATCH_COUNT;  // Slot 0: 0
+	pTerrainRenderer->pSlotCoords[iSlot * 2] = pTerrain->terrainXCoord;
+	pTerrainRenderer->pSlotCoords[iSlot * 2 + 1] = pTerrain->terrainZCoord;
+	pTerrain->globalOffset = (size_t)iSlot * pTerrain->sliceBytes;  // Byte offset
 
-	for (int32_t iTerrNumZ = 0; iTerrNumZ < terrainsZNum; iTerrNumZ++)
+	if (pTerrainRenderer->pHeightMapSSBO->isPersistent)
 	{
-		for (int32_t iTerrNumX = 0; iTerrNumX < terrainsXNum; iTerrNumX++)
+		for (int32_t i = 0; i < 3; i++)
 		{
-			int32_t iTerrainIndex = iTerrNumZ * terrainsXNum + iTerrNumX;
-			Terrain pTerrain = Vector_GetPtr(pTerrainMap->terrains, iTerrainIndex);
-			if (!pTerrain)
+			pTerrain->mapPtrs[i] = (char*)heightMapGPUData + pTerrain->globalOffset;
+		}
+	}
+
+	// Store Model Matrix in the GPU Array
+	if (pTerrainRenderer->pTerrainRendererSSBO->isPersistent)
+	{
+		// This is the magic: Every patch in this terrain points to this heightmap
+		terrainGPUData[iSlot].heightOffset = (uint32_t)pTerrain->globalOffset / sizeof(GLfloat);
+		terrainGPUData[iSlot].terrainCoords[0] = pTerrain->terrainXCoord;
+		terrainGPUData[iSlot].terrainCoords[1] = pTerrain->terrainZCoord;
+	}
+
+	for (int32_t iPatchZ = 0; iPatchZ < PATCH_ZCOUNT; iPatchZ++)
+	{
+		for (int32_t iPatchX = 0; iPatchX < PATCH_XCOUNT; iPatchX++)
+		{
+			int32_t iPatchIndex = iPatchZ * PATCH_XCOUNT + iPatchX;
+			TerrainPatch terrainPatch = Vector_GetPtr(pTerrain->terrainPatches, iPatchIndex);  // Single line!
+
+			if (!terrainPatch || !terrainPatch->terrainMesh)
 			{
-				syserr("Error At Terrain %d", iTerrainIndex);
-				break;
+				syserr("Patch %d has no mesh", iPatchIndex);
+				continue;
 			}
 
-			pTerrain->baseGlobalPatchIndex = globalPatchIndex;  // Terrain 0,0: 0
-			pTerrain->globalOffset = heightMapOffset;  // Byte offset
-
+			TerrainMesh terrainMesh = terrainPatch->terrainMesh;
+			uint32_t ssboIndex = pTerrain->baseGlobalPatchIndex + iPatchIndex;
+			terrainMesh->meshMatrixIndex = ssboIndex;
 
-			if (pTerrainRenderer->pHeightMapSSBO->isPersistent)
+#if TERRAIN_VERTEX_PULLING
+			// Nothing to upload, with baseVertex 0 gl_VertexID is the shared index itself (the vertex in the patch grid)
+			terrainMesh->vertexOffset = 0;
+			terrainMesh->indexOffset = pSharedIndices->firstIndex[0][0];
+#else
+			if (terrainMesh->vertexCount == 0 || terrainMesh->vertexCount > PATCH_VERTEX_COUNT)
 			{
-				for (int32_t i = 0; i < 3; i++)
-				{
-					pTerrain->mapPtrs[i] = (char*)heightMapGPUData + heightMapOffset;
-				}
+				syserr("Patch %d mesh does not fit its slot range (%d vertices)", iPatchIndex, (int32_t)terrainMesh->vertexCount);
+				continue;
 			}
 
+			// Upload the vertices into the slot's range, the indices are the shared full detail pattern
+			TerrainBuffer_UploadDataAt(pTerrainRenderer->pTerrainBuffer, terrainMesh, (GLsizeiptr)ssboIndex * PATCH_VERTEX_COUNT, pSharedIndices->firstIndex[0][0]);
+#endif
+
+			terrainPatch->patchVerticesOffset = terrainMesh->vertexOffset;
+			terrainPatch->patchIndicesOffset = terrainMesh->indexOffset;
+
 			// Store Model Matrix in the GPU Array
-			if (pTerrainRenderer->pTerrainRendererSSBO->isPersistent)
+			if (pTerrainRenderer->pPatchRendererSSBO->isPersistent)
 			{
 				// This is the magic: Every patch in this terrain points to this heightmap
-				terrainGPUData[iTerrainIndex].heightOffset = (uint32_t)pTerrain->globalOffset / sizeof(GLfloat);
-				terrainGPUData[iTerrainIndex].terrainCoords[0] = pTerrain->terrainXCoord;
-				terrainGPUData[iTerrainIndex].terrainCoords[1] = pTerrain->terrainZCoord;
+				patchGPUData[ssboIndex].terrainIndex = iSlot;
+				patchGPUData[ssboIndex].localPatchID = iPatchIndex;
 			}
 
-			for (int32_t iPatchZ = 0; iPatchZ < PATCH_ZCOUNT; iPatchZ++)
-			{
-				for (int32_t iPatchX = 0; iPatchX < PATCH_XCOUNT; iPatchX++)
-				{
-					int32_t iPatchIndex = iPatchZ * PATCH_XCOUNT + iPatchX;
-					TerrainPatch terrainPatch = Vector_GetPtr(pTerrain->terrainPatches, iPatchIndex);  // Single line!
-
-					if (!terrainPatch || !terrainPatch->terrainMesh || terrainPatch->terrainMesh->vertexCount == 0)
-					{
-						syserr("vertex count is 0 for mesh Index %d", iPatchIndex);
-						continue;
-					}
-
-					TerrainMesh terrainMesh = terrainPatch->terrainMesh;
+			// Overwrite the slot's command at full resolution, TerrainRenderer_SelectLODs sets its LOD and
+			// TerrainRenderer_CullPatches picks the visible ones every frame
+			SIndirectDrawCommand* pCommand = &pTerrainRenderer->pPatchCommands[ssboIndex];
+			pCommand->count = pSharedIndices->indexCount[0][0];
+			pCommand->instanceCount = 1;
+			pCommand->firstIndex = (GLuint)terrainMesh->indexOffset;
+			pCommand->baseVertex = (GLuint)terrainMesh->vertexOffset;
+			pCommand->baseInstance = ssboIndex;		// baseInstance = index into SSBO!
+
+			// World bounds, x and z from the patch position, y from the heights the patch covers
+			float fPatchMinX = (float)(pTerrain->terrainXCoord * TERRAIN_XSIZE + iPatchX * PATCH_XSIZE * ENGINE_CELL_SIZE);
+			float fPatchMinZ = (float)(pTerrain->terrainZCoord * TERRAIN_ZSIZE + iPatchZ * PATCH_ZSIZE * ENGINE_CELL_SIZE);
+			Vector3 v3Min = Vector3D(fPatchMinX, terrainPatch->minHeight, fPatchMinZ);
+			Vector3 v3Max = Vector3D(fPatchMinX + PATCH_XSIZE * ENGINE_CELL_SIZE, terrainPatch->maxHeight, fPatchMinZ + PATCH_ZSIZE * ENGINE_CELL_SIZE);
+			TerrainPatchBounds_Set(&pTerrainRenderer->patchBounds, ssboIndex, v3Min, v3Max);
+			memcpy(&pTerrainRenderer->pPatchLODErrors[ssboIndex * PATCH_LOD_COUNT], terrainPatch->lodError, sizeof(terrainPatch->lodError));
+			pTerrainRenderer->pPatchLODs[ssboIndex] = 0;
+			TerrainRenderer_WriteCullPatch(pTerrainRenderer, ssboIndex);
+		}
+	}
 
-					// Capture buffer offsets
-					terrainMesh->vertexOffset = TerrainBuffer_GetVertexOffset(pTerrainRenderer->pTerrainBuffer);
-					terrainMesh->indexOffset = TerrainBuffer_GetIndexOffset(pTerrainRenderer->pTerrainBuffer);
+	// The quadtree is kept up to date in every mode, so switching to CDLOD needs no rebuild
+	if (TerrainRenderer_PrepareCDLOD(pTerrainRenderer, GetTerrainManager()->pTerrainMap))
+	{
+		TerrainCDLOD_SetTerrain(&pTerrainRenderer->cdlod, pTerrain);
+	}
+}
 
-					terrainMesh->meshMatrixIndex = pTerrain->baseGlobalPatchIndex + iPatchIndex;
+/**
+ * @brief Stops drawing a slot, its buffers are overwritten by the next terrain that takes it.
+ */
+void TerrainRenderer_ReleaseSlot(TerrainRenderer pTerrainRenderer, int32_t iSlot)
+{
+	if (!pTerrainRenderer || iSlot < 0 || iSlot >= pTerrainRenderer->gpuSlotCount)
+	{
+		return;
+	}
 
-					// Upload mesh data (advances buffer offsets)
-					TerrainBuffer_UploadData(pTerrainRenderer->pTerrainBuffer, terrainMesh);
+	for (int32_t iPatch = 0; iPatch < TERRAIN_PATCH_COUNT; iPatch++)
+	{
+		uint32_t index = (uint32_t)iSlot * TERRAIN_PATCH_COUNT + (uint32_t)iPatch;
+		memset(&pTerrainRenderer->pPatchCommands[index], 0, sizeof(SIndirectDrawCommand));
+		TerrainPatchBounds_SetEmpty(&pTerrainRenderer->patchBounds, index);
+		TerrainRenderer_WriteCullPatch(pTerrainRenderer, index);
+	}
 
-					terrainPatch->patchVerticesOffset = terrainMesh->vertexOffset;
-					terrainPatch->patchIndicesOffset = terrainMesh->indexOffset;
+	// The terrain may already be back in another slot, its leaves are only dropped while they still point here
+	int32_t iTerrainX = pTerrainRenderer->pSlotCoords[iSlot * 2];
+	int32_t iTerrainZ = pTerrainRenderer->pSlotCoords[iSlot * 2 + 1];
+	if (TerrainCDLOD_GetTerrainSlot(&pTerrainRenderer->cdlod, iTerrainX, iTerrainZ) == iSlot)
+	{
+		TerrainCDLOD_ClearTerrain(&pTerrainRenderer->cdlod, iTerrainX, iTerrainZ);
+	}
 
-					// ... inside the patch loops ...
-					uint32_t ssboIndex = pTerrain->baseGlobalPatchIndex + iPatchIndex;
+	pTerrainRenderer->pSlotCoords[iSlot * 2] = INT32_MIN;
+	pTerrainRenderer->pSlotCoords[iSlot * 2 + 1] = INT32_MIN;
+}
 
-					// Store Model Matrix in the GPU Array
-					if (pTerrainRenderer->pPatchRendererSSBO->isPersistent)
-					{
-						// This is the magic: Every patch in this terrain points to this heightmap
-						patchGPUData[ssboIndex].terrainIndex = iTerrainIndex;
-						patchGPUData[ssboIndex].localPatchID = iPatchIndex;
-					}
+/**
+ * @brief One empty command per patch of every slot, so slots can be filled in any order.
+ */
+void TerrainRenderer_ResetSlots(TerrainRenderer pTerrainRenderer)
+{
+	IndirectBufferObject_Clear(pTerrainRenderer->pIndirectBuffer);
 
-					// Add indirect command with correct offsets
-					IndirectBufferObject_AddCommand(
-						pTerrainRenderer->pIndirectBuffer,
-						(GLuint)terrainMesh->indexCount,
-						1,
-						(GLuint)terrainMesh->indexOffset,			// Correct offset!
-						(GLuint)terrainMesh->vertexOffset,			// Correct offset!
-						pTerrain->baseGlobalPatchIndex + iPatchIndex					// baseInstance = index into SSBO!
-					);
-				}
-			}
+	size_t commandCount = (size_t)pTerrainRenderer->gpuSlotCount * TERRAIN_PATCH_COUNT;
+	memset(pTerrainRenderer->pPatchCommands, 0, commandCount * sizeof(SIndirectDrawCommand));
+	TerrainPatchBounds_Clear(&pTerrainRenderer->patchBounds);
 
-			globalPatchIndex += PATCH_ZCOUNT * PATCH_XCOUNT;
-			heightMapOffset += pTerrain->sliceBytes;
-		}
+	for (int32_t i = 0; i < pTerrainRenderer->gpuSlotCount * 2; i++)
+	{
+		pTerrainRenderer->pSlotCoords[i] = INT32_MIN;
 	}
 
-	// Upload all model matrices to SSBO, Upload only meshes we have made, at offset 0 without need to reallocate
-	// ShaderStorageBufferObject_Update(group->pRendererSSBO, group->modelsMetrices, pTerrainRenderer->meshCounter * sizeof(Matrix4), 0, false);
+	TerrainCDLOD_Clear(&pTerrainRenderer->cdlod);
+	HiZBuffer_Invalidate(pTerrainRenderer->pHiZBuffer);
 
-	// Upload indirect commands
-	IndirectBufferObject_Upload(pTerrainRenderer->pIndirectBuffer);
+	if (pTerrainRenderer->bGPUCulling)
+	{
+		memset(pTerrainRenderer->pCullCommandsSSBO->pBufferData, 0, commandCount * sizeof(SIndirectDrawCommand));
+	}
 }
 
 void TerrainRenderer_Render(TerrainRenderer pTerrainRenderer)
@@ -275,6 +603,8 @@ void TerrainRenderer_Render(TerrainRenderer pTerrainRenderer)
 	Shader_SetFloat(pTerrainRenderer->pTerrainShader, "ENGINE_CELL_SIZE", (float)ENGINE_CELL_SIZE);
 	Shader_SetVec2(pTerrainRenderer->pTerrainShader, "TERRAIN_SIZE", Vector2Di(TERRAIN_XSIZE, TERRAIN_ZSIZE));
 	Shader_SetInt(pTerrainRenderer->pTerrainShader, "TERRAIN_HEIGHTMAP_RAW_XSIZE", HEIGHTMAP_RAW_XSIZE);
+	Shader_SetInt(pTerrainRenderer->pTerrainShader, "PATCH_SIZE", PATCH_SIZE);
+	Shader_SetInt(pTerrainRenderer->pTerrainShader, "u_vertex_DrawID", -1); // Indirect draws carry the patch in baseInstance, the legacy path sets it per draw
 
 	StateManager_SetCapability(GetStateManager(), CAP_DEPTH_TEST, true);
 	StateManager_SetCapability(GetStateManager(), CAP_CULL_FACE, true);
@@ -284,28 +614,537 @@ void TerrainRenderer_Render(TerrainRenderer pTerrainRenderer)
 	StateManager_SetCapability(GetStateManager(), CAP_BLEND, false);
 	StateManager_SetBlendFunc(GetStateManager(), GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	if (IsGLVersionHigher(4, 5))
+	if (pTerrainRenderer->bCDLOD)
 	{
-		TerrainRenderer_RenderIndirect(pTerrainRenderer);
+		TerrainRenderer_RenderCDLOD(pTerrainRenderer);
 	}
 	else
 	{
-		TerrainRenderer_RenderLegacy(pTerrainRenderer);
+		// Runs on the CPU in GPU cull mode too, terrain_cull.comp only culls the commands it picks
+		double startMs = JobSystem_GetTimeMs();
+		TerrainRenderer_SelectLODs(pTerrainRenderer);
+		pTerrainRenderer->cullStats.lodMs = JobSystem_GetTimeMs() - startMs;
+
+		if (IsGLVersionHigher(4, 5))
+		{
+			TerrainRenderer_RenderIndirect(pTerrainRenderer);
+		}
+		else
+		{
+			TerrainRenderer_RenderLegacy(pTerrainRenderer);
+		}
+	}
+
+	// Every occlusion culled frame rebuilds the pyramid, one left from before a frame without it is stale
+	if (!pTerrainRenderer->bOcclusion || pTerrainRenderer->cullMode != TERRAIN_CULL_GPU || pTerrainRenderer->bCDLOD)
+	{
+		HiZBuffer_Invalidate(pTerrainRenderer->pHiZBuffer);
 	}
 
 	StateManager_PopState(GetStateManager());
 }
 
+// Command index of the patch on one side (EPatchStitch bit order) of a patch, -1 when no resident patch is there
+static int32_t TerrainRenderer_GetNeighbourPatch(TerrainRenderer pTerrainRenderer, uint32_t index, int32_t side)
+{
+	static const int32_t sideX[4] = { -1, 1, 0, 0 };
+	static const int32_t sideZ[4] = { 0, 0, -1, 1 };
+
+	int32_t iSlot = (int32_t)(index / TERRAIN_PATCH_COUNT);
+	int32_t iPatchX = (int32_t)(index % TERRAIN_PATCH_COUNT) % PATCH_XCOUNT + sideX[side];
+	int32_t iPatchZ = (int32_t)(index % TERRAIN_PATCH_COUNT) / PATCH_XCOUNT + sideZ[side];
+
+	// Off the terrain edge, the patch on the other side belongs to the neighbouring slot
+	if (iPatchX < 0 || iPatchX >= PATCH_XCOUNT || iPatchZ < 0 || iPatchZ >= PATCH_ZCOUNT)
+	{
+		iSlot = pTerrainRenderer->pSlotNeighbours[iSlot * 4 + side];
+		iPatchX = (iPatchX + PATCH_XCOUNT) % PATCH_XCOUNT;
+		iPatchZ = (iPatchZ + PATCH_ZCOUNT) % PATCH_ZCOUNT;
+	}
+
+	if (iSlot < 0)
+	{
+		return (-1);
+	}
+
+	uint32_t neighbour = (uint32_t)iSlot * TERRAIN_PATCH_COUNT + (uint32_t)(iPatchZ * PATCH_XCOUNT + iPatchX);
+	return ((pTerrainRenderer->pPatchCommands[neighbour].count > 0) ? (int32_t)neighbour : -1);
+}
+
+void TerrainRenderer_SelectLODs(TerrainRenderer pTerrainRenderer)
+{
+	uint32_t commandCount = (uint32_t)pTerrainRenderer->gpuSlotCount * TERRAIN_PATCH_COUNT;
+	uint8_t* pLODs = pTerrainRenderer->pPatchLODs;
+	const STerrainPatchBounds* pBounds = &pTerrainRenderer->patchBounds;
+	TerrainMap pTerrainMap = GetTerrainManager()->pTerrainMap;
+
+	// Which slot holds the terrain on each side, slots are reused so it is redone every frame
+	for (int32_t iSlot = 0; iSlot < pTerrainRenderer->gpuSlotCount; iSlot++)
+	{
+		int32_t iTerrainX = pTerrainRenderer->pSlotCoords[iSlot * 2];
+		int32_t iTerrainZ = pTerrainRenderer->pSlotCoords[iSlot * 2 + 1];
+
+		for (int32_t side = 0; side < 4; side++)
+		{
+			int32_t iNeighbourX = iTerrainX + ((side == 0) ? -1 : (side == 1) ? 1 : 0);
+			int32_t iNeighbourZ = iTerrainZ + ((side == 2) ? -1 : (side == 3) ? 1 : 0);
+			Terrain pNeighbour = (iTerrainX != INT32_MIN) ? TerrainMap_GetTerrain(pTerrainMap, iNeighbourX, iNeighbourZ) : NULL;
+
+			int32_t iNeighbourSlot = (pNeighbour) ? pNeighbour->gpuSlot : -1;
+			bool bUploaded = (iNeighbourSlot >= 0 && iNeighbourSlot < pTerrainRenderer->gpuSlotCount &&
+				pTerrainRenderer->pSlotCoords[iNeighbourSlot * 2] == iNeighbourX && pTerrainRenderer->pSlotCoords[iNeighbourSlot * 2 + 1] == iNeighbourZ);
+			pTerrainRenderer->pSlotNeighbours[iSlot * 4 + side] = (bUploaded) ? iNeighbourSlot : -1;
+		}
+	}
+
+	// Coarsest LOD whose height error projects under lodPixelError pixels, from the distance to the patch box
+	if (pTerrainRenderer->bLOD)
+	{
+		Vector3 v3Camera = Camera_GetPosition(pTerrainRenderer->pCamera);
+		float pixelsPerUnit = 0.5f * Camera_GetViewportHeight(pTerrainRenderer->pCamera) * Camera_GetProjectionMatrix(pTerrainRenderer->pCamera).m[5];
+		float errorPerDistance = (pixelsPerUnit > 0.0f) ? pTerrainRenderer->lodPixelError / pixelsPerUnit : 0.0f;
+
+		for (uint32_t i = 0; i < commandCount; i++)
+		{
+			if (pTerrainRenderer->pPatchCommands[i].count == 0)
+			{
+				pLODs[i] = 0;
+				continue;
+			}
+
+			float dx = fmaxf(fmaxf(pBounds->pMinX[i] - v3Camera.x, v3Camera.x - pBounds->pMaxX[i]), 0.0f);
+			float dy = fmaxf(fmaxf(pBounds->pMinY[i] - v3Camera.y, v3Camera.y - pBounds->pMaxY[i]), 0.0f);
+			float dz = fmaxf(fmaxf(pBounds->pMinZ[i] - v3Camera.z, v3Camera.z - pBounds->pMaxZ[i]), 0.0f);
+			float allowedError = errorPerDistance * sqrtf(dx * dx + dy * dy + dz * dz);
+
+			const float* pErrors = &pTerrainRenderer->pPatchLODErrors[i * PATCH_LOD_COUNT];
+			uint8_t lod = 0;
+			while (lod + 1 < PATCH_LOD_COUNT && pErrors[lod + 1] <= allowedError)
+			{
+				lod++;
+			}
+			pLODs[i] = lod;
+		}
+
+		// A stitch folds one level, so neighbours may differ by one LOD at most. Lowering only moves
+		// a patch towards its finer neighbour, and a chain of lowerings is shorter than the LOD count
+		for (int32_t iPass = 0; iPass < PATCH_LOD_COUNT; iPass++)
+		{
+			bool bChanged = false;
+			for (uint32_t i = 0; i < commandCount; i++)
+			{
+				if (pTerrainRenderer->pPatchCommands[i].count == 0)
+				{
+					continue;
+				}
+
+				for (int32_t side = 0; side < 4; side++)
+				{
+					int32_t iNeighbour = TerrainRenderer_GetNeighbourPatch(pTerrainRenderer, i, side);
+					if (iNeighbour >= 0 && pLODs[i] > pLODs[iNeighbour] + 1)
+					{
+						pLODs[i] = (uint8_t)(pLODs[iNeighbour] + 1);
+						bChanged = true;
+					}
+				}
+			}
+
+			if (!bChanged)
+			{
+				break;
+			}
+		}
+	}
+	else
+	{
+		memset(pLODs, 0, commandCount);
+	}
+
+	// Stitch the sides facing a coarser neighbour, only changed commands are written again
+	const STerrainPatchIndices* pSharedIndices = TerrainPatch_GetSharedIndices();
+	for (uint32_t i = 0; i < commandCount; i++)
+	{
+		SIndirectDrawCommand* pCommand = &pTerrainRenderer->pPatchCommands[i];
+		if (pCommand->count == 0)
+		{
+			continue;
+		}
+
+		uint32_t stitch = 0;
+		for (int32_t side = 0; side < 4 && pTerrainRenderer->bLOD; side++)
+		{
+			int32_t iNeighbour = TerrainRenderer_GetNeighbourPatch(pTerrainRenderer, i, side);
+			if (iNeighbour >= 0 && pLODs[iNeighbour] > pLODs[i])
+			{
+				stitch |= 1u << side;
+			}
+		}
+
+		GLuint firstIndex = pSharedIndices->firstIndex[pLODs[i]][stitch];
+		if (pCommand->firstIndex != firstIndex)
+		{
+			pCommand->firstIndex = firstIndex;
+			pCommand->count = pSharedIndices->indexCount[pLODs[i]][stitch];
+			TerrainRenderer_WriteCullPatch(pTerrainRenderer, i);
+		}
+	}
+}
+
+void TerrainRenderer_SetLOD(TerrainRenderer pTerrainRenderer, bool bEnabled)
+{
+	if (!pTerrainRenderer)
+	{
+		return;
+	}
+
+	pTerrainRenderer->bLOD = bEnabled;
+}
+
+void TerrainRenderer_SetCDLOD(TerrainRenderer pTerrainRenderer, bool bEnabled)
+{
+	if (!pTerrainRenderer)
+	{
+		return;
+	}
+
+	if (bEnabled && !pTerrainRenderer->pCDLODNodesSSBO)
+	{
+		syslog("CDLOD Terrain is not supported, drawing the patches");
+		bEnabled = false;
+	}
+
+	pTerrainRenderer->bCDLOD = bEnabled;
+}
+
+void TerrainRenderer_SetOcclusion(TerrainRenderer pTerrainRenderer, bool bEnabled)
+{
+	if (!pTerrainRenderer)
+	{
+		return;
+	}
+
+	if (bEnabled && !pTerrainRenderer->pHiZBuffer)
+	{
+		syslog("Terrain Occlusion Culling is not supported, drawing every patch in the frustum");
+		bEnabled = false;
+	}
+
+	pTerrainRenderer->bOcclusion = bEnabled;
+}
+
+/**
+ * @brief Resets the counters and dispatches terrain_cull.comp, which appends the visible commands to the indirect buffer.
+ */
+static void TerrainRenderer_CullPatchesGPU(TerrainRenderer pTerrainRenderer, uint32_t commandCount)
+{
+	static const GLuint zeroCounts[TERRAIN_CULL_COUNTER_COUNT] = { 0, 0, 0, 0, 0 };
+	ShaderStorageBufferObject_Update(pTerrainRenderer->pDrawCountSSBO, zeroCounts, sizeof(zeroCounts), 0, false);
+
+	ShaderStorageBufferObject_Bind(pTerrainRenderer->pCullBoundsSSBO);
+	ShaderStorageBufferObject_Bind(pTerrainRenderer->pCullCommandsSSBO);
+	ShaderStorageBufferObject_Bind(pTerrainRenderer->pDrawCountSSBO);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SSBO_BP_CULL_VISIBLE_COMMANDS, pTerrainRenderer->pIndirectBuffer->bufferID);
+
+	// Without a pyramid u_hizLevelCount is 0 and the occlusion test passes everything
+	if (pTerrainRenderer->bOcclusion)
+	{
+		ShaderStorageBufferObject_Bind(pTerrainRenderer->pOccludedSSBO);
+		HiZBuffer_Bind(pTerrainRenderer->pHiZBuffer, pTerrainRenderer->pCullShader);
+	}
+	else
+	{
+		Shader_SetInt(pTerrainRenderer->pCullShader, "u_hizLevelCount", 0);
+	}
+	Shader_SetInt(pTerrainRenderer->pCullShader, "u_cullPass", 0);
+
+	StateManager_BindShader(GetStateManager(), pTerrainRenderer->pCullShader);
+	glDispatchCompute((commandCount + TERRAIN_CULL_GROUP_SIZE - 1) / TERRAIN_CULL_GROUP_SIZE, 1, 1);
+
+	// The draw reads the commands and the count, the next reset and the stats read the counters, the second pass the occluded list
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+/**
+ * @brief Builds the pyramid from the first draw and tests the patches it hid last frame again.
+ *
+ * The ones this frame uncovered are appended to the late buffer, so terrain coming out
+ * from behind a ridge is not missing for a frame.
+ */
+static void TerrainRenderer_CullOccludedGPU(TerrainRenderer pTerrainRenderer, uint32_t commandCount)
+{
+	HiZBuffer_Build(pTerrainRenderer->pHiZBuffer, Camera_GetViewProjectionMatrix(pTerrainRenderer->pCamera));
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SSBO_BP_CULL_VISIBLE_COMMANDS, pTerrainRenderer->pLateIndirectBuffer->bufferID);
+	HiZBuffer_Bind(pTerrainRenderer->pHiZBuffer, pTerrainRenderer->pCullShader);
+	Shader_SetInt(pTerrainRenderer->pCullShader, "u_cullPass", 1);
+
+	// The occluded count is only known on the GPU, the extra invocations return early
+	StateManager_BindShader(GetStateManager(), pTerrainRenderer->pCullShader);
+	glDispatchCompute((commandCount + TERRAIN_CULL_GROUP_SIZE - 1) / TERRAIN_CULL_GROUP_SIZE, 1, 1);
+
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+}
+
+/**
+ * @brief Takes every counter copy the GPU has finished, oldest first, so the newest one is kept.
+ */
+static void TerrainRenderer_PollCullReadback(TerrainRenderer pTerrainRenderer)
+{
+	for (int32_t i = 0; i < TERRAIN_CULL_READBACK_COUNT; i++)
+	{
+		int32_t index = (pTerrainRenderer->cullReadbackIndex + i) % TERRAIN_CULL_READBACK_COUNT;
+		GLsync fence = pTerrainRenderer->cullReadbackFences[index];
+		if (!fence)
+		{
+			continue;
+		}
+
+		// Copies finish in order, once one is still running the later ones are too
+		GLenum waitResult = glClientWaitSync(fence, 0, 0);
+		if (waitResult != GL_ALREADY_SIGNALED && waitResult != GL_CONDITION_SATISFIED)
+		{
+			break;
+		}
+
+		memcpy(pTerrainRenderer->cullCounters, pTerrainRenderer->pCullReadbackData[index], sizeof(pTerrainRenderer->cullCounters));
+		glDeleteSync(fence);
+		pTerrainRenderer->cullReadbackFences[index] = NULL;
+	}
+}
+
+/**
+ * @brief Copies this frame's counters into the ring once both cull passes wrote them.
+ *
+ * When the oldest copy is still in flight the frame is skipped rather than waited on.
+ */
+static void TerrainRenderer_QueueCullReadback(TerrainRenderer pTerrainRenderer)
+{
+	TerrainRenderer_PollCullReadback(pTerrainRenderer);
+
+	int32_t index = pTerrainRenderer->cullReadbackIndex;
+	if (pTerrainRenderer->cullReadbackFences[index])
+	{
+		return;
+	}
+
+	glCopyNamedBufferSubData(pTerrainRenderer->pDrawCountSSBO->bufferID, pTerrainRenderer->cullReadbackBuffers[index], 0, 0, sizeof(pTerrainRenderer->cullCounters));
+	pTerrainRenderer->cullReadbackFences[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	pTerrainRenderer->cullReadbackIndex = (index + 1) % TERRAIN_CULL_READBACK_COUNT;
+}
+
+void TerrainRenderer_CullPatches(TerrainRenderer pTerrainRenderer)
+{
+	double startMs = JobSystem_GetTimeMs();
+
+	uint32_t commandCount = (uint32_t)pTerrainRenderer->gpuSlotCount * TERRAIN_PATCH_COUNT;
+	uint32_t candidateCount = commandCount;
+
+	pTerrainRenderer->cullStats.mode = pTerrainRenderer->cullMode;
+	pTerrainRenderer->cullStats.bCDLOD = false;
+	pTerrainRenderer->cullStats.occludedCount = 0;
+	pTerrainRenderer->cullStats.hizBuildMs = (pTerrainRenderer->bOcclusion && pTerrainRenderer->pHiZBuffer) ? pTerrainRenderer->pHiZBuffer->buildMs : 0.0;
+
+	// No CPU work that grows with the map, the counts come back through TerrainRenderer_QueueCullReadback
+	if (pTerrainRenderer->cullMode == TERRAIN_CULL_GPU)
+	{
+		TerrainRenderer_CullPatchesGPU(pTerrainRenderer, commandCount);
+		pTerrainRenderer->cullStats.cullMs = JobSystem_GetTimeMs() - startMs;
+		return;
+	}
+
+	// Staging for the compacted list, only lives until IndirectBufferObject_SetCommands copies it
+	uint32_t* pCandidates = engine_frame_new(uint32_t, commandCount, MEM_TAG_RENDERING);
+	SIndirectDrawCommand* pVisibleCommands = engine_frame_new(SIndirectDrawCommand, commandCount, MEM_TAG_RENDERING);
+	if (!pCandidates || !pVisibleCommands)
+	{
+		syserr("Failed to Allocate Terrain Cull Staging");
+		return;
+	}
+
+	if (pTerrainRenderer->cullMode == TERRAIN_CULL_CPU)
+	{
+		SFrustum frustum = Frustum_FromViewProjection(Camera_GetViewProjectionMatrix(pTerrainRenderer->pCamera));
+		candidateCount = TerrainPatchBounds_Cull(&pTerrainRenderer->patchBounds, &frustum, pCandidates);
+	}
+	else
+	{
+		for (uint32_t i = 0; i < commandCount; i++)
+		{
+			pCandidates[i] = i;
+		}
+	}
+
+	// Compact, empty slots have no indices
+	uint32_t visibleCount = 0;
+	uint32_t residentCount = 0;
+	uint64_t triangleCount = 0;
+	for (uint32_t i = 0; i < commandCount; i++)
+	{
+		residentCount += (pTerrainRenderer->pPatchCommands[i].count > 0) ? 1u : 0u;
+	}
+	for (uint32_t i = 0; i < candidateCount; i++)
+	{
+		const SIndirectDrawCommand* pCommand = &pTerrainRenderer->pPatchCommands[pCandidates[i]];
+		if (pCommand->count > 0)
+		{
+			pVisibleCommands[visibleCount++] = *pCommand;
+			triangleCount += pCommand->count / 3;
+		}
+	}
+
+	IndirectBufferObject_SetCommands(pTerrainRenderer->pIndirectBuffer, pVisibleCommands, visibleCount);
+
+	pTerrainRenderer->cullStats.visibleCount = visibleCount;
+	pTerrainRenderer->cullStats.totalCount = residentCount;
+	pTerrainRenderer->cullStats.triangleCount = triangleCount;
+	pTerrainRenderer->cullStats.cullMs = JobSystem_GetTimeMs() - startMs;
+}
+
+void TerrainRenderer_SetCullMode(TerrainRenderer pTerrainRenderer, ETerrainCullMode cullMode)
+{
+	if (!pTerrainRenderer || cullMode < TERRAIN_CULL_NONE || cullMode >= TERRAIN_CULL_MODE_COUNT)
+	{
+		return;
+	}
+
+	if (cullMode == TERRAIN_CULL_GPU && !pTerrainRenderer->bGPUCulling)
+	{
+		syslog("GPU Terrain Culling is not supported, using CPU culling");
+		cullMode = TERRAIN_CULL_CPU;
+	}
+
+	pTerrainRenderer->cullMode = cullMode;
+}
+
+void TerrainRenderer_GetCullStats(TerrainRenderer pTerrainRenderer, STerrainCullStats* pStats)
+{
+	if (!pTerrainRenderer || !pStats)
+	{
+		return;
+	}
+
+	*pStats = pTerrainRenderer->cullStats;
+
+	// The counters are written on the GPU, the newest copy that already came back is a frame or two old
+	if (pTerrainRenderer->cullStats.mode == TERRAIN_CULL_GPU && !pTerrainRenderer->cullStats.bCDLOD)
+	{
+		TerrainRenderer_PollCullReadback(pTerrainRenderer);
+		const GLuint* counts = pTerrainRenderer->cullCounters;
+		pStats->visibleCount = counts[0] + counts[4];
+		pStats->totalCount = counts[1];
+		pStats->triangleCount = counts[2];
+		pStats->occludedCount = counts[3] - counts[4];
+	}
+}
+
 void TerrainRenderer_RenderIndirect(TerrainRenderer pTerrainRenderer)
 {
 	ShaderStorageBufferObject_Bind(pTerrainRenderer->pTerrainRendererSSBO);
 	ShaderStorageBufferObject_Bind(pTerrainRenderer->pPatchRendererSSBO);
 	ShaderStorageBufferObject_Bind(pTerrainRenderer->pHeightMapSSBO);
 
+	TerrainRenderer_CullPatches(pTerrainRenderer);
+
+	if (pTerrainRenderer->cullMode == TERRAIN_CULL_GPU)
+	{
+		// The cull pass bound its compute program, the count comes from the GPU
+		GLsizei maxDrawCount = pTerrainRenderer->gpuSlotCount * TERRAIN_PATCH_COUNT;
+		StateManager_BindShader(GetStateManager(), pTerrainRenderer->pTerrainShader);
+		IndirectBufferObject_DrawCount(pTerrainRenderer->pIndirectBuffer, pTerrainRenderer->primitiveType, pTerrainRenderer->pDrawCountSSBO->bufferID, 0, maxDrawCount);
+
+		// The occluded patches this frame's depth uncovered, drawn with the count after the first four counters
+		if (pTerrainRenderer->bOcclusion)
+		{
+			TerrainRenderer_CullOccludedGPU(pTerrainRenderer, (uint32_t)maxDrawCount);
+			StateManager_BindShader(GetStateManager(), pTerrainRenderer->pTerrainShader);
+			IndirectBufferObject_DrawCount(pTerrainRenderer->pLateIndirectBuffer, pTerrainRenderer->primitiveType, pTerrainRenderer->pDrawCountSSBO->bufferID, 4 * sizeof(GLuint), maxDrawCount);
+		}
+
+		TerrainRenderer_QueueCullReadback(pTerrainRenderer);
+		return;
+	}
+
 	// Execute all commands in one GPU call
 	IndirectBufferObject_Draw(pTerrainRenderer->pIndirectBuffer, pTerrainRenderer->primitiveType);
 }
 
+/**
+ * @brief Selects the quadtree nodes and draws them as two instance ranges of the shared patch grid.
+ *
+ * Full nodes use the full detail indices, half nodes the LOD 1 ones so they
+ * keep their parent's resolution. Two draws whatever the map size.
+ */
+void TerrainRenderer_RenderCDLOD(TerrainRenderer pTerrainRenderer)
+{
+	double startMs = JobSystem_GetTimeMs();
+
+	STerrainCDLOD* pTree = &pTerrainRenderer->cdlod;
+	if (!pTree->pMinHeights)
+	{
+		return;
+	}
+
+	SFrustum frustum = Frustum_FromViewProjection(Camera_GetViewProjectionMatrix(pTerrainRenderer->pCamera));
+	Vector3 v3Camera = Camera_GetPosition(pTerrainRenderer->pCamera);
+	uint32_t nodeCount = TerrainCDLOD_Select(pTree, v3Camera, &frustum);
+
+	if (pTree->bSlotsDirty)
+	{
+		ShaderStorageBufferObject_Update(pTerrainRenderer->pCDLODSlotsSSBO, pTree->pTerrainSlots, pTerrainRenderer->pCDLODSlotsSSBO->bufferSize, 0, false);
+		pTree->bSlotsDirty = false;
+	}
+
+	if (nodeCount > 0)
+	{
+		ShaderStorageBufferObject_Update(pTerrainRenderer->pCDLODNodesSSBO, pTree->pNodes, nodeCount * sizeof(STerrainCDLODNode), 0, false);
+	}
+
+	const STerrainPatchIndices* pSharedIndices = TerrainPatch_GetSharedIndices();
+	GLuint fullIndexCount = pSharedIndices->indexCount[0][0];
+	GLuint halfIndexCount = pSharedIndices->indexCount[1][0];
+
+	pTerrainRenderer->cullStats.bCDLOD = true;
+	pTerrainRenderer->cullStats.occludedCount = 0;
+	pTerrainRenderer->cullStats.hizBuildMs = 0.0;
+	pTerrainRenderer->cullStats.lodMs = 0.0;
+	pTerrainRenderer->cullStats.visibleCount = nodeCount;
+	pTerrainRenderer->cullStats.totalCount = pTree->pResidentLeaves[pTree->levelOffset[pTree->levelCount - 1]];
+	pTerrainRenderer->cullStats.triangleCount = (uint64_t)pTree->fullCount * (fullIndexCount / 3) + (uint64_t)pTree->halfCount * (halfIndexCount / 3);
+	pTerrainRenderer->cullStats.cullMs = JobSystem_GetTimeMs() - startMs;
+
+	GLShader pShader = pTerrainRenderer->pCDLODShader;
+	StateManager_BindShader(GetStateManager(), pShader);
+
+	Shader_SetFloat(pShader, "ENGINE_CELL_SIZE", (float)ENGINE_CELL_SIZE);
+	Shader_SetVec2(pShader, "TERRAIN_SIZE", Vector2Di(TERRAIN_XSIZE, TERRAIN_ZSIZE));
+	Shader_SetInt(pShader, "TERRAIN_HEIGHTMAP_RAW_XSIZE", HEIGHTMAP_RAW_XSIZE);
+	Shader_SetInt(pShader, "PATCH_SIZE", PATCH_SIZE);
+	Shader_SetVec2(pShader, "u_cdlodMapSize", Vector2Di(pTree->terrainsXCount, pTree->terrainsZCount));
+	Shader_SetInt(pShader, "u_cdlodTopLevel", pTree->levelCount - 1);
+	Shader_SetFloat(pShader, "u_cdlodLeafRange", pTree->leafRange);
+	Shader_SetFloat(pShader, "u_cdlodMorphStart", TERRAIN_CDLOD_MORPH_START);
+	Shader_SetVec3(pShader, "u_cdlodCamera", v3Camera);
+
+	ShaderStorageBufferObject_Bind(pTerrainRenderer->pTerrainRendererSSBO);
+	ShaderStorageBufferObject_Bind(pTerrainRenderer->pHeightMapSSBO);
+	ShaderStorageBufferObject_Bind(pTerrainRenderer->pCDLODNodesSSBO);
+	ShaderStorageBufferObject_Bind(pTerrainRenderer->pCDLODSlotsSSBO);
+
+	if (pTree->fullCount > 0)
+	{
+		Shader_SetInt(pShader, "u_cdlodFirstNode", 0);
+		glDrawElementsInstanced(pTerrainRenderer->primitiveType, (GLsizei)fullIndexCount, GL_UNSIGNED_INT,
+			(void*)(pSharedIndices->firstIndex[0][0] * sizeof(GLuint)), (GLsizei)pTree->fullCount);
+	}
+
+	if (pTree->halfCount > 0)
+	{
+		Shader_SetInt(pShader, "u_cdlodFirstNode", (GLint)pTree->fullCount);
+		glDrawElementsInstanced(pTerrainRenderer->primitiveType, (GLsizei)halfIndexCount, GL_UNSIGNED_INT,
+			(void*)(pSharedIndices->firstIndex[1][0] * sizeof(GLuint)), (GLsizei)pTree->halfCount);
+	}
+}
+
 void TerrainRenderer_RenderLegacy(TerrainRenderer pTerrainRenderer)
 {
 	if (GetTerrainManager()->isMapReady == false)
@@ -324,22 +1163,17 @@ void TerrainRenderer_RenderLegacy(TerrainRenderer pTerrainRenderer)
 	int32_t terrainsZNum = pTerrainMap->terrainsZCount;
 	int32_t terrainsXNum = pTerrainMap->terrainsXCount;
 
-	uint32_t globalPatchIndex = 0;
-
 	for (int32_t iTerrNumZ = 0; iTerrNumZ < terrainsZNum; iTerrNumZ++)
 	{
 		for (int32_t iTerrNumX = 0; iTerrNumX < terrainsXNum; iTerrNumX++)
 		{
-			int32_t iTerrainIndex = iTerrNumZ * terrainsXNum + iTerrNumX;
-			Terrain pTerrain = Vector_GetPtr(pTerrainMap->terrains, iTerrainIndex);
+			// Not loaded yet
+			Terrain pTerrain = TerrainMap_GetTerrain(pTerrainMap, iTerrNumX, iTerrNumZ);
 			if (!pTerrain)
 			{
-				syserr("Error At Terrain %d", iTerrainIndex);
-				break;
+				continue;
 			}
 
-			pTerrain->baseGlobalPatchIndex = globalPatchIndex;  // Terrain 0,0: 0
-
 			for (int32_t iPatchZ = 0; iPatchZ < PATCH_ZCOUNT; iPatchZ++)
 			{
 				for (int32_t iPatchX = 0; iPatchX < PATCH_XCOUNT; iPatchX++)
@@ -347,7 +1181,7 @@ void TerrainRenderer_RenderLegacy(TerrainRenderer pTerrainRenderer)
 					int32_t iPatchIndex = iPatchZ * PATCH_XCOUNT + iPatchX;
 					TerrainPatch terrainPatch = Vector_GetPtr(pTerrain->terrainPatches, iPatchIndex);  // Single line!
 
-					if (!terrainPatch || !terrainPatch->terrainMesh || terrainPatch->terrainMesh->vertexCount == 0)
+					if (!terrainPatch || !terrainPatch->terrainMesh || (!TERRAIN_VERTEX_PULLING && terrainPatch->terrainMesh->vertexCount == 0))
 					{
 						syserr("vertex count is 0 for mesh Index %d", iPatchIndex);
 						continue;
@@ -355,6 +1189,13 @@ void TerrainRenderer_RenderLegacy(TerrainRenderer pTerrainRenderer)
 
 					TerrainMesh terrainMesh = terrainPatch->terrainMesh;
 
+					// The patch command carries the LOD TerrainRenderer_SelectLODs picked
+					const SIndirectDrawCommand* pCommand = &pTerrainRenderer->pPatchCommands[terrainMesh->meshMatrixIndex];
+					if (pTerrain->gpuSlot < 0 || pCommand->count == 0)
+					{
+						continue;
+					}
+
 					// Set model matrix as uniform (instead of SSBO)
 					Shader_SetMat4(pTerrainRenderer->pTerrainShader, "u_matModel", S_Matrix4_Identity);
 					Shader_SetInt(pTerrainRenderer->pTerrainShader, "u_vertex_DrawID", terrainMesh->meshMatrixIndex);
@@ -362,9 +1203,9 @@ void TerrainRenderer_RenderLegacy(TerrainRenderer pTerrainRenderer)
 					// Draw this mesh
 					glDrawElementsBaseVertex(
 						pTerrainRenderer->primitiveType,
-						(GLsizei)terrainMesh->indexCount,
+						(GLsizei)pCommand->count,
 						GL_UNSIGNED_INT,
-						(void*)(terrainMesh->indexOffset * sizeof(GLuint)),  // Index offset
+						(void*)(pCommand->firstIndex * sizeof(GLuint)),  // Index offset
 						(GLint)terrainMesh->vertexOffset                      // Vertex offset
 					);
 				}
@@ -377,7 +1218,8 @@ void TerrainRenderer_RenderLegacy(TerrainRenderer pTerrainRenderer)
 
 void TerrainRenderer_Reset(TerrainRenderer pTerrainRenderer)
 {
-	// Reset buffer and commands
+	// Reset buffer and commands, the shared indices go back in so the high-water mark covers them
 	TerrainBuffer_Reset(pTerrainRenderer->pTerrainBuffer);
-	IndirectBufferObject_Clear(pTerrainRenderer->pIndirectBuffer);
+	TerrainRenderer_UploadSharedIndices(pTerrainRenderer);
+	TerrainRenderer_ResetSlots(pTerrainRenderer);
 }
@@ -8,12 +8,26 @@
 #include "../Core/Camera.h"
 #include "../Terrain/Terrain/Terrain.h"
 #include "../Terrain/TerrainMap/TerrainMap.h"
+#include "TerrainCulling.h"
+#include "TerrainCDLOD.h"
+#include "HiZBuffer.h"
+
+#define TERRAIN_LOD_PIXEL_ERROR 1.0f // Height error a coarser patch LOD may show on screen, in pixels
+#define TERRAIN_CULL_READBACK_COUNT 3 // Frames of GPU cull counters in flight before the stats get them
+#define TERRAIN_CULL_COUNTER_COUNT 5  // drawCount, residentCount, triangleCount, occludedCount, lateDrawCount
 
 typedef enum ERendererSSBOBP // Renderer SSBO Binding Points
 {
     SSBO_BP_TERRAIN_DATA,
     SSBO_BP_PATCHES_DATA,
     SSBO_BP_TERRAIN_HEIGHTMAP,
+    SSBO_BP_CULL_BOUNDS,            // terrain_cull.comp inputs and outputs
+    SSBO_BP_CULL_COMMANDS,
+    SSBO_BP_CULL_VISIBLE_COMMANDS,  // The indirect buffer
+    SSBO_BP_CULL_DRAW_COUNT,
+    SSBO_BP_CDLOD_NODES,            // terrain_shader_cdlod.vert
+    SSBO_BP_CDLOD_TERRAIN_SLOTS,
+    SSBO_BP_CULL_OCCLUDED,          // terrain_cull.comp, patches the first pass found occluded
 } ERendererSSBOBP;
 
 typedef struct SPatchGPUData
@@ -29,6 +43,12 @@ typedef struct STerrainGPUData
     int32_t terrainCoords[2];       // Maintain 16-byte alignment for GLSL
 } STerrainGPUData;
 
+typedef struct SPatchGPUBounds
+{
+    float minBounds[4];             // World AABB, w unused (vec4 in std430)
+    float maxBounds[4];
+} SPatchGPUBounds;
+
 typedef struct STerrainRenderer
 {
     // GPU Resources
@@ -41,6 +61,50 @@ typedef struct STerrainRenderer
 
     // Typed primitive groups (dynamic)
     GLenum primitiveType; // GL_LINES or GL_TRIANGLES
+    int32_t gpuSlotCount; // Terrains the GPU buffers hold at once
+
+    // Patch culling, one entry per patch of every slot (slot * TERRAIN_PATCH_COUNT + patch)
+    SIndirectDrawCommand* pPatchCommands;   // Every resident patch, the indirect buffer only gets the visible ones
+    STerrainPatchBounds patchBounds;
+    STerrainCullStats cullStats;
+    ETerrainCullMode cullMode;
+
+    // GPU culling, the commands and bounds mirrored into persistent SSBOs for terrain_cull.comp
+    GLShader pCullShader;
+    ShaderStorageBufferObject pCullBoundsSSBO;
+    ShaderStorageBufferObject pCullCommandsSSBO;
+    ShaderStorageBufferObject pDrawCountSSBO;    // drawCount, residentCount, triangleCount, occludedCount, lateDrawCount
+    bool bGPUCulling;                            // Compute shaders and indirect count draws are available
+
+    // The counters are copied into a ring after the cull passes, the stats take the newest copy whose fence passed
+    GLuint cullReadbackBuffers[TERRAIN_CULL_READBACK_COUNT];
+    GLuint* pCullReadbackData[TERRAIN_CULL_READBACK_COUNT];  // Persistently mapped for reading
+    GLsync cullReadbackFences[TERRAIN_CULL_READBACK_COUNT];  // NULL when the copy was read or never made
+    int32_t cullReadbackIndex;                               // Next copy, also the oldest one still in flight
+    GLuint cullCounters[TERRAIN_CULL_COUNTER_COUNT];         // Last counters read back
+
+    // Occlusion culling, terrain_cull.comp also tests the patches against the depth pyramid of the last frame.
+    // The pyramid is then rebuilt from the first draw and the occluded patches tested again, the ones
+    // it uncovered are drawn from the late buffer in the same frame
+    HiZBuffer pHiZBuffer;
+    IndirectBufferObject pLateIndirectBuffer;
+    ShaderStorageBufferObject pOccludedSSBO;
+    bool bOcclusion;
+
+    // Geomipmapping, the LOD and stitch mask of every patch are picked each frame and written into its command
+    float* pPatchLODErrors;     // PATCH_LOD_COUNT per patch, from TerrainPatch_UpdateLODErrors
+    uint8_t* pPatchLODs;
+    int32_t* pSlotCoords;       // Terrain x, z held by every slot, INT32_MIN when free
+    int32_t* pSlotNeighbours;   // Slot on each side of a slot (EPatchStitch order), -1 when none
+    float lodPixelError;
+    bool bLOD;
+
+    // CDLOD, one quadtree over the map replaces the per patch commands, its nodes are instances of one grid
+    GLShader pCDLODShader;
+    ShaderStorageBufferObject pCDLODNodesSSBO;
+    ShaderStorageBufferObject pCDLODSlotsSSBO;  // GPU slot of every map terrain, sized for the map
+    STerrainCDLOD cdlod;
+    bool bCDLOD;
 
     // Renderer Data
     char* szRendererName;
@@ -51,16 +115,38 @@ typedef struct STerrainRenderer
 
 typedef struct STerrainRenderer* TerrainRenderer;
 
-bool TerrainRenderer_Initialize(TerrainRenderer* ppTerrainRenderer, const char* szRendererName, int32_t iTerrainX, int32_t iTerrainZ);
+bool TerrainRenderer_Initialize(TerrainRenderer* ppTerrainRenderer, const char* szRendererName, int32_t gpuSlotCount);
 void TerrainRenderer_Destroy(TerrainRenderer* pTerrainRenderer);
-bool TerrainRenderer_InitGLBuffers(TerrainRenderer pTerrainRenderer, GLenum glType, GLint iTerrainX, GLint iTerrainZ);
+bool TerrainRenderer_InitGLBuffers(TerrainRenderer pTerrainRenderer, GLenum glType, GLint gpuSlotCount);
 void TerrainRenderer_DestroyGLBuffers(TerrainRenderer pTerrainRenderer);
 
+void TerrainRenderer_UploadSharedIndices(TerrainRenderer pTerrainRenderer);
 void TerrainRenderer_UploadGPUData(TerrainRenderer pTerrainRenderer);
+void TerrainRenderer_UploadTerrain(TerrainRenderer pTerrainRenderer, Terrain pTerrain); // Writes one terrain into its GPU slot
+void TerrainRenderer_ReleaseSlot(TerrainRenderer pTerrainRenderer, int32_t iSlot);
+void TerrainRenderer_ResetSlots(TerrainRenderer pTerrainRenderer);
 void TerrainRenderer_Render(TerrainRenderer pTerrainRenderer);
 void TerrainRenderer_RenderIndirect(TerrainRenderer pTerrainRenderer);
 void TerrainRenderer_RenderLegacy(TerrainRenderer pTerrainRenderer);
+void TerrainRenderer_RenderCDLOD(TerrainRenderer pTerrainRenderer);
 
 void TerrainRenderer_Reset(TerrainRenderer pTerrainRenderer);
 
+/**
+ * @brief Rewrites the indirect buffer with the patches whose bounds touch the camera frustum.
+ *
+ * With TERRAIN_CULL_GPU this only dispatches terrain_cull.comp, the draw count stays on the GPU.
+ */
+void TerrainRenderer_CullPatches(TerrainRenderer pTerrainRenderer);
+
+/**
+ * @brief Picks the coarsest LOD each patch can take within lodPixelError, then brings neighbours within one LOD and stitches them.
+ */
+void TerrainRenderer_SelectLODs(TerrainRenderer pTerrainRenderer);
+void TerrainRenderer_SetLOD(TerrainRenderer pTerrainRenderer, bool bEnabled); // Off draws every patch at full resolution
+void TerrainRenderer_SetCDLOD(TerrainRenderer pTerrainRenderer, bool bEnabled); // Draws the map from the CDLOD quadtree instead of the patches
+void TerrainRenderer_SetOcclusion(TerrainRenderer pTerrainRenderer, bool bEnabled); // Only used with TERRAIN_CULL_GPU
+void TerrainRenderer_SetCullMode(TerrainRenderer pTerrainRenderer, ETerrainCullMode cullMode); // TERRAIN_CULL_GPU falls back to the CPU when unsupported
+void TerrainRenderer_GetCullStats(TerrainRenderer pTerrainRenderer, STerrainCullStats* pStats);
+
 #endif // __TERRAIN_RENDERER_H__
\ No newline at end of file
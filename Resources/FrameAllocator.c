@@ -0,0 +1,275 @@
+#include "FrameAllocator.h"
+#include "Stdafx.h"
+#include "Core/Atomics.h"
+
+// Header for blocks that did not fit in the arena and spilled to the tracked heap
+typedef struct SFrameOverflowBlock
+{
+	struct SFrameOverflowBlock* next;
+	char padding[8]; // keep the user pointer 16-byte aligned
+} SFrameOverflowBlock;
+
+typedef struct SFrameArena
+{
+	uint8_t* pBase;
+	volatile int64_t offset;			// bump pointer (bytes)
+	volatile int64_t allocationCount;
+	volatile int64_t overflowBytes;
+	volatile int64_t usageByTag[MEM_TAG_COUNT];
+	SFrameOverflowBlock* volatile pOverflow; // released when the arena is reset
+} SFrameArena;
+
+typedef struct SFrameAllocator
+{
+	SFrameArena arenas[FRAME_ARENA_COUNT];
+	size_t arenaCapacity;
+	volatile int32_t currentArena;
+	uint64_t frameIndex;
+
+	// Stats over the whole run
+	size_t highWaterMark;
+	volatile int64_t overflowCount;
+	size_t peakByTag[MEM_TAG_COUNT];
+} SFrameAllocator;
+
+static FrameAllocator psFrameAllocator = NULL;
+
+static void FrameAllocator_ResetArena(SFrameArena* pArena);
+
+bool FrameAllocator_Initialize(FrameAllocator* ppFrameAllocator, size_t arenaSize)
+{
+	if (ppFrameAllocator == NULL)
+	{
+		syserr("ppFrameAllocator is NULL (invalid address)");
+		return (false);
+	}
+
+	*ppFrameAllocator = engine_new_zero(SFrameAllocator, 1, MEM_TAG_ENGINE);
+
+	FrameAllocator pAllocator = *ppFrameAllocator;
+	if (!pAllocator)
+	{
+		syserr("Failed to Allocate Memory for FrameAllocator");
+		return (false);
+	}
+
+	// Round up so every arena starts and ends on an aligned boundary
+	arenaSize = (arenaSize + (FRAME_ARENA_ALIGNMENT - 1)) & ~((size_t)FRAME_ARENA_ALIGNMENT - 1);
+
+	for (int32_t i = 0; i < FRAME_ARENA_COUNT; i++)
+	{
+		pAllocator->arenas[i].pBase = (uint8_t*)engine_malloc(arenaSize, MEM_TAG_ENGINE);
+		if (!pAllocator->arenas[i].pBase)
+		{
+			syserr("Failed to Allocate Frame Arena %d (%zu bytes)", i, arenaSize);
+			FrameAllocator_Destroy(ppFrameAllocator);
+			return (false);
+		}
+	}
+
+	pAllocator->arenaCapacity = arenaSize;
+	pAllocator->currentArena = 0;
+
+	psFrameAllocator = pAllocator;
+	return (true);
+}
+
+void FrameAllocator_Destroy(FrameAllocator* ppFrameAllocator)
+{
+	if (!ppFrameAllocator || !*ppFrameAllocator)
+	{
+		return;
+	}
+
+	FrameAllocator pAllocator = *ppFrameAllocator;
+
+	for (int32_t i = 0; i < FRAME_ARENA_COUNT; i++)
+	{
+		FrameAllocator_ResetArena(&pAllocator->arenas[i]);
+		engine_delete(pAllocator->arenas[i].pBase);
+	}
+
+	if (psFrameAllocator == pAllocator)
+	{
+		psFrameAllocator = NULL;
+	}
+
+	engine_delete(pAllocator);
+	*ppFrameAllocator = NULL;
+}
+
+void FrameAllocator_BeginFrame()
+{
+	FrameAllocator pAllocator = psFrameAllocator;
+	if (!pAllocator)
+	{
+		return;
+	}
+
+	// Record the frame that just finished before flipping
+	SFrameArena* pFinished = &pAllocator->arenas[pAllocator->currentArena];
+	size_t used = (size_t)pFinished->offset + (size_t)pFinished->overflowBytes;
+	if (used > pAllocator->highWaterMark)
+	{
+		pAllocator->highWaterMark = used;
+	}
+
+	for (int32_t i = 0; i < MEM_TAG_COUNT; i++)
+	{
+		if ((size_t)pFinished->usageByTag[i] > pAllocator->peakByTag[i])
+		{
+			pAllocator->peakByTag[i] = (size_t)pFinished->usageByTag[i];
+		}
+	}
+
+	int32_t next = (pAllocator->currentArena + 1) % FRAME_ARENA_COUNT;
+	FrameAllocator_ResetArena(&pAllocator->arenas[next]);
+
+	AeroAtomic_Store32(&pAllocator->currentArena, next);
+	pAllocator->frameIndex++;
+}
+
+void* FrameAllocator_Alloc(size_t size, size_t alignment, EMemoryTag tag, const char* file, int line)
+{
+	FrameAllocator pAllocator = psFrameAllocator;
+	if (!pAllocator)
+	{
+		syserr("FrameAllocator used before initialization (%s:%d)", file, line);
+		return (NULL);
+	}
+
+	if (alignment < FRAME_ARENA_ALIGNMENT)
+	{
+		alignment = FRAME_ARENA_ALIGNMENT;
+	}
+
+	SFrameArena* pArena = &pAllocator->arenas[AeroAtomic_Load32(&pAllocator->currentArena)];
+
+	// Lock-free bump: retry only when another thread moved the offset under us
+	int64_t oldOffset = AeroAtomic_Load64(&pArena->offset);
+	for (;;)
+	{
+		int64_t alignedOffset = (oldOffset + (int64_t)(alignment - 1)) & ~(int64_t)(alignment - 1);
+		int64_t newOffset = alignedOffset + (int64_t)size;
+
+		if ((size_t)newOffset > pAllocator->arenaCapacity)
+		{
+			break; // Arena is full, spill to the heap
+		}
+
+		if (AeroAtomic_CompareExchange64(&pArena->offset, oldOffset, newOffset))
+		{
+			AeroAtomic_Add64(&pArena->allocationCount, 1);
+			AeroAtomic_Add64(&pArena->usageByTag[tag], (int64_t)size);
+			return (pArena->pBase + alignedOffset);
+		}
+
+		oldOffset = AeroAtomic_Load64(&pArena->offset);
+	}
+
+	// Overflow: keep the block on the arena so it dies with the frame
+	SFrameOverflowBlock* pBlock = (SFrameOverflowBlock*)tracked_malloc_internal(sizeof(SFrameOverflowBlock) + size, file, line, "frame_overflow", tag);
+	if (!pBlock)
+	{
+		syserr("Frame arena overflow allocation of %zu bytes failed (%s:%d)", size, file, line);
+		return (NULL);
+	}
+
+	do
+	{
+		pBlock->next = (SFrameOverflowBlock*)AeroAtomic_LoadPtr((void* volatile*)&pArena->pOverflow);
+	} while (!AeroAtomic_CompareExchangePtr((void* volatile*)&pArena->pOverflow, pBlock->next, pBlock));
+
+	AeroAtomic_Add64(&pAllocator->overflowCount, 1);
+	AeroAtomic_Add64(&pArena->overflowBytes, (int64_t)size);
+	AeroAtomic_Add64(&pArena->allocationCount, 1);
+	AeroAtomic_Add64(&pArena->usageByTag[tag], (int64_t)size);
+
+	return (pBlock + 1);
+}
+
+void FrameAllocator_GetStats(SFrameAllocatorStats* pStats)
+{
+	if (!pStats)
+	{
+		return;
+	}
+
+	memset(pStats, 0, sizeof(SFrameAllocatorStats));
+
+	FrameAllocator pAllocator = psFrameAllocator;
+	if (!pAllocator)
+	{
+		return;
+	}
+
+	SFrameArena* pArena = &pAllocator->arenas[AeroAtomic_Load32(&pAllocator->currentArena)];
+
+	pStats->frameIndex = pAllocator->frameIndex;
+	pStats->arenaCapacity = pAllocator->arenaCapacity;
+	pStats->currentUsage = (size_t)AeroAtomic_Load64(&pArena->offset);
+	pStats->overflowBytes = (size_t)AeroAtomic_Load64(&pArena->overflowBytes);
+	pStats->allocationCount = (uint64_t)AeroAtomic_Load64(&pArena->allocationCount);
+	pStats->overflowCount = (uint64_t)AeroAtomic_Load64(&pAllocator->overflowCount);
+
+	size_t used = pStats->currentUsage + pStats->overflowBytes;
+	pStats->highWaterMark = (used > pAllocator->highWaterMark) ? used : pAllocator->highWaterMark;
+
+	for (int32_t i = 0; i < MEM_TAG_COUNT; i++)
+	{
+		pStats->usageByTag[i] = (size_t)AeroAtomic_Load64(&pArena->usageByTag[i]);
+		pStats->peakByTag[i] = (pStats->usageByTag[i] > pAllocator->peakByTag[i]) ? pStats->usageByTag[i] : pAllocator->peakByTag[i];
+	}
+}
+
+void FrameAllocator_PrintReport()
+{
+	SFrameAllocatorStats stats;
+	FrameAllocator_GetStats(&stats);
+
+	char capacity[16], current[16], highWater[16];
+	FormatMemorySizeThreadSafe(stats.arenaCapacity, capacity, sizeof(capacity));
+	FormatMemorySizeThreadSafe(stats.currentUsage + stats.overflowBytes, current, sizeof(current));
+	FormatMemorySizeThreadSafe(stats.highWaterMark, highWater, sizeof(highWater));
+
+	syslog("--- FRAME ARENA REPORT (frame %llu) ---", (unsigned long long)stats.frameIndex);
+	syslog("Arena Capacity: %s x %d", capacity, FRAME_ARENA_COUNT);
+	syslog("This Frame: %s in %llu allocations", current, (unsigned long long)stats.allocationCount);
+	syslog("High Water Mark: %s", highWater);
+	syslog("Overflow Allocations: %llu", (unsigned long long)stats.overflowCount);
+
+	for (int32_t i = 0; i < MEM_TAG_COUNT; i++)
+	{
+		if (stats.peakByTag[i] == 0)
+		{
+			continue;
+		}
+
+		char usage[16], peak[16];
+		FormatMemorySizeThreadSafe(stats.usageByTag[i], usage, sizeof(usage));
+		FormatMemorySizeThreadSafe(stats.peakByTag[i], peak, sizeof(peak));
+		syslog("%-12s: %s (peak %s)", MemoryTagNames[i], usage, peak);
+	}
+}
+
+FrameAllocator GetFrameAllocator()
+{
+	return (psFrameAllocator);
+}
+
+static void FrameAllocator_ResetArena(SFrameArena* pArena)
+{
+	SFrameOverflowBlock* pBlock = pArena->pOverflow;
+	while (pBlock)
+	{
+		SFrameOverflowBlock* pNext = pBlock->next;
+		engine_delete(pBlock);
+		pBlock = pNext;
+	}
+
+	pArena->pOverflow = NULL;
+	pArena->offset = 0;
+	pArena->allocationCount = 0;
+	pArena->overflowBytes = 0;
+	memset((void*)pArena->usageByTag, 0, sizeof(pArena->usageByTag));
+}
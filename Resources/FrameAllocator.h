@@ -0,0 +1,57 @@
+#ifndef __FRAME_ALLOCATOR_H__
+#define __FRAME_ALLOCATOR_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "MemoryTags.h"
+
+#define FRAME_ARENA_COUNT 2
+#define FRAME_ARENA_DEFAULT_SIZE (4 * 1024 * 1024) // 4 MB per arena
+#define FRAME_ARENA_ALIGNMENT 16
+
+typedef struct SFrameAllocator* FrameAllocator;
+
+// Snapshot of the frame arena counters
+typedef struct SFrameAllocatorStats
+{
+	uint64_t frameIndex;
+	size_t arenaCapacity;		// bytes per arena
+	size_t currentUsage;		// bytes used by the active arena this frame
+	size_t highWaterMark;		// most bytes ever used in a single frame
+	size_t overflowBytes;		// bytes that spilled to the tracked heap this frame
+	uint64_t overflowCount;		// allocations that spilled to the tracked heap since start
+	uint64_t allocationCount;	// allocations served this frame
+	size_t usageByTag[MEM_TAG_COUNT];
+	size_t peakByTag[MEM_TAG_COUNT];
+} SFrameAllocatorStats;
+
+bool FrameAllocator_Initialize(FrameAllocator* ppFrameAllocator, size_t arenaSize);
+void FrameAllocator_Destroy(FrameAllocator* ppFrameAllocator);
+
+/**
+ * @brief Flips to the other arena and resets it.
+ *
+ * Called once at the top of Engine_Update. Arenas are double-buffered, so
+ * anything allocated last frame stays valid until the end of this frame
+ * (enough for data the GPU consumes one frame late).
+ */
+void FrameAllocator_BeginFrame();
+
+/**
+ * @brief Bump-allocates from the active arena. Never free the result.
+ *
+ * Thread safe (atomic bump). When the arena is full the block comes from the
+ * tracked heap instead and is released on the arena's next reset.
+ */
+void* FrameAllocator_Alloc(size_t size, size_t alignment, EMemoryTag tag, const char* file, int line);
+
+void FrameAllocator_GetStats(SFrameAllocatorStats* pStats);
+void FrameAllocator_PrintReport();
+
+FrameAllocator GetFrameAllocator();
+
+#define engine_frame_alloc(size, tag) FrameAllocator_Alloc(size, FRAME_ARENA_ALIGNMENT, tag, __FILE__, __LINE__)
+#define engine_frame_new(type, count, tag) (type*)FrameAllocator_Alloc(sizeof(type) * (count), FRAME_ARENA_ALIGNMENT, tag, __FILE__, __LINE__)
+
+#endif // __FRAME_ALLOCATOR_H__
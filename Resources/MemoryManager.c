@@ -3,29 +3,52 @@
 #include <windows.h>
 #endif
 #include "Stdafx.h"
+#include "Core/Atomics.h"
 
-typedef struct AERO_ALIGN(16) SMemoryBlockHeader
+// What a block carries in front of the user pointer
+#define MEMORY_BLOCK_TRACKED 0   // Full header, linked in a live list
+#define MEMORY_BLOCK_COUNTED 1   // SMemoryBlockInfo only, counted in the atomic counters
+#define MEMORY_BLOCK_UNTRACKED 2 // SMemoryBlockInfo only, invisible to the stats
+
+// Every block ends with these 16 bytes right before the user pointer, so a free
+// can always tell how the block was tracked, whatever the level is now.
+typedef struct SMemoryBlockInfo
 {
 	size_t size;
-	uint32_t magic;   // To detect corruption (e.g., 0xDEADBEEF)
-	uint32_t line;
+	uint32_t magic;    // To detect corruption (e.g., 0xDEADBEEF)
+	uint16_t tag;
+	uint8_t kind;      // MEMORY_BLOCK_*
+	uint8_t sizeClass; // 0 = exact-size block, otherwise (size class index + 1)
+} SMemoryBlockInfo;
+
+typedef struct AERO_ALIGN(16) SMemoryBlockHeader
+{
 	const char* file;
 	const char* typeName;
 
 	struct SMemoryBlockHeader* next;
 	struct SMemoryBlockHeader* prev;
 
-	EMemoryTag tag;
-	// Current size (x64): 8+4+4+8+8+8+8 = 48 bytes.
-	// 48 is a multiple of 16, so no extra padding is strictly needed,
-	// but we can keep a small buffer for future safety.
-	char padding[12];
+	uint32_t line;
+	uint32_t callsite;  // Index into the callsite histogram, MEMORY_CALLSITE_NONE if not recorded
+	uint16_t ownerSlot; // 0 = global locked list, otherwise (thread cache index + 1)
+	char padding[6];
+
+	// Same layout as SMemoryBlockInfo
+	size_t size;
+	uint32_t magic;
+	uint16_t tag;
+	uint8_t kind;
+	uint8_t sizeClass;
+	// Current size (x64): 8+8+8+8+4+4+2+6 + 16 = 64 bytes, keeps the user pointer 16-byte aligned.
 } SMemoryBlockHeader;
 
 #ifdef __cplusplus
 static_assert(sizeof(SMemoryBlockHeader) % 16 == 0, "Memory header must be 16-byte aligned!");
+static_assert(offsetof(SMemoryBlockHeader, size) + sizeof(SMemoryBlockInfo) == sizeof(SMemoryBlockHeader), "Block info must end the header!");
 #else
 _Static_assert(sizeof(SMemoryBlockHeader) % 16 == 0, "Memory header must be 16-byte aligned!");
+_Static_assert(offsetof(SMemoryBlockHeader, size) + sizeof(SMemoryBlockInfo) == sizeof(SMemoryBlockHeader), "Block info must end the header!");
 #endif
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -35,6 +58,86 @@ typedef CRITICAL_SECTION MutexHandle;
 typedef pthread_mutex_t MutexHandle;
 #endif
 
+// Per-thread caches recycle small blocks (header included) by power-of-two size class: 64, 128 ... 4096 bytes
+#define MEMORY_THREAD_CACHE_SLOTS 64
+#define MEMORY_SIZE_CLASS_COUNT 7
+#define MEMORY_SIZE_CLASS_MIN_SHIFT 6
+#define MEMORY_SIZE_CLASS_MAX_CACHED 256 // blocks kept per class before they go back to the OS
+
+typedef struct SMemoryFreeBlock
+{
+	struct SMemoryFreeBlock* next;
+} SMemoryFreeBlock;
+
+// Counters for blocks allocated without a callsite (counters-only and sampled levels).
+// Every thread cache owns a set written by its thread alone: a free counts on the freeing
+// thread, so one set can go negative and only the sum is meaningful. Threads without a
+// cache slot fall back to the manager's set, updated atomically.
+typedef struct SMemoryCounters
+{
+	volatile int64_t currentUsage;
+	volatile int64_t totalFreed; // total allocated is derived as current + freed
+	volatile int64_t peakUsage;
+	volatile int64_t allocationCount;
+
+	volatile int64_t usageByTag[MEM_TAG_COUNT];
+	volatile int64_t allocatedByTag[MEM_TAG_COUNT];
+} SMemoryCounters;
+
+// Callsite counters. Every thread cache owns a set per callsite written by its thread alone,
+// as with SMemoryCounters only the sum over the sets is meaningful.
+typedef struct SMemoryCallsiteCounters
+{
+	volatile int64_t liveBytes;
+	volatile int64_t liveCount;
+	volatile int64_t totalAllocs;
+	volatile int64_t totalFrees;
+} SMemoryCallsiteCounters;
+
+typedef struct AERO_ALIGN(AERO_CACHE_LINE_SIZE) SMemoryThreadCache
+{
+	uint64_t totalAllocated;
+	uint64_t totalFreed;
+	uint64_t peakUsage;
+	uint64_t currentUsage;
+	uint64_t allocationCount;
+
+	size_t usageByTag[MEM_TAG_COUNT];
+	uint64_t allocatedByTag[MEM_TAG_COUNT];
+
+	SMemoryBlockHeader* head; // Blocks allocated by the owning thread
+
+	// Recycled blocks, only ever touched by the thread that owns this cache
+	SMemoryFreeBlock* freeLists[MEMORY_SIZE_CLASS_COUNT];
+	uint32_t freeCounts[MEMORY_SIZE_CLASS_COUNT];
+
+	// The owner takes it uncontended, other threads only for cross-thread frees and reports
+	AeroSpinLock lock;
+	volatile int32_t inUse; // Claimed by a running thread
+
+	SMemoryCounters counters;
+	SMemoryCallsiteCounters* callsiteCounters; // MEMORY_CALLSITE_CAPACITY sets, allocated on the slot's first recorded callsite
+} SMemoryThreadCache;
+
+
+#define MEMORY_CALLSITE_NONE 0xFFFFFFFFu
+#define MEMORY_CALLSITE_TABLE_SIZE (MEMORY_CALLSITE_CAPACITY * 2) // hash slots, kept half empty
+
+typedef struct SMemoryCallsite
+{
+	const char* file;
+	const char* typeName;
+	int32_t line;
+	EMemoryTag tag;
+
+	SMemoryCallsiteCounters counters; // Threads without a cache slot, updated atomically
+
+	int64_t frameStartAllocs; // total allocations summed at the last MemoryManager_BeginFrame
+	int64_t lastFrameAllocs;
+	int64_t peakFrameAllocs;
+	uint64_t firstFrame;
+} SMemoryCallsite;
+
 typedef struct SMemoryManager
 {
 	uint64_t totalAllocated; // total allocated memory in bytes
@@ -44,16 +147,56 @@ typedef struct SMemoryManager
 	uint64_t allocationCount; // number of allocations
 
 	size_t usageByTag[MEM_TAG_COUNT];
+	uint64_t allocatedByTag[MEM_TAG_COUNT];
 
 	SMemoryBlockHeader* head; // Head of the "live" allocations list
 
 	// Crucial for multi-threaded operations
 	MutexHandle lock;
 
+	volatile int32_t trackingMode; // EMemoryTrackingMode used by new allocations
+	volatile int32_t trackingLevel; // EMemoryTrackingLevel used by new allocations
+	volatile int32_t sampleRate;
+
 	bool isInitialized;
-	char padding[7]; // to match 16 bytes align
+	char padding[3]; // to match 16 bytes align
+
+	SMemoryCounters counters; // Fallback for threads without a cache slot
+
+	// Callsite histogram: dense records plus an open-addressing index (slot = record + 1, 0 = empty).
+	// Slots are published once and never change, lookups read them without the lock
+	SMemoryCallsite* callsites;
+	volatile int32_t* callsiteTable;
+	volatile int32_t callsiteCount;
+	AeroSpinLock callsiteLock; // Only taken to insert
+	uint64_t frameIndex;
+
+	// Per-tag budgets, checked once per frame in MemoryManager_BeginFrame
+	size_t tagBudgets[MEM_TAG_COUNT]; // 0 = unlimited
+	SMemoryTagFrameStats tagFrames[MEM_TAG_COUNT];
+	uint64_t lastAllocatedByTag[MEM_TAG_COUNT];
+	MemoryBudgetCallbackFn pfnBudgetCallback;
+	void* pBudgetUserData;
+	SMemoryThreadCache threadCaches[MEMORY_THREAD_CACHE_SLOTS];
 } SMemoryManager;
 
+static AERO_THREAD_LOCAL SMemoryThreadCache* s_pThreadCache = NULL;
+static AERO_THREAD_LOCAL uint32_t s_iSampleCounter = 0;
+
+static SMemoryThreadCache* MemoryManager_GetThreadCache();
+static void* MemoryManager_AcquireBlock(SMemoryThreadCache* pCache, size_t totalSize, uint8_t* pSizeClass);
+static void MemoryManager_ReleaseBlock(SMemoryBlockHeader* header);
+static void MemoryManager_FreeCachedBlocks(SMemoryThreadCache* pCache);
+static bool MemoryManager_ValidateList(SMemoryBlockHeader* curr);
+static void* MemoryManager_AllocUntracked(size_t size, EMemoryTag tag, bool bCounted);
+static void MemoryManager_FreeUntracked(SMemoryBlockInfo* pInfo);
+static void MemoryManager_CountUntracked(SMemoryBlockInfo* pInfo, int64_t iSign);
+static void MemoryManager_AddCounters(SMemoryStats* pStats, SMemoryCounters* pCounters);
+static uint32_t MemoryManager_RecordCallsiteAlloc(SMemoryBlockHeader* header, SMemoryThreadCache* pCache);
+static void MemoryManager_RecordCallsiteFree(SMemoryBlockHeader* header);
+static int32_t MemoryManager_GetCallsiteSets(SMemoryCallsiteCounters** ppSets);
+static void MemoryManager_SumCallsite(uint32_t index, SMemoryCallsiteCounters** ppSets, int32_t setCount, SMemoryCallsiteCounters* pSum);
+
 bool MemoryManager_Initialize(MemoryManager* ppMemoryManager)
 {
     if (ppMemoryManager == NULL)
@@ -63,21 +206,17 @@ bool MemoryManager_Initialize(MemoryManager* ppMemoryManager)
 	}
 
 	// Use standard allocation for the manager itself to avoid recursion/locking issues
-	void* raw_mem = _mm_malloc(sizeof(SMemoryManager), 16);
+	// Cache-line aligned so every thread cache sits on its own lines
+	void* raw_mem = _mm_malloc(sizeof(SMemoryManager), AERO_CACHE_LINE_SIZE);
 	if (!raw_mem)
 	{
-		return false;
+		syserr("Failed to Allocate Memory for MemoryManager");
+		return (false);
 	}
 
 	// This is the most important line to fix your 0xCDCDCD issue!
 	memset(raw_mem, 0, sizeof(SMemoryManager));
 
-	if (!(*ppMemoryManager))
-    {
-		syserr("Failed to Allocate Memory for MemoryManager");
-		return (false);
-    }
-
 	psMemoryManager = (MemoryManager)raw_mem;
 	*ppMemoryManager = psMemoryManager;
 
@@ -88,6 +227,21 @@ bool MemoryManager_Initialize(MemoryManager* ppMemoryManager)
 #endif
 
 	psMemoryManager->head = NULL; // Explicitly NULL the head
+	psMemoryManager->trackingMode = MEMORY_TRACKING_LOCKED;
+	psMemoryManager->trackingLevel = MEMORY_TRACKING_MAX_LEVEL;
+	psMemoryManager->sampleRate = MEMORY_TRACKING_DEFAULT_SAMPLE_RATE;
+
+	// Histogram storage stays outside the tracker so it never shows up in its own stats
+	psMemoryManager->callsites = (SMemoryCallsite*)calloc(MEMORY_CALLSITE_CAPACITY, sizeof(SMemoryCallsite));
+	psMemoryManager->callsiteTable = (volatile int32_t*)calloc(MEMORY_CALLSITE_TABLE_SIZE, sizeof(int32_t));
+	if (!psMemoryManager->callsites || !psMemoryManager->callsiteTable)
+	{
+		syserr("Failed to Allocate the Callsite Histogram, callsites will not be recorded");
+		free(psMemoryManager->callsites);
+		free((void*)psMemoryManager->callsiteTable);
+		psMemoryManager->callsites = NULL;
+		psMemoryManager->callsiteTable = NULL;
+	}
 	(*ppMemoryManager)->isInitialized = true;
     return (true);
 }
@@ -99,6 +253,16 @@ void MemoryManager_Destroy(MemoryManager* ppMemoryManager)
         return;
     }
 
+	for (int32_t i = 0; i < MEMORY_THREAD_CACHE_SLOTS; i++)
+	{
+		MemoryManager_FreeCachedBlocks(&psMemoryManager->threadCaches[i]);
+		free(psMemoryManager->threadCaches[i].callsiteCounters);
+	}
+	s_pThreadCache = NULL;
+
+	free(psMemoryManager->callsites);
+	free((void*)psMemoryManager->callsiteTable);
+
 #ifdef _WIN32
 	DeleteCriticalSection(&psMemoryManager->lock);
 #else
@@ -109,15 +273,451 @@ void MemoryManager_Destroy(MemoryManager* ppMemoryManager)
 	*ppMemoryManager = NULL;
 }
 
-bool MemoryManager_Validate()
+void MemoryManager_SetTrackingMode(EMemoryTrackingMode eMode)
 {
-	if (!psMemoryManager || !psMemoryManager->isInitialized) return true;
+	if (!psMemoryManager)
+	{
+		return;
+	}
+
+	AeroAtomic_Store32(&psMemoryManager->trackingMode, (int32_t)eMode);
+}
+
+EMemoryTrackingMode MemoryManager_GetTrackingMode()
+{
+	if (!psMemoryManager)
+	{
+		return (MEMORY_TRACKING_LOCKED);
+	}
+
+	return ((EMemoryTrackingMode)AeroAtomic_Load32(&psMemoryManager->trackingMode));
+}
+
+void MemoryManager_SetTrackingLevel(EMemoryTrackingLevel eLevel)
+{
+	if (!psMemoryManager)
+	{
+		return;
+	}
+
+	if (eLevel > MEMORY_TRACKING_MAX_LEVEL)
+	{
+		syslog("Memory tracking level %d is not compiled in, using %d", (int)eLevel, (int)MEMORY_TRACKING_MAX_LEVEL);
+		eLevel = MEMORY_TRACKING_MAX_LEVEL;
+	}
+
+	AeroAtomic_Store32(&psMemoryManager->trackingLevel, (int32_t)eLevel);
+}
+
+EMemoryTrackingLevel MemoryManager_GetTrackingLevel()
+{
+	if (!psMemoryManager)
+	{
+		return (MEMORY_TRACKING_MAX_LEVEL);
+	}
+
+	return ((EMemoryTrackingLevel)AeroAtomic_Load32(&psMemoryManager->trackingLevel));
+}
+
+void MemoryManager_SetSampleRate(uint32_t iRate)
+{
+	if (!psMemoryManager)
+	{
+		return;
+	}
+
+	AeroAtomic_Store32(&psMemoryManager->sampleRate, (int32_t)(iRate ? iRate : 1));
+}
+
+void MemoryManager_GetStats(SMemoryStats* pStats)
+{
+	if (!pStats)
+	{
+		return;
+	}
+
+	memset(pStats, 0, sizeof(SMemoryStats));
+
+	if (!psMemoryManager)
+	{
+		return;
+	}
+
+	LockManager(psMemoryManager);
+	pStats->totalAllocated = psMemoryManager->totalAllocated;
+	pStats->totalFreed = psMemoryManager->totalFreed;
+	pStats->peakUsage = psMemoryManager->peakUsage;
+	pStats->currentUsage = psMemoryManager->currentUsage;
+	pStats->allocationCount = psMemoryManager->allocationCount;
+	for (int32_t i = 0; i < MEM_TAG_COUNT; i++)
+	{
+		pStats->usageByTag[i] = psMemoryManager->usageByTag[i];
+		pStats->allocatedByTag[i] = psMemoryManager->allocatedByTag[i];
+	}
+	UnlockManager(psMemoryManager);
+
+	for (int32_t slot = 0; slot < MEMORY_THREAD_CACHE_SLOTS; slot++)
+	{
+		SMemoryThreadCache* pCache = &psMemoryManager->threadCaches[slot];
+
+		AeroSpinLock_Lock(&pCache->lock);
+		pStats->totalAllocated += pCache->totalAllocated;
+		pStats->totalFreed += pCache->totalFreed;
+		// Each cache tracks its own peak, so the merged value is an upper bound of the real peak
+		pStats->peakUsage += pCache->peakUsage;
+		pStats->currentUsage += pCache->currentUsage;
+		pStats->allocationCount += pCache->allocationCount;
+		for (int32_t i = 0; i < MEM_TAG_COUNT; i++)
+		{
+			pStats->usageByTag[i] += pCache->usageByTag[i];
+			pStats->allocatedByTag[i] += pCache->allocatedByTag[i];
+		}
+		AeroSpinLock_Unlock(&pCache->lock);
+	}
+
+	// Untracked counters go in last, their per-thread parts only add up once summed
+	SMemoryStats counterStats = { 0 };
+	MemoryManager_AddCounters(&counterStats, &psMemoryManager->counters);
+	for (int32_t slot = 0; slot < MEMORY_THREAD_CACHE_SLOTS; slot++)
+	{
+		MemoryManager_AddCounters(&counterStats, &psMemoryManager->threadCaches[slot].counters);
+	}
+
+	pStats->totalAllocated += counterStats.totalAllocated;
+	pStats->totalFreed += counterStats.totalFreed;
+	pStats->peakUsage += counterStats.peakUsage;
+	pStats->currentUsage += counterStats.currentUsage;
+	pStats->allocationCount += counterStats.allocationCount;
+	for (int32_t i = 0; i < MEM_TAG_COUNT; i++)
+	{
+		pStats->usageByTag[i] += counterStats.usageByTag[i];
+		pStats->allocatedByTag[i] += counterStats.allocatedByTag[i];
+	}
+}
+
+void MemoryManager_ReleaseThreadCache()
+{
+	SMemoryThreadCache* pCache = s_pThreadCache;
+	if (!pCache)
+	{
+		return;
+	}
+
+	// Live blocks stay linked in the slot, the next thread that adopts it inherits them
+	MemoryManager_FreeCachedBlocks(pCache);
+
+	s_pThreadCache = NULL;
+	AeroAtomic_Store32(&pCache->inUse, 0);
+}
+
+void MemoryManager_BeginFrame()
+{
+	if (!psMemoryManager)
+	{
+		return;
+	}
+
+	SMemoryCallsiteCounters* pSets[MEMORY_THREAD_CACHE_SLOTS];
+	int32_t setCount = MemoryManager_GetCallsiteSets(pSets);
+
+	int32_t count = (psMemoryManager->callsites) ? AeroAtomic_Load32(&psMemoryManager->callsiteCount) : 0;
+	for (int32_t i = 0; i < count; i++)
+	{
+		SMemoryCallsite* pCallsite = &psMemoryManager->callsites[i];
+
+		// The frame's allocations are what the summed total grew by since the last frame
+		SMemoryCallsiteCounters sum;
+		MemoryManager_SumCallsite((uint32_t)i, pSets, setCount, &sum);
+		int64_t frameAllocs = sum.totalAllocs - pCallsite->frameStartAllocs;
+		pCallsite->frameStartAllocs = sum.totalAllocs;
+		pCallsite->lastFrameAllocs = frameAllocs;
+		if (frameAllocs > pCallsite->peakFrameAllocs)
+		{
+			pCallsite->peakFrameAllocs = frameAllocs;
+		}
+	}
+
+	// Close the per-tag frame: deltas since the previous frame, then the budget check
+	SMemoryStats stats;
+	MemoryManager_GetStats(&stats);
+
+	for (int32_t i = 0; i < MEM_TAG_COUNT; i++)
+	{
+		SMemoryTagFrameStats* pFrame = &psMemoryManager->tagFrames[i];
+
+		uint64_t frameAllocated = stats.allocatedByTag[i] - psMemoryManager->lastAllocatedByTag[i];
+		int64_t usageDelta = (int64_t)stats.usageByTag[i] - (int64_t)pFrame->usage;
+
+		pFrame->frameAllocated = frameAllocated;
+		pFrame->frameFreed = (uint64_t)((int64_t)frameAllocated - usageDelta);
+		pFrame->usage = stats.usageByTag[i];
+		pFrame->budget = psMemoryManager->tagBudgets[i];
+		psMemoryManager->lastAllocatedByTag[i] = stats.allocatedByTag[i];
+
+		bool isOverBudget = pFrame->budget != 0 && pFrame->usage > pFrame->budget;
+		if (isOverBudget && !pFrame->isOverBudget)
+		{
+			// Only on the crossing, not every frame it stays over
+			if (psMemoryManager->pfnBudgetCallback)
+			{
+				psMemoryManager->pfnBudgetCallback((EMemoryTag)i, pFrame->usage, pFrame->budget, psMemoryManager->pBudgetUserData);
+			}
+			else
+			{
+				char usage[16], budget[16];
+				FormatMemorySizeThreadSafe(pFrame->usage, usage, sizeof(usage));
+				FormatMemorySizeThreadSafe(pFrame->budget, budget, sizeof(budget));
+				syserr("Memory tag %s is over budget: %s / %s", MemoryTagNames[i], usage, budget);
+			}
+		}
+		pFrame->isOverBudget = isOverBudget;
+	}
+
+	psMemoryManager->frameIndex++;
+}
+
+void MemoryManager_SetTagBudget(EMemoryTag eTag, size_t budget)
+{
+	if (!psMemoryManager || eTag >= MEM_TAG_COUNT)
+	{
+		return;
+	}
+
+	psMemoryManager->tagBudgets[eTag] = budget;
+}
+
+size_t MemoryManager_GetTagBudget(EMemoryTag eTag)
+{
+	if (!psMemoryManager || eTag >= MEM_TAG_COUNT)
+	{
+		return (0);
+	}
+
+	return (psMemoryManager->tagBudgets[eTag]);
+}
 
+void MemoryManager_SetBudgetCallback(MemoryBudgetCallbackFn pfnCallback, void* pUserData)
+{
+	if (!psMemoryManager)
+	{
+		return;
+	}
+
+	psMemoryManager->pfnBudgetCallback = pfnCallback;
+	psMemoryManager->pBudgetUserData = pUserData;
+}
+
+size_t MemoryManager_GetTagUsage(EMemoryTag eTag)
+{
+	if (!psMemoryManager || eTag >= MEM_TAG_COUNT)
+	{
+		return (0);
+	}
+
+	// Same merge as MemoryManager_GetStats, for a single tag
 	LockManager(psMemoryManager);
+	int64_t usage = (int64_t)psMemoryManager->usageByTag[eTag];
+	UnlockManager(psMemoryManager);
+
+	for (int32_t slot = 0; slot < MEMORY_THREAD_CACHE_SLOTS; slot++)
+	{
+		SMemoryThreadCache* pCache = &psMemoryManager->threadCaches[slot];
+
+		AeroSpinLock_Lock(&pCache->lock);
+		usage += (int64_t)pCache->usageByTag[eTag];
+		AeroSpinLock_Unlock(&pCache->lock);
+
+		usage += AeroAtomic_Load64(&pCache->counters.usageByTag[eTag]);
+	}
+
+	usage += AeroAtomic_Load64(&psMemoryManager->counters.usageByTag[eTag]);
+
+	return ((usage > 0) ? (size_t)usage : 0);
+}
+
+size_t MemoryManager_GetTagHeadroom(EMemoryTag eTag)
+{
+	size_t budget = MemoryManager_GetTagBudget(eTag);
+	if (budget == 0)
+	{
+		return (SIZE_MAX);
+	}
+
+	size_t usage = MemoryManager_GetTagUsage(eTag);
+	return ((usage < budget) ? budget - usage : 0);
+}
+
+bool MemoryManager_CanAllocate(EMemoryTag eTag, size_t size)
+{
+	return (size <= MemoryManager_GetTagHeadroom(eTag));
+}
+
+void MemoryManager_GetTagFrameStats(EMemoryTag eTag, SMemoryTagFrameStats* pStats)
+{
+	if (!pStats)
+	{
+		return;
+	}
+
+	memset(pStats, 0, sizeof(SMemoryTagFrameStats));
+
+	if (!psMemoryManager || eTag >= MEM_TAG_COUNT)
+	{
+		return;
+	}
+
+	*pStats = psMemoryManager->tagFrames[eTag];
+}
+
+static int MemoryManager_CompareCallsites(const SMemoryCallsiteStats* pA, const SMemoryCallsiteStats* pB, EMemoryCallsiteSort eSort)
+{
+	uint64_t a = 0, b = 0;
+	switch (eSort)
+	{
+	case MEMORY_CALLSITE_SORT_LIVE_COUNT:   a = pA->liveCount;       b = pB->liveCount;       break;
+	case MEMORY_CALLSITE_SORT_TOTAL_ALLOCS: a = pA->totalAllocs;     b = pB->totalAllocs;     break;
+	case MEMORY_CALLSITE_SORT_FRAME_ALLOCS: a = pA->lastFrameAllocs; b = pB->lastFrameAllocs; break;
+	default:                                a = pA->liveBytes;       b = pB->liveBytes;       break;
+	}
+
+	// Descending
+	return (a < b) - (a > b);
+}
+
+static int MemoryManager_CompareLiveBytes(const void* pA, const void* pB) { return MemoryManager_CompareCallsites(pA, pB, MEMORY_CALLSITE_SORT_LIVE_BYTES); }
+static int MemoryManager_CompareLiveCount(const void* pA, const void* pB) { return MemoryManager_CompareCallsites(pA, pB, MEMORY_CALLSITE_SORT_LIVE_COUNT); }
+static int MemoryManager_CompareTotalAllocs(const void* pA, const void* pB) { return MemoryManager_CompareCallsites(pA, pB, MEMORY_CALLSITE_SORT_TOTAL_ALLOCS); }
+static int MemoryManager_CompareFrameAllocs(const void* pA, const void* pB) { return MemoryManager_CompareCallsites(pA, pB, MEMORY_CALLSITE_SORT_FRAME_ALLOCS); }
+
+uint32_t MemoryManager_GetCallsiteStats(SMemoryCallsiteStats* pStats, uint32_t iMaxCount, EMemoryCallsiteSort eSort)
+{
+	if (!pStats || iMaxCount == 0 || !psMemoryManager || !psMemoryManager->callsites)
+	{
+		return (0);
+	}
 
-	SMemoryBlockHeader* curr = psMemoryManager->head;
+	uint32_t count = (uint32_t)AeroAtomic_Load32(&psMemoryManager->callsiteCount);
+	if (count == 0)
+	{
+		return (0);
+	}
+
+	// Snapshot everything first, the top entries can only be picked once the whole set is sorted
+	SMemoryCallsiteStats* pAll = (SMemoryCallsiteStats*)malloc(count * sizeof(SMemoryCallsiteStats));
+	if (!pAll)
+	{
+		return (0);
+	}
+
+	SMemoryCallsiteCounters* pSets[MEMORY_THREAD_CACHE_SLOTS];
+	int32_t setCount = MemoryManager_GetCallsiteSets(pSets);
+
+	uint64_t frameIndex = psMemoryManager->frameIndex;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		SMemoryCallsite* pCallsite = &psMemoryManager->callsites[i];
+		SMemoryCallsiteStats* pOut = &pAll[i];
+
+		SMemoryCallsiteCounters sum;
+		MemoryManager_SumCallsite(i, pSets, setCount, &sum);
+
+		pOut->file = pCallsite->file;
+		pOut->typeName = pCallsite->typeName;
+		pOut->line = pCallsite->line;
+		pOut->tag = pCallsite->tag;
+		pOut->liveBytes = (uint64_t)sum.liveBytes;
+		pOut->liveCount = (uint64_t)sum.liveCount;
+		pOut->totalAllocs = (uint64_t)sum.totalAllocs;
+		pOut->totalFrees = (uint64_t)sum.totalFrees;
+		pOut->lastFrameAllocs = (uint64_t)pCallsite->lastFrameAllocs;
+		pOut->peakFrameAllocs = (uint64_t)pCallsite->peakFrameAllocs;
+		pOut->avgFrameAllocs = (float)pOut->totalAllocs / (float)(frameIndex - pCallsite->firstFrame + 1);
+	}
+
+	int (*pfnCompare)(const void*, const void*) = MemoryManager_CompareLiveBytes;
+	switch (eSort)
+	{
+	case MEMORY_CALLSITE_SORT_LIVE_COUNT:   pfnCompare = MemoryManager_CompareLiveCount;   break;
+	case MEMORY_CALLSITE_SORT_TOTAL_ALLOCS: pfnCompare = MemoryManager_CompareTotalAllocs; break;
+	case MEMORY_CALLSITE_SORT_FRAME_ALLOCS: pfnCompare = MemoryManager_CompareFrameAllocs; break;
+	default: break;
+	}
+	qsort(pAll, count, sizeof(SMemoryCallsiteStats), pfnCompare);
+
+	uint32_t written = (count < iMaxCount) ? count : iMaxCount;
+	memcpy(pStats, pAll, written * sizeof(SMemoryCallsiteStats));
+	free(pAll);
+
+	return (written);
+}
+
+void MemoryManager_PrintCallsiteReport(uint32_t iTopCount, EMemoryCallsiteSort eSort)
+{
+	SMemoryCallsiteStats* pStats = (SMemoryCallsiteStats*)malloc(iTopCount * sizeof(SMemoryCallsiteStats));
+	if (!pStats)
+	{
+		return;
+	}
+
+	uint32_t count = MemoryManager_GetCallsiteStats(pStats, iTopCount, eSort);
+
+	syslog("--- MEMORY CALLSITE REPORT (top %u) ---", count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		SMemoryCallsiteStats* pCallsite = &pStats[i];
+
+		char liveBytes[16];
+		FormatMemorySizeThreadSafe(pCallsite->liveBytes, liveBytes, sizeof(liveBytes));
+
+		syslog("%s:%d (%s, %s) live %s in %llu, allocs %llu, frees %llu, last frame %llu",
+			pCallsite->file, pCallsite->line, pCallsite->typeName ? pCallsite->typeName : "UnKnown", MemoryTagNames[pCallsite->tag], liveBytes,
+			(unsigned long long)pCallsite->liveCount, (unsigned long long)pCallsite->totalAllocs,
+			(unsigned long long)pCallsite->totalFrees, (unsigned long long)pCallsite->lastFrameAllocs);
+	}
+
+	free(pStats);
+}
+
+bool MemoryManager_ExportCallsitesCSV(const char* szFilePath, EMemoryCallsiteSort eSort)
+{
+	SMemoryCallsiteStats* pStats = (SMemoryCallsiteStats*)malloc(MEMORY_CALLSITE_CAPACITY * sizeof(SMemoryCallsiteStats));
+	if (!pStats)
+	{
+		return (false);
+	}
+
+	FILE* pFile = fopen(szFilePath, "w");
+	if (!pFile)
+	{
+		syserr("Failed to Open %s for writing", szFilePath);
+		free(pStats);
+		return (false);
+	}
+
+	uint32_t count = MemoryManager_GetCallsiteStats(pStats, MEMORY_CALLSITE_CAPACITY, eSort);
+
+	fprintf(pFile, "file,line,type,tag,live_bytes,live_count,total_allocs,total_frees,last_frame_allocs,peak_frame_allocs,avg_frame_allocs\n");
+	for (uint32_t i = 0; i < count; i++)
+	{
+		SMemoryCallsiteStats* pCallsite = &pStats[i];
+		fprintf(pFile, "\"%s\",%d,\"%s\",%s,%llu,%llu,%llu,%llu,%llu,%llu,%.3f\n",
+			pCallsite->file, pCallsite->line, pCallsite->typeName ? pCallsite->typeName : "", MemoryTagNames[pCallsite->tag],
+			(unsigned long long)pCallsite->liveBytes, (unsigned long long)pCallsite->liveCount,
+			(unsigned long long)pCallsite->totalAllocs, (unsigned long long)pCallsite->totalFrees,
+			(unsigned long long)pCallsite->lastFrameAllocs, (unsigned long long)pCallsite->peakFrameAllocs,
+			pCallsite->avgFrameAllocs);
+	}
+
+	fclose(pFile);
+	free(pStats);
+
+	syslog("Exported %u callsites to %s", count, szFilePath);
+	return (true);
+}
+
+static bool MemoryManager_ValidateList(SMemoryBlockHeader* curr)
+{
 	int index = 0;
-	bool is_corrupt = false;
 
 	while (curr)
 	{
@@ -133,9 +733,8 @@ bool MemoryManager_Validate()
 				syserr("Error: Node is marked as FREED but still exists in the live list!");
 			}
 
-			is_corrupt = true;
 			// We stop here because if the header is corrupt, the 'next' pointer might be garbage
-			break;
+			return (false);
 		}
 
 		// 2. Cross-link validation (The "Perfect" Check)
@@ -143,16 +742,33 @@ bool MemoryManager_Validate()
 		if (curr->next && curr->next->prev != curr)
 		{
 			syserr("CRITICAL: Linked List pointer corruption at %s:%d (Type: %s)", curr->file, curr->line, curr->typeName ? curr->typeName : "UnKnown");
-			is_corrupt = true;
-			break;
+			return (false);
 		}
 
 		curr = curr->next;
 		index++;
 	}
 
+	return (true);
+}
+
+bool MemoryManager_Validate()
+{
+	if (!psMemoryManager || !psMemoryManager->isInitialized) return true;
+
+	LockManager(psMemoryManager);
+	bool is_corrupt = !MemoryManager_ValidateList(psMemoryManager->head);
 	UnlockManager(psMemoryManager);
 
+	for (int32_t slot = 0; slot < MEMORY_THREAD_CACHE_SLOTS && !is_corrupt; slot++)
+	{
+		SMemoryThreadCache* pCache = &psMemoryManager->threadCaches[slot];
+
+		AeroSpinLock_Lock(&pCache->lock);
+		is_corrupt = !MemoryManager_ValidateList(pCache->head);
+		AeroSpinLock_Unlock(&pCache->lock);
+	}
+
 	if (is_corrupt)
 	{
 		// Force a crash so you can see the callstack in the debugger
@@ -163,82 +779,119 @@ bool MemoryManager_Validate()
 		assert(!is_corrupt);
 	}
 
-	return !is_corrupt;
-}
+	return !is_corrupt;
+}
+
+void MemoryManager_DumpLeaks()
+{
+	// Pool elements first: they carry the real callsite, their slabs show up below
+	bool bHasLeaks = PoolAllocator_DumpLeaks();
+
+	LockManager(psMemoryManager);
+	for (SMemoryBlockHeader* curr = psMemoryManager->head; curr; curr = curr->next)
+	{
+		if (!bHasLeaks)
+		{
+			syslog("--- MEMORY LEAK REPORT ---");
+			bHasLeaks = true;
+		}
+		syslog("Leak: %zu bytes allocated at %s:%d", curr->size, curr->file, curr->line);
+	}
+	UnlockManager(psMemoryManager);
+
+	for (int32_t slot = 0; slot < MEMORY_THREAD_CACHE_SLOTS; slot++)
+	{
+		SMemoryThreadCache* pCache = &psMemoryManager->threadCaches[slot];
 
-void MemoryManager_DumpLeaks()
-{
-	LockManager(psMemoryManager);
-	SMemoryBlockHeader* curr = psMemoryManager->head;
+		AeroSpinLock_Lock(&pCache->lock);
+		for (SMemoryBlockHeader* curr = pCache->head; curr; curr = curr->next)
+		{
+			if (!bHasLeaks)
+			{
+				syslog("--- MEMORY LEAK REPORT ---");
+				bHasLeaks = true;
+			}
+			syslog("Leak: %zu bytes allocated at %s:%d (thread cache %d)", curr->size, curr->file, curr->line, slot);
+		}
+		AeroSpinLock_Unlock(&pCache->lock);
+	}
 
-	if (!curr)
+	// Blocks from the counters-only/sampled levels have no callsite, only their totals are known
+	SMemoryStats counterStats = { 0 };
+	MemoryManager_AddCounters(&counterStats, &psMemoryManager->counters);
+	for (int32_t slot = 0; slot < MEMORY_THREAD_CACHE_SLOTS; slot++)
 	{
-		syslog("No leaks detected! Great job.");
+		MemoryManager_AddCounters(&counterStats, &psMemoryManager->threadCaches[slot].counters);
 	}
-	else
+
+	if (counterStats.allocationCount > 0)
 	{
-		syslog("--- MEMORY LEAK REPORT ---");
-		while (curr)
+		if (!bHasLeaks)
 		{
-			syslog("Leak: %zu bytes allocated at %s:%d", curr->size, curr->file, curr->line);
-			curr = curr->next;
+			syslog("--- MEMORY LEAK REPORT ---");
+			bHasLeaks = true;
 		}
+		syslog("Leak: %llu allocations (%s) made without callsite tracking", (unsigned long long)counterStats.allocationCount, FormatMemorySize(counterStats.currentUsage));
+	}
+
+	if (!bHasLeaks)
+	{
+		syslog("No leaks detected! Great job.");
 	}
-	UnlockManager(psMemoryManager);
 }
 
 void MemoryManager_PrintData()
 {
-	LockManager(psMemoryManager);
-	SMemoryBlockHeader* curr = psMemoryManager->head;
+	SMemoryStats stats;
+	MemoryManager_GetStats(&stats);
 
-	if (!curr)
+	if (stats.allocationCount == 0)
 	{
 		syslog("No Current Active Elements.");
-	}
-	else
-	{
-		syslog("--- MEMORY MANAGER REPORT ---");
-		syslog("Allocation Count: %zu", psMemoryManager->allocationCount);
-
-		char totalAllocated[16], currentAllocated[16], totalFreed[16], peak[16];
-		FormatMemorySizeThreadSafe(psMemoryManager->totalAllocated, totalAllocated, sizeof(totalAllocated));
-		FormatMemorySizeThreadSafe(psMemoryManager->currentUsage, currentAllocated, sizeof(currentAllocated));
-		FormatMemorySizeThreadSafe(psMemoryManager->totalFreed, totalFreed, sizeof(totalFreed));
-		FormatMemorySizeThreadSafe(psMemoryManager->peakUsage, peak, sizeof(peak));
-
-		syslog("Total Allocated: %s", totalAllocated);
-		syslog("Current Usage: %s", currentAllocated);
-		syslog("Current Total Freed: %s", totalFreed);
-		syslog("Peak Usage: %s", peak);
-		
-		while (curr)
-		{
-			if (curr->typeName != NULL)
-			{
-				syslog("Object Allocated At %s:%d with size: %s, Type: %s", curr->file, curr->line, FormatMemorySize(curr->size), curr->typeName);
-			}
-			else 
-			{
-				syslog("Object Allocated At %s:%d with size: %s", curr->file, curr->line, FormatMemorySize(curr->size));
-			}
-			curr = curr->next;
-		}
+		return;
 	}
 
-	UnlockManager(psMemoryManager);
+	static const char* szLevelNames[] = { "Off", "Counters", "Sampled", "Full" };
+
+	syslog("--- MEMORY MANAGER REPORT ---");
+	syslog("Tracking Level: %s", szLevelNames[MemoryManager_GetTrackingLevel()]);
+	syslog("Allocation Count: %llu", (unsigned long long)stats.allocationCount);
+
+	char totalAllocated[16], currentAllocated[16], totalFreed[16], peak[16];
+	FormatMemorySizeThreadSafe(stats.totalAllocated, totalAllocated, sizeof(totalAllocated));
+	FormatMemorySizeThreadSafe(stats.currentUsage, currentAllocated, sizeof(currentAllocated));
+	FormatMemorySizeThreadSafe(stats.totalFreed, totalFreed, sizeof(totalFreed));
+	FormatMemorySizeThreadSafe(stats.peakUsage, peak, sizeof(peak));
+
+	syslog("Total Allocated: %s", totalAllocated);
+	syslog("Current Usage: %s", currentAllocated);
+	syslog("Current Total Freed: %s", totalFreed);
+	syslog("Peak Usage: %s", peak);
+
+	// Aggregated per callsite, a line per live block is unreadable once terrains are loaded
+	MemoryManager_PrintCallsiteReport(MEMORY_CALLSITE_REPORT_TOP, MEMORY_CALLSITE_SORT_LIVE_BYTES);
 }
 
 void MemoryManager_PrintTagReport()
 {
-	LockManager(psMemoryManager);
+	SMemoryStats stats;
+	MemoryManager_GetStats(&stats);
+
 	syslog("--- MEMORY TAG REPORT ---");
 	for (int i = 0; i < MEM_TAG_COUNT; i++)
 	{
-		syslog("%-12s: %s", MemoryTagNames[i], FormatMemorySize(psMemoryManager->usageByTag[i]));
+		SMemoryTagFrameStats frame;
+		MemoryManager_GetTagFrameStats((EMemoryTag)i, &frame);
+
+		char usage[16], budget[16];
+		FormatMemorySizeThreadSafe(stats.usageByTag[i], usage, sizeof(usage));
+		FormatMemorySizeThreadSafe(frame.budget, budget, sizeof(budget));
+
+		syslog("%-12s: %s / %s, last frame +%llu -%llu bytes%s", MemoryTagNames[i], usage, frame.budget ? budget : "unlimited",
+			(unsigned long long)frame.frameAllocated, (unsigned long long)frame.frameFreed, frame.isOverBudget ? " (OVER BUDGET)" : "");
 	}
-	UnlockManager(psMemoryManager);
 }
+
 void LockManager(MemoryManager mgr)
 {
 	if (!mgr) return;
@@ -269,14 +922,39 @@ MemoryManager GetMemoryManager()
 
 void* tracked_malloc_internal(size_t size, const char* file, int line, const char* typeName, EMemoryTag tag)
 {
+	// Below full tracking most blocks skip the header, the list and the lock entirely
+	EMemoryTrackingLevel level = (EMemoryTrackingLevel)AeroAtomic_Load32(&psMemoryManager->trackingLevel);
+	if (level > MEMORY_TRACKING_MAX_LEVEL)
+	{
+		level = MEMORY_TRACKING_MAX_LEVEL;
+	}
+
+	if (level != MEMORY_TRACKING_LEVEL_FULL)
+	{
+		bool bSampled = (level == MEMORY_TRACKING_LEVEL_SAMPLED) && (++s_iSampleCounter % (uint32_t)psMemoryManager->sampleRate) == 0;
+		if (!bSampled)
+		{
+			return MemoryManager_AllocUntracked(size, tag, level != MEMORY_TRACKING_LEVEL_OFF);
+		}
+	}
+
 	// 1. Align the header size to 16 bytes. 
 	// Even if size_t is 8, we reserve 16 to keep the user pointer aligned.
 	size_t total_size = size + sizeof(SMemoryBlockHeader); // actual size + header_size(for size_t)
 
+	// In per-thread mode the block comes from (and is tracked by) the calling thread's cache,
+	// falling back to the locked list if every cache slot is taken
+	SMemoryThreadCache* pCache = NULL;
+	if (AeroAtomic_Load32(&psMemoryManager->trackingMode) == MEMORY_TRACKING_PER_THREAD)
+	{
+		pCache = MemoryManager_GetThreadCache();
+	}
+
 	// 2. Use _aligned_malloc or ensure malloc gives us 16-byte alignment
 	// On most 64-bit systems, malloc is 16-byte aligned by default.
 	// size_t* raw_ptr = (size_t*)malloc(total_size); // allocate with total size
-	void* raw_ptr = _mm_malloc(total_size, 16); // Ensure we get a 16-byte aligned block from the OS
+	uint8_t sizeClass = 0;
+	void* raw_ptr = (pCache) ? MemoryManager_AcquireBlock(pCache, total_size, &sizeClass) : _mm_malloc(total_size, 16); // Ensure we get a 16-byte aligned block from the OS
 
 	if (!raw_ptr)
 	{
@@ -290,7 +968,39 @@ void* tracked_malloc_internal(size_t size, const char* file, int line, const cha
 	header->file = file;
 	header->line = line;
 	header->typeName = typeName;
-	header->tag = tag;
+	header->tag = (uint16_t)tag;
+	header->kind = MEMORY_BLOCK_TRACKED;
+	header->ownerSlot = (pCache) ? (uint16_t)(pCache - psMemoryManager->threadCaches + 1) : 0;
+	header->sizeClass = sizeClass;
+	header->callsite = MemoryManager_RecordCallsiteAlloc(header, pCache);
+
+	if (pCache)
+	{
+		AeroSpinLock_Lock(&pCache->lock);
+
+		header->next = pCache->head;
+		header->prev = NULL;
+		if (pCache->head)
+		{
+			pCache->head->prev = header;
+		}
+		pCache->head = header;
+
+		pCache->currentUsage += total_size;
+		pCache->totalAllocated += total_size;
+		pCache->allocationCount++;
+		if (pCache->currentUsage > pCache->peakUsage)
+		{
+			pCache->peakUsage = pCache->currentUsage;
+		}
+
+		pCache->usageByTag[tag] += size;
+		pCache->allocatedByTag[tag] += size;
+
+		AeroSpinLock_Unlock(&pCache->lock);
+
+		return (void*)((char*)raw_ptr + sizeof(SMemoryBlockHeader));
+	}
 
 	// 4. Thread-Safe Linked List Insertion
 	LockManager(psMemoryManager);
@@ -312,6 +1022,7 @@ void* tracked_malloc_internal(size_t size, const char* file, int line, const cha
 	}
 
 	psMemoryManager->usageByTag[tag] += size;
+	psMemoryManager->allocatedByTag[tag] += size;
 
 	// Unlock The Manager
 	UnlockManager(psMemoryManager);
@@ -365,8 +1076,8 @@ void* tracked_realloc_internal(void* ptr, size_t new_size, const char* file, int
 		return NULL;
 	}
 
-	// Move the pointer back to find the header
-	SMemoryBlockHeader* old_header = (SMemoryBlockHeader*)((char*)ptr - sizeof(SMemoryBlockHeader));
+	// Move the pointer back to find the block info (the full header only exists for tracked blocks)
+	SMemoryBlockInfo* old_header = (SMemoryBlockInfo*)ptr - 1;
 
 	// Safety check: Validate the magic number before doing anything
 	if (old_header->magic != 0xDEADBEEF)
@@ -376,9 +1087,13 @@ void* tracked_realloc_internal(void* ptr, size_t new_size, const char* file, int
 	}
 
 	// Allocate the NEW block
-	const char* finalTypeName = (typeName != NULL) ? typeName : old_header->typeName;
+	const char* finalTypeName = typeName;
+	if (finalTypeName == NULL && old_header->kind == MEMORY_BLOCK_TRACKED)
+	{
+		finalTypeName = ((SMemoryBlockHeader*)((char*)ptr - sizeof(SMemoryBlockHeader)))->typeName;
+	}
 
-	void* new_ptr = tracked_malloc_internal(new_size, file, line, finalTypeName, old_header->tag);
+	void* new_ptr = tracked_malloc_internal(new_size, file, line, finalTypeName, (EMemoryTag)old_header->tag);
 	if (!new_ptr)
 	{
 		// Recovery: If realloc fails, the old pointer is still valid
@@ -431,17 +1146,16 @@ void tracked_free_internal(void* pObject, const char* file, int line)
 		return;
 	}
 
-	// 1. Move the pointer back to find the header
-	// Shift back by 16 bytes to find the real start
-	SMemoryBlockHeader* header = (SMemoryBlockHeader*)((char*)pObject - sizeof(SMemoryBlockHeader));
+	// 1. Move the pointer back to find the block info, shared by every tracking level
+	SMemoryBlockInfo* pInfo = (SMemoryBlockInfo*)pObject - 1;
 
 	// Validation Check
-	if (header->magic != 0xDEADBEEF)
+	if (pInfo->magic != 0xDEADBEEF)
 	{
 		fprintf(stderr, "MEMORY CORRUPTION! \n");
 		// fprintf(stderr, "Attempted free at: %s:%d\n", get_filename(file), line);
 
-		if (header->magic == 0xBAADF00D)
+		if (pInfo->magic == 0xBAADF00D)
 		{
 			fprintf(stderr, "Error: DOUBLE FREE detected! (Already freed elsewhere)\n");
 		}
@@ -451,6 +1165,54 @@ void tracked_free_internal(void* pObject, const char* file, int line)
 		}
 	}
 
+	if (pInfo->kind != MEMORY_BLOCK_TRACKED)
+	{
+		MemoryManager_FreeUntracked(pInfo);
+		return;
+	}
+
+	// Shift back by the full header size to find the real start
+	SMemoryBlockHeader* header = (SMemoryBlockHeader*)((char*)pObject - sizeof(SMemoryBlockHeader));
+
+	MemoryManager_RecordCallsiteFree(header);
+
+	size_t total_size = header->size + sizeof(SMemoryBlockHeader);
+
+	// Blocks from a thread cache go back to that cache's list, even when freed by another thread
+	if (header->ownerSlot != 0)
+	{
+		SMemoryThreadCache* pOwner = &psMemoryManager->threadCaches[header->ownerSlot - 1];
+
+		AeroSpinLock_Lock(&pOwner->lock);
+
+		if (header->prev)
+		{
+			header->prev->next = header->next;
+		}
+		else
+		{
+			pOwner->head = header->next;
+		}
+
+		if (header->next)
+		{
+			header->next->prev = header->prev;
+		}
+
+		pOwner->currentUsage -= total_size;
+		pOwner->totalFreed += total_size;
+		pOwner->allocationCount--;
+		pOwner->usageByTag[header->tag] -= header->size;
+
+		AeroSpinLock_Unlock(&pOwner->lock);
+
+		header->magic = 0xBAADF00D;
+		memset(pObject, 0xFE, header->size);
+
+		MemoryManager_ReleaseBlock(header);
+		return;
+	}
+
 	// 3. Thread-Safe Unlinking
 	LockManager(psMemoryManager);
 
@@ -472,7 +1234,6 @@ void tracked_free_internal(void* pObject, const char* file, int line)
 	}
 
 	// 4. Update Stats
-	size_t total_size = header->size + sizeof(SMemoryBlockHeader);
 	psMemoryManager->currentUsage -= total_size;
 	psMemoryManager->totalFreed += total_size;
 	psMemoryManager->allocationCount--;
@@ -495,9 +1256,199 @@ void tracked_free_internal(void* pObject, const char* file, int line)
 	// Fill user memory with a garbage pattern to catch "use-after-free"
 	memset(pObject, 0xFE, header->size); // Easy to track use-after-free bugs
 
+	MemoryManager_ReleaseBlock(header);
+}
+
+static SMemoryThreadCache* MemoryManager_GetThreadCache()
+{
+	if (s_pThreadCache)
+	{
+		return (s_pThreadCache);
+	}
+
+	// First tracked allocation on this thread: claim a free slot
+	for (int32_t slot = 0; slot < MEMORY_THREAD_CACHE_SLOTS; slot++)
+	{
+		SMemoryThreadCache* pCache = &psMemoryManager->threadCaches[slot];
+		if (AeroAtomic_CompareExchange32(&pCache->inUse, 0, 1))
+		{
+			s_pThreadCache = pCache;
+			return (pCache);
+		}
+	}
+
+	return (NULL);
+}
+
+static void* MemoryManager_AcquireBlock(SMemoryThreadCache* pCache, size_t totalSize, uint8_t* pSizeClass)
+{
+	uint32_t classIndex = 0;
+	while (classIndex < MEMORY_SIZE_CLASS_COUNT && ((size_t)1 << (classIndex + MEMORY_SIZE_CLASS_MIN_SHIFT)) < totalSize)
+	{
+		classIndex++;
+	}
+
+	// Too big to cache, exact-size block straight from the OS
+	if (classIndex == MEMORY_SIZE_CLASS_COUNT)
+	{
+		*pSizeClass = 0;
+		return _mm_malloc(totalSize, 16);
+	}
+
+	*pSizeClass = (uint8_t)(classIndex + 1);
+
+	SMemoryFreeBlock* pBlock = pCache->freeLists[classIndex];
+	if (pBlock)
+	{
+		pCache->freeLists[classIndex] = pBlock->next;
+		pCache->freeCounts[classIndex]--;
+		return (pBlock);
+	}
+
+	return _mm_malloc((size_t)1 << (classIndex + MEMORY_SIZE_CLASS_MIN_SHIFT), 16);
+}
+
+static void MemoryManager_ReleaseBlock(SMemoryBlockHeader* header)
+{
+	// Size-classed blocks are recycled into the freeing thread's cache, whoever allocated them
+	SMemoryThreadCache* pCache = s_pThreadCache;
+	if (header->sizeClass != 0 && pCache)
+	{
+		uint32_t classIndex = header->sizeClass - 1u;
+		if (pCache->freeCounts[classIndex] < MEMORY_SIZE_CLASS_MAX_CACHED)
+		{
+			SMemoryFreeBlock* pBlock = (SMemoryFreeBlock*)header; // keeps the 0xBAADF00D magic intact
+			pBlock->next = pCache->freeLists[classIndex];
+			pCache->freeLists[classIndex] = pBlock;
+			pCache->freeCounts[classIndex]++;
+			return;
+		}
+	}
+
 	_mm_free(header);
 }
 
+static void* MemoryManager_AllocUntracked(size_t size, EMemoryTag tag, bool bCounted)
+{
+	size_t total_size = size + sizeof(SMemoryBlockInfo);
+
+	SMemoryBlockInfo* pInfo = (SMemoryBlockInfo*)_mm_malloc(total_size, 16);
+	if (!pInfo)
+	{
+		return (NULL);
+	}
+
+	pInfo->size = size;
+	pInfo->magic = 0xDEADBEEF;
+	pInfo->tag = (uint16_t)tag;
+	pInfo->kind = (bCounted) ? MEMORY_BLOCK_COUNTED : MEMORY_BLOCK_UNTRACKED;
+	pInfo->sizeClass = 0;
+
+	if (bCounted)
+	{
+		MemoryManager_CountUntracked(pInfo, 1);
+	}
+
+	return (pInfo + 1);
+}
+
+static void MemoryManager_FreeUntracked(SMemoryBlockInfo* pInfo)
+{
+	if (pInfo->kind == MEMORY_BLOCK_COUNTED)
+	{
+		MemoryManager_CountUntracked(pInfo, -1);
+	}
+
+	// No use-after-free fill here, these levels are meant for shipping builds
+	pInfo->magic = 0xBAADF00D;
+
+	_mm_free(pInfo);
+}
+
+static void MemoryManager_CountUntracked(SMemoryBlockInfo* pInfo, int64_t iSign)
+{
+	int64_t total_size = iSign * (int64_t)(pInfo->size + sizeof(SMemoryBlockInfo));
+	int64_t tag_size = iSign * (int64_t)pInfo->size;
+
+	// Own thread's set: plain adds, no lock and no atomic read-modify-write
+	SMemoryThreadCache* pCache = MemoryManager_GetThreadCache();
+	if (pCache)
+	{
+		SMemoryCounters* pCounters = &pCache->counters;
+
+		pCounters->currentUsage += total_size;
+		pCounters->allocationCount += iSign;
+		pCounters->usageByTag[pInfo->tag] += tag_size;
+
+		if (iSign < 0)
+		{
+			pCounters->totalFreed -= total_size;
+			return;
+		}
+
+		pCounters->allocatedByTag[pInfo->tag] += tag_size;
+		if (pCounters->currentUsage > pCounters->peakUsage)
+		{
+			pCounters->peakUsage = pCounters->currentUsage;
+		}
+		return;
+	}
+
+	SMemoryCounters* pCounters = &psMemoryManager->counters;
+
+	int64_t current = AeroAtomic_Add64(&pCounters->currentUsage, total_size);
+	AeroAtomic_Add64(&pCounters->allocationCount, iSign);
+	AeroAtomic_Add64(&pCounters->usageByTag[pInfo->tag], tag_size);
+
+	if (iSign < 0)
+	{
+		AeroAtomic_Add64(&pCounters->totalFreed, -total_size);
+		return;
+	}
+
+	AeroAtomic_Add64(&pCounters->allocatedByTag[pInfo->tag], tag_size);
+
+	int64_t peak = AeroAtomic_Load64(&pCounters->peakUsage);
+	while (current > peak && !AeroAtomic_CompareExchange64(&pCounters->peakUsage, peak, current))
+	{
+		peak = AeroAtomic_Load64(&pCounters->peakUsage);
+	}
+}
+
+static void MemoryManager_AddCounters(SMemoryStats* pStats, SMemoryCounters* pCounters)
+{
+	int64_t currentUsage = AeroAtomic_Load64(&pCounters->currentUsage);
+	int64_t totalFreed = AeroAtomic_Load64(&pCounters->totalFreed);
+
+	pStats->totalAllocated += (uint64_t)(currentUsage + totalFreed);
+	pStats->totalFreed += (uint64_t)totalFreed;
+	pStats->currentUsage += (uint64_t)currentUsage;
+	pStats->peakUsage += (uint64_t)AeroAtomic_Load64(&pCounters->peakUsage);
+	pStats->allocationCount += (uint64_t)AeroAtomic_Load64(&pCounters->allocationCount);
+	for (int32_t i = 0; i < MEM_TAG_COUNT; i++)
+	{
+		pStats->usageByTag[i] += (size_t)AeroAtomic_Load64(&pCounters->usageByTag[i]);
+		pStats->allocatedByTag[i] += (uint64_t)AeroAtomic_Load64(&pCounters->allocatedByTag[i]);
+	}
+}
+
+static void MemoryManager_FreeCachedBlocks(SMemoryThreadCache* pCache)
+{
+	for (int32_t i = 0; i < MEMORY_SIZE_CLASS_COUNT; i++)
+	{
+		SMemoryFreeBlock* pBlock = pCache->freeLists[i];
+		while (pBlock)
+		{
+			SMemoryFreeBlock* pNext = pBlock->next;
+			_mm_free(pBlock);
+			pBlock = pNext;
+		}
+
+		pCache->freeLists[i] = NULL;
+		pCache->freeCounts[i] = 0;
+	}
+}
+
 const char* FormatMemorySize(uint64_t bytes)
 {
 	static char buffer[32]; // Static buffer for quick logging (not thread-safe!)
@@ -530,3 +1481,173 @@ void FormatMemorySizeThreadSafe(uint64_t bytes, char* out_buf, size_t buf_size)
 	snprintf(out_buf, buf_size, "%.2f %s", size, units[unit_index]);
 }
 
+/**
+ * @brief Probes the callsite index without the lock.
+ *
+ * Returns the record index, or MEMORY_CALLSITE_NONE with the first empty slot of the probe.
+ */
+static uint32_t MemoryManager_FindCallsite(const SMemoryBlockHeader* header, uint32_t slot, uint32_t* pEmptySlot)
+{
+	for (;;)
+	{
+		int32_t entry = AeroAtomic_Load32(&psMemoryManager->callsiteTable[slot]);
+		if (entry == 0)
+		{
+			*pEmptySlot = slot;
+			return (MEMORY_CALLSITE_NONE);
+		}
+
+		// The record is written before its slot is published
+		const SMemoryCallsite* pCallsite = &psMemoryManager->callsites[entry - 1];
+		if (pCallsite->file == header->file && pCallsite->line == (int32_t)header->line && pCallsite->typeName == header->typeName && pCallsite->tag == (EMemoryTag)header->tag)
+		{
+			return ((uint32_t)entry - 1);
+		}
+
+		slot = (slot + 1) & (MEMORY_CALLSITE_TABLE_SIZE - 1);
+	}
+}
+
+static uint32_t MemoryManager_InsertCallsite(const SMemoryBlockHeader* header, uint32_t slot)
+{
+	AeroSpinLock_Lock(&psMemoryManager->callsiteLock);
+
+	// Another thread may have inserted it since the unlocked probe, inserts are serialized from here
+	uint32_t emptySlot = 0;
+	uint32_t index = MemoryManager_FindCallsite(header, slot, &emptySlot);
+
+	int32_t count = psMemoryManager->callsiteCount;
+	if (index == MEMORY_CALLSITE_NONE && count < MEMORY_CALLSITE_CAPACITY)
+	{
+		SMemoryCallsite* pCallsite = &psMemoryManager->callsites[count];
+		pCallsite->file = header->file;
+		pCallsite->typeName = header->typeName;
+		pCallsite->line = (int32_t)header->line;
+		pCallsite->tag = (EMemoryTag)header->tag;
+		pCallsite->firstFrame = psMemoryManager->frameIndex;
+
+		AeroAtomic_Store32(&psMemoryManager->callsiteCount, count + 1);
+		AeroAtomic_Store32(&psMemoryManager->callsiteTable[emptySlot], count + 1);
+		index = (uint32_t)count;
+	}
+
+	AeroSpinLock_Unlock(&psMemoryManager->callsiteLock);
+
+	return (index);
+}
+
+/**
+ * @brief Adds to a callsite's counters: the thread cache's own set with plain adds, the shared set atomically without one.
+ */
+static void MemoryManager_CountCallsite(uint32_t index, SMemoryThreadCache* pCache, int64_t iBytes, bool bAlloc)
+{
+	int64_t iSign = bAlloc ? 1 : -1;
+
+	if (pCache && !pCache->callsiteCounters)
+	{
+		// Published atomically, reports may sum the sets from another thread
+		SMemoryCallsiteCounters* pSets = (SMemoryCallsiteCounters*)calloc(MEMORY_CALLSITE_CAPACITY, sizeof(SMemoryCallsiteCounters));
+		AeroAtomic_StorePtr((void* volatile*)&pCache->callsiteCounters, pSets);
+	}
+
+	if (pCache && pCache->callsiteCounters)
+	{
+		SMemoryCallsiteCounters* pSet = &pCache->callsiteCounters[index];
+		pSet->liveBytes += iSign * iBytes;
+		pSet->liveCount += iSign;
+		if (bAlloc)
+		{
+			pSet->totalAllocs++;
+		}
+		else
+		{
+			pSet->totalFrees++;
+		}
+		return;
+	}
+
+	SMemoryCallsiteCounters* pShared = &psMemoryManager->callsites[index].counters;
+	AeroAtomic_Add64(&pShared->liveBytes, iSign * iBytes);
+	AeroAtomic_Add64(&pShared->liveCount, iSign);
+	AeroAtomic_Add64(bAlloc ? &pShared->totalAllocs : &pShared->totalFrees, 1);
+}
+
+static uint32_t MemoryManager_RecordCallsiteAlloc(SMemoryBlockHeader* header, SMemoryThreadCache* pCache)
+{
+	if (!psMemoryManager->callsites)
+	{
+		return (MEMORY_CALLSITE_NONE);
+	}
+
+	// __FILE__ and type names are literals, so pointer identity is enough for the key
+	uint64_t key = (uint64_t)(uintptr_t)header->file ^ ((uint64_t)(uintptr_t)header->typeName << 1) ^ ((uint64_t)header->line << 32) ^ header->tag;
+	uint32_t slot = (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> 40) & (MEMORY_CALLSITE_TABLE_SIZE - 1);
+
+	// Known callsites, nearly every allocation, take no lock
+	uint32_t emptySlot = 0;
+	uint32_t index = MemoryManager_FindCallsite(header, slot, &emptySlot);
+	if (index == MEMORY_CALLSITE_NONE)
+	{
+		index = MemoryManager_InsertCallsite(header, slot);
+	}
+
+	if (index != MEMORY_CALLSITE_NONE)
+	{
+		MemoryManager_CountCallsite(index, pCache, (int64_t)header->size, true);
+	}
+
+	return (index);
+}
+
+static void MemoryManager_RecordCallsiteFree(SMemoryBlockHeader* header)
+{
+	if (header->callsite == MEMORY_CALLSITE_NONE || !psMemoryManager->callsites)
+	{
+		return;
+	}
+
+	// Counted on the freeing thread's set, like the untracked counters
+	SMemoryThreadCache* pCache = NULL;
+	if (AeroAtomic_Load32(&psMemoryManager->trackingMode) == MEMORY_TRACKING_PER_THREAD)
+	{
+		pCache = MemoryManager_GetThreadCache();
+	}
+
+	MemoryManager_CountCallsite(header->callsite, pCache, (int64_t)header->size, false);
+}
+
+/**
+ * @brief Collects the thread caches' callsite sets, returns how many there are.
+ */
+static int32_t MemoryManager_GetCallsiteSets(SMemoryCallsiteCounters** ppSets)
+{
+	int32_t setCount = 0;
+	for (int32_t slot = 0; slot < MEMORY_THREAD_CACHE_SLOTS; slot++)
+	{
+		SMemoryCallsiteCounters* pSet = (SMemoryCallsiteCounters*)AeroAtomic_LoadPtr((void* volatile*)&psMemoryManager->threadCaches[slot].callsiteCounters);
+		if (pSet)
+		{
+			ppSets[setCount++] = pSet;
+		}
+	}
+
+	return (setCount);
+}
+
+static void MemoryManager_SumCallsite(uint32_t index, SMemoryCallsiteCounters** ppSets, int32_t setCount, SMemoryCallsiteCounters* pSum)
+{
+	SMemoryCallsiteCounters* pShared = &psMemoryManager->callsites[index].counters;
+	pSum->liveBytes = AeroAtomic_Load64(&pShared->liveBytes);
+	pSum->liveCount = AeroAtomic_Load64(&pShared->liveCount);
+	pSum->totalAllocs = AeroAtomic_Load64(&pShared->totalAllocs);
+	pSum->totalFrees = AeroAtomic_Load64(&pShared->totalFrees);
+
+	for (int32_t i = 0; i < setCount; i++)
+	{
+		const SMemoryCallsiteCounters* pSet = &ppSets[i][index];
+		pSum->liveBytes += pSet->liveBytes;
+		pSum->liveCount += pSet->liveCount;
+		pSum->totalAllocs += pSet->totalAllocs;
+		pSum->totalFrees += pSet->totalFrees;
+	}
+}
@@ -10,9 +10,147 @@
 
 typedef struct SMemoryManager* MemoryManager;
 
+typedef enum EMemoryTrackingMode
+{
+	MEMORY_TRACKING_LOCKED,     // Single global live list guarded by the manager mutex (default)
+	MEMORY_TRACKING_PER_THREAD, // Per-thread live lists, counters and size-class caches, merged on demand
+} EMemoryTrackingMode;
+
+typedef enum EMemoryTrackingLevel
+{
+	MEMORY_TRACKING_LEVEL_OFF,      // Plain aligned malloc, nothing is recorded
+	MEMORY_TRACKING_LEVEL_COUNTERS, // Per-tag atomic counters only, no live list and no lock
+	MEMORY_TRACKING_LEVEL_SAMPLED,  // Counters, plus 1-in-N allocations fully tracked with their callsite
+	MEMORY_TRACKING_LEVEL_FULL,     // Every allocation linked with its callsite (default)
+} EMemoryTrackingLevel;
+
+// Highest level compiled in, see the AERO_MEMORY_TRACKING_LEVEL CMake option.
+// Anything above it folds away in tracked_malloc_internal.
+#ifndef MEMORY_TRACKING_MAX_LEVEL
+#define MEMORY_TRACKING_MAX_LEVEL MEMORY_TRACKING_LEVEL_FULL
+#endif
+
+#define MEMORY_TRACKING_DEFAULT_SAMPLE_RATE 64
+
+#define MEMORY_CALLSITE_CAPACITY 4096 // distinct (file, line, typeName, tag) keys, power of two
+#define MEMORY_CALLSITE_REPORT_TOP 32 // rows printed by MemoryManager_PrintData
+
+typedef enum EMemoryCallsiteSort
+{
+	MEMORY_CALLSITE_SORT_LIVE_BYTES,
+	MEMORY_CALLSITE_SORT_LIVE_COUNT,
+	MEMORY_CALLSITE_SORT_TOTAL_ALLOCS,
+	MEMORY_CALLSITE_SORT_FRAME_ALLOCS, // allocations during the last frame
+	MEMORY_CALLSITE_SORT_COUNT,
+} EMemoryCallsiteSort;
+
+// Aggregated allocations of one callsite (only blocks that keep their callsite: full and sampled levels)
+typedef struct SMemoryCallsiteStats
+{
+	const char* file;
+	const char* typeName;
+	int32_t line;
+	EMemoryTag tag;
+
+	uint64_t liveBytes;
+	uint64_t liveCount;
+	uint64_t totalAllocs;
+	uint64_t totalFrees;
+	uint64_t lastFrameAllocs;
+	uint64_t peakFrameAllocs;
+	float avgFrameAllocs; // since the callsite was first seen
+} SMemoryCallsiteStats;
+
+// Snapshot of the allocator counters, merged across every thread cache
+typedef struct SMemoryStats
+{
+	uint64_t totalAllocated;
+	uint64_t totalFreed;
+	uint64_t peakUsage;
+	uint64_t currentUsage;
+	uint64_t allocationCount;
+	size_t usageByTag[MEM_TAG_COUNT];
+	uint64_t allocatedByTag[MEM_TAG_COUNT]; // bytes ever allocated, freed bytes are (allocated - usage)
+} SMemoryStats;
+
+// Per-tag view of the last completed frame
+typedef struct SMemoryTagFrameStats
+{
+	size_t usage;            // live bytes when the frame closed
+	size_t budget;           // 0 = unlimited
+	uint64_t frameAllocated; // bytes allocated during the frame
+	uint64_t frameFreed;     // bytes freed during the frame
+	bool isOverBudget;
+} SMemoryTagFrameStats;
+
+/**
+ * @brief Fired from MemoryManager_BeginFrame (main thread) when a tag goes over its budget.
+ * Evicting from here is safe.
+ */
+typedef void (*MemoryBudgetCallbackFn)(EMemoryTag eTag, size_t usage, size_t budget, void* pUserData);
+
 bool MemoryManager_Initialize(MemoryManager* ppMemoryManager);
 void MemoryManager_Destroy(MemoryManager* ppMemoryManager);
 
+/**
+ * @brief Selects how new allocations are tracked.
+ *
+ * Safe to switch at any time: every block remembers which path allocated it,
+ * so frees always go back to the list that owns the block.
+ */
+void MemoryManager_SetTrackingMode(EMemoryTrackingMode eMode);
+EMemoryTrackingMode MemoryManager_GetTrackingMode();
+
+/**
+ * @brief Selects how much is recorded for new allocations (clamped to
+ * MEMORY_TRACKING_MAX_LEVEL). Like the mode, it can change at any time.
+ */
+void MemoryManager_SetTrackingLevel(EMemoryTrackingLevel eLevel);
+EMemoryTrackingLevel MemoryManager_GetTrackingLevel();
+
+/**
+ * @brief In sampled level, one allocation out of iRate per thread keeps its callsite.
+ */
+void MemoryManager_SetSampleRate(uint32_t iRate);
+
+/**
+ * @brief Fills pStats with the locked counters plus every per-thread cache.
+ */
+void MemoryManager_GetStats(SMemoryStats* pStats);
+
+/**
+ * @brief Returns the calling thread's size-class cache to the OS and lets the
+ * next new thread adopt its tracking slot. Call before a worker thread exits.
+ */
+void MemoryManager_ReleaseThreadCache();
+
+/**
+ * @brief Closes the per-frame allocation counts of every callsite.
+ * Called once at the top of Engine_Update.
+ */
+void MemoryManager_BeginFrame();
+
+/**
+ * @brief Per-tag budgets. Crossing is checked once per frame; systems that can
+ * evict (terrain streaming, textures) should ask MemoryManager_CanAllocate first.
+ */
+void MemoryManager_SetTagBudget(EMemoryTag eTag, size_t budget);
+size_t MemoryManager_GetTagBudget(EMemoryTag eTag);
+void MemoryManager_SetBudgetCallback(MemoryBudgetCallbackFn pfnCallback, void* pUserData);
+
+size_t MemoryManager_GetTagUsage(EMemoryTag eTag);
+size_t MemoryManager_GetTagHeadroom(EMemoryTag eTag); // SIZE_MAX when the tag has no budget
+bool MemoryManager_CanAllocate(EMemoryTag eTag, size_t size);
+void MemoryManager_GetTagFrameStats(EMemoryTag eTag, SMemoryTagFrameStats* pStats);
+
+/**
+ * @brief Copies up to iMaxCount callsites into pStats, sorted descending by eSort.
+ * Returns how many were written.
+ */
+uint32_t MemoryManager_GetCallsiteStats(SMemoryCallsiteStats* pStats, uint32_t iMaxCount, EMemoryCallsiteSort eSort);
+void MemoryManager_PrintCallsiteReport(uint32_t iTopCount, EMemoryCallsiteSort eSort);
+bool MemoryManager_ExportCallsitesCSV(const char* szFilePath, EMemoryCallsiteSort eSort);
+
 bool MemoryManager_Validate();
 void MemoryManager_DumpLeaks();
 void MemoryManager_PrintData();
@@ -0,0 +1,324 @@
+#include "PoolAllocator.h"
+#include "Stdafx.h"
+#include "Core/Atomics.h"
+
+#define POOL_SLOT_LIVE 0x504F4F4C // "POOL"
+#define POOL_SLOT_FREE 0x46524545 // "FREE"
+
+// Every element is preceded by its callsite so leaks can be blamed
+typedef struct SPoolSlotHeader
+{
+	const char* file;
+	int32_t line;
+	uint32_t magic;
+} SPoolSlotHeader;
+
+typedef struct SPoolSlab
+{
+	struct SPoolSlab* next;
+	char padding[8]; // keep the first slot 16-byte aligned
+} SPoolSlab;
+
+// Free slots reuse the element bytes for the free-list link
+typedef struct SPoolFreeSlot
+{
+	SPoolSlotHeader header;
+	struct SPoolFreeSlot* next;
+} SPoolFreeSlot;
+
+typedef struct SPoolAllocator
+{
+	const char* szName;
+	size_t elementSize;
+	size_t slotStride;		// header + element, rounded up to the alignment
+	size_t elementsPerSlab;
+	EMemoryTag tag;
+
+	SPoolSlab* pSlabs;
+	SPoolFreeSlot* pFreeList;
+	AeroSpinLock lock;
+
+	uint32_t slabCount;
+	uint32_t liveCount;
+	uint32_t peakLiveCount;
+	uint64_t totalAllocations;
+
+	// Registry links, so MemoryManager_DumpLeaks can see every pool
+	struct SPoolAllocator* pPrevPool;
+	struct SPoolAllocator* pNextPool;
+} SPoolAllocator;
+
+static PoolAllocator s_pPoolRegistry = NULL;
+static AeroSpinLock s_poolRegistryLock = 0;
+
+static bool PoolAllocator_AddSlab(PoolAllocator pPool);
+static bool PoolAllocator_PrintLiveSlots(PoolAllocator pPool, bool bHasLeaks);
+
+bool PoolAllocator_Initialize(PoolAllocator* ppPool, const char* szName, size_t elementSize, size_t elementsPerSlab, EMemoryTag tag)
+{
+	if (ppPool == NULL)
+	{
+		syserr("ppPool is NULL (invalid address)");
+		return (false);
+	}
+
+	*ppPool = engine_new_zero(SPoolAllocator, 1, tag);
+
+	PoolAllocator pPool = *ppPool;
+	if (!pPool)
+	{
+		syserr("Failed to Allocate Memory for Pool %s", szName);
+		return (false);
+	}
+
+	if (elementSize < sizeof(void*))
+	{
+		elementSize = sizeof(void*);
+	}
+
+	pPool->szName = szName ? szName : "unnamed_pool";
+	pPool->elementSize = elementSize;
+	pPool->slotStride = (sizeof(SPoolSlotHeader) + elementSize + (POOL_ALLOCATOR_ALIGNMENT - 1)) & ~((size_t)POOL_ALLOCATOR_ALIGNMENT - 1);
+	pPool->elementsPerSlab = elementsPerSlab ? elementsPerSlab : POOL_ALLOCATOR_DEFAULT_SLAB_COUNT;
+	pPool->tag = tag;
+
+	AeroSpinLock_Lock(&s_poolRegistryLock);
+	pPool->pNextPool = s_pPoolRegistry;
+	if (s_pPoolRegistry)
+	{
+		s_pPoolRegistry->pPrevPool = pPool;
+	}
+	s_pPoolRegistry = pPool;
+	AeroSpinLock_Unlock(&s_poolRegistryLock);
+
+	return (true);
+}
+
+void PoolAllocator_Destroy(PoolAllocator* ppPool)
+{
+	if (!ppPool || !*ppPool)
+	{
+		return;
+	}
+
+	PoolAllocator pPool = *ppPool;
+
+	AeroSpinLock_Lock(&s_poolRegistryLock);
+	if (pPool->pPrevPool)
+	{
+		pPool->pPrevPool->pNextPool = pPool->pNextPool;
+	}
+	else
+	{
+		s_pPoolRegistry = pPool->pNextPool;
+	}
+
+	if (pPool->pNextPool)
+	{
+		pPool->pNextPool->pPrevPool = pPool->pPrevPool;
+	}
+	AeroSpinLock_Unlock(&s_poolRegistryLock);
+
+	if (pPool->liveCount > 0)
+	{
+		syserr("Pool %s destroyed with %u live elements", pPool->szName, pPool->liveCount);
+		PoolAllocator_PrintLiveSlots(pPool, true);
+	}
+
+	SPoolSlab* pSlab = pPool->pSlabs;
+	while (pSlab)
+	{
+		SPoolSlab* pNext = pSlab->next;
+		engine_delete(pSlab);
+		pSlab = pNext;
+	}
+
+	engine_delete(pPool);
+	*ppPool = NULL;
+}
+
+void* PoolAllocator_Alloc(PoolAllocator pPool, const char* file, int line)
+{
+	if (!pPool)
+	{
+		syserr("Allocating from a NULL pool (%s:%d)", file, line);
+		return (NULL);
+	}
+
+	AeroSpinLock_Lock(&pPool->lock);
+
+	if (!pPool->pFreeList && !PoolAllocator_AddSlab(pPool))
+	{
+		AeroSpinLock_Unlock(&pPool->lock);
+		syserr("Pool %s failed to grow (%s:%d)", pPool->szName, file, line);
+		return (NULL);
+	}
+
+	SPoolFreeSlot* pSlot = pPool->pFreeList;
+	pPool->pFreeList = pSlot->next;
+
+	pPool->liveCount++;
+	pPool->totalAllocations++;
+	if (pPool->liveCount > pPool->peakLiveCount)
+	{
+		pPool->peakLiveCount = pPool->liveCount;
+	}
+
+	AeroSpinLock_Unlock(&pPool->lock);
+
+	pSlot->header.file = file;
+	pSlot->header.line = line;
+	pSlot->header.magic = POOL_SLOT_LIVE;
+
+	return ((SPoolSlotHeader*)pSlot + 1);
+}
+
+void* PoolAllocator_AllocZero(PoolAllocator pPool, const char* file, int line)
+{
+	void* pElement = PoolAllocator_Alloc(pPool, file, line);
+	if (pElement)
+	{
+		memset(pElement, 0, pPool->elementSize);
+	}
+
+	return (pElement);
+}
+
+void PoolAllocator_Free(PoolAllocator pPool, void* pElement)
+{
+	if (!pPool || !pElement)
+	{
+		return;
+	}
+
+	SPoolFreeSlot* pSlot = (SPoolFreeSlot*)((SPoolSlotHeader*)pElement - 1);
+	if (pSlot->header.magic != POOL_SLOT_LIVE)
+	{
+		syserr("Pool %s: double free or foreign pointer %p", pPool->szName, pElement);
+		return;
+	}
+
+	pSlot->header.magic = POOL_SLOT_FREE;
+
+	AeroSpinLock_Lock(&pPool->lock);
+	pSlot->next = pPool->pFreeList;
+	pPool->pFreeList = pSlot;
+	pPool->liveCount--;
+	AeroSpinLock_Unlock(&pPool->lock);
+}
+
+void PoolAllocator_GetStats(PoolAllocator pPool, SPoolAllocatorStats* pStats)
+{
+	if (!pStats)
+	{
+		return;
+	}
+
+	memset(pStats, 0, sizeof(SPoolAllocatorStats));
+
+	if (!pPool)
+	{
+		return;
+	}
+
+	AeroSpinLock_Lock(&pPool->lock);
+	pStats->elementSize = pPool->elementSize;
+	pStats->elementsPerSlab = pPool->elementsPerSlab;
+	pStats->slabCount = pPool->slabCount;
+	pStats->liveCount = pPool->liveCount;
+	pStats->peakLiveCount = pPool->peakLiveCount;
+	pStats->totalAllocations = pPool->totalAllocations;
+	AeroSpinLock_Unlock(&pPool->lock);
+}
+
+bool PoolAllocator_DumpLeaks()
+{
+	bool bHasLeaks = false;
+
+	AeroSpinLock_Lock(&s_poolRegistryLock);
+	for (PoolAllocator pPool = s_pPoolRegistry; pPool; pPool = pPool->pNextPool)
+	{
+		AeroSpinLock_Lock(&pPool->lock);
+		bHasLeaks = PoolAllocator_PrintLiveSlots(pPool, bHasLeaks);
+		AeroSpinLock_Unlock(&pPool->lock);
+	}
+	AeroSpinLock_Unlock(&s_poolRegistryLock);
+
+	return (bHasLeaks);
+}
+
+void PoolAllocator_PrintReport()
+{
+	syslog("--- POOL ALLOCATOR REPORT ---");
+
+	AeroSpinLock_Lock(&s_poolRegistryLock);
+	for (PoolAllocator pPool = s_pPoolRegistry; pPool; pPool = pPool->pNextPool)
+	{
+		SPoolAllocatorStats stats;
+		PoolAllocator_GetStats(pPool, &stats);
+
+		char reserved[16];
+		FormatMemorySizeThreadSafe((uint64_t)stats.slabCount * stats.elementsPerSlab * pPool->slotStride, reserved, sizeof(reserved));
+
+		syslog("%-24s [%s] live %u / peak %u, %u slabs (%s), %llu allocs", pPool->szName, MemoryTagNames[pPool->tag],
+			stats.liveCount, stats.peakLiveCount, stats.slabCount, reserved, (unsigned long long)stats.totalAllocations);
+	}
+	AeroSpinLock_Unlock(&s_poolRegistryLock);
+}
+
+static bool PoolAllocator_AddSlab(PoolAllocator pPool)
+{
+	SPoolSlab* pSlab = (SPoolSlab*)tracked_malloc_internal(sizeof(SPoolSlab) + pPool->slotStride * pPool->elementsPerSlab, __FILE__, __LINE__, pPool->szName, pPool->tag);
+	if (!pSlab)
+	{
+		return (false);
+	}
+
+	pSlab->next = pPool->pSlabs;
+	pPool->pSlabs = pSlab;
+	pPool->slabCount++;
+
+	// Push in reverse so consecutive allocations come out in address order
+	uint8_t* pFirst = (uint8_t*)(pSlab + 1);
+	for (size_t i = pPool->elementsPerSlab; i-- > 0;)
+	{
+		SPoolFreeSlot* pSlot = (SPoolFreeSlot*)(pFirst + i * pPool->slotStride);
+		pSlot->header.file = NULL;
+		pSlot->header.line = 0;
+		pSlot->header.magic = POOL_SLOT_FREE;
+		pSlot->next = pPool->pFreeList;
+		pPool->pFreeList = pSlot;
+	}
+
+	return (true);
+}
+
+static bool PoolAllocator_PrintLiveSlots(PoolAllocator pPool, bool bHasLeaks)
+{
+	if (pPool->liveCount == 0)
+	{
+		return (bHasLeaks);
+	}
+
+	for (SPoolSlab* pSlab = pPool->pSlabs; pSlab; pSlab = pSlab->next)
+	{
+		uint8_t* pFirst = (uint8_t*)(pSlab + 1);
+		for (size_t i = 0; i < pPool->elementsPerSlab; i++)
+		{
+			SPoolSlotHeader* pHeader = (SPoolSlotHeader*)(pFirst + i * pPool->slotStride);
+			if (pHeader->magic != POOL_SLOT_LIVE)
+			{
+				continue;
+			}
+
+			if (!bHasLeaks)
+			{
+				syslog("--- MEMORY LEAK REPORT ---");
+				bHasLeaks = true;
+			}
+			syslog("Leak: %zu bytes from pool %s allocated at %s:%d", pPool->elementSize, pPool->szName, pHeader->file, pHeader->line);
+		}
+	}
+
+	return (bHasLeaks);
+}
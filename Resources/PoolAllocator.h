@@ -0,0 +1,55 @@
+#ifndef __POOL_ALLOCATOR_H__
+#define __POOL_ALLOCATOR_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "MemoryTags.h"
+
+#define POOL_ALLOCATOR_ALIGNMENT 16
+#define POOL_ALLOCATOR_DEFAULT_SLAB_COUNT 64 // elements per slab
+
+typedef struct SPoolAllocator* PoolAllocator;
+
+// Snapshot of one pool's counters
+typedef struct SPoolAllocatorStats
+{
+	size_t elementSize;
+	size_t elementsPerSlab;
+	uint32_t slabCount;
+	uint32_t liveCount;
+	uint32_t peakLiveCount;
+	uint64_t totalAllocations;
+} SPoolAllocatorStats;
+
+/**
+ * @brief Creates a fixed-size pool. Elements are carved out of contiguous slabs
+ * (one tracked heap allocation per slab) and recycled through a free-list.
+ *
+ * szName must outlive the pool (use a string literal).
+ */
+bool PoolAllocator_Initialize(PoolAllocator* ppPool, const char* szName, size_t elementSize, size_t elementsPerSlab, EMemoryTag tag);
+
+/**
+ * @brief Reports any element still alive, then releases every slab.
+ */
+void PoolAllocator_Destroy(PoolAllocator* ppPool);
+
+void* PoolAllocator_Alloc(PoolAllocator pPool, const char* file, int line);
+void* PoolAllocator_AllocZero(PoolAllocator pPool, const char* file, int line);
+void PoolAllocator_Free(PoolAllocator pPool, void* pElement);
+
+void PoolAllocator_GetStats(PoolAllocator pPool, SPoolAllocatorStats* pStats);
+
+/**
+ * @brief Prints live elements of every registered pool. Called from
+ * MemoryManager_DumpLeaks. Returns true when something leaked.
+ */
+bool PoolAllocator_DumpLeaks();
+void PoolAllocator_PrintReport();
+
+#define pool_new(pool, type) (type*)PoolAllocator_Alloc(pool, __FILE__, __LINE__)
+#define pool_new_zero(pool, type) (type*)PoolAllocator_AllocZero(pool, __FILE__, __LINE__)
+#define pool_delete(pool, pElement) PoolAllocator_Free(pool, pElement)
+
+#endif // __POOL_ALLOCATOR_H__
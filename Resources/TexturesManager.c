@@ -1 +1,304 @@
-#include "TexturesManager.h"
\ No newline at end of file
+#include "TexturesManager.h"
+#include "Stdafx.h"
+
+static TexturesManager psTexturesManager = NULL;
+
+static TextureHandle TexturesManager_AddEntry(TexturesManager pManager, const char* szKey, Texture pTexture);
+static void TexturesManager_DestroyEntry(TexturesManager pManager, STextureEntry* pEntry);
+
+bool TexturesManager_Initialize(TexturesManager* ppTexturesManager)
+{
+	if (ppTexturesManager == NULL)
+	{
+		syserr("ppTexturesManager is NULL (invalid address)");
+		return (false);
+	}
+
+	*ppTexturesManager = engine_new_zero(STexturesManager, 1, MEM_TAG_TEXTURE);
+
+	if (!(*ppTexturesManager))
+	{
+		syserr("Failed to Allocate Memory for TexturesManager");
+		return (false);
+	}
+
+	psTexturesManager = *ppTexturesManager;
+
+	if (!SlotMap_Initialize(&psTexturesManager->textures, sizeof(STextureEntry), MAX_ENGINE_TEXTURES, MEM_TAG_TEXTURE))
+	{
+		syserr("Failed to Initialize Textures SlotMap");
+		TexturesManager_Destroy(ppTexturesManager);
+		return (false);
+	}
+
+	// Values are handles stored inline, nothing to destroy
+	if (!UnorderedMap_Initialize(&psTexturesManager->nameToHandle, MEM_TAG_TEXTURE))
+	{
+		syserr("Failed to Initialize Textures name map");
+		TexturesManager_Destroy(ppTexturesManager);
+		return (false);
+	}
+	UnorderedMap_Reserve(psTexturesManager->nameToHandle, MAX_ENGINE_TEXTURES);
+
+	return (true);
+}
+
+void TexturesManager_Destroy(TexturesManager* ppTexturesManager)
+{
+	if (!ppTexturesManager || !(*ppTexturesManager))
+	{
+		return;
+	}
+
+	TexturesManager pManager = *ppTexturesManager;
+
+	// Anything still referenced at shutdown is released here
+	if (pManager->textures)
+	{
+		for (uint32_t i = 0; i < SlotMap_Count(pManager->textures); i++)
+		{
+			TexturesManager_DestroyEntry(pManager, (STextureEntry*)SlotMap_DenseAt(pManager->textures, i));
+		}
+	}
+
+	SlotMap_Destroy(&pManager->textures);
+	UnoderedMap_Destroy(&pManager->nameToHandle);
+
+	engine_delete(pManager);
+
+	psTexturesManager = NULL;
+	*ppTexturesManager = NULL;
+}
+
+static TextureHandle TexturesManager_AddEntry(TexturesManager pManager, const char* szKey, Texture pTexture)
+{
+	TextureHandle handle = TEXTURE_HANDLE_INVALID;
+	STextureEntry* pEntry = (STextureEntry*)SlotMap_Emplace(pManager->textures, &handle);
+	if (!pEntry)
+	{
+		return (TEXTURE_HANDLE_INVALID);
+	}
+
+	pEntry->szKey = engine_strdup(szKey, MEM_TAG_STRINGS);
+	if (!pEntry->szKey || !UnorderedMap_Insert(pManager->nameToHandle, szKey, (void*)(uintptr_t)handle))
+	{
+		if (pEntry->szKey)
+		{
+			engine_delete(pEntry->szKey);
+		}
+		SlotMap_Remove(pManager->textures, handle);
+		syserr("Failed to register texture key: %s", szKey);
+		return (TEXTURE_HANDLE_INVALID);
+	}
+
+	pEntry->pTexture = pTexture;
+	pEntry->textureID = pTexture->textureID;
+	pEntry->bindlessHandle = pTexture->textureHandle;
+	pEntry->isResident = pTexture->isResident;
+	pEntry->refCount = 1;
+
+	if (pEntry->isResident)
+	{
+		pManager->activeResidentCount++;
+	}
+
+	return (handle);
+}
+
+static void TexturesManager_DestroyEntry(TexturesManager pManager, STextureEntry* pEntry)
+{
+	if (pEntry->isResident && pManager->activeResidentCount > 0)
+	{
+		pManager->activeResidentCount--;
+	}
+
+	Texture_Destroy(&pEntry->pTexture);
+
+	if (pEntry->szKey)
+	{
+		engine_delete(pEntry->szKey);
+		pEntry->szKey = NULL;
+	}
+}
+
+TextureHandle TexturesManager_Load(const char* szTexturePath, bool isBindless)
+{
+	TexturesManager pManager = GetTexturesManager();
+	if (!pManager || !szTexturePath)
+	{
+		return (TEXTURE_HANDLE_INVALID);
+	}
+
+	// Same path, same texture
+	TextureHandle handle = TexturesManager_Find(szTexturePath);
+	if (handle != TEXTURE_HANDLE_INVALID)
+	{
+		STextureEntry* pEntry = (STextureEntry*)SlotMap_Get(pManager->textures, handle);
+		pEntry->refCount++;
+
+		if (isBindless && !pEntry->pTexture->isBindless)
+		{
+			pEntry->pTexture->isBindless = true;
+			TexturesManager_SetResident(handle, true);
+		}
+		return (handle);
+	}
+
+	Texture pTexture = NULL;
+	if (!Texture_Initialize(&pTexture))
+	{
+		syserr("Failed to Initialize texture: %s", szTexturePath);
+		return (TEXTURE_HANDLE_INVALID);
+	}
+
+	pTexture->isBindless = isBindless;
+
+	// Texture_Load frees the texture itself when it fails
+	if (!Texture_Load(pTexture, szTexturePath))
+	{
+		syserr("Failed to Load texture: %s", szTexturePath);
+		return (TEXTURE_HANDLE_INVALID);
+	}
+
+	handle = TexturesManager_AddEntry(pManager, szTexturePath, pTexture);
+	if (handle == TEXTURE_HANDLE_INVALID)
+	{
+		Texture_Destroy(&pTexture);
+	}
+
+	return (handle);
+}
+
+TextureHandle TexturesManager_Register(const char* szKey, Texture pTexture)
+{
+	TexturesManager pManager = GetTexturesManager();
+	if (!pManager || !szKey || !pTexture)
+	{
+		return (TEXTURE_HANDLE_INVALID);
+	}
+
+	if (TexturesManager_Find(szKey) != TEXTURE_HANDLE_INVALID)
+	{
+		syserr("Texture key already registered: %s", szKey);
+		return (TEXTURE_HANDLE_INVALID);
+	}
+
+	return (TexturesManager_AddEntry(pManager, szKey, pTexture));
+}
+
+TextureHandle TexturesManager_Find(const char* szKey)
+{
+	TexturesManager pManager = GetTexturesManager();
+	if (!pManager || !szKey)
+	{
+		return (TEXTURE_HANDLE_INVALID);
+	}
+
+	return ((TextureHandle)(uintptr_t)UnorderedMap_Find(pManager->nameToHandle, szKey));
+}
+
+Texture TexturesManager_Get(TextureHandle handle)
+{
+	TexturesManager pManager = GetTexturesManager();
+	if (!pManager)
+	{
+		return (NULL);
+	}
+
+	STextureEntry* pEntry = (STextureEntry*)SlotMap_Get(pManager->textures, handle);
+	return ((pEntry) ? pEntry->pTexture : NULL);
+}
+
+void TexturesManager_Release(TextureHandle* pHandle)
+{
+	TexturesManager pManager = GetTexturesManager();
+	if (!pManager || !pHandle)
+	{
+		return;
+	}
+
+	STextureEntry* pEntry = (STextureEntry*)SlotMap_Get(pManager->textures, *pHandle);
+	if (pEntry && --pEntry->refCount == 0)
+	{
+		UnorderedMap_Remove(pManager->nameToHandle, pEntry->szKey);
+		TexturesManager_DestroyEntry(pManager, pEntry);
+		SlotMap_Remove(pManager->textures, *pHandle);
+	}
+
+	*pHandle = TEXTURE_HANDLE_INVALID;
+}
+
+bool TexturesManager_SetResident(TextureHandle handle, bool bSetResident)
+{
+	TexturesManager pManager = GetTexturesManager();
+	if (!pManager)
+	{
+		return (false);
+	}
+
+	STextureEntry* pEntry = (STextureEntry*)SlotMap_Get(pManager->textures, handle);
+	if (!pEntry)
+	{
+		syserr("Stale texture handle 0x%08X", handle);
+		return (false);
+	}
+
+	bool bResult = Texture_MakeResident(pEntry->pTexture, bSetResident);
+
+	bool isResident = pEntry->pTexture->isResident;
+	if (isResident != pEntry->isResident)
+	{
+		pManager->activeResidentCount += (isResident) ? 1 : -1;
+	}
+	pEntry->isResident = isResident;
+	pEntry->bindlessHandle = pEntry->pTexture->textureHandle;
+
+	return (bResult);
+}
+
+uint32_t TexturesManager_GatherResidentHandles(uint64_t* pHandles, uint32_t maxHandles)
+{
+	TexturesManager pManager = GetTexturesManager();
+	if (!pManager || !pHandles)
+	{
+		return (0);
+	}
+
+	// Walks only the packed entries, the STexture behind each one stays cold
+	const STextureEntry* pEntries = (const STextureEntry*)pManager->textures->pDense;
+	uint32_t count = SlotMap_Count(pManager->textures);
+	uint32_t written = 0;
+
+	for (uint32_t i = 0; i < count && written < maxHandles; i++)
+	{
+		if (pEntries[i].isResident)
+		{
+			pHandles[written++] = pEntries[i].bindlessHandle;
+		}
+	}
+
+	return (written);
+}
+
+uint32_t TexturesManager_GetCount()
+{
+	TexturesManager pManager = GetTexturesManager();
+	return ((pManager) ? SlotMap_Count(pManager->textures) : 0);
+}
+
+STextureEntry* TexturesManager_GetEntries()
+{
+	TexturesManager pManager = GetTexturesManager();
+	return ((pManager) ? (STextureEntry*)pManager->textures->pDense : NULL);
+}
+
+uint32_t TexturesManager_GetResidentCount()
+{
+	TexturesManager pManager = GetTexturesManager();
+	return ((pManager) ? pManager->activeResidentCount : 0);
+}
+
+TexturesManager GetTexturesManager()
+{
+	return (psTexturesManager);
+}
@@ -3,19 +3,82 @@
 
 #define MAX_ENGINE_TEXTURES 256
 
+#include <stdint.h>
+#include <stdbool.h>
 #include "PipeLine/Texture.h"
+#include "AeroLib/SlotMap.h"
+#include "AeroLib/UnorderedMap.h"
+
+// Generational handle to a managed texture, 0 = no texture
+typedef AeroHandle TextureHandle;
+
+#define TEXTURE_HANDLE_INVALID AERO_HANDLE_INVALID
+
+/**
+ * @brief Dense per-texture record, only what per-frame loops touch.
+ *
+ * Everything else stays in the STexture it points to.
+ */
+typedef struct STextureEntry
+{
+	uint64_t bindlessHandle;	// Copy of pTexture->textureHandle while resident
+	Texture pTexture;			// Owned by the manager
+	char* szKey;				// Key in nameToHandle (path for loaded textures)
+	uint32_t textureID;
+	uint32_t refCount;
+	bool isResident;
+} STextureEntry;
 
 typedef struct STexturesManager
 {
-    Texture* textures; // double Pointers to our textures (array)
+	AeroSlotMap textures;				// STextureEntry, packed
+	AeroUnorderedMap nameToHandle;		// Key -> TextureHandle, dedups loads
+	uint32_t activeResidentCount;
+} STexturesManager;
 
-    // Tracking
-    uint32_t count;
-    uint32_t capacity;
-    uint32_t activeResidentCount;
+typedef struct STexturesManager* TexturesManager;
 
-    // Search (Optional but highly recommended)
-    // You could store a hash-map here later to find textures by name
-} STexturesManager;
+#ifdef __cplusplus
+extern "C" {
+#endif
+bool TexturesManager_Initialize(TexturesManager* ppTexturesManager);
+void TexturesManager_Destroy(TexturesManager* ppTexturesManager);
+
+/**
+ * @brief Loads a texture from disk once, later loads of the same path add a reference.
+ */
+TextureHandle TexturesManager_Load(const char* szTexturePath, bool isBindless);
+
+/**
+ * @brief Hands a loaded texture to the manager under szKey, the manager owns it on success.
+ */
+TextureHandle TexturesManager_Register(const char* szKey, Texture pTexture);
+
+TextureHandle TexturesManager_Find(const char* szKey);
+Texture TexturesManager_Get(TextureHandle handle);
+
+/**
+ * @brief Drops one reference, the texture is destroyed with the last one.
+ */
+void TexturesManager_Release(TextureHandle* pHandle);
+
+bool TexturesManager_SetResident(TextureHandle handle, bool bSetResident);
+
+/**
+ * @brief Writes the bindless handles of all resident textures, returns how many.
+ */
+uint32_t TexturesManager_GatherResidentHandles(uint64_t* pHandles, uint32_t maxHandles);
+
+// Dense iteration, entries in [0, count)
+uint32_t TexturesManager_GetCount();
+STextureEntry* TexturesManager_GetEntries();
+uint32_t TexturesManager_GetResidentCount();
+
+// Singleton ~
+TexturesManager GetTexturesManager();
+
+#ifdef __cplusplus
+}
+#endif
 
-#endif 
\ No newline at end of file
+#endif // __TEXTURES_MANAGER_H__
@@ -17,12 +17,16 @@
 #endif
 
 #include "Resources/MemoryManager.h" // new Malloc
+#include "Resources/FrameAllocator.h" // per-frame scratch memory
+#include "Resources/PoolAllocator.h" // fixed-size object pools
+#include "Resources/TexturesManager.h" // texture handles, dedup loading
 
 #include "Engine.h"
 #include "Core/Window.h"
 #include "Core/Camera.h"
 #include "Core/Input.h"
 #include "Core/Log.h"
+#include "Core/JobSystem.h"
 #include "Buffers/Buffer.h"
 #include "Renderer/DebugRenderer.h"
 #include "PipeLine/StateManager.h"
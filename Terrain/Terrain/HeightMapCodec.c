@@ -0,0 +1,273 @@
+#include "HeightMapCodec.h"
+#include "Stdafx.h"
+#include <float.h>
+#include <emmintrin.h> // SSE2
+
+#define HEIGHTMAP_CODEC_LEVELS 65535.0f
+
+static inline uint32_t HeightMapCodec_GetBlockCount(int32_t cols, int32_t rows)
+{
+	return ((uint32_t)(((size_t)cols * (size_t)rows + HEIGHTMAP_CODEC_BLOCK_SIZE - 1) / HEIGHTMAP_CODEC_BLOCK_SIZE));
+}
+
+// Width 15 is stored as 16 so every width fits a nibble
+static inline uint32_t HeightMapCodec_RoundWidth(uint32_t width)
+{
+	return ((width == 15) ? 16 : width);
+}
+
+static inline uint32_t HeightMapCodec_WidthToCode(uint32_t width)
+{
+	return ((width >= 16) ? 15 : width);
+}
+
+static inline uint32_t HeightMapCodec_CodeToWidth(uint32_t code)
+{
+	return ((code == 15) ? 16 : code);
+}
+
+size_t HeightMapCodec_GetMaxEncodedSize(int32_t cols, int32_t rows)
+{
+	size_t blockCount = HeightMapCodec_GetBlockCount(cols, rows);
+	return (sizeof(SHeightMapCodecHeader) + (blockCount + 1) / 2 + blockCount * HEIGHTMAP_CODEC_BLOCK_SIZE * sizeof(uint16_t) + HEIGHTMAP_CODEC_PADDING);
+}
+
+size_t HeightMapCodec_Encode(const float* pHeights, int32_t cols, int32_t rows, uint8_t* pOut, size_t outCapacity)
+{
+	if (!pHeights || !pOut || cols <= 0 || rows <= 0 || outCapacity < HeightMapCodec_GetMaxEncodedSize(cols, rows))
+	{
+		return (0);
+	}
+
+	size_t count = (size_t)cols * (size_t)rows;
+	uint32_t blockCount = HeightMapCodec_GetBlockCount(cols, rows);
+
+	float minHeight = FLT_MAX;
+	float maxHeight = -FLT_MAX;
+	for (size_t i = 0; i < count; i++)
+	{
+		float height = isfinite(pHeights[i]) ? pHeights[i] : 0.0f;
+		minHeight = fminf(minHeight, height);
+		maxHeight = fmaxf(maxHeight, height);
+	}
+
+	float heightStep = (maxHeight - minHeight) / HEIGHTMAP_CODEC_LEVELS;
+	float invStep = (heightStep > 0.0f) ? 1.0f / heightStep : 0.0f;
+
+	SHeightMapCodecHeader* pHeader = (SHeightMapCodecHeader*)pOut;
+	pHeader->minHeight = minHeight;
+	pHeader->heightStep = heightStep;
+	pHeader->blockCount = blockCount;
+
+	uint8_t* pWidths = pOut + sizeof(SHeightMapCodecHeader);
+	uint8_t* pBits = pWidths + (blockCount + 1) / 2;
+	memset(pWidths, 0, (blockCount + 1) / 2);
+
+	uint16_t* pLevels = (uint16_t*)engine_malloc(count * sizeof(uint16_t), MEM_TAG_TERRAIN);
+	if (!pLevels)
+	{
+		syserr("Failed to Allocate HeightMap encode buffer");
+		return (0);
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		float height = isfinite(pHeights[i]) ? pHeights[i] : 0.0f;
+		float level = (height - minHeight) * invStep + 0.5f;
+		pLevels[i] = (uint16_t)((level > HEIGHTMAP_CODEC_LEVELS) ? HEIGHTMAP_CODEC_LEVELS : level);
+	}
+
+	uint64_t bitBuffer = 0;
+	uint32_t bitCount = 0;
+	size_t bitsSize = 0;
+
+	for (uint32_t b = 0; b < blockCount; b++)
+	{
+		uint16_t block[HEIGHTMAP_CODEC_BLOCK_SIZE] = { 0 };
+		uint16_t bitsOr = 0;
+
+		// Gradient predictor: q - up - left + upleft, modulo 2^16 like the decoder, zigzagged
+		for (uint32_t j = 0; j < HEIGHTMAP_CODEC_BLOCK_SIZE; j++)
+		{
+			size_t i = (size_t)b * HEIGHTMAP_CODEC_BLOCK_SIZE + j;
+			if (i >= count)
+			{
+				break;
+			}
+
+			size_t x = i % (size_t)cols;
+			bool hasUp = (i >= (size_t)cols);
+			uint16_t up = (hasUp) ? pLevels[i - (size_t)cols] : 0;
+			uint16_t left = (x > 0) ? pLevels[i - 1] : 0;
+			uint16_t upLeft = (hasUp && x > 0) ? pLevels[i - (size_t)cols - 1] : 0;
+
+			uint16_t residual = (uint16_t)(pLevels[i] - up - left + upLeft);
+			block[j] = (uint16_t)((residual << 1) ^ ((residual & 0x8000) ? 0xFFFF : 0));
+			bitsOr |= block[j];
+		}
+
+		uint32_t width = 0;
+		while (width < 16 && (bitsOr >> width) != 0)
+		{
+			width++;
+		}
+		width = HeightMapCodec_RoundWidth(width);
+
+		pWidths[b / 2] |= (uint8_t)(HeightMapCodec_WidthToCode(width) << ((b & 1) * 4));
+
+		for (uint32_t j = 0; j < HEIGHTMAP_CODEC_BLOCK_SIZE && width > 0; j++)
+		{
+			bitBuffer |= (uint64_t)block[j] << bitCount;
+			bitCount += width;
+			while (bitCount >= 8)
+			{
+				pBits[bitsSize++] = (uint8_t)bitBuffer;
+				bitBuffer >>= 8;
+				bitCount -= 8;
+			}
+		}
+	}
+
+	engine_delete(pLevels);
+
+	if (bitCount > 0)
+	{
+		pBits[bitsSize++] = (uint8_t)bitBuffer;
+	}
+
+	memset(pBits + bitsSize, 0, HEIGHTMAP_CODEC_PADDING);
+	bitsSize += HEIGHTMAP_CODEC_PADDING;
+
+	pHeader->bitsSize = (uint32_t)bitsSize;
+	return ((size_t)(pBits - pOut) + bitsSize);
+}
+
+// Fills pResiduals with every zigzagged residual, block by block
+static bool HeightMapCodec_Unpack(const uint8_t* pWidths, const uint8_t* pBits, size_t bitsSize, uint32_t blockCount, uint16_t* pResiduals)
+{
+	uint64_t bitPos = 0;
+	for (uint32_t b = 0; b < blockCount; b++)
+	{
+		uint32_t width = HeightMapCodec_CodeToWidth((pWidths[b / 2] >> ((b & 1) * 4)) & 0xF);
+		uint16_t* pBlock = pResiduals + (size_t)b * HEIGHTMAP_CODEC_BLOCK_SIZE;
+
+		if (width == 0)
+		{
+			memset(pBlock, 0, HEIGHTMAP_CODEC_BLOCK_SIZE * sizeof(uint16_t));
+			continue;
+		}
+
+		// The padding keeps the 8 byte loads inside the payload
+		if (((bitPos + (uint64_t)width * HEIGHTMAP_CODEC_BLOCK_SIZE + 7) >> 3) + HEIGHTMAP_CODEC_PADDING > bitsSize)
+		{
+			return (false);
+		}
+
+		// A 64 bit load shifted by up to 7 bits still holds 57 good bits, take as many values as fit
+		uint64_t mask = (1u << width) - 1u;
+		uint32_t perLoad = 57 / width;
+		for (uint32_t j = 0; j < HEIGHTMAP_CODEC_BLOCK_SIZE;)
+		{
+			uint64_t word;
+			memcpy(&word, pBits + (bitPos >> 3), sizeof(word));
+			word >>= (bitPos & 7);
+
+			uint32_t end = (j + perLoad < HEIGHTMAP_CODEC_BLOCK_SIZE) ? j + perLoad : HEIGHTMAP_CODEC_BLOCK_SIZE;
+			bitPos += (uint64_t)(end - j) * width;
+			for (; j < end; j++)
+			{
+				pBlock[j] = (uint16_t)(word & mask);
+				word >>= width;
+			}
+		}
+	}
+
+	return (true);
+}
+
+bool HeightMapCodec_Decode(const uint8_t* pData, size_t size, int32_t cols, int32_t rows, float* pOutHeights)
+{
+	if (!pData || !pOutHeights || cols <= 0 || rows <= 0 || size < sizeof(SHeightMapCodecHeader))
+	{
+		return (false);
+	}
+
+	SHeightMapCodecHeader header;
+	memcpy(&header, pData, sizeof(header));
+
+	uint32_t blockCount = HeightMapCodec_GetBlockCount(cols, rows);
+	size_t widthsSize = (blockCount + 1) / 2;
+	if (header.blockCount != blockCount || header.bitsSize < HEIGHTMAP_CODEC_PADDING ||
+		size < sizeof(SHeightMapCodecHeader) + widthsSize + header.bitsSize)
+	{
+		return (false);
+	}
+
+	const uint8_t* pWidths = pData + sizeof(SHeightMapCodecHeader);
+	const uint8_t* pBits = pWidths + widthsSize;
+
+	// Residuals for the whole tile, then one row of quantized heights carried down
+	size_t residualCount = (size_t)blockCount * HEIGHTMAP_CODEC_BLOCK_SIZE;
+	uint16_t* pResiduals = (uint16_t*)engine_malloc((residualCount + (size_t)cols) * sizeof(uint16_t), MEM_TAG_TERRAIN);
+	if (!pResiduals)
+	{
+		syserr("Failed to Allocate HeightMap decode buffer");
+		return (false);
+	}
+	uint16_t* pRowQ = pResiduals + residualCount;
+	memset(pRowQ, 0, (size_t)cols * sizeof(uint16_t));
+
+	if (!HeightMapCodec_Unpack(pWidths, pBits, header.bitsSize, blockCount, pResiduals))
+	{
+		engine_delete(pResiduals);
+		return (false);
+	}
+
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 step = _mm_set1_ps(header.heightStep);
+	const __m128 base = _mm_set1_ps(header.minHeight);
+
+	for (int32_t z = 0; z < rows; z++)
+	{
+		const uint16_t* pRow = pResiduals + (size_t)z * (size_t)cols;
+		float* pOut = pOutHeights + (size_t)z * (size_t)cols;
+		__m128i carry = zero;	// Running column delta, broadcast
+		int32_t x = 0;
+
+		// Undo zigzag, prefix sum the row deltas, add the row above
+		for (; x + 8 <= cols; x += 8)
+		{
+			__m128i zz = _mm_loadu_si128((const __m128i*)(pRow + x));
+			__m128i delta = _mm_xor_si128(_mm_srli_epi16(zz, 1), _mm_sub_epi16(zero, _mm_and_si128(zz, one)));
+
+			delta = _mm_add_epi16(delta, _mm_slli_si128(delta, 2));
+			delta = _mm_add_epi16(delta, _mm_slli_si128(delta, 4));
+			delta = _mm_add_epi16(delta, _mm_slli_si128(delta, 8));
+			delta = _mm_add_epi16(delta, carry);
+
+			__m128i last = _mm_shufflehi_epi16(delta, _MM_SHUFFLE(3, 3, 3, 3));
+			carry = _mm_unpackhi_epi64(last, last);
+
+			__m128i q = _mm_add_epi16(_mm_loadu_si128((const __m128i*)(pRowQ + x)), delta);
+			_mm_storeu_si128((__m128i*)(pRowQ + x), q);
+
+			__m128 lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(q, zero));
+			__m128 hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(q, zero));
+			_mm_storeu_ps(pOut + x, _mm_add_ps(_mm_mul_ps(lo, step), base));
+			_mm_storeu_ps(pOut + x + 4, _mm_add_ps(_mm_mul_ps(hi, step), base));
+		}
+
+		uint16_t delta = (uint16_t)_mm_cvtsi128_si32(carry);
+		for (; x < cols; x++)
+		{
+			uint16_t zz = pRow[x];
+			delta = (uint16_t)(delta + (uint16_t)((zz >> 1) ^ (uint16_t)(0u - (zz & 1u))));
+			pRowQ[x] = (uint16_t)(pRowQ[x] + delta);
+			pOut[x] = header.minHeight + (float)pRowQ[x] * header.heightStep;
+		}
+	}
+
+	engine_delete(pResiduals);
+	return (true);
+}
@@ -0,0 +1,47 @@
+#ifndef __HEIGHTMAP_CODEC_H__
+#define __HEIGHTMAP_CODEC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define HEIGHTMAP_CODEC_BLOCK_SIZE 16		// Residuals sharing one bit width
+#define HEIGHTMAP_CODEC_PADDING 8			// Zero bytes after the bits, the decoder reads 64 bits at a time
+
+// HeightMap.raw starts with this, then cols * rows floats (version 1) or the encoded body (version 2)
+typedef struct SHeightMapHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	int32_t cols;
+	int32_t rows;
+} SHeightMapHeader;
+
+/**
+ * @brief Version 2 heightmap body, follows the usual magic / version / cols / rows.
+ *
+ * Heights are quantized to 16 bits between the tile min and max. Each value is
+ * predicted from its up, left and up-left neighbours (gradient predictor), the
+ * zigzagged residuals are bit packed in blocks of HEIGHTMAP_CODEC_BLOCK_SIZE with
+ * a 4 bit width per block. Lossy, the error stays under half a quantization step.
+ */
+typedef struct SHeightMapCodecHeader
+{
+	float minHeight;
+	float heightStep;		// (max - min) / 65535, 0 for a flat tile
+	uint32_t blockCount;
+	uint32_t bitsSize;		// Packed residual bytes, padding included
+} SHeightMapCodecHeader;
+
+size_t HeightMapCodec_GetMaxEncodedSize(int32_t cols, int32_t rows);
+
+/**
+ * @brief Encodes cols * rows heights, non finite heights are stored as 0.
+ *
+ * @return Bytes written to pOut, 0 when pOut is too small.
+ */
+size_t HeightMapCodec_Encode(const float* pHeights, int32_t cols, int32_t rows, uint8_t* pOut, size_t outCapacity);
+
+bool HeightMapCodec_Decode(const uint8_t* pData, size_t size, int32_t cols, int32_t rows, float* pOutHeights);
+
+#endif // __HEIGHTMAP_CODEC_H__
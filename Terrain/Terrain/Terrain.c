@@ -25,6 +25,7 @@ bool Terrain_Initialize(Terrain* ppTerrain)
 	}
 
 	Terrain_SetTerrainCoords(pTerrain, -1, -1);
+	pTerrain->gpuSlot = -1;
 
 	return (true);
 }
@@ -41,9 +42,19 @@ void Terrain_Destroy(Terrain* ppTerrain)
 	Vector_Destroy(&pTerrain->terrainPatches);
 
 	FloatGrid_Destroy(&pTerrain->heightMap);
+	MappedFile_Close(&pTerrain->heightMapFile);
 
 	Texture_Destroy(&pTerrain->pHeightMapTexture);
 
+	// Streamed terrains come and go, their fences must not pile up
+	for (int32_t i = 0; i < 3; i++)
+	{
+		if (pTerrain->fences[i])
+		{
+			glDeleteSync(pTerrain->fences[i]);
+		}
+	}
+
 	engine_delete(pTerrain);
 
 	*ppTerrain = NULL;
@@ -92,11 +103,6 @@ bool Terrain_InitializePatches(Terrain pTerrain)
 		for (int32_t iPatchNumX = 0; iPatchNumX < PATCH_XCOUNT; iPatchNumX++)
 		{
 			GLint iPatchNum = iPatchNumZ * PATCH_XCOUNT + iPatchNumX;
-			Vector4 color;
-			color.r = (float)(iPatchNum % 8) / 8.0f;      // Red: 0,0.125,0.25...
-			color.g = (float)(iPatchNum / 8 % 8) / 8.0f;  // Green: cycles every 8
-			color.b = 0.5f + 0.5f * sinf(iPatchNum * 0.3f);  // Blue: rainbow
-			color.a = 1.0f;
 
 			TerrainPatch pTerrainPatch = NULL;
 			if (!TerrainPatch_Initialize(&pTerrainPatch, pTerrain, iPatchNum))
@@ -104,26 +110,37 @@ bool Terrain_InitializePatches(Terrain pTerrain)
 				syserr("Failed to Initialize Patch %d", iPatchNum);
 				return (false);
 			}
+
+			TerrainPatch_UpdateBounds(pTerrainPatch, iPatchNumX, iPatchNumZ);
+			TerrainPatch_UpdateLODErrors(pTerrainPatch, iPatchNumX, iPatchNumZ);
 			
 			Vector_PushBack(pTerrain->terrainPatches, pTerrainPatch);
 		}
 	}
 
+#if !TERRAIN_VERTEX_PULLING
+	// With vertex pulling the heightmap SSBO is the only geometry, Terrain_Update uploads it
 	Terrain_UpdatePatches(pTerrain);
+#endif
 	return (true);
 }
 
-void Terrain_UpdatePatches(Terrain pTerrain)
+static void Terrain_UpdatePatchesRange(void* pUserData, uint32_t begin, uint32_t end)
 {
-	for (int32_t iPatchNumZ = 0; iPatchNumZ < PATCH_ZCOUNT; iPatchNumZ++)
+	Terrain pTerrain = (Terrain)pUserData;
+
+	for (uint32_t iPatchNum = begin; iPatchNum < end; iPatchNum++)
 	{
-		for (int32_t iPatchNumX = 0; iPatchNumX < PATCH_XCOUNT; iPatchNumX++)
-		{
-			Terrain_UpdatePatch(pTerrain, iPatchNumX, iPatchNumZ);
-		}
+		Terrain_UpdatePatch(pTerrain, (int32_t)(iPatchNum % PATCH_XCOUNT), (int32_t)(iPatchNum / PATCH_XCOUNT));
 	}
 }
 
+void Terrain_UpdatePatches(Terrain pTerrain)
+{
+	// Every patch only writes its own mesh, so rows of patches run as independent jobs
+	JobSystem_ParallelFor(TERRAIN_PATCH_COUNT, PATCH_XCOUNT, Terrain_UpdatePatchesRange, pTerrain);
+}
+
 void Terrain_UpdatePatch(Terrain pTerrain, int32_t iPatchNumX, int32_t iPatchNumZ)
 {
 	if (!pTerrain)
@@ -137,15 +154,6 @@ void Terrain_UpdatePatch(Terrain pTerrain, int32_t iPatchNumX, int32_t iPatchNum
 	int32_t iPatchStartX = iPatchNumX * PATCH_XSIZE;
 	int32_t iPatchStartZ = iPatchNumZ * PATCH_ZSIZE;
 
-	float fPatchXSizeMeters = PATCH_XSIZE * ENGINE_CELL_SIZE;
-	float fPatchZSizeMeters = PATCH_ZSIZE * ENGINE_CELL_SIZE;
-
-	float fPatchStartX = (float)(pTerrain->terrainXCoord * XSIZE * ENGINE_CELL_SIZE) + (float)(iPatchStartX * ENGINE_CELL_SIZE);
-	float fPatchStartZ = (float)(pTerrain->terrainZCoord * ZSIZE * ENGINE_CELL_SIZE) + (float)(iPatchStartZ * ENGINE_CELL_SIZE);
-
-	float fOriginalPatchStartX = fPatchStartX;
-	float fOriginalPatchStartZ = fPatchStartZ;
-
 	// Terrain Patch
 	TerrainPatch pTerrainPatch = Vector_GetPtr(pTerrain->terrainPatches, iPatchNum);
 	if (pTerrainPatch == NULL)
@@ -157,14 +165,48 @@ void Terrain_UpdatePatch(Terrain pTerrain, int32_t iPatchNumX, int32_t iPatchNum
 	// Clear Elements
 	TerrainMesh mesh = pTerrainPatch->terrainMesh;
 
-	Vector_Clear(mesh->pVertices);
-	Vector_Clear(mesh->pIndices);
+	TerrainMesh_Clear(mesh);
 
-	// Normals Calculations
-	Matrix4 model = TransformGetMatrix(&pTerrainPatch->terrainMesh->transform);
-	Matrix3 mat3Model = Matrix3_InitMatrix4(model);
-	Matrix3 invModel = Matrix3_Inverse(mat3Model);
-	Matrix3 normalMatrix = Matrix3_TransposeN(invModel);
+#if TERRAIN_COMPACT_VERTEX
+	// Grid position and normal only, the shader reads the height and places the vertex
+	if (!pTerrain->heightMap)
+	{
+		syserr("Terrain (%d, %d) has no heightmap", pTerrain->terrainXCoord, pTerrain->terrainZCoord);
+		return;
+	}
+
+	const int32_t rawCols = pTerrain->heightMap->cols;
+	for (GLint iZ = iPatchStartZ; iZ <= iPatchStartZ + PATCH_ZSIZE; iZ++)
+	{
+		// The padding keeps every neighbour inside the grid, the vertex itself sits at (iX + 1, iZ + 1)
+		const float* pRow = pTerrain->heightMap->pArray + (size_t)(iZ + 1) * rawCols + 1;
+
+		for (GLint iX = iPatchStartX; iX <= iPatchStartX + PATCH_XSIZE; iX++)
+		{
+			STerrainVertex vertex = { 0 };
+			vertex.gridX = (uint16_t)iX;
+			vertex.gridZ = (uint16_t)iZ;
+
+			// Central differences
+			float hL = pRow[iX - 1];
+			float hR = pRow[iX + 1];
+			float hD = pRow[iX - rawCols];
+			float hU = pRow[iX + rawCols];
+
+			TerrainVertex_EncodeNormal(Vector3D(hL - hR, 2.0f * ENGINE_CELL_SIZE, hD - hU), vertex.octNormal);
+
+			TerrainMesh_AddVertex(mesh, vertex);
+		}
+	}
+#else
+	float fPatchXSizeMeters = PATCH_XSIZE * ENGINE_CELL_SIZE;
+	float fPatchZSizeMeters = PATCH_ZSIZE * ENGINE_CELL_SIZE;
+
+	float fPatchStartX = (float)(pTerrain->terrainXCoord * XSIZE * ENGINE_CELL_SIZE) + (float)(iPatchStartX * ENGINE_CELL_SIZE);
+	float fPatchStartZ = (float)(pTerrain->terrainZCoord * ZSIZE * ENGINE_CELL_SIZE) + (float)(iPatchStartZ * ENGINE_CELL_SIZE);
+
+	float fOriginalPatchStartX = fPatchStartX;
+	float fOriginalPatchStartZ = fPatchStartZ;
 
 	// vertex color
 	Vector4 color;
@@ -195,8 +237,7 @@ void Terrain_UpdatePatch(Terrain pTerrain, int32_t iPatchNumX, int32_t iPatchNum
 
 		fPatchStartZ += (GLfloat)ENGINE_CELL_SIZE;
 	}
-
-	TerrainPatch_InitializeIndices(pTerrainPatch);
+#endif
 }
 
 void Terrain_Update(Terrain pTerrain)
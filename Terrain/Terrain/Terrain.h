@@ -8,6 +8,7 @@
 #include "AeroLib/Vector.h"
 #include "Math/Matrix/Matrix4.h"
 #include "Math/Transform.h"
+#include "Core/MappedFile.h"
 
 typedef struct STerrain
 {
@@ -17,9 +18,12 @@ typedef struct STerrain
 	int32_t terrainXCoord;	// Terrain Num Among X Axis
 	int32_t terrainZCoord;	// Terrain Num Among Z Axis
 	int32_t baseGlobalPatchIndex;
+	int32_t gpuSlot;		// Renderer slot, -1 while not on the GPU
+	uint32_t lastUsedFrame;	// Streaming LRU stamp
 
 	struct STerrainMap* parentMap;
 	struct SFloatGrid* heightMap;
+	SMappedFile heightMapFile;	// Backs heightMap while it is a view on HeightMap.raw
 	struct STexture* pHeightMapTexture;
 
 	// Height map direct access, Triple MAPPING — 3 pointers to SAME texture backing storage
@@ -58,6 +62,7 @@ bool Terrain_CreateFiles(struct STerrainMap* pParentMap, int32_t iTerrainX, int3
 bool Terrain_CreateHeightMap(Terrain pTerrain, const char* szTerrainsFolder);
 
 bool Terrain_LoadHeightMap(Terrain pTerrain, const char* szTerrainsFolder);
+bool Terrain_LoadHeightMapFromMemory(Terrain pTerrain, uint8_t* pData, size_t size, const char* szSource); // HeightMap.raw bytes, the grid keeps pointing at pData
 bool Terrain_SaveHeightMap(Terrain pTerrain, const char* szTerrainsFolder);
 
 bool Terrain_Load(Terrain pTerrain);
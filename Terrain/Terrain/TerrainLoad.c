@@ -2,6 +2,7 @@
 #include "Terrain/TerrainMap/TerrainMap.h"
 #include "Stdafx.h"
 #include "Math/Grids/FloatGrid.h"
+#include "HeightMapCodec.h"
 #include "Terrain/TerrainPatch.h"
 #include "PipeLine/Texture.h"
 #include "AeroLib/cJSON.h"
@@ -123,18 +124,94 @@ bool Terrain_CreateHeightMap(Terrain pTerrain, const char* szTerrainsFolder)
 	return (success);
 }
 
-bool Terrain_LoadHeightMap(Terrain pTerrain, const char* szTerrainsFolder)
+static bool Terrain_FixupHeightMap(Terrain pTerrain);
+
+static bool Terrain_ParseHeightMap(Terrain pTerrain, uint8_t* pData, size_t size, const char* szHeightMapFile, bool bCanView)
 {
-	char szHeightMapFile[MAX_STRING_LEN] = { 0 };
-	int32_t written = snprintf(szHeightMapFile, sizeof(szHeightMapFile), "%s/HeightMap.raw", szTerrainsFolder);
+	const SHeightMapHeader* pHeader = (const SHeightMapHeader*)pData;
 
-	// Check if the name was truncated
-	if (written >= sizeof(szHeightMapFile))
+	if (size < sizeof(SHeightMapHeader))
 	{
-		syserr("Path name is too long.");
+		syserr("Truncated heightmap file: %s", szHeightMapFile);
+		return (false);
+	}
+
+	if (pHeader->magic != TERRAIN_MAGIC_NUMBER)
+	{
+		syserr("Invalid file format: %s", szHeightMapFile);
+		return (false);
+	}
+
+	if (pHeader->version != TERRAIN_VERSION_NUMBER && pHeader->version != TERRAIN_HEIGHTMAP_VERSION_QUANTIZED)
+	{
+		syserr("Invalid file version: %s", szHeightMapFile);
+		return (false);
+	}
+
+	uint8_t* pBody = pData + sizeof(SHeightMapHeader);
+	size_t bodySize = size - sizeof(SHeightMapHeader);
+
+	if (pHeader->version == TERRAIN_HEIGHTMAP_VERSION_QUANTIZED)
+	{
+		// The encoding is tied to its dimensions, there is no partial read to fall back on
+		if (pHeader->cols != HEIGHTMAP_RAW_XSIZE || pHeader->rows != HEIGHTMAP_RAW_ZSIZE)
+		{
+			syserr("File dimensions (%dx%d) mismatch engine (%dx%d): %s", pHeader->cols, pHeader->rows, HEIGHTMAP_RAW_XSIZE, HEIGHTMAP_RAW_ZSIZE, szHeightMapFile);
+			return (false);
+		}
+
+		if (!FloatGrid_Initialize(&pTerrain->heightMap, HEIGHTMAP_RAW_XSIZE, HEIGHTMAP_RAW_ZSIZE, MEM_TAG_TERRAIN))
+		{
+			syserr("Failed to Initialize Height map");
+			return (false);
+		}
+
+		if (!HeightMapCodec_Decode(pBody, bodySize, HEIGHTMAP_RAW_XSIZE, HEIGHTMAP_RAW_ZSIZE, pTerrain->heightMap->pArray))
+		{
+			syserr("Failed to decode HeightMap Data: %s", szHeightMapFile);
+			FloatGrid_Destroy(&pTerrain->heightMap);
+			return (false);
+		}
+
+		return (true);
+	}
+
+	if (bodySize < HEIGHTMAP_RAW_XSIZE * HEIGHTMAP_RAW_ZSIZE * sizeof(float))
+	{
+		syserr("Failed to read HeightMap Data");
+		return (false);
+	}
+
+	//  Verify if file dimensions match engine dimensions
+	if (pHeader->cols != HEIGHTMAP_RAW_XSIZE || pHeader->rows != HEIGHTMAP_RAW_ZSIZE)
+	{
+		syserr("Warning: File dimensions (%dx%d) mismatch engine (%dx%d)", pHeader->cols, pHeader->rows, HEIGHTMAP_RAW_XSIZE, HEIGHTMAP_RAW_ZSIZE);
+	}
+
+	if (!bCanView)
+	{
+		if (!FloatGrid_Initialize(&pTerrain->heightMap, HEIGHTMAP_RAW_XSIZE, HEIGHTMAP_RAW_ZSIZE, MEM_TAG_TERRAIN))
+		{
+			syserr("Failed to Initialize Height map");
+			return (false);
+		}
+
+		memcpy(pTerrain->heightMap->pArray, pBody, FloatGrid_GetBytesSize(pTerrain->heightMap));
+		return (true);
+	}
+
+	// The grid reads the page cache directly, edits copy only the pages they touch
+	if (!FloatGrid_InitializeView(&pTerrain->heightMap, HEIGHTMAP_RAW_XSIZE, HEIGHTMAP_RAW_ZSIZE, (float*)pBody, MEM_TAG_TERRAIN))
+	{
+		syserr("Failed to Initialize Height map");
 		return (false);
 	}
 
+	return (true);
+}
+
+static bool Terrain_ReadHeightMap(Terrain pTerrain, const char* szHeightMapFile)
+{
 	// read our file
 	FILE* fHeightMap = fopen(szHeightMapFile, "rb");
 	if (fHeightMap == NULL)
@@ -143,35 +220,49 @@ bool Terrain_LoadHeightMap(Terrain pTerrain, const char* szTerrainsFolder)
 		return (false);
 	}
 
-	// 1. Check Magic Number
-	uint32_t MAGIC_NUMBER = 0;
-	if (fread(&MAGIC_NUMBER, sizeof(uint32_t), 1, fHeightMap) != 1)
+	fseek(fHeightMap, 0, SEEK_END);
+	long fileSize = ftell(fHeightMap);
+	fseek(fHeightMap, 0, SEEK_SET);
+
+	if (fileSize <= 0)
 	{
-		syserr("Failed to read Magic Number");
+		syserr("Truncated heightmap file: %s", szHeightMapFile);
 		fclose(fHeightMap);
 		return (false);
 	}
 
-	if (MAGIC_NUMBER != TERRAIN_MAGIC_NUMBER)
+	uint8_t* pBuffer = (uint8_t*)engine_malloc((size_t)fileSize, MEM_TAG_TERRAIN);
+	if (!pBuffer)
 	{
-		syserr("Invalid file format: %s", szHeightMapFile);
+		syserr("Failed to Allocate %ld bytes for %s", fileSize, szHeightMapFile);
 		fclose(fHeightMap);
 		return (false);
 	}
 
-	// 2. Check Version Number
-	uint32_t VERSION_NUMBER = 0;
-	if (fread(&VERSION_NUMBER, sizeof(uint32_t), 1, fHeightMap) != 1)
+	bool success = false;
+	if (fread(pBuffer, (size_t)fileSize, 1, fHeightMap) != 1)
 	{
-		syserr("Failed to read Version Number");
-		fclose(fHeightMap);
-		return (false);
+		syserr("Failed to read HeightMap Data");
 	}
+	else
+	{
+		success = Terrain_ParseHeightMap(pTerrain, pBuffer, (size_t)fileSize, szHeightMapFile, false);
+	}
+
+	engine_delete(pBuffer);
+	fclose(fHeightMap);
+	return (success);
+}
 
-	if (VERSION_NUMBER != TERRAIN_VERSION_NUMBER)
+bool Terrain_LoadHeightMap(Terrain pTerrain, const char* szTerrainsFolder)
+{
+	char szHeightMapFile[MAX_STRING_LEN] = { 0 };
+	int32_t written = snprintf(szHeightMapFile, sizeof(szHeightMapFile), "%s/HeightMap.raw", szTerrainsFolder);
+
+	// Check if the name was truncated
+	if (written >= sizeof(szHeightMapFile))
 	{
-		syserr("Invalid file version: %s", szHeightMapFile);
-		fclose(fHeightMap);
+		syserr("Path name is too long.");
 		return (false);
 	}
 
@@ -179,65 +270,83 @@ bool Terrain_LoadHeightMap(Terrain pTerrain, const char* szTerrainsFolder)
 	{
 		FloatGrid_Destroy(&pTerrain->heightMap);
 	}
+	MappedFile_Close(&pTerrain->heightMapFile);
 
-	// Create our grid
-	if (!FloatGrid_Initialize(&pTerrain->heightMap, HEIGHTMAP_RAW_XSIZE, HEIGHTMAP_RAW_ZSIZE, MEM_TAG_TERRAIN))
+	bool success = false;
+	if (MappedFile_Open(&pTerrain->heightMapFile, szHeightMapFile))
 	{
-		syserr("Failed to Initialize Height map");
-		fclose(fHeightMap);
-		return (false);
-	}
+		// Everything is read front to back right away (validation, patch meshes, SSBO upload)
+		MappedFile_Advise(&pTerrain->heightMapFile, 0, 0, MAPPED_FILE_ADVICE_SEQUENTIAL);
+		MappedFile_Advise(&pTerrain->heightMapFile, 0, 0, MAPPED_FILE_ADVICE_WILLNEED);
 
-	int32_t fCols = 0, fRows = 0;
-	bool success = false;
+		success = Terrain_ParseHeightMap(pTerrain, pTerrain->heightMapFile.pData, pTerrain->heightMapFile.size, szHeightMapFile, true) && Terrain_FixupHeightMap(pTerrain);
 
-	// Read metadata (Columns and Rows)
-	if (fread(&fCols, sizeof(int32_t), 1, fHeightMap) != 1)
+		// Quantized or fixed up heights live in an owned grid, the mapping is not needed past this point
+		if (!success || !pTerrain->heightMap->isView)
+		{
+			MappedFile_Close(&pTerrain->heightMapFile);
+		}
+	}
+	else
 	{
-		syserr("Failed to read Columns Number");
+		// Some file systems can't map, reading into our own grid still works there
+		success = Terrain_ReadHeightMap(pTerrain, szHeightMapFile) && Terrain_FixupHeightMap(pTerrain);
 	}
-	else if (fread(&fRows, sizeof(int32_t), 1, fHeightMap) != 1)
+
+	return (success);
+}
+
+bool Terrain_LoadHeightMapFromMemory(Terrain pTerrain, uint8_t* pData, size_t size, const char* szSource)
+{
+	if (pTerrain->heightMap)
 	{
-		syserr("Failed to read Rows Number");
+		FloatGrid_Destroy(&pTerrain->heightMap);
 	}
-	else if (fread(pTerrain->heightMap->pArray, FloatGrid_GetBytesSize(pTerrain->heightMap), 1, fHeightMap) != 1)
+	MappedFile_Close(&pTerrain->heightMapFile);
+
+	// pData has to outlive the terrain, raw tiles are viewed in place
+	return (Terrain_ParseHeightMap(pTerrain, pData, size, szSource, true) && Terrain_FixupHeightMap(pTerrain));
+}
+
+static bool Terrain_FixupHeightMap(Terrain pTerrain)
+{
+	FloatGrid pHeightMap = pTerrain->heightMap;
+
+	bool bNeedsFixup = false;
+	for (size_t i = 0; i < pHeightMap->size && !bNeedsFixup; ++i)
 	{
-		syserr("Failed to read HeightMap Data");
+		// isfinite checks if the number is not NaN and not Infinity
+		bNeedsFixup = !isfinite(pHeightMap->pArray[i]) || (i < 5 && pHeightMap->pArray[i] != 10.0f);
 	}
-	else
+
+	if (!bNeedsFixup)
 	{
-		//  Verify if file dimensions match engine dimensions
-		if (fCols != pTerrain->heightMap->cols || fRows != pTerrain->heightMap->rows)
-		{
-			syserr("Warning: File dimensions (%dx%d) mismatch engine (%dx%d)", fCols, fRows, pTerrain->heightMap->cols, pTerrain->heightMap->rows);
-		}
+		return (true);
+	}
 
-		success = true;
+	// Views are never written, a pack tile is read again from the same pages when it streams back in
+	if (!FloatGrid_MakeOwned(pHeightMap, MEM_TAG_TERRAIN))
+	{
+		syserr("Failed to copy HeightMap for fixup");
+		FloatGrid_Destroy(&pTerrain->heightMap);
+		return (false);
 	}
 
 	// Validate the data
-	if (success)
+	for (size_t i = 0; i < pHeightMap->size; ++i)
 	{
-		for (size_t i = 0; i < pTerrain->heightMap->size; ++i)
+		if (!isfinite(pHeightMap->pArray[i]))
 		{
-			float h = pTerrain->heightMap->pArray[i];
-			// isfinite checks if the number is not NaN and not Infinity
-			if (!isfinite(h))
-			{
-				pTerrain->heightMap->pArray[i] = 0.0f; // Reset bad data to 0
-			}
+			pHeightMap->pArray[i] = 0.0f; // Reset bad data to 0
 		}
 	}
 
-	fclose(fHeightMap);
-
-
 	for (int32_t i = 0; i < 5; i++)
 	{
-		pTerrain->heightMap->pArray[i] = 10.0f;
+		pHeightMap->pArray[i] = 10.0f;
 	}
 
-	return (success);
+	return (true);
 }
 
 bool Terrain_SaveHeightMap(Terrain pTerrain, const char* szTerrainsFolder)
@@ -247,6 +356,17 @@ bool Terrain_SaveHeightMap(Terrain pTerrain, const char* szTerrainsFolder)
 		return Terrain_CreateHeightMap(pTerrain, szTerrainsFolder);
 	}
 
+	// The file gets replaced below, a grid mapped on it needs its own copy first
+	if (pTerrain->heightMap->isView)
+	{
+		if (!FloatGrid_MakeOwned(pTerrain->heightMap, MEM_TAG_TERRAIN))
+		{
+			syserr("Failed to detach HeightMap from %s", szTerrainsFolder);
+			return (false);
+		}
+		MappedFile_Close(&pTerrain->heightMapFile);
+	}
+
 	char szHeightMapFile[MAX_STRING_LEN] = { 0 };
 	char szHeightMapFileBackUP[MAX_STRING_LEN] = { 0 };
 	int32_t written = snprintf(szHeightMapFileBackUP, sizeof(szHeightMapFileBackUP), "%s/HeightMap.raw.bak", szTerrainsFolder); // write to external file, in case we interrupt 
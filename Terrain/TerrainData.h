@@ -16,6 +16,14 @@ typedef enum ETerrainData
 
 	TERRAIN_PATCH_COUNT = PATCH_XCOUNT * PATCH_ZCOUNT,
 
+	// Every patch mesh has the same size, so each GPU terrain slot owns a fixed range
+	PATCH_VERTEX_COUNT = (PATCH_XSIZE + 1) * (PATCH_ZSIZE + 1),
+	PATCH_INDEX_COUNT = PATCH_XSIZE * PATCH_ZSIZE * 6,
+
+	// Index patterns shared by every patch, LOD n joins 2^n x 2^n quads (16, 8, 4, 2, 1 quads per side)
+	PATCH_LOD_COUNT = 5,
+	PATCH_STITCH_COUNT = 16,										// One pattern per set of sides facing a coarser neighbour (EPatchStitch bits)
+
 	// Core terrain grid dimensions (in cells)
 	XSIZE = TERRAIN_SIZE,											// Number of cells along X-axis (e.g., 128 cells)
 	ZSIZE = TERRAIN_SIZE,											// Number of cells along Z-axis (matches X for square terrain)
@@ -38,5 +46,6 @@ static const char terrainMapsFolder[] = "Assets/Maps/";
 static const char terrainMapScriptType[] = "AnubisMapSettings";
 static const uint32_t TERRAIN_MAGIC_NUMBER = 0x47726964;
 static const uint32_t TERRAIN_VERSION_NUMBER = 1;
+static const uint32_t TERRAIN_HEIGHTMAP_VERSION_QUANTIZED = 2; // HeightMap.raw body is HeightMapCodec encoded instead of raw floats
 
 #endif // __TERRAIN_DATA_H__
\ No newline at end of file
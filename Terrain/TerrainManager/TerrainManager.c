@@ -3,6 +3,8 @@
 #include "Terrain/TerrainMap/TerrainMap.h"
 #include "Renderer/TerrainRenderer.h"
 #include "PipeLine/Texture.h"
+#include "Terrain/TerrainPatch.h"
+#include "Terrain/TerrainStreamer/TerrainStreamer.h"
 
 bool TerrainManager_Initialize(TerrainManager* ppTerrainManager)
 {
@@ -30,16 +32,8 @@ bool TerrainManager_Initialize(TerrainManager* ppTerrainManager)
 		return (false);  // Cleanup everything above
 	}
 
-	if (!Texture_Initialize(&psTerrainManager->terrainTex))
-	{
-		TerrainManager_Destroy(ppTerrainManager);
-		syserr("Failed to Initialize terrain texture");
-		return (false);
-	}
-
-	psTerrainManager->terrainTex->isBindless = false;
-
-	if (!Texture_Load(psTerrainManager->terrainTex, "Assets/Textures/grass01.png"))
+	psTerrainManager->terrainTex = TexturesManager_Load("Assets/Textures/grass01.png", false);
+	if (psTerrainManager->terrainTex == TEXTURE_HANDLE_INVALID)
 	{
 		TerrainManager_Destroy(ppTerrainManager);
 		syserr("Failed to Load terrain texture");
@@ -66,10 +60,15 @@ void TerrainManager_Destroy(TerrainManager* ppTerrainManager)
 	}
 
 	TerrainRenderer_Destroy(&pManager->terarinRenderer);
+	TerrainStreamer_Destroy(&pManager->pStreamer);
 	
 	TerrainMap_Destroy(&pManager->pTerrainMap);
 
-	Texture_Destroy(&pManager->terrainTex);
+	// Every patch is gone with the map, release the pool slabs
+	TerrainPatch_DestroyPool();
+	TerrainMesh_DestroyPool();
+
+	TexturesManager_Release(&pManager->terrainTex);
 
 	// Destroy Manager
 	engine_delete(pManager);
@@ -88,6 +87,7 @@ void TerrainManager_Clear()
 
 	if (terrMgr->pTerrainMap)
 	{
+		TerrainStreamer_Destroy(&terrMgr->pStreamer);
 		TerrainMap_Clear(terrMgr->pTerrainMap);
 		TerrainRenderer_Reset(terrMgr->terarinRenderer);
 
@@ -108,6 +108,17 @@ void TerrainManager_Update()
 		return;
 	}
 
+	if (terrMgr->pStreamer)
+	{
+		TerrainStreamer_Update(terrMgr->pStreamer, Camera_GetPosition(GetEngine()->camera), GetEngine()->deltaTime);
+	}
+
+	// Full uploads below already cover whatever is attached this frame
+	if (!terrMgr->bNeedsUpdate)
+	{
+		TerrainManager_UploadLoadedTerrains(TERRAIN_UPLOAD_BUDGET_MS);
+	}
+
 	if (terrMgr->bNeedsUpdate)
 	{
 		if (terrMgr->pTerrainMap && terrMgr->pTerrainMap->isReady)
@@ -120,6 +131,132 @@ void TerrainManager_Update()
 	}
 }
 
+/**
+ * @brief Attaches terrains the workers finished and uploads them, until budgetMs is spent.
+ *
+ * At least one terrain goes up per call so a tiny budget still makes progress.
+ * @return Number of terrains uploaded.
+ */
+uint32_t TerrainManager_UploadLoadedTerrains(double budgetMs)
+{
+	TerrainManager terrMgr = GetTerrainManager();
+	if (!terrMgr || !terrMgr->isMapReady || !TerrainMap_IsLoading(terrMgr->pTerrainMap))
+	{
+		return (0);
+	}
+
+	double deadline = JobSystem_GetTimeMs() + budgetMs;
+	uint32_t uploaded = 0;
+
+	do
+	{
+		Terrain pTerrain = TerrainMap_PopBuiltTerrain(terrMgr->pTerrainMap);
+		if (!pTerrain)
+		{
+			break;
+		}
+
+		// Streaming shares a slot pool, otherwise every terrain owns the slot of its map position
+		if (terrMgr->pStreamer)
+		{
+			int32_t iSlot = TerrainStreamer_AcquireSlot(terrMgr->pStreamer, pTerrain);
+			if (iSlot < 0)
+			{
+				TerrainMap_UnloadTerrain(terrMgr->pTerrainMap, pTerrain->terrainXCoord, pTerrain->terrainZCoord);
+				continue;
+			}
+
+			// The slot may have held an evicted terrain, stop drawing it and drop its quadtree leaves
+			TerrainRenderer_ReleaseSlot(terrMgr->terarinRenderer, iSlot);
+		}
+		else
+		{
+			pTerrain->gpuSlot = pTerrain->terrainZCoord * terrMgr->pTerrainMap->terrainsXCount + pTerrain->terrainXCoord;
+		}
+
+		TerrainRenderer_UploadTerrain(terrMgr->terarinRenderer, pTerrain);
+
+		// Copies the heightmap into its slice of the global SSBO
+		Terrain_Update(pTerrain);
+		uploaded++;
+	} while (JobSystem_GetTimeMs() < deadline);
+
+	if (uploaded > 0 && !terrMgr->pStreamer && !TerrainMap_IsLoading(terrMgr->pTerrainMap))
+	{
+		syslog("Map %s finished loading", terrMgr->pTerrainMap->szMapName);
+	}
+
+	return (uploaded);
+}
+
+bool TerrainManager_GetStreamingStats(STerrainStreamerStats* pStats)
+{
+	TerrainManager terrMgr = GetTerrainManager();
+	if (!terrMgr || !terrMgr->pStreamer)
+	{
+		return (false);
+	}
+
+	TerrainStreamer_GetStats(terrMgr->pStreamer, pStats);
+	return (true);
+}
+
+bool TerrainManager_GetCullingStats(STerrainCullStats* pStats)
+{
+	TerrainManager terrMgr = GetTerrainManager();
+	if (!terrMgr || !terrMgr->terarinRenderer)
+	{
+		return (false);
+	}
+
+	TerrainRenderer_GetCullStats(terrMgr->terarinRenderer, pStats);
+	return (true);
+}
+
+void TerrainManager_SetCullMode(int32_t cullMode)
+{
+	TerrainManager terrMgr = GetTerrainManager();
+	if (!terrMgr || !terrMgr->terarinRenderer)
+	{
+		return;
+	}
+
+	TerrainRenderer_SetCullMode(terrMgr->terarinRenderer, (ETerrainCullMode)cullMode);
+}
+
+void TerrainManager_SetTerrainLOD(bool bEnabled)
+{
+	TerrainManager terrMgr = GetTerrainManager();
+	if (!terrMgr || !terrMgr->terarinRenderer)
+	{
+		return;
+	}
+
+	TerrainRenderer_SetLOD(terrMgr->terarinRenderer, bEnabled);
+}
+
+void TerrainManager_SetTerrainCDLOD(bool bEnabled)
+{
+	TerrainManager terrMgr = GetTerrainManager();
+	if (!terrMgr || !terrMgr->terarinRenderer)
+	{
+		return;
+	}
+
+	TerrainRenderer_SetCDLOD(terrMgr->terarinRenderer, bEnabled);
+}
+
+void TerrainManager_SetTerrainOcclusion(bool bEnabled)
+{
+	TerrainManager terrMgr = GetTerrainManager();
+	if (!terrMgr || !terrMgr->terarinRenderer)
+	{
+		return;
+	}
+
+	TerrainRenderer_SetOcclusion(terrMgr->terarinRenderer, bEnabled);
+}
+
 void TerrainManager_Render()
 {
 	TerrainManager terrMgr = GetTerrainManager();
@@ -4,11 +4,16 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "Math/Vectors/Vector3.h"
+#include "Resources/TexturesManager.h"
+
+#define TERRAIN_UPLOAD_BUDGET_MS 2.0	// Per-frame time TerrainManager_Update spends attaching loaded terrains
 
 // Use forward declarations if possible to prevent circular includes
 typedef struct STerrainMap* TerrainMap;
 typedef struct STerrainRenderer* TerrainRenderer;
-typedef struct STexture* Texture;
+typedef struct STerrainStreamer* TerrainStreamer;
+typedef struct STerrainStreamerStats STerrainStreamerStats;
+typedef struct STerrainCullStats STerrainCullStats;
 
 typedef struct STerrainManagerEditor
 {
@@ -44,10 +49,11 @@ typedef struct STerrainManager
 	STerrainManagerEditor editor;
 
 	TerrainMap pTerrainMap;
+	TerrainStreamer pStreamer;	// Only while a map streams around the camera
 
 	// renderer
 	TerrainRenderer terarinRenderer;
-	Texture terrainTex;
+	TextureHandle terrainTex;
 	bool isMapReady;
 	bool bNeedsUpdate;
 } STerrainManager;
@@ -62,12 +68,22 @@ void TerrainManager_Destroy(TerrainManager* ppTerrainManager);
 void TerrainManager_Clear();
 
 void TerrainManager_Update();
+uint32_t TerrainManager_UploadLoadedTerrains(double budgetMs);
 void TerrainManager_Render();
 
 // Manager Editor
 bool TerrainManager_CreateMap();
 bool TerrainManager_LoadMap(char* szMapName);
+bool TerrainManager_LoadMapAsync(char* szMapName); // Returns once the workers are started, see TerrainManager_Update
+bool TerrainManager_LoadMapStreaming(char* szMapName, int32_t radius); // Keeps only the terrains around the camera resident
+bool TerrainManager_GetStreamingStats(STerrainStreamerStats* pStats);
+bool TerrainManager_GetCullingStats(STerrainCullStats* pStats);
+void TerrainManager_SetCullMode(int32_t cullMode); // ETerrainCullMode
+void TerrainManager_SetTerrainLOD(bool bEnabled);
+void TerrainManager_SetTerrainCDLOD(bool bEnabled);
+void TerrainManager_SetTerrainOcclusion(bool bEnabled); // Hi-Z occlusion culling, needs TERRAIN_CULL_GPU
 bool TerrainManager_SaveMap();
+bool TerrainManager_PackMap(bool bQuantize); // Writes Assets/Maps/<name>.amap from the map folder, loads prefer it afterwards
 
 // Manager Editor Map Accessors
 void TerrainManager_SetMapName(const char* szMapName);
@@ -2,6 +2,10 @@
 #include "TerrainManager.h"
 #include "Terrain/TerrainMap/TerrainMap.h"
 #include "Renderer/TerrainRenderer.h"
+#include "Terrain/TerrainStreamer/TerrainStreamer.h"
+#include "Terrain/TerrainMap/TerrainPack.h"
+
+static bool TerrainManager_InitializeRenderer(TerrainManager terrMgr);
 
 // Creating Map Part
 bool TerrainManager_CreateMap()
@@ -42,6 +46,8 @@ bool TerrainManager_LoadMap(char* szMapName)
 		return (false);
 	}
 
+	TerrainStreamer_Destroy(&terrMgr->pStreamer);
+
 	if (terrMgr->pTerrainMap)
 	{
 		TerrainMap_Clear(terrMgr->pTerrainMap);
@@ -59,8 +65,87 @@ bool TerrainManager_LoadMap(char* szMapName)
 		return (false);
 	}
 
+	// Every terrain is resident, each one gets the GPU slot of its map position
+	for (int32_t iTerrainZ = 0; iTerrainZ < terrMgr->pTerrainMap->terrainsZCount; iTerrainZ++)
+	{
+		for (int32_t iTerrainX = 0; iTerrainX < terrMgr->pTerrainMap->terrainsXCount; iTerrainX++)
+		{
+			Terrain pTerrain = TerrainMap_GetTerrain(terrMgr->pTerrainMap, iTerrainX, iTerrainZ);
+			if (pTerrain)
+			{
+				pTerrain->gpuSlot = iTerrainZ * terrMgr->pTerrainMap->terrainsXCount + iTerrainX;
+			}
+		}
+	}
+
+	return (TerrainManager_InitializeRenderer(terrMgr));
+}
+
+bool TerrainManager_LoadMapAsync(char* szMapName)
+{
+	TerrainManager terrMgr = GetTerrainManager();
+	if (!terrMgr || !terrMgr->pTerrainMap)
+	{
+		return (false);
+	}
+
+	// Waits for the builds of the previous map, if any
+	TerrainStreamer_Destroy(&terrMgr->pStreamer);
+	TerrainMap_Clear(terrMgr->pTerrainMap);
+
+	if (!TerrainMap_LoadMapAsync(terrMgr->pTerrainMap, szMapName))
+	{
+		syserr("Failed to Load Map %s", szMapName);
+		TerrainMap_Clear(terrMgr->pTerrainMap);
+		return (false);
+	}
+
+	// Terrains are uploaded by TerrainManager_Update as the workers finish them
+	return (TerrainManager_InitializeRenderer(terrMgr));
+}
+
+bool TerrainManager_LoadMapStreaming(char* szMapName, int32_t radius)
+{
+	TerrainManager terrMgr = GetTerrainManager();
+	if (!terrMgr || !terrMgr->pTerrainMap)
+	{
+		return (false);
+	}
+
+	TerrainStreamer_Destroy(&terrMgr->pStreamer);
+	TerrainMap_Clear(terrMgr->pTerrainMap);
+
+	if (!TerrainMap_OpenMap(terrMgr->pTerrainMap, szMapName))
+	{
+		syserr("Failed to Open Map %s", szMapName);
+		TerrainMap_Clear(terrMgr->pTerrainMap);
+		return (false);
+	}
+
+	if (!TerrainStreamer_Initialize(&terrMgr->pStreamer, terrMgr->pTerrainMap, radius))
+	{
+		syserr("Failed to Initialize Terrain Streamer");
+		TerrainMap_Clear(terrMgr->pTerrainMap);
+		return (false);
+	}
+
+	// Nothing is requested yet, TerrainManager_Update follows the camera from here
+	terrMgr->pTerrainMap->isReady = true;
+
+	return (TerrainManager_InitializeRenderer(terrMgr));
+}
+
+static bool TerrainManager_InitializeRenderer(TerrainManager terrMgr)
+{
+	// Sized for the map, a new map needs a new one
+	TerrainRenderer_Destroy(&terrMgr->terarinRenderer);
+	terrMgr->isMapReady = false;
+
+	// Streaming only needs the slot pool, otherwise one slot per terrain of the map
+	int32_t gpuSlotCount = (terrMgr->pStreamer) ? terrMgr->pStreamer->slotCount : terrMgr->pTerrainMap->terrainsXCount * terrMgr->pTerrainMap->terrainsZCount;
+
 	// Initialize Renderer
-	if (!TerrainRenderer_Initialize(&terrMgr->terarinRenderer, "Terrain Renderer", terrMgr->pTerrainMap->terrainsXCount, terrMgr->pTerrainMap->terrainsZCount))
+	if (!TerrainRenderer_Initialize(&terrMgr->terarinRenderer, "Terrain Renderer", gpuSlotCount))
 	{
 		syserr("Failed to Create Terrain Renderer");
 		return (false);
@@ -95,4 +180,17 @@ bool TerrainManager_SaveMap()
 	return (TerrainMap_SaveMap(terrMgr->pTerrainMap));
 }
 
+bool TerrainManager_PackMap(bool bQuantize)
+{
+	TerrainManager terrMgr = GetTerrainManager();
+	if (!terrMgr || !terrMgr->pTerrainMap || !terrMgr->pTerrainMap->szMapName)
+	{
+		syserr("Load a Map before Packing it");
+		return (false);
+	}
+
+	// Packs what is on disk, unsaved edits are not part of it
+	return (TerrainPack_PackMap(terrMgr->pTerrainMap->szMapName, bQuantize));
+}
+
 // Editing Map Part
@@ -1,5 +1,6 @@
 #include "TerrainMap.h"
 #include "Stdafx.h"
+#include "TerrainPack.h"
 
 bool TerrainMap_Initialize(TerrainMap* ppTerrainMap)
 {
@@ -33,8 +34,19 @@ void TerrainMap_Destroy(TerrainMap* ppTerrainMap)
 
 	TerrainMap pTerrainMap = *ppTerrainMap;
 
+	// Workers still read the map while they build
+	TerrainMap_WaitPendingLoads(pTerrainMap);
+
 	Vector_Destroy(&pTerrainMap->terrains);
 
+	// Terrain heightmaps point into it, so it goes after them
+	TerrainPack_Close(&pTerrainMap->pPack);
+
+	if (pTerrainMap->pLoadStates)
+	{
+		engine_delete(pTerrainMap->pLoadStates);
+	}
+
 	if (pTerrainMap->szMapName)
 	{
 		engine_delete(pTerrainMap->szMapName);
@@ -56,8 +68,16 @@ void TerrainMap_Clear(TerrainMap pTerrainMap)
 	{
 		pTerrainMap->isReady = false;
 
+		TerrainMap_WaitPendingLoads(pTerrainMap);
+
 		// Clear
 		Vector_Destroy(&pTerrainMap->terrains);
+		TerrainPack_Close(&pTerrainMap->pPack);
+		if (pTerrainMap->pLoadStates)
+		{
+			engine_delete(pTerrainMap->pLoadStates);
+			pTerrainMap->pLoadStates = NULL;
+		}
 		if (pTerrainMap->szMapName)
 		{
 			engine_delete(pTerrainMap->szMapName);
@@ -3,16 +3,36 @@
 
 #include "Terrain/Terrain/Terrain.h"
 #include "AeroLib/Vector.h"
+#include "Core/JobSystem.h"
+
+typedef enum ETerrainLoadState
+{
+	TERRAIN_LOAD_NONE,		// Not requested
+	TERRAIN_LOAD_PENDING,	// Building on a worker or waiting for upload
+	TERRAIN_LOAD_READY,		// In terrains and on the GPU
+} ETerrainLoadState;
+
+typedef struct STerrainLoadRequest STerrainLoadRequest;
 
 typedef struct STerrainMap
 {
-	Vector terrains;
+	Vector terrains;		// One slot per terrain, row major, NULL until loaded
 	int32_t terrainsXCount; // number of terrains among X Axis
 	int32_t terrainsZCount; // Number of Terrains Among Z Axis
 	int32_t mapPositionX;	// Map Coords
 	int32_t mapPositionZ;	// Map Coords
 	bool isReady; // is the map ready to render
 
+	// Async loading, workers build terrains and the GL thread attaches them
+	uint8_t* pLoadStates;				// ETerrainLoadState per terrain slot
+	STerrainLoadRequest* pBuiltHead;	// Built terrains waiting for the GL thread, FIFO
+	STerrainLoadRequest* pBuiltTail;
+	AeroSpinLock builtLock;				// Guards pBuiltHead / pBuiltTail
+	SJobCounter loadCounter;			// Terrain builds still running
+	int32_t pendingCount;				// Requested and not attached yet (GL thread only)
+
+	struct STerrainPack* pPack;			// Set when the map was opened from its packed archive
+
 	char* szMapName;
 	char* szMapDir;
 } STerrainMap;
@@ -37,9 +57,22 @@ bool TerrainMap_CreateMap(char* szMapName, int32_t terrainsX, int32_t terrainsZ)
 
 // Terrain Map Load
 bool TerrainMap_LoadMap(TerrainMap pTerrainMap, char* szMapName);
+bool TerrainMap_OpenMap(TerrainMap pTerrainMap, char* szMapName); // Settings and empty terrain slots only, the packed archive wins over the folder
 bool TerrainMap_LoadSettingsFile(TerrainMap pTerrainMap, const char* szMapPath);
+bool TerrainMap_LoadTerrains(TerrainMap pTerrainMap); // Whole map, built on the job system
 bool TerrainMap_LoadTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t iTerrainZ);
+bool TerrainMap_BuildTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t iTerrainZ, Terrain* ppTerrain); // CPU only, any thread
+bool TerrainMap_AttachTerrain(TerrainMap pTerrainMap, Terrain pTerrain); // GL thread
 bool TerrainMap_IsTerrainLoaded(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t iTerrainZ);
+Terrain TerrainMap_GetTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t iTerrainZ);
+
+// Terrain Map Async Load, workers read and build, the GL thread attaches
+bool TerrainMap_LoadMapAsync(TerrainMap pTerrainMap, char* szMapName);
+bool TerrainMap_RequestTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t iTerrainZ);
+Terrain TerrainMap_PopBuiltTerrain(TerrainMap pTerrainMap); // GL thread, attached on return, NULL when nothing is ready
+void TerrainMap_WaitPendingLoads(TerrainMap pTerrainMap);
+bool TerrainMap_IsLoading(TerrainMap pTerrainMap);
+void TerrainMap_UnloadTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t iTerrainZ);
 
 bool TerrainMap_SaveMap(TerrainMap pTerrainMap);
 bool TerrainMap_SaveSettingsFile(TerrainMap pTerrainMap);
@@ -1,6 +1,17 @@
 #include "TerrainMap.h"
 #include "Stdafx.h"
 #include "AeroLib/cJSON.h"
+#include "Terrain/TerrainPatch.h"
+#include "TerrainPack.h"
+
+struct STerrainLoadRequest
+{
+	TerrainMap pTerrainMap;
+	Terrain pTerrain;				// NULL when the build failed
+	int32_t iTerrainX;
+	int32_t iTerrainZ;
+	STerrainLoadRequest* pNext;
+};
 
 bool TerrainMap_CreateFolder(TerrainMap pTerrainMap, char* szMapName)
 {
@@ -213,6 +224,26 @@ bool TerrainMap_CreateMap(char* szMapName, int32_t terrainsX, int32_t terrainsZ)
 }
 
 bool TerrainMap_LoadMap(TerrainMap pTerrainMap, char* szMapName)
+{
+	if (!TerrainMap_OpenMap(pTerrainMap, szMapName))
+	{
+		return (false);
+	}
+
+	if (!TerrainMap_LoadTerrains(pTerrainMap))
+	{
+		return (false);
+	}
+
+	pTerrainMap->isReady = true;
+	syslog("Loaded Map %s Size %dx%d", pTerrainMap->szMapName, pTerrainMap->terrainsXCount, pTerrainMap->terrainsZCount);
+	return (true);
+}
+
+/**
+ * @brief Reads the map settings and sets up one empty slot per terrain, no terrain is loaded yet.
+ */
+bool TerrainMap_OpenMap(TerrainMap pTerrainMap, char* szMapName)
 {
 	if (!IsDirectoryExists(terrainMapsFolder))
 	{
@@ -245,42 +276,58 @@ bool TerrainMap_LoadMap(TerrainMap pTerrainMap, char* szMapName)
 		return false;
 	}
 
-	if (!IsDirectoryExists(fullMapPath))
+	// One mapped file for the whole map instead of a folder and a file per terrain
+	if (TerrainPack_Exists(szMapName))
 	{
-		syserr("TerrainMap_LoadMap: Map Directory doesn't exist!");
-		return (false);
-	}
+		if (!TerrainPack_Open(&pTerrainMap->pPack, szMapName))
+		{
+			syserr("TerrainMap_LoadMap: Failed to Open Map Pack %s", szMapName);
+			return (false);
+		}
 
-	if (!TerrainMap_LoadSettingsFile(pTerrainMap, fullMapPath))
+		TerrainMap_SetDeminsions(pTerrainMap, pTerrainMap->pPack->pHeader->terrainsXCount, pTerrainMap->pPack->pHeader->terrainsZCount);
+		TerrainMap_SetMapName(pTerrainMap, szMapName);
+		TerrainMap_SetMapDir(pTerrainMap, fullMapPath);
+	}
+	else
 	{
-		syserr("TerrainMap_LoadMap: Map Settings doesn't exist!");
-		return (false);
+		if (!IsDirectoryExists(fullMapPath))
+		{
+			syserr("TerrainMap_LoadMap: Map Directory doesn't exist!");
+			return (false);
+		}
+
+		if (!TerrainMap_LoadSettingsFile(pTerrainMap, fullMapPath))
+		{
+			syserr("TerrainMap_LoadMap: Map Settings doesn't exist!");
+			return (false);
+		}
 	}
 
-	// Setup Terrains Vector with size of given map?
-	if (!Vector_InitCapacity(&pTerrainMap->terrains, sizeof(Terrain), pTerrainMap->terrainsXCount * pTerrainMap->terrainsZCount, false))
+	// One slot per terrain so they can arrive in any order
+	size_t terrainCount = (size_t)pTerrainMap->terrainsXCount * pTerrainMap->terrainsZCount;
+	if (!Vector_InitCapacity(&pTerrainMap->terrains, sizeof(Terrain), terrainCount, false))
 	{
 		syserr("Failed to Initialize Terrain Map Vector");
 		return (false);
 	}
 
 	pTerrainMap->terrains->destructor = (VectorDestructorFn)Terrain_Destroy;
+	Vector_Resize(pTerrainMap->terrains, terrainCount);
 
-	// Create Terrains Among X-Z Axis
-	for (int32_t iTerrZ = 0; iTerrZ < pTerrainMap->terrainsZCount; iTerrZ++)
+	pTerrainMap->pLoadStates = engine_new_zero(uint8_t, terrainCount, MEM_TAG_TERRAIN);
+	if (!pTerrainMap->pLoadStates)
 	{
-		for (int32_t iTerrX = 0; iTerrX < pTerrainMap->terrainsXCount; iTerrX++)
-		{
-			if (!TerrainMap_LoadTerrain(pTerrainMap, iTerrX, iTerrZ))
-			{
-				syserr("Failed to Load Terrain At (%d, %d)", iTerrX, iTerrZ);
-				return (false);
-			}
-		}
+		syserr("Failed to Allocate Terrain Load States");
+		return (false);
+	}
+
+	// Lazily created pools would race once terrains build on several threads
+	if (!TerrainPatch_InitializePool() || !TerrainMesh_InitializePool())
+	{
+		return (false);
 	}
 
-	pTerrainMap->isReady = true;
-	syslog("Loaded Map %s Size %dx%d", pTerrainMap->szMapName, pTerrainMap->terrainsXCount, pTerrainMap->terrainsZCount);
 	return (true);
 }
 
@@ -337,11 +384,17 @@ bool TerrainMap_LoadSettingsFile(TerrainMap pTerrainMap, const char* szFullPath)
 	}
 
 
-	char* settingsFileData = engine_malloc(len + 1, MEM_TAG_RESOURCES);
+	char* settingsFileData = engine_frame_alloc(len + 1, MEM_TAG_RESOURCES); // scratch, recycled by the frame arena
+	if (!settingsFileData)
+	{
+		syserr("Failed to Allocate the settings file buffer");
+		fclose(fSettingsFile);
+		return (false);
+	}
+
 	if (fread(settingsFileData, 1, len, fSettingsFile) != len)
 	{
 		syserr("Failed to Read the settings file");
-		engine_delete(settingsFileData);
 		fclose(fSettingsFile);
 		return (false);
 	}
@@ -350,7 +403,6 @@ bool TerrainMap_LoadSettingsFile(TerrainMap pTerrainMap, const char* szFullPath)
 	settingsFileData[len] = '\0'; // Add NULL terminator
 
 	cJSON* settingsJson = cJSON_Parse(settingsFileData);
-	engine_delete(settingsFileData); // Free early since cJSON makes its own internal copy
 
 	if (settingsJson == NULL)
 	{
@@ -455,6 +507,72 @@ bool TerrainMap_LoadSettingsFile(TerrainMap pTerrainMap, const char* szFullPath)
 	return (true);
 }
 
+typedef struct STerrainMapBuildJob
+{
+	TerrainMap pTerrainMap;
+	Terrain* pTerrains;		// One slot per terrain, row major, NULL when the build failed
+} STerrainMapBuildJob;
+
+static void TerrainMap_BuildTerrainsRange(void* pUserData, uint32_t begin, uint32_t end)
+{
+	STerrainMapBuildJob* pJob = (STerrainMapBuildJob*)pUserData;
+
+	for (uint32_t i = begin; i < end; i++)
+	{
+		int32_t iTerrainX = (int32_t)i % pJob->pTerrainMap->terrainsXCount;
+		int32_t iTerrainZ = (int32_t)i / pJob->pTerrainMap->terrainsXCount;
+
+		if (!TerrainMap_BuildTerrain(pJob->pTerrainMap, iTerrainX, iTerrainZ, &pJob->pTerrains[i]))
+		{
+			syserr("Failed to Load Terrain At (%d, %d)", iTerrainX, iTerrainZ);
+		}
+	}
+}
+
+bool TerrainMap_LoadTerrains(TerrainMap pTerrainMap)
+{
+	uint32_t terrainCount = (uint32_t)(pTerrainMap->terrainsXCount * pTerrainMap->terrainsZCount);
+	if (terrainCount == 0)
+	{
+		return (true);
+	}
+
+	// Lazily created pools would race once terrains build on several threads
+	if (!TerrainPatch_InitializePool() || !TerrainMesh_InitializePool())
+	{
+		return (false);
+	}
+
+	STerrainMapBuildJob job = { 0 };
+	job.pTerrainMap = pTerrainMap;
+	job.pTerrains = engine_new_zero(Terrain, terrainCount, MEM_TAG_TERRAIN);
+	if (!job.pTerrains)
+	{
+		syserr("Failed to Allocate %u Terrain slots", terrainCount);
+		return (false);
+	}
+
+	// Disk reads and patch geometry spread over the workers, one terrain per job
+	double startTime = JobSystem_GetTimeMs();
+	JobSystem_ParallelFor(terrainCount, 1, TerrainMap_BuildTerrainsRange, &job);
+
+	// GL objects are created here on the main thread
+	bool success = true;
+	for (uint32_t i = 0; i < terrainCount; i++)
+	{
+		if (!success || !job.pTerrains[i] || !TerrainMap_AttachTerrain(pTerrainMap, job.pTerrains[i]))
+		{
+			Terrain_Destroy(&job.pTerrains[i]);
+			success = false;
+		}
+	}
+
+	engine_delete(job.pTerrains);
+
+	syslog("Built %u Terrains in %.2f ms on %u threads", terrainCount, JobSystem_GetTimeMs() - startTime, JobSystem_GetThreadCount());
+	return (success);
+}
+
 bool TerrainMap_LoadTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t iTerrainZ)
 {
 	if (TerrainMap_IsTerrainLoaded(pTerrainMap, iTerrainX, iTerrainZ))
@@ -462,6 +580,25 @@ bool TerrainMap_LoadTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t i
 		return (true);
 	}
 
+	Terrain pTerrain = NULL;
+	if (!TerrainMap_BuildTerrain(pTerrainMap, iTerrainX, iTerrainZ, &pTerrain))
+	{
+		return (false);
+	}
+
+	if (!TerrainMap_AttachTerrain(pTerrainMap, pTerrain))
+	{
+		Terrain_Destroy(&pTerrain);
+		return (false);
+	}
+
+	return (true);
+}
+
+bool TerrainMap_BuildTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t iTerrainZ, Terrain* ppTerrain)
+{
+	*ppTerrain = NULL;
+
 	Terrain pTerrain = NULL;
 	int32_t iTerrainIndex = iTerrainZ * 1000 + iTerrainX;
 
@@ -496,19 +633,21 @@ bool TerrainMap_LoadTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t i
 		return false;
 	}
 
-	// Load HeightMap
-	if (!Terrain_LoadHeightMap(pTerrain, fullTerrainPath))
+	// Load HeightMap, straight out of the pack mapping when the map is packed
+	if (pTerrainMap->pPack)
 	{
-		Terrain_Destroy(&pTerrain);
-		return (false);
+		uint8_t* pTileData = NULL;
+		size_t tileSize = 0;
+		if (!TerrainPack_GetTile(pTerrainMap->pPack, iTerrainX, iTerrainZ, &pTileData, &tileSize) ||
+			!Terrain_LoadHeightMapFromMemory(pTerrain, pTileData, tileSize, fullTerrainPath))
+		{
+			Terrain_Destroy(&pTerrain);
+			return (false);
+		}
 	}
-	
-	// Initialize Terrain HeightMap Tex
-	// if (!Terrain_LoadHeightMapTexture(pTerrain))
-	if (!Terrain_LoadHeightMapSSBO(pTerrain))
+	else if (!Terrain_LoadHeightMap(pTerrain, fullTerrainPath))
 	{
 		Terrain_Destroy(&pTerrain);
-		syserr("Failed to Initialize Terrain HeightMap Buffer");
 		return (false);
 	}
 
@@ -520,9 +659,31 @@ bool TerrainMap_LoadTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t i
 		return (false);
 	}
 
+	*ppTerrain = pTerrain;
+	return (true);
+}
+
+bool TerrainMap_AttachTerrain(TerrainMap pTerrainMap, Terrain pTerrain)
+{
+	int32_t iSlot = pTerrain->terrainZCoord * pTerrainMap->terrainsXCount + pTerrain->terrainXCoord;
+	if (TerrainMap_GetTerrain(pTerrainMap, pTerrain->terrainXCoord, pTerrain->terrainZCoord) != NULL || !pTerrainMap->pLoadStates)
+	{
+		syserr("Terrain slot (%d, %d) is taken or out of the map", pTerrain->terrainXCoord, pTerrain->terrainZCoord);
+		return (false);
+	}
+
+	// Initialize Terrain HeightMap Tex
+	// if (!Terrain_LoadHeightMapTexture(pTerrain))
+	if (!Terrain_LoadHeightMapSSBO(pTerrain))
+	{
+		syserr("Failed to Initialize Terrain HeightMap Buffer");
+		return (false);
+	}
+
 	pTerrain->bIsReady = true;
 
-	Vector_PushBack(pTerrainMap->terrains, pTerrain);
+	*(Terrain*)Vector_Get(pTerrainMap->terrains, iSlot) = pTerrain;
+	pTerrainMap->pLoadStates[iSlot] = TERRAIN_LOAD_READY;
 	return (true);
 }
 
@@ -540,17 +701,199 @@ bool TerrainMap_IsTerrainLoaded(TerrainMap pTerrainMap, int32_t iTerrainX, int32
 		return (false);
 	}
 
-	for (int32_t i = 0; i < pTerrainMap->terrains->count; i++)
+	return (TerrainMap_GetTerrain(pTerrainMap, iTerrainX, iTerrainZ) != NULL);
+}
+
+Terrain TerrainMap_GetTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t iTerrainZ)
+{
+	if (!pTerrainMap || iTerrainX < 0 || iTerrainZ < 0 || iTerrainX >= pTerrainMap->terrainsXCount || iTerrainZ >= pTerrainMap->terrainsZCount)
+	{
+		return (NULL);
+	}
+
+	return ((Terrain)Vector_GetPtr(pTerrainMap->terrains, iTerrainZ * pTerrainMap->terrainsXCount + iTerrainX));
+}
+
+static void TerrainMap_BuildTerrainJob(void* pUserData)
+{
+	STerrainLoadRequest* pRequest = (STerrainLoadRequest*)pUserData;
+	TerrainMap pTerrainMap = pRequest->pTerrainMap;
+
+	if (!TerrainMap_BuildTerrain(pTerrainMap, pRequest->iTerrainX, pRequest->iTerrainZ, &pRequest->pTerrain))
+	{
+		syserr("Failed to Load Terrain At (%d, %d)", pRequest->iTerrainX, pRequest->iTerrainZ);
+	}
+
+	// Failed builds are queued too, the GL thread owns the bookkeeping
+	AeroSpinLock_Lock(&pTerrainMap->builtLock);
+	if (pTerrainMap->pBuiltTail)
+	{
+		pTerrainMap->pBuiltTail->pNext = pRequest;
+	}
+	else
+	{
+		pTerrainMap->pBuiltHead = pRequest;
+	}
+	pTerrainMap->pBuiltTail = pRequest;
+	AeroSpinLock_Unlock(&pTerrainMap->builtLock);
+}
+
+static STerrainLoadRequest* TerrainMap_PopBuiltRequest(TerrainMap pTerrainMap)
+{
+	// Checked without the lock first, most frames have nothing to pick up
+	if (AeroAtomic_LoadPtr((void* volatile*)&pTerrainMap->pBuiltHead) == NULL)
+	{
+		return (NULL);
+	}
+
+	AeroSpinLock_Lock(&pTerrainMap->builtLock);
+	STerrainLoadRequest* pRequest = pTerrainMap->pBuiltHead;
+	if (pRequest)
 	{
-		Terrain pSearchTerrain = Vector_GetPtr(pTerrainMap->terrains, i);
+		pTerrainMap->pBuiltHead = pRequest->pNext;
+		if (!pTerrainMap->pBuiltHead)
+		{
+			pTerrainMap->pBuiltTail = NULL;
+		}
+	}
+	AeroSpinLock_Unlock(&pTerrainMap->builtLock);
+
+	return (pRequest);
+}
 
-		if (pSearchTerrain->terrainXCoord == iTerrainX && pSearchTerrain->terrainZCoord == iTerrainZ)
+bool TerrainMap_LoadMapAsync(TerrainMap pTerrainMap, char* szMapName)
+{
+	if (!TerrainMap_OpenMap(pTerrainMap, szMapName))
+	{
+		return (false);
+	}
+
+	for (int32_t iTerrainZ = 0; iTerrainZ < pTerrainMap->terrainsZCount; iTerrainZ++)
+	{
+		for (int32_t iTerrainX = 0; iTerrainX < pTerrainMap->terrainsXCount; iTerrainX++)
 		{
-			return (true);
+			if (!TerrainMap_RequestTerrain(pTerrainMap, iTerrainX, iTerrainZ))
+			{
+				return (false);
+			}
 		}
 	}
 
-	return (false);
+	// Ready to render, terrains show up as TerrainManager_Update attaches them
+	pTerrainMap->isReady = true;
+	syslog("Loading Map %s Size %dx%d in the background", pTerrainMap->szMapName, pTerrainMap->terrainsXCount, pTerrainMap->terrainsZCount);
+	return (true);
+}
+
+bool TerrainMap_RequestTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t iTerrainZ)
+{
+	if (!pTerrainMap || !pTerrainMap->pLoadStates || iTerrainX < 0 || iTerrainZ < 0 || iTerrainX >= pTerrainMap->terrainsXCount || iTerrainZ >= pTerrainMap->terrainsZCount)
+	{
+		syserr("Terrain (%d, %d) is out of the map", iTerrainX, iTerrainZ);
+		return (false);
+	}
+
+	int32_t iSlot = iTerrainZ * pTerrainMap->terrainsXCount + iTerrainX;
+	if (pTerrainMap->pLoadStates[iSlot] != TERRAIN_LOAD_NONE)
+	{
+		return (true);
+	}
+
+	STerrainLoadRequest* pRequest = engine_new_zero(STerrainLoadRequest, 1, MEM_TAG_TERRAIN);
+	if (!pRequest)
+	{
+		syserr("Failed to Allocate Terrain Load Request");
+		return (false);
+	}
+
+	pRequest->pTerrainMap = pTerrainMap;
+	pRequest->iTerrainX = iTerrainX;
+	pRequest->iTerrainZ = iTerrainZ;
+
+	pTerrainMap->pLoadStates[iSlot] = TERRAIN_LOAD_PENDING;
+	pTerrainMap->pendingCount++;
+
+	JobSystem_Submit(TerrainMap_BuildTerrainJob, pRequest, &pTerrainMap->loadCounter);
+	return (true);
+}
+
+Terrain TerrainMap_PopBuiltTerrain(TerrainMap pTerrainMap)
+{
+	if (!pTerrainMap)
+	{
+		return (NULL);
+	}
+
+	STerrainLoadRequest* pRequest = NULL;
+	while ((pRequest = TerrainMap_PopBuiltRequest(pTerrainMap)) != NULL)
+	{
+		int32_t iSlot = pRequest->iTerrainZ * pTerrainMap->terrainsXCount + pRequest->iTerrainX;
+		Terrain pTerrain = pRequest->pTerrain;
+		engine_delete(pRequest);
+
+		pTerrainMap->pendingCount--;
+
+		if (pTerrain && TerrainMap_AttachTerrain(pTerrainMap, pTerrain))
+		{
+			return (pTerrain);
+		}
+
+		// A failed terrain can be requested again
+		Terrain_Destroy(&pTerrain);
+		pTerrainMap->pLoadStates[iSlot] = TERRAIN_LOAD_NONE;
+	}
+
+	return (NULL);
+}
+
+/**
+ * @brief Blocks until every requested build is done and drops the ones not attached yet.
+ */
+void TerrainMap_WaitPendingLoads(TerrainMap pTerrainMap)
+{
+	if (!pTerrainMap || pTerrainMap->pendingCount == 0)
+	{
+		return;
+	}
+
+	JobSystem_Wait(&pTerrainMap->loadCounter);
+
+	STerrainLoadRequest* pRequest = NULL;
+	while ((pRequest = TerrainMap_PopBuiltRequest(pTerrainMap)) != NULL)
+	{
+		if (pTerrainMap->pLoadStates)
+		{
+			pTerrainMap->pLoadStates[pRequest->iTerrainZ * pTerrainMap->terrainsXCount + pRequest->iTerrainX] = TERRAIN_LOAD_NONE;
+		}
+
+		Terrain_Destroy(&pRequest->pTerrain);
+		engine_delete(pRequest);
+	}
+
+	pTerrainMap->pendingCount = 0;
+}
+
+bool TerrainMap_IsLoading(TerrainMap pTerrainMap)
+{
+	return (pTerrainMap && pTerrainMap->pendingCount > 0);
+}
+
+/**
+ * @brief Destroys a loaded terrain and frees its slot so it can be requested again (GL thread).
+ */
+void TerrainMap_UnloadTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t iTerrainZ)
+{
+	Terrain pTerrain = TerrainMap_GetTerrain(pTerrainMap, iTerrainX, iTerrainZ);
+	if (!pTerrain)
+	{
+		return;
+	}
+
+	int32_t iSlot = iTerrainZ * pTerrainMap->terrainsXCount + iTerrainX;
+	*(Terrain*)Vector_Get(pTerrainMap->terrains, iSlot) = NULL;
+	pTerrainMap->pLoadStates[iSlot] = TERRAIN_LOAD_NONE;
+
+	Terrain_Destroy(&pTerrain);
 }
 
 bool TerrainMap_SaveMap(TerrainMap pTerrainMap)
@@ -572,6 +915,12 @@ bool TerrainMap_SaveMap(TerrainMap pTerrainMap)
 		return (false);
 	}
 
+	if (TerrainMap_IsLoading(pTerrainMap))
+	{
+		syserr("TerrainMap_SaveMap: Map %s is still loading", pTerrainMap->szMapName);
+		return (false);
+	}
+
 	if (!TerrainMap_SaveSettingsFile(pTerrainMap))
 	{
 		syserr("Failed to Save Map %s Settings File", pTerrainMap->szMapName);
@@ -591,6 +940,18 @@ bool TerrainMap_SaveMap(TerrainMap pTerrainMap)
 		}
 	}
 
+	// Every heightmap owns its data after the save, so the old pack can be replaced under the map
+	if (pTerrainMap->pPack)
+	{
+		bool bQuantized = (pTerrainMap->pPack->pHeader->flags & TERRAIN_PACK_FLAG_QUANTIZED) != 0;
+		TerrainPack_Close(&pTerrainMap->pPack);
+		if (!TerrainPack_PackMap(pTerrainMap->szMapName, bQuantized) || !TerrainPack_Open(&pTerrainMap->pPack, pTerrainMap->szMapName))
+		{
+			syserr("Failed to Repack Map %s", pTerrainMap->szMapName);
+			return (false);
+		}
+	}
+
 	syslog("Saved Map %s Size %dx%d", pTerrainMap->szMapName, pTerrainMap->terrainsXCount, pTerrainMap->terrainsZCount);
 	return (true);
 }
@@ -724,7 +1085,7 @@ bool TerrainMap_SaveTerrain(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t i
 		return (false);
 	}
 
-	Terrain pTerrain = Vector_GetPtr(pTerrainMap->terrains, iTerrainZ * pTerrainMap->terrainsXCount + iTerrainX);
+	Terrain pTerrain = TerrainMap_GetTerrain(pTerrainMap, iTerrainX, iTerrainZ);
 
 	if (pTerrain == NULL)
 	{
@@ -0,0 +1,440 @@
+#include "TerrainPack.h"
+#include "Stdafx.h"
+#include "TerrainMap.h"
+#include "Terrain/Terrain/HeightMapCodec.h"
+#include "Core/Atomics.h"
+
+#define TERRAIN_PACK_FNV_OFFSET 0x811c9dc5
+#define TERRAIN_PACK_FNV_PRIME 0x01000193
+
+static size_t TerrainPack_AlignUp(size_t value)
+{
+	return ((value + TERRAIN_PACK_ALIGNMENT - 1) & ~((size_t)TERRAIN_PACK_ALIGNMENT - 1));
+}
+
+uint32_t TerrainPack_Checksum(const void* pData, size_t size)
+{
+	// FNV-1a over 32 bit words in four interleaved lanes, one serial multiply chain would cap it at a word per multiply latency
+	const uint8_t* pBytes = (const uint8_t*)pData;
+	uint32_t lanes[4] = { TERRAIN_PACK_FNV_OFFSET, TERRAIN_PACK_FNV_OFFSET + 1, TERRAIN_PACK_FNV_OFFSET + 2, TERRAIN_PACK_FNV_OFFSET + 3 };
+
+	size_t i = 0;
+	for (; i + sizeof(lanes) <= size; i += sizeof(lanes))
+	{
+		uint32_t words[4];
+		memcpy(words, pBytes + i, sizeof(words));
+		lanes[0] = (lanes[0] ^ words[0]) * TERRAIN_PACK_FNV_PRIME;
+		lanes[1] = (lanes[1] ^ words[1]) * TERRAIN_PACK_FNV_PRIME;
+		lanes[2] = (lanes[2] ^ words[2]) * TERRAIN_PACK_FNV_PRIME;
+		lanes[3] = (lanes[3] ^ words[3]) * TERRAIN_PACK_FNV_PRIME;
+	}
+
+	uint32_t hash = TERRAIN_PACK_FNV_OFFSET;
+	for (int32_t lane = 0; lane < 4; lane++)
+	{
+		hash = (hash ^ lanes[lane]) * TERRAIN_PACK_FNV_PRIME;
+	}
+
+	for (; i < size; i++)
+	{
+		hash = (hash ^ pBytes[i]) * TERRAIN_PACK_FNV_PRIME;
+	}
+
+	return (hash);
+}
+
+bool TerrainPack_GetPath(const char* szMapName, char* szOutPath, size_t pathSize)
+{
+	int32_t written = snprintf(szOutPath, pathSize, "%s%s%s", terrainMapsFolder, szMapName, TERRAIN_PACK_EXTENSION);
+	if (written < 0 || (size_t)written >= pathSize)
+	{
+		syserr("Path name is too long.");
+		return (false);
+	}
+
+	return (true);
+}
+
+bool TerrainPack_Exists(const char* szMapName)
+{
+	char szPackPath[MAX_STRING_LEN] = { 0 };
+	return (TerrainPack_GetPath(szMapName, szPackPath, sizeof(szPackPath)) && File_IsFileExists(szPackPath));
+}
+
+bool TerrainPack_Open(TerrainPack* ppPack, const char* szMapName)
+{
+	if (ppPack == NULL)
+	{
+		syserr("ppPack is NULL (invalid address)");
+		return (false);
+	}
+
+	char szPackPath[MAX_STRING_LEN] = { 0 };
+	if (!TerrainPack_GetPath(szMapName, szPackPath, sizeof(szPackPath)))
+	{
+		return (false);
+	}
+
+	*ppPack = engine_new_zero(STerrainPack, 1, MEM_TAG_TERRAIN);
+	if (!(*ppPack))
+	{
+		syserr("Failed to Allocate Memory for TerrainPack");
+		return (false);
+	}
+
+	TerrainPack pPack = *ppPack;
+
+	if (!MappedFile_Open(&pPack->file, szPackPath))
+	{
+		TerrainPack_Close(ppPack);
+		return (false);
+	}
+
+	const STerrainPackHeader* pHeader = (const STerrainPackHeader*)pPack->file.pData;
+	if (pPack->file.size < sizeof(STerrainPackHeader) || pHeader->magic != TERRAIN_PACK_MAGIC)
+	{
+		syserr("Invalid file format: %s", szPackPath);
+		TerrainPack_Close(ppPack);
+		return (false);
+	}
+
+	if (pHeader->version != TERRAIN_PACK_VERSION || pHeader->terrainVersion != TERRAIN_VERSION_NUMBER)
+	{
+		syserr("Invalid file version: %s", szPackPath);
+		TerrainPack_Close(ppPack);
+		return (false);
+	}
+
+	uint64_t indexSize = (uint64_t)pHeader->tileCount * sizeof(STerrainPackEntry);
+	if (pHeader->terrainsXCount <= 0 || pHeader->terrainsZCount <= 0 ||
+		pHeader->tileCount != (uint32_t)(pHeader->terrainsXCount * pHeader->terrainsZCount) ||
+		pHeader->fileSize != pPack->file.size || pHeader->indexOffset > pPack->file.size || indexSize > pPack->file.size - pHeader->indexOffset)
+	{
+		syserr("Truncated or corrupt map pack: %s", szPackPath);
+		TerrainPack_Close(ppPack);
+		return (false);
+	}
+
+	pPack->pHeader = pHeader;
+	pPack->pEntries = (const STerrainPackEntry*)(pPack->file.pData + pHeader->indexOffset);
+
+	pPack->pVerified = engine_new_zero(int32_t, pHeader->tileCount, MEM_TAG_TERRAIN);
+	if (!pPack->pVerified)
+	{
+		syserr("Failed to Allocate %u Map Pack Tile Flags", pHeader->tileCount);
+		TerrainPack_Close(ppPack);
+		return (false);
+	}
+
+	// Only the index is needed now, tiles are paged in as they are requested
+	MappedFile_Advise(&pPack->file, (size_t)pHeader->indexOffset, (size_t)indexSize, MAPPED_FILE_ADVICE_WILLNEED);
+
+	return (true);
+}
+
+void TerrainPack_Close(TerrainPack* ppPack)
+{
+	if (!ppPack || !(*ppPack))
+	{
+		return;
+	}
+
+	MappedFile_Close(&(*ppPack)->file);
+	engine_delete((int32_t*)(*ppPack)->pVerified);
+	engine_delete(*ppPack);
+
+	*ppPack = NULL;
+}
+
+bool TerrainPack_GetTile(TerrainPack pPack, int32_t iTerrainX, int32_t iTerrainZ, uint8_t** ppData, size_t* pSize)
+{
+	if (!pPack || iTerrainX < 0 || iTerrainZ < 0 || iTerrainX >= pPack->pHeader->terrainsXCount || iTerrainZ >= pPack->pHeader->terrainsZCount)
+	{
+		syserr("Terrain (%d, %d) is out of the map pack", iTerrainX, iTerrainZ);
+		return (false);
+	}
+
+	int32_t iTile = iTerrainZ * pPack->pHeader->terrainsXCount + iTerrainX;
+	const STerrainPackEntry* pEntry = &pPack->pEntries[iTile];
+	if (pEntry->iTerrainX != iTerrainX || pEntry->iTerrainZ != iTerrainZ || pEntry->offset > pPack->file.size || pEntry->size > pPack->file.size - pEntry->offset)
+	{
+		syserr("Corrupt map pack index at (%d, %d)", iTerrainX, iTerrainZ);
+		return (false);
+	}
+
+	uint8_t* pData = pPack->file.pData + pEntry->offset;
+	MappedFile_Advise(&pPack->file, (size_t)pEntry->offset, (size_t)pEntry->size, MAPPED_FILE_ADVICE_WILLNEED);
+
+	// The mapping is read only from here on, a tile streamed in again needs no second pass over its bytes
+	if (!AeroAtomic_Load32(&pPack->pVerified[iTile]))
+	{
+		if (TerrainPack_Checksum(pData, (size_t)pEntry->size) != pEntry->checksum)
+		{
+			syserr("Checksum mismatch for terrain (%d, %d) in the map pack", iTerrainX, iTerrainZ);
+			return (false);
+		}
+		AeroAtomic_Store32(&pPack->pVerified[iTile], 1);
+	}
+
+	*ppData = pData;
+	*pSize = (size_t)pEntry->size;
+	return (true);
+}
+
+static bool TerrainPack_GetTilePath(const char* szMapDir, int32_t iTerrainX, int32_t iTerrainZ, char* szOutPath, size_t pathSize)
+{
+	int32_t written = snprintf(szOutPath, pathSize, "%s/%06d/HeightMap.raw", szMapDir, iTerrainZ * 1000 + iTerrainX);
+	if (written < 0 || (size_t)written >= pathSize)
+	{
+		syserr("Path name is too long.");
+		return (false);
+	}
+
+	return (true);
+}
+
+// Re-encodes a version 1 HeightMap.raw as version 2, other tiles are left as they are
+static size_t TerrainPack_QuantizeTile(const uint8_t* pTile, size_t tileSize, uint8_t* pOut, size_t outCapacity)
+{
+	SHeightMapHeader header;
+	if (tileSize < sizeof(header))
+	{
+		return (0);
+	}
+	memcpy(&header, pTile, sizeof(header));
+
+	if (header.magic != TERRAIN_MAGIC_NUMBER || header.version != TERRAIN_VERSION_NUMBER || header.cols <= 0 || header.rows <= 0 ||
+		tileSize < sizeof(header) + (size_t)header.cols * (size_t)header.rows * sizeof(float))
+	{
+		return (0);
+	}
+
+	// The floats sit right after the 16 byte header, aligned for a direct read
+	size_t bodySize = HeightMapCodec_Encode((const float*)(pTile + sizeof(header)), header.cols, header.rows, pOut + sizeof(header), outCapacity - sizeof(header));
+	if (bodySize == 0)
+	{
+		return (0);
+	}
+
+	header.version = TERRAIN_HEIGHTMAP_VERSION_QUANTIZED;
+	memcpy(pOut, &header, sizeof(header));
+	return (sizeof(header) + bodySize);
+}
+
+static bool TerrainPack_WritePacked(FILE* fPack, TerrainMap pSourceMap, STerrainPackHeader* pHeader, STerrainPackEntry* pEntries)
+{
+	static const uint8_t padding[TERRAIN_PACK_ALIGNMENT] = { 0 };
+
+	// Header and index get written again once the payload offsets, sizes and checksums are known
+	if (fwrite(pHeader, sizeof(STerrainPackHeader), 1, fPack) != 1 ||
+		fwrite(pEntries, sizeof(STerrainPackEntry), pHeader->tileCount, fPack) != pHeader->tileCount)
+	{
+		syserr("Failed to write the map pack index");
+		return (false);
+	}
+
+	size_t position = sizeof(STerrainPackHeader) + pHeader->tileCount * sizeof(STerrainPackEntry);
+	size_t bufferSize = 0;
+	for (uint32_t i = 0; i < pHeader->tileCount; i++)
+	{
+		bufferSize = ((size_t)pEntries[i].size > bufferSize) ? (size_t)pEntries[i].size : bufferSize;
+	}
+
+	// One scratch buffer sized for the largest tile, plus room for its encoding when quantizing
+	bool bQuantize = (pHeader->flags & TERRAIN_PACK_FLAG_QUANTIZED) != 0;
+	size_t encodedCapacity = (bQuantize) ? sizeof(SHeightMapHeader) + HeightMapCodec_GetMaxEncodedSize(HEIGHTMAP_RAW_XSIZE, HEIGHTMAP_RAW_ZSIZE) : 0;
+
+	uint8_t* pBuffer = (uint8_t*)engine_malloc(bufferSize + encodedCapacity, MEM_TAG_TERRAIN);
+	if (!pBuffer)
+	{
+		syserr("Failed to Allocate %zu bytes for the map pack tiles", bufferSize + encodedCapacity);
+		return (false);
+	}
+	uint8_t* pEncoded = pBuffer + bufferSize;
+
+	bool success = true;
+
+	for (uint32_t i = 0; i < pHeader->tileCount && success; i++)
+	{
+		STerrainPackEntry* pEntry = &pEntries[i];
+
+		char szTilePath[MAX_STRING_LEN] = { 0 };
+		if (!TerrainPack_GetTilePath(pSourceMap->szMapDir, pEntry->iTerrainX, pEntry->iTerrainZ, szTilePath, sizeof(szTilePath)))
+		{
+			success = false;
+			break;
+		}
+
+		FILE* fTile = fopen(szTilePath, "rb");
+		if (!fTile)
+		{
+			syserr("Error loading heightmap file %s", szTilePath);
+			success = false;
+			break;
+		}
+
+		bool bRead = (fread(pBuffer, (size_t)pEntry->size, 1, fTile) == 1);
+		fclose(fTile);
+
+		if (!bRead)
+		{
+			syserr("Failed to read HeightMap Data from %s", szTilePath);
+			success = false;
+			break;
+		}
+
+		uint8_t* pPayload = pBuffer;
+		size_t payloadSize = (size_t)pEntry->size;
+		if (bQuantize && encodedCapacity > 0)
+		{
+			size_t encodedSize = TerrainPack_QuantizeTile(pBuffer, payloadSize, pEncoded, encodedCapacity);
+			if (encodedSize == 0)
+			{
+				syserr("Failed to quantize %s, packing it unchanged", szTilePath);
+			}
+			else
+			{
+				pPayload = pEncoded;
+				payloadSize = encodedSize;
+			}
+		}
+
+		size_t offset = TerrainPack_AlignUp(position);
+		if ((offset > position && fwrite(padding, offset - position, 1, fPack) != 1) || fwrite(pPayload, payloadSize, 1, fPack) != 1)
+		{
+			syserr("Failed to write terrain (%d, %d) to the map pack", pEntry->iTerrainX, pEntry->iTerrainZ);
+			success = false;
+			break;
+		}
+
+		pEntry->offset = offset;
+		pEntry->size = payloadSize;
+		pEntry->checksum = TerrainPack_Checksum(pPayload, payloadSize);
+		position = offset + payloadSize;
+	}
+
+	engine_delete(pBuffer);
+
+	pHeader->fileSize = position;
+
+	// Rewrite the header and index with the final layout
+	if (success && (fseek(fPack, 0, SEEK_SET) != 0 ||
+		fwrite(pHeader, sizeof(STerrainPackHeader), 1, fPack) != 1 ||
+		fwrite(pEntries, sizeof(STerrainPackEntry), pHeader->tileCount, fPack) != pHeader->tileCount))
+	{
+		syserr("Failed to write the map pack index");
+		success = false;
+	}
+
+	return (success);
+}
+
+bool TerrainPack_PackMap(const char* szMapName, bool bQuantize)
+{
+	char szMapPath[MAX_STRING_LEN] = { 0 };
+	char szPackPath[MAX_STRING_LEN] = { 0 };
+	char szTempPath[MAX_STRING_LEN] = { 0 };
+
+	int32_t written = snprintf(szMapPath, sizeof(szMapPath), "%s%s", terrainMapsFolder, szMapName);
+	if (written < 0 || (size_t)written >= sizeof(szMapPath) || !TerrainPack_GetPath(szMapName, szPackPath, sizeof(szPackPath)))
+	{
+		syserr("Path name is too long.");
+		return (false);
+	}
+
+	written = snprintf(szTempPath, sizeof(szTempPath), "%s.tmp", szPackPath);
+	if (written < 0 || (size_t)written >= sizeof(szTempPath))
+	{
+		syserr("Path name is too long.");
+		return (false);
+	}
+
+	// The settings give the map size and where the tiles are
+	TerrainMap pSourceMap = NULL;
+	if (!TerrainMap_Initialize(&pSourceMap))
+	{
+		return (false);
+	}
+
+	if (!TerrainMap_LoadSettingsFile(pSourceMap, szMapPath))
+	{
+		syserr("Failed to Load Map %s Settings File", szMapName);
+		TerrainMap_Destroy(&pSourceMap);
+		return (false);
+	}
+
+	uint32_t tileCount = (uint32_t)(pSourceMap->terrainsXCount * pSourceMap->terrainsZCount);
+	STerrainPackEntry* pEntries = engine_new_zero(STerrainPackEntry, tileCount, MEM_TAG_TERRAIN);
+	if (!pEntries)
+	{
+		syserr("Failed to Allocate %u Map Pack Entries", tileCount);
+		TerrainMap_Destroy(&pSourceMap);
+		return (false);
+	}
+
+	STerrainPackHeader header = { 0 };
+	header.magic = TERRAIN_PACK_MAGIC;
+	header.version = TERRAIN_PACK_VERSION;
+	header.terrainVersion = TERRAIN_VERSION_NUMBER;
+	header.terrainsXCount = pSourceMap->terrainsXCount;
+	header.terrainsZCount = pSourceMap->terrainsZCount;
+	header.tileCount = tileCount;
+	header.indexOffset = sizeof(STerrainPackHeader);
+	header.flags = (bQuantize) ? TERRAIN_PACK_FLAG_QUANTIZED : 0;
+
+	// Every tile has to be there before anything is written, the sizes give the scratch buffer
+	bool success = true;
+
+	for (uint32_t i = 0; i < tileCount && success; i++)
+	{
+		STerrainPackEntry* pEntry = &pEntries[i];
+		pEntry->iTerrainX = (int32_t)i % pSourceMap->terrainsXCount;
+		pEntry->iTerrainZ = (int32_t)i / pSourceMap->terrainsXCount;
+
+		char szTilePath[MAX_STRING_LEN] = { 0 };
+		size_t tileSize = 0;
+		if (!TerrainPack_GetTilePath(pSourceMap->szMapDir, pEntry->iTerrainX, pEntry->iTerrainZ, szTilePath, sizeof(szTilePath)) || !File_GetInfo(szTilePath, &tileSize) || tileSize == 0)
+		{
+			syserr("Missing heightmap for terrain (%d, %d): %s", pEntry->iTerrainX, pEntry->iTerrainZ, szTilePath);
+			success = false;
+			break;
+		}
+
+		pEntry->size = tileSize;
+	}
+
+	if (success)
+	{
+		FILE* fPack = fopen(szTempPath, "wb");
+		if (!fPack)
+		{
+			syserr("Error opening map pack file %s", szTempPath);
+			success = false;
+		}
+		else
+		{
+			success = TerrainPack_WritePacked(fPack, pSourceMap, &header, pEntries);
+			fclose(fPack);
+		}
+	}
+
+	engine_delete(pEntries);
+	TerrainMap_Destroy(&pSourceMap);
+
+	if (!success)
+	{
+		remove(szTempPath);
+		return (false);
+	}
+
+	// Same as heightmap saves, some file systems refuse to rename over an existing file
+	remove(szPackPath);
+	if (rename(szTempPath, szPackPath) != 0)
+	{
+		syserr("Failed to promote %s to %s", szTempPath, szPackPath);
+		return (false);
+	}
+
+	syslog("Packed Map %s (%dx%d, %llu bytes%s) into %s", szMapName, header.terrainsXCount, header.terrainsZCount, (unsigned long long)header.fileSize, (bQuantize) ? ", quantized" : "", szPackPath);
+	return (true);
+}
@@ -0,0 +1,81 @@
+#ifndef __TERRAIN_PACK_H__
+#define __TERRAIN_PACK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "Core/MappedFile.h"
+
+#define TERRAIN_PACK_MAGIC 0x4B50414D		// "MAPK"
+#define TERRAIN_PACK_VERSION 1
+#define TERRAIN_PACK_ALIGNMENT 64			// Every tile payload starts on a cache line
+#define TERRAIN_PACK_EXTENSION ".amap"		// Assets/Maps/<name>.amap, next to the map folder
+
+#define TERRAIN_PACK_FLAG_QUANTIZED 0x1		// Tiles were re-encoded as version 2 (HeightMapCodec) heightmaps
+
+/**
+ * @brief Packed map layout: header, tile index, then the tile payloads.
+ *
+ * The index has one entry per terrain, row major (z * terrainsXCount + x).
+ * A payload is the tile's HeightMap.raw byte for byte, or its version 2
+ * encoding in a quantized pack, so both layouts share one parser. All values
+ * are little endian.
+ */
+typedef struct STerrainPackHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t terrainVersion;	// TERRAIN_VERSION_NUMBER the payloads were written with
+	int32_t terrainsXCount;
+	int32_t terrainsZCount;
+	uint32_t tileCount;
+	uint64_t indexOffset;		// STerrainPackEntry[tileCount]
+	uint64_t fileSize;
+	uint32_t flags;				// TERRAIN_PACK_FLAG_*
+	uint8_t reserved[20];
+} STerrainPackHeader;
+
+typedef struct STerrainPackEntry
+{
+	int32_t iTerrainX;
+	int32_t iTerrainZ;
+	uint64_t offset;			// From the start of the file, TERRAIN_PACK_ALIGNMENT aligned
+	uint64_t size;
+	uint32_t checksum;			// TerrainPack_Checksum of the payload
+	uint32_t reserved;
+} STerrainPackEntry;
+
+typedef struct STerrainPack
+{
+	SMappedFile file;
+	const STerrainPackHeader* pHeader;
+	const STerrainPackEntry* pEntries;
+	volatile int32_t* pVerified;	// One flag per tile, set once its payload matched the checksum
+} STerrainPack;
+
+typedef struct STerrainPack* TerrainPack;
+
+bool TerrainPack_GetPath(const char* szMapName, char* szOutPath, size_t pathSize);
+bool TerrainPack_Exists(const char* szMapName);
+
+bool TerrainPack_Open(TerrainPack* ppPack, const char* szMapName);
+void TerrainPack_Close(TerrainPack* ppPack);
+
+/**
+ * @brief Finds a tile payload, its checksum is checked the first time the tile is requested.
+ *
+ * The payload lives in the mapping, it stays valid until the pack is closed.
+ * It must not be written to, an evicted tile is read from the same pages again.
+ */
+bool TerrainPack_GetTile(TerrainPack pPack, int32_t iTerrainX, int32_t iTerrainZ, uint8_t** ppData, size_t* pSize);
+
+/**
+ * @brief Converter, packs the directory layout of Assets/Maps/<name> into Assets/Maps/<name>.amap.
+ *
+ * @param bQuantize Store the tiles 16 bit quantized (lossy, see HeightMapCodec), the map folder keeps the exact heights.
+ */
+bool TerrainPack_PackMap(const char* szMapName, bool bQuantize);
+
+uint32_t TerrainPack_Checksum(const void* pData, size_t size);
+
+#endif // __TERRAIN_PACK_H__
@@ -2,7 +2,13 @@
 #include "TerrainData.h"
 #include "Terrain/Terrain.h"
 #include "../Math/Matrix/Matrix3.h"
+#include "../Math/Grids/FloatGrid.h"
 #include "Stdafx.h"
+#include "Resources/PoolAllocator.h"
+#include <float.h>
+
+// One slab holds a whole terrain's patches, so they sit next to each other in memory
+static PoolAllocator s_pTerrainPatchPool = NULL;
 
 void TerrainPatch_GenerateGeometry(TerrainPatch patch, int32_t patchX, int32_t patchZ, float cellSize, Vector4 color)
 {
@@ -11,19 +17,20 @@ void TerrainPatch_GenerateGeometry(TerrainPatch patch, int32_t patchX, int32_t p
     int32_t depth = patch->patchDepth;
 
     // Clear any existing geometry
-    Vector_Clear(mesh->pVertices);
-    Vector_Clear(mesh->pIndices);
-
-    Vector_Reserve(mesh->pVertices, (width + 1) * (depth + 1));
-    Vector_Reserve(mesh->pIndices, (width * depth * 6));
+    TerrainMesh_Clear(mesh);
 
-    mesh->vertexCount = 0;
-    mesh->indexCount = 0;
+    if (!AeroVector_STerrainVertex_Reserve(&mesh->vertices, (width + 1) * (depth + 1)))
+    {
+        syserr("Failed to reserve geometry for patch %d", patch->patchIndex);
+        return;
+    }
 
+#if !TERRAIN_COMPACT_VERTEX
     Matrix4 model = TransformGetMatrix(&patch->terrainMesh->transform);
     Matrix3 mat3Model = Matrix3_InitMatrix4(model);
     Matrix3 invModel = Matrix3_Inverse(mat3Model);
     Matrix3 normalMatrix = Matrix3_TransposeN(invModel);
+#endif
 
     // Generate Vertices
     // We go to <= width/depth because a 16x16 square grid needs 17x17 vertices
@@ -31,21 +38,33 @@ void TerrainPatch_GenerateGeometry(TerrainPatch patch, int32_t patchX, int32_t p
     {
         for (int32_t iX = 0; iX <= patch->patchWidth; iX++)
         {
-            STerrainVertex v = { 0 };
+            // Capacity is reserved above, so this only bumps the count
+            STerrainVertex* v = AeroVector_STerrainVertex_EmplaceBack(&mesh->vertices);
 
             // Calculate Global coordinates for the heightmap
             int32_t gx = (patchX * patch->patchWidth) + iX;
             int32_t gz = (patchZ * patch->patchDepth) + iZ;
 
+#if TERRAIN_COMPACT_VERTEX
+            // The shader places the vertex from the heightmap SSBO, only the normal is baked
+            float hL = GetHeightMapValue(patch->pParentTerrain, gx + 0, gz + 1);
+            float hR = GetHeightMapValue(patch->pParentTerrain, gx + 2, gz + 1);
+            float hD = GetHeightMapValue(patch->pParentTerrain, gx + 1, gz + 0);
+            float hU = GetHeightMapValue(patch->pParentTerrain, gx + 1, gz + 2);
+
+            v->gridX = (uint16_t)gx;
+            v->gridZ = (uint16_t)gz;
+            TerrainVertex_EncodeNormal(Vector3D(hL - hR, 2.0f * cellSize, hD - hU), v->octNormal);
+#else
             // Height lookup (using your +1 padding offset)
             float height = GetHeightMapValue(patch->pParentTerrain, gx + 1, gz + 1);
             // syslog("gx: %d, gz: %d", gx, gz);
 
             Vector3 localPos = Vector3D(iX * cellSize, height, iZ * cellSize);
-            v.v3Position = Matrix4_Mul_Vec3(model, localPos);
-            // v.v3Position = localPos;
+            v->v3Position = Matrix4_Mul_Vec3(model, localPos);
+            // v->v3Position = localPos;
 
-            v.v2TexCoords = Vector2D((float)iX / patch->patchWidth * ENGINE_CELL_SIZE, (float)iZ / patch->patchDepth * ENGINE_CELL_SIZE);
+            v->v2TexCoords = Vector2D((float)iX / patch->patchWidth * ENGINE_CELL_SIZE, (float)iZ / patch->patchDepth * ENGINE_CELL_SIZE);
 
             // 3. Central Difference Normal Calculation
             // We sample the 4 neighbors from the heightmap (using the padding)
@@ -63,36 +82,96 @@ void TerrainPatch_GenerateGeometry(TerrainPatch patch, int32_t patchX, int32_t p
 
             // 4. Transform Normal to World Space
             // Using the Inverse Transpose matrix to handle scaling correctly
-            v.v3Normals = Vector3_Normalized(Matrix3_Mul_Vec3(normalMatrix, localNormal));
+            v->v3Normals = Vector3_Normalized(Matrix3_Mul_Vec3(normalMatrix, localNormal));
 
-            v.v4Color = color;
+            v->v4Color = color;
+#endif
+        }
+    }
+
+    mesh->vertexCount = (GLsizeiptr)mesh->vertices.count;
+}
 
-            TerrainMesh_AddVertex(mesh, v);
+void TerrainPatch_UpdateBounds(TerrainPatch patch, int32_t patchX, int32_t patchZ)
+{
+    FloatGrid heightMap = patch->pParentTerrain->heightMap;
+    if (!heightMap || !heightMap->pArray)
+    {
+        patch->minHeight = 0.0f;
+        patch->maxHeight = 0.0f;
+        return;
+    }
+
+    float minHeight = FLT_MAX;
+    float maxHeight = -FLT_MAX;
+
+    // Vertices (x, z) of the patch, the heightmap keeps a one sample border
+    for (int32_t iZ = 0; iZ <= patch->patchDepth; iZ++)
+    {
+        int32_t gz = patchZ * patch->patchDepth + iZ;
+        const float* pRow = heightMap->pArray + (size_t)(gz + 1) * heightMap->cols + 1 + patchX * patch->patchWidth;
+
+        for (int32_t iX = 0; iX <= patch->patchWidth; iX++)
+        {
+            minHeight = fminf(minHeight, pRow[iX]);
+            maxHeight = fmaxf(maxHeight, pRow[iX]);
         }
     }
 
-    // 2. GENERATE INDICES (The "Wiring")
-    int32_t verticesPerRow = patch->patchWidth + 1;
-    for (int32_t z = 0; z < patch->patchDepth; z++)
+    patch->minHeight = minHeight;
+    patch->maxHeight = maxHeight;
+}
+
+void TerrainPatch_UpdateLODErrors(TerrainPatch patch, int32_t patchX, int32_t patchZ)
+{
+    memset(patch->lodError, 0, sizeof(patch->lodError));
+
+    FloatGrid heightMap = patch->pParentTerrain->heightMap;
+    if (!heightMap || !heightMap->pArray)
+    {
+        return;
+    }
+
+    // Vertex (0, 0) of the patch, the heightmap keeps a one sample border
+    const float* pOrigin = heightMap->pArray + (size_t)(patchZ * patch->patchDepth + 1) * heightMap->cols + 1 + patchX * patch->patchWidth;
+    int32_t cols = heightMap->cols;
+
+    for (int32_t lod = 1; lod < PATCH_LOD_COUNT; lod++)
     {
-        for (int32_t x = 0; x < patch->patchWidth; x++)
+        int32_t step = 1 << lod;
+        float invStep = 1.0f / (float)step;
+        float maxError = patch->lodError[lod - 1];
+
+        // Every vertex the LOD skips against the triangle that covers it (TL, BL, TR / TR, BL, BR like the shared indices)
+        for (int32_t qz = 0; qz < patch->patchDepth; qz += step)
         {
-            // Calculate indices for the 4 corners of the current quad
-            GLuint topLeft = (z * verticesPerRow) + x;
-            GLuint topRight = topLeft + 1;
-            GLuint bottomLeft = ((z + 1) * verticesPerRow) + x;
-            GLuint bottomRight = bottomLeft + 1;
-
-            // Triangle 1 (Clockwise or Counter-Clockwise depending on your GL setup)
-            TerrainMesh_AddIndex(mesh, topLeft);
-            TerrainMesh_AddIndex(mesh, bottomLeft);
-            TerrainMesh_AddIndex(mesh, topRight);
-
-            // Triangle 2
-            TerrainMesh_AddIndex(mesh, topRight);
-            TerrainMesh_AddIndex(mesh, bottomLeft);
-            TerrainMesh_AddIndex(mesh, bottomRight);
+            for (int32_t qx = 0; qx < patch->patchWidth; qx += step)
+            {
+                float hTL = pOrigin[qz * cols + qx];
+                float hTR = pOrigin[qz * cols + qx + step];
+                float hBL = pOrigin[(qz + step) * cols + qx];
+                float hBR = pOrigin[(qz + step) * cols + qx + step];
+
+                for (int32_t iZ = 0; iZ <= step; iZ++)
+                {
+                    const float* pRow = pOrigin + (qz + iZ) * cols + qx;
+                    float v = (float)iZ * invStep;
+
+                    for (int32_t iX = 0; iX <= step; iX++)
+                    {
+                        float u = (float)iX * invStep;
+                        float coarse = (u + v <= 1.0f) ?
+                            hTL + u * (hTR - hTL) + v * (hBL - hTL) :
+                            hBR + (1.0f - u) * (hBL - hBR) + (1.0f - v) * (hTR - hBR);
+
+                        float error = fabsf(pRow[iX] - coarse);
+                        maxError = (error > maxError) ? error : maxError;
+                    }
+                }
+            }
         }
+
+        patch->lodError[lod] = maxError;
     }
 }
 
@@ -107,7 +186,7 @@ void TerrainPatch_Destroy(TerrainPatch* ppTerrainPatch)
 
     TerrainMesh_Destroy(&patch->terrainMesh);
 
-    engine_delete(patch);
+    pool_delete(s_pTerrainPatchPool, patch);
 
     *ppTerrainPatch = NULL;
 }
@@ -123,7 +202,12 @@ void TerrainPatch_DestroyPtr(TerrainPatch elem)
 
 bool TerrainPatch_Initialize(TerrainPatch* ppTerrainPatch, struct STerrain* pParentTerrain, int32_t index)
 {
-    *ppTerrainPatch = engine_new_zero(STerrainPatch, 1, MEM_TAG_TERRAIN);
+    if (!TerrainPatch_InitializePool())
+    {
+        return (false);
+    }
+
+    *ppTerrainPatch = pool_new_zero(s_pTerrainPatchPool, STerrainPatch);
 
     if (!(*ppTerrainPatch))
     {
@@ -136,9 +220,13 @@ bool TerrainPatch_Initialize(TerrainPatch* ppTerrainPatch, struct STerrain* pPar
     (*ppTerrainPatch)->patchIndex = index;
     (*ppTerrainPatch)->pParentTerrain = pParentTerrain;
 
+    // No indices, every patch draws the shared pattern (TerrainPatch_GetSharedIndices)
+#if TERRAIN_VERTEX_PULLING
+    int32_t vertexCapacity = 0;  // The shader generates them
+#else
     int32_t vertexCapacity = ((*ppTerrainPatch)->patchWidth + 1) * ((*ppTerrainPatch)->patchDepth + 1);  // Grid vertices
-    int32_t indexCapacity = (*ppTerrainPatch)->patchWidth * (*ppTerrainPatch)->patchDepth * 6;            // 6 indices per quad
-    (*ppTerrainPatch)->terrainMesh = TerrainMesh_CreateWithCapacity(GL_TRIANGLES, vertexCapacity, indexCapacity);
+#endif
+    (*ppTerrainPatch)->terrainMesh = TerrainMesh_CreateWithCapacity(GL_TRIANGLES, vertexCapacity, 0);
 
     if ((*ppTerrainPatch)->terrainMesh == NULL)
     {
@@ -150,51 +238,113 @@ bool TerrainPatch_Initialize(TerrainPatch* ppTerrainPatch, struct STerrain* pPar
     return (true);
 }
 
+/**
+ * @brief Creates the patch pool up front, call it on one thread before terrains load in parallel.
+ */
+bool TerrainPatch_InitializePool()
+{
+    if (!s_pTerrainPatchPool && !PoolAllocator_Initialize(&s_pTerrainPatchPool, "STerrainPatch", sizeof(STerrainPatch), TERRAIN_PATCH_COUNT, MEM_TAG_TERRAIN))
+    {
+        syserr("Failed to Initialize Terrain Patch Pool");
+        return (false);
+    }
+
+    return (true);
+}
+
+void TerrainPatch_DestroyPool()
+{
+    PoolAllocator_Destroy(&s_pTerrainPatchPool);
+}
+
 void TerrainPatch_Clear(TerrainPatch pTerrainPatch)
 {
-    Vector_Clear(pTerrainPatch->terrainMesh->pVertices);
-    Vector_Clear(pTerrainPatch->terrainMesh->pIndices);
+    TerrainMesh_Clear(pTerrainPatch->terrainMesh);
 }
 
-bool TerrainPatch_InitializeIndices(TerrainPatch pTerrainPatch)
+static STerrainPatchIndices s_sharedIndices;
+static bool s_bSharedIndicesBuilt = false;
+
+// Grid vertex of (x, z) once the stitched sides are folded onto the coarser neighbour's step
+static GLuint TerrainPatch_GetStitchedVertex(int32_t x, int32_t z, int32_t step, uint32_t stitch)
 {
-    if (!pTerrainPatch)
+    int32_t coarseStep = step * 2;
+
+    if (((stitch & PATCH_STITCH_NEG_X) && x == 0) || ((stitch & PATCH_STITCH_POS_X) && x == PATCH_XSIZE))
     {
-        syserr("Failed to Initialize Patch Indices (NULL)");
-        return (false);
+        z -= z % coarseStep;
+    }
+    if (((stitch & PATCH_STITCH_NEG_Z) && z == 0) || ((stitch & PATCH_STITCH_POS_Z) && z == PATCH_ZSIZE))
+    {
+        x -= x % coarseStep;
     }
 
-    TerrainMesh mesh = pTerrainPatch->terrainMesh;
+    return ((GLuint)(z * (PATCH_XSIZE + 1) + x));
+}
 
-    if (!mesh)
+// Folding leaves one empty triangle per skipped vertex, it is not written
+static GLuint* TerrainPatch_AddTriangle(GLuint* pIndex, GLuint a, GLuint b, GLuint c)
+{
+    if (a != b && b != c && a != c)
     {
-        syserr("Failed to Initialize Patch Mesh (NULL)");
-        return (false);
+        *pIndex++ = a;
+        *pIndex++ = b;
+        *pIndex++ = c;
+    }
+
+    return (pIndex);
+}
+
+const STerrainPatchIndices* TerrainPatch_GetSharedIndices()
+{
+    if (s_bSharedIndicesBuilt)
+    {
+        return (&s_sharedIndices);
     }
 
-    // 2. GENERATE INDICES (The "Wiring")
-    int32_t verticesPerRow = pTerrainPatch->patchWidth + 1;
-    for (int32_t z = 0; z < pTerrainPatch->patchDepth; z++)
+    // Every LOD wires the same (PATCH_XSIZE + 1) x (PATCH_ZSIZE + 1) vertex grid, skipping 2^lod - 1 vertices between corners
+    GLuint* pIndex = s_sharedIndices.indices;
+
+    for (int32_t lod = 0; lod < PATCH_LOD_COUNT; lod++)
     {
-        for (int32_t x = 0; x < pTerrainPatch->patchWidth; x++)
+        int32_t step = 1 << lod;
+
+        for (uint32_t stitch = 0; stitch < PATCH_STITCH_COUNT; stitch++)
         {
-            // Calculate indices for the 4 corners of the current quad
-            GLuint topLeft = (z * verticesPerRow) + x;
-            GLuint topRight = topLeft + 1;
-            GLuint bottomLeft = ((z + 1) * verticesPerRow) + x;
-            GLuint bottomRight = bottomLeft + 1;
-
-            // Triangle 1 (Clockwise or Counter-Clockwise depending on your GL setup)
-            TerrainMesh_AddIndex(mesh, topLeft);
-            TerrainMesh_AddIndex(mesh, bottomLeft);
-            TerrainMesh_AddIndex(mesh, topRight);
-
-            // Triangle 2
-            TerrainMesh_AddIndex(mesh, topRight);
-            TerrainMesh_AddIndex(mesh, bottomLeft);
-            TerrainMesh_AddIndex(mesh, bottomRight);
+            // Nothing is coarser than the last LOD
+            if (lod == PATCH_LOD_COUNT - 1 && stitch > 0)
+            {
+                s_sharedIndices.firstIndex[lod][stitch] = s_sharedIndices.firstIndex[lod][0];
+                s_sharedIndices.indexCount[lod][stitch] = s_sharedIndices.indexCount[lod][0];
+                continue;
+            }
+
+            s_sharedIndices.firstIndex[lod][stitch] = (GLuint)(pIndex - s_sharedIndices.indices);
+
+            for (int32_t z = 0; z < PATCH_ZSIZE; z += step)
+            {
+                for (int32_t x = 0; x < PATCH_XSIZE; x += step)
+                {
+                    // Calculate indices for the 4 corners of the current quad
+                    GLuint topLeft = TerrainPatch_GetStitchedVertex(x, z, step, stitch);
+                    GLuint topRight = TerrainPatch_GetStitchedVertex(x + step, z, step, stitch);
+                    GLuint bottomLeft = TerrainPatch_GetStitchedVertex(x, z + step, step, stitch);
+                    GLuint bottomRight = TerrainPatch_GetStitchedVertex(x + step, z + step, step, stitch);
+
+                    // Triangle 1 (Clockwise or Counter-Clockwise depending on your GL setup)
+                    pIndex = TerrainPatch_AddTriangle(pIndex, topLeft, bottomLeft, topRight);
+
+                    // Triangle 2
+                    pIndex = TerrainPatch_AddTriangle(pIndex, topRight, bottomLeft, bottomRight);
+                }
+            }
+
+            s_sharedIndices.indexCount[lod][stitch] = (GLuint)(pIndex - s_sharedIndices.indices) - s_sharedIndices.firstIndex[lod][stitch];
         }
     }
 
-    return (true);
-}
\ No newline at end of file
+    s_sharedIndices.totalCount = (GLuint)(pIndex - s_sharedIndices.indices);
+    s_bSharedIndicesBuilt = true;
+
+    return (&s_sharedIndices);
+}
@@ -2,6 +2,37 @@
 #define __TERRAIN_PATCH__
 
 #include "Meshes/TerrainMesh.h"
+#include "TerrainData.h"
+
+/**
+ * @brief Sides of a patch whose neighbour is one LOD coarser.
+ *
+ * The vertices the neighbour skips fold onto the previous even vertex of that
+ * side, so both patches share the same edge and no crack opens.
+ */
+typedef enum EPatchStitch
+{
+	PATCH_STITCH_NEG_X = 1 << 0,
+	PATCH_STITCH_POS_X = 1 << 1,
+	PATCH_STITCH_NEG_Z = 1 << 2,
+	PATCH_STITCH_POS_Z = 1 << 3,
+} EPatchStitch;
+
+/**
+ * @brief The index lists every patch draws, one per LOD and stitch mask, back to back.
+ *
+ * Patches share the vertex layout, so the indices only differ by baseVertex
+ * and one copy serves all of them. The renderer uploads it once at the start
+ * of the EBO, so firstIndex is valid both here and on the GPU. The coarsest LOD
+ * has no coarser neighbour, all its masks point at the unstitched list.
+ */
+typedef struct STerrainPatchIndices
+{
+	GLuint firstIndex[PATCH_LOD_COUNT][PATCH_STITCH_COUNT];
+	GLuint indexCount[PATCH_LOD_COUNT][PATCH_STITCH_COUNT];
+	GLuint totalCount;
+	GLuint indices[PATCH_INDEX_COUNT * 2 * PATCH_STITCH_COUNT];	// Each LOD has a quarter of the previous one, the sum stays under 4/3 of LOD 0 per mask
+} STerrainPatchIndices;
 
 typedef struct STerrainPatch
 {
@@ -17,9 +48,10 @@ typedef struct STerrainPatch
 	float cellSize;          // Size of each quad cell
 	float minHeight;         // For culling optimization
 	float maxHeight;
+	float lodError[PATCH_LOD_COUNT]; // Worst height difference of each LOD against the full grid, never decreasing
 
 	GLsizeiptr patchVerticesOffset;		// this patch vertices offset in OpenGL Buffer (from x to y)
-	GLsizeiptr patchIndicesOffset;		// this patch indices offset in OpenGL Buffer (from x to y)
+	GLsizeiptr patchIndicesOffset;		// first index of the shared pattern this patch draws
 
 	struct STerrain* pParentTerrain;
 } STerrainPatch;
@@ -29,10 +61,24 @@ typedef struct STerrainPatch* TerrainPatch;
 bool TerrainPatch_Initialize(TerrainPatch* ppTerrainPatch, struct STerrain* pParentTerrain, int32_t index);
 void TerrainPatch_Destroy(TerrainPatch* ppTerrainPatch);
 void TerrainPatch_DestroyPtr(TerrainPatch elem);
+bool TerrainPatch_InitializePool();
+void TerrainPatch_DestroyPool(); // call once every terrain is gone
 void TerrainPatch_Clear(TerrainPatch pTerrainPatch);
-bool TerrainPatch_InitializeIndices(TerrainPatch pTerrainPatch);
+
+// Built on the first call, make that call on the main thread (the renderer does at init)
+const STerrainPatchIndices* TerrainPatch_GetSharedIndices();
 
 void TerrainPatch_GenerateGeometry(TerrainPatch patch, int32_t patchX, int32_t patchZ, float cellSize, Vector4 color);
 
+/**
+ * @brief Height range of the patch vertices, read from the parent terrain's heightmap (culling bounds).
+ */
+void TerrainPatch_UpdateBounds(TerrainPatch patch, int32_t patchX, int32_t patchZ);
+
+/**
+ * @brief Geometric error of every LOD, the renderer projects it to pixels to pick the LOD.
+ */
+void TerrainPatch_UpdateLODErrors(TerrainPatch patch, int32_t patchX, int32_t patchZ);
+
 
 #endif // __TERRAIN_PATCH__
@@ -0,0 +1,261 @@
+#include "TerrainStreamer.h"
+#include "Stdafx.h"
+#include "Terrain/TerrainMap/TerrainMap.h"
+
+typedef struct STerrainStreamRequest
+{
+	int32_t iTerrainX;
+	int32_t iTerrainZ;
+	int32_t priority;		// Lower goes first
+} STerrainStreamRequest;
+
+static int TerrainStreamer_CompareRequests(const void* pA, const void* pB)
+{
+	return (((const STerrainStreamRequest*)pA)->priority - ((const STerrainStreamRequest*)pB)->priority);
+}
+
+bool TerrainStreamer_Initialize(TerrainStreamer* ppStreamer, TerrainMap pTerrainMap, int32_t radius)
+{
+	if (ppStreamer == NULL)
+	{
+		syserr("ppStreamer is NULL (invalid address)");
+		return (false);
+	}
+
+	if (!pTerrainMap || !pTerrainMap->pLoadStates)
+	{
+		syserr("TerrainStreamer needs an opened map");
+		return (false);
+	}
+
+	*ppStreamer = engine_new_zero(STerrainStreamer, 1, MEM_TAG_TERRAIN);
+	if (!(*ppStreamer))
+	{
+		syserr("Failed to Allocate Memory for TerrainStreamer");
+		return (false);
+	}
+
+	TerrainStreamer pStreamer = *ppStreamer;
+
+	// The wanted square plus its ring has to fit the per-update request list
+	if (radius < 0)
+	{
+		radius = 0;
+	}
+	while (radius > 0 && TerrainStreamer_GetSlotCount(radius) > TERRAIN_STREAM_MAX_WANTED)
+	{
+		radius--;
+	}
+
+	int32_t terrainCount = pTerrainMap->terrainsXCount * pTerrainMap->terrainsZCount;
+	int32_t slotCount = TerrainStreamer_GetSlotCount(radius);
+
+	pStreamer->pTerrainMap = pTerrainMap;
+	pStreamer->radius = radius;
+	pStreamer->prefetchSeconds = TERRAIN_STREAM_PREFETCH_SECONDS;
+	pStreamer->slotCount = (slotCount < terrainCount) ? slotCount : terrainCount;
+
+	pStreamer->pSlotTerrains = engine_new_zero(Terrain, pStreamer->slotCount, MEM_TAG_TERRAIN);
+	if (!pStreamer->pSlotTerrains)
+	{
+		syserr("Failed to Allocate %d Terrain Stream Slots", pStreamer->slotCount);
+		TerrainStreamer_Destroy(ppStreamer);
+		return (false);
+	}
+
+	pStreamer->stats.slotCount = (uint32_t)pStreamer->slotCount;
+
+	syslog("Streaming map %s, radius %d, %d GPU slots for %d terrains", pTerrainMap->szMapName, radius, pStreamer->slotCount, terrainCount);
+	return (true);
+}
+
+void TerrainStreamer_Destroy(TerrainStreamer* ppStreamer)
+{
+	if (!ppStreamer || !(*ppStreamer))
+	{
+		return;
+	}
+
+	TerrainStreamer pStreamer = *ppStreamer;
+
+	// The terrains belong to the map, only the slot table is ours
+	if (pStreamer->pSlotTerrains)
+	{
+		engine_delete(pStreamer->pSlotTerrains);
+	}
+
+	engine_delete(pStreamer);
+
+	*ppStreamer = NULL;
+}
+
+int32_t TerrainStreamer_GetSlotCount(int32_t radius)
+{
+	int32_t side = 2 * radius + 3;
+	return (side * side);
+}
+
+static bool TerrainStreamer_IsInMap(TerrainMap pTerrainMap, int32_t iTerrainX, int32_t iTerrainZ)
+{
+	return (iTerrainX >= 0 && iTerrainZ >= 0 && iTerrainX < pTerrainMap->terrainsXCount && iTerrainZ < pTerrainMap->terrainsZCount);
+}
+
+void TerrainStreamer_Update(TerrainStreamer pStreamer, Vector3 v3CameraPos, float deltaTime)
+{
+	if (!pStreamer)
+	{
+		return;
+	}
+
+	TerrainMap pTerrainMap = pStreamer->pTerrainMap;
+	pStreamer->frameIndex++;
+
+	// Smoothed travel velocity, a jump of more than a terrain in one frame is a teleport
+	if (pStreamer->bHasLastCameraPos && deltaTime > 0.0f)
+	{
+		Vector3 v3Delta = Vector3_Sub(v3CameraPos, pStreamer->v3LastCameraPos);
+		if (fabsf(v3Delta.x) > TERRAIN_XSIZE || fabsf(v3Delta.z) > TERRAIN_ZSIZE)
+		{
+			pStreamer->v3Velocity = Vector3Zero();
+		}
+		else
+		{
+			pStreamer->v3Velocity = Vector3_Lerp(pStreamer->v3Velocity, Vector3_Divs(v3Delta, deltaTime), 0.2f);
+		}
+	}
+	pStreamer->v3LastCameraPos = v3CameraPos;
+	pStreamer->bHasLastCameraPos = true;
+
+	int32_t iCameraX = (int32_t)floorf(v3CameraPos.x / TERRAIN_XSIZE);
+	int32_t iCameraZ = (int32_t)floorf(v3CameraPos.z / TERRAIN_ZSIZE);
+
+	Vector3 v3Predicted = Vector3_Add(v3CameraPos, Vector3_Muls(pStreamer->v3Velocity, pStreamer->prefetchSeconds));
+	int32_t iPredictedX = (int32_t)floorf(v3Predicted.x / TERRAIN_XSIZE);
+	int32_t iPredictedZ = (int32_t)floorf(v3Predicted.z / TERRAIN_ZSIZE);
+
+	STerrainStreamRequest missing[TERRAIN_STREAM_MAX_WANTED];
+	int32_t missingCount = 0;
+	int32_t wantedResident = 0;
+
+	// The wanted square, plus the part of its outer ring that lies towards the predicted position
+	int32_t ring = pStreamer->radius + 1;
+	for (int32_t dz = -ring; dz <= ring; dz++)
+	{
+		for (int32_t dx = -ring; dx <= ring; dx++)
+		{
+			int32_t iTerrainX = iCameraX + dx;
+			int32_t iTerrainZ = iCameraZ + dz;
+			if (!TerrainStreamer_IsInMap(pTerrainMap, iTerrainX, iTerrainZ))
+			{
+				continue;
+			}
+
+			bool isCore = (abs(dx) < ring && abs(dz) < ring);
+			bool isAhead = (abs(iTerrainX - iPredictedX) <= pStreamer->radius && abs(iTerrainZ - iPredictedZ) <= pStreamer->radius);
+			if (!isCore && (!isAhead || (iPredictedX == iCameraX && iPredictedZ == iCameraZ)))
+			{
+				continue;
+			}
+
+			Terrain pTerrain = TerrainMap_GetTerrain(pTerrainMap, iTerrainX, iTerrainZ);
+			if (pTerrain)
+			{
+				pTerrain->lastUsedFrame = pStreamer->frameIndex;
+				wantedResident++;
+				continue;
+			}
+
+			if (pTerrainMap->pLoadStates[iTerrainZ * pTerrainMap->terrainsXCount + iTerrainX] != TERRAIN_LOAD_NONE)
+			{
+				continue;
+			}
+
+			// Closest first, prefetch after everything around the camera
+			STerrainStreamRequest* pRequest = &missing[missingCount++];
+			pRequest->iTerrainX = iTerrainX;
+			pRequest->iTerrainZ = iTerrainZ;
+			pRequest->priority = dx * dx + dz * dz + ((isCore) ? 0 : (1 << 16));
+		}
+	}
+
+	if (missingCount == 0)
+	{
+		return;
+	}
+
+	qsort(missing, (size_t)missingCount, sizeof(STerrainStreamRequest), TerrainStreamer_CompareRequests);
+
+	// Never ask for more than the slots can take, the rest waits for the next update
+	int32_t budget = pStreamer->slotCount - pTerrainMap->pendingCount - wantedResident;
+	for (int32_t i = 0; i < missingCount && i < budget; i++)
+	{
+		if (TerrainMap_RequestTerrain(pTerrainMap, missing[i].iTerrainX, missing[i].iTerrainZ))
+		{
+			pStreamer->stats.requestCount++;
+		}
+	}
+}
+
+int32_t TerrainStreamer_AcquireSlot(TerrainStreamer pStreamer, Terrain pTerrain)
+{
+	if (!pStreamer || !pTerrain)
+	{
+		return (-1);
+	}
+
+	int32_t iFreeSlot = -1;
+	int32_t iVictimSlot = -1;
+
+	for (int32_t i = 0; i < pStreamer->slotCount; i++)
+	{
+		Terrain pResident = pStreamer->pSlotTerrains[i];
+		if (!pResident)
+		{
+			iFreeSlot = i;
+			break;
+		}
+
+		// Terrains wanted this update are never evicted
+		if (pResident->lastUsedFrame < pStreamer->frameIndex &&
+			(iVictimSlot < 0 || pResident->lastUsedFrame < pStreamer->pSlotTerrains[iVictimSlot]->lastUsedFrame))
+		{
+			iVictimSlot = i;
+		}
+	}
+
+	if (iFreeSlot < 0)
+	{
+		if (iVictimSlot < 0)
+		{
+			pStreamer->stats.droppedCount++;
+			return (-1);
+		}
+
+		Terrain pVictim = pStreamer->pSlotTerrains[iVictimSlot];
+		TerrainMap_UnloadTerrain(pStreamer->pTerrainMap, pVictim->terrainXCoord, pVictim->terrainZCoord);
+
+		pStreamer->pSlotTerrains[iVictimSlot] = NULL;
+		pStreamer->stats.residentCount--;
+		pStreamer->stats.evictionCount++;
+		iFreeSlot = iVictimSlot;
+	}
+
+	pTerrain->lastUsedFrame = pStreamer->frameIndex;
+	pTerrain->gpuSlot = iFreeSlot;
+
+	pStreamer->pSlotTerrains[iFreeSlot] = pTerrain;
+	pStreamer->stats.residentCount++;
+
+	return (iFreeSlot);
+}
+
+void TerrainStreamer_GetStats(TerrainStreamer pStreamer, STerrainStreamerStats* pStats)
+{
+	if (!pStreamer || !pStats)
+	{
+		return;
+	}
+
+	*pStats = pStreamer->stats;
+	pStats->pendingCount = (uint32_t)pStreamer->pTerrainMap->pendingCount;
+}
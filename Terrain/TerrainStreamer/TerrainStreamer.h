@@ -0,0 +1,73 @@
+#ifndef __TERRAIN_STREAMER_H__
+#define __TERRAIN_STREAMER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Math/Vectors/Vector3.h"
+
+#define TERRAIN_STREAM_DEFAULT_RADIUS 2				// Terrains kept on each side of the camera terrain
+#define TERRAIN_STREAM_PREFETCH_SECONDS 1.5f		// How far ahead along the camera velocity to prefetch
+#define TERRAIN_STREAM_MAX_WANTED 1024				// Upper bound on terrains one update looks at
+
+typedef struct STerrainMap* TerrainMap;
+typedef struct STerrain* Terrain;
+
+typedef struct STerrainStreamerStats
+{
+	uint32_t residentCount;		// Terrains holding a GPU slot
+	uint32_t pendingCount;		// Requested, not attached yet
+	uint32_t slotCount;
+	uint64_t requestCount;		// Total since the map opened
+	uint64_t evictionCount;
+	uint64_t droppedCount;		// Arrived with every slot in use
+} STerrainStreamerStats;
+
+/**
+ * @brief Keeps the terrains around the camera resident in a fixed pool of GPU slots.
+ *
+ * Terrains inside the radius (square, in terrains) are requested closest first,
+ * then the ones around where the camera will be in prefetchSeconds. When a new
+ * terrain needs a slot and none is free, the least recently wanted terrain
+ * outside the current set is evicted.
+ */
+typedef struct STerrainStreamer
+{
+	TerrainMap pTerrainMap;
+	Terrain* pSlotTerrains;		// GPU slot -> resident terrain, NULL = free
+	int32_t slotCount;
+	int32_t radius;
+	float prefetchSeconds;
+
+	uint32_t frameIndex;		// Stamped on every terrain wanted this update
+	Vector3 v3LastCameraPos;
+	Vector3 v3Velocity;			// Smoothed, world units per second
+	bool bHasLastCameraPos;
+
+	STerrainStreamerStats stats;
+} STerrainStreamer;
+
+typedef struct STerrainStreamer* TerrainStreamer;
+
+bool TerrainStreamer_Initialize(TerrainStreamer* ppStreamer, TerrainMap pTerrainMap, int32_t radius);
+void TerrainStreamer_Destroy(TerrainStreamer* ppStreamer);
+
+/**
+ * @brief GPU slots needed for a radius, the wanted square plus one ring for prefetch and cache.
+ */
+int32_t TerrainStreamer_GetSlotCount(int32_t radius);
+
+/**
+ * @brief Marks the terrains around the camera as wanted and requests the missing ones.
+ */
+void TerrainStreamer_Update(TerrainStreamer pStreamer, Vector3 v3CameraPos, float deltaTime);
+
+/**
+ * @brief Gives a freshly attached terrain a GPU slot, evicting the least recently wanted terrain if needed.
+ *
+ * @return The slot, -1 when every slot holds a wanted terrain (the caller unloads pTerrain).
+ */
+int32_t TerrainStreamer_AcquireSlot(TerrainStreamer pStreamer, Terrain pTerrain);
+
+void TerrainStreamer_GetStats(TerrainStreamer pStreamer, STerrainStreamerStats* pStats);
+
+#endif // __TERRAIN_STREAMER_H__
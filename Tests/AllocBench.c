@@ -0,0 +1,138 @@
+#include "Stdafx.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#define ALLOC_BENCH_MAX_THREADS 64
+#define ALLOC_BENCH_DEFAULT_OPS 2000000		// Allocations per thread, each one freed again
+#define ALLOC_BENCH_LIVE_BLOCKS 64			// Blocks each thread keeps alive, frees are spread over the size classes
+#define ALLOC_BENCH_MIN_SIZE 16
+#define ALLOC_BENCH_SIZE_STEP 40			// 16..216 bytes, the small object range the per-thread caches serve
+
+static volatile int32_t s_iStartFlag = 0;
+static uint32_t s_iOpsPerThread = ALLOC_BENCH_DEFAULT_OPS;
+
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI AllocBench_Thread(LPVOID pParam)
+#else
+static void* AllocBench_Thread(void* pParam)
+#endif
+{
+	void* blocks[ALLOC_BENCH_LIVE_BLOCKS] = { 0 };
+
+	while (!AeroAtomic_Load32(&s_iStartFlag))
+	{
+	}
+
+	for (uint32_t i = 0; i < s_iOpsPerThread; i++)
+	{
+		uint32_t slot = i % ALLOC_BENCH_LIVE_BLOCKS;
+		engine_free(blocks[slot]);
+		blocks[slot] = engine_malloc(ALLOC_BENCH_MIN_SIZE + (i % 6) * ALLOC_BENCH_SIZE_STEP, MEM_TAG_ENGINE);
+	}
+
+	for (uint32_t slot = 0; slot < ALLOC_BENCH_LIVE_BLOCKS; slot++)
+	{
+		engine_free(blocks[slot]);
+	}
+
+	MemoryManager_ReleaseThreadCache();
+#if defined(_WIN32) || defined(_WIN64)
+	return (0);
+#else
+	return (NULL);
+#endif
+}
+
+// All threads are started first and released together, only the churn is timed
+static double AllocBench_Run(uint32_t threadCount)
+{
+	AeroAtomic_Store32(&s_iStartFlag, 0);
+
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE threads[ALLOC_BENCH_MAX_THREADS];
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		threads[i] = CreateThread(NULL, 0, AllocBench_Thread, NULL, 0, NULL);
+	}
+
+	double startMs = JobSystem_GetTimeMs();
+	AeroAtomic_Store32(&s_iStartFlag, 1);
+
+	WaitForMultipleObjects(threadCount, threads, TRUE, INFINITE);
+	double elapsedMs = JobSystem_GetTimeMs() - startMs;
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		CloseHandle(threads[i]);
+	}
+#else
+	pthread_t threads[ALLOC_BENCH_MAX_THREADS];
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		pthread_create(&threads[i], NULL, AllocBench_Thread, NULL);
+	}
+
+	double startMs = JobSystem_GetTimeMs();
+	AeroAtomic_Store32(&s_iStartFlag, 1);
+
+	for (uint32_t i = 0; i < threadCount; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+	double elapsedMs = JobSystem_GetTimeMs() - startMs;
+#endif
+
+	return (elapsedMs);
+}
+
+// Small block churn on 1, 2, 4, ... up to argv[1] (default 8) threads, locked vs per-thread tracking, argv[2] ops per thread
+int main(int argc, char* argv[])
+{
+	MemoryManager memoryManager;
+	if (!MemoryManager_Initialize(&memoryManager))
+	{
+		syserr("Failed to Initialize Memory Manager");
+		return (EXIT_FAILURE);
+	}
+
+	uint32_t maxThreads = (argc > 1) ? (uint32_t)atoi(argv[1]) : 8;
+	s_iOpsPerThread = (argc > 2) ? (uint32_t)atoi(argv[2]) : ALLOC_BENCH_DEFAULT_OPS;
+	if (maxThreads > ALLOC_BENCH_MAX_THREADS)
+	{
+		maxThreads = ALLOC_BENCH_MAX_THREADS;
+	}
+
+	static const EMemoryTrackingMode modes[] = { MEMORY_TRACKING_LOCKED, MEMORY_TRACKING_PER_THREAD };
+	static const char* modeNames[] = { "locked", "per-thread" };
+
+	for (uint32_t mode = 0; mode < 2; mode++)
+	{
+		MemoryManager_SetTrackingMode(modes[mode]);
+
+		double baseOpsPerMs = 0.0;
+		for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+		{
+			double elapsedMs = AllocBench_Run(threads);
+			double opsPerMs = (double)threads * s_iOpsPerThread / elapsedMs;
+			if (threads == 1)
+			{
+				baseOpsPerMs = opsPerMs;
+			}
+
+			syslog("%-10s threads %2u: %8.2f ms  %6.2f Mops/s  scaling %.2fx", modeNames[mode], threads, elapsedMs, opsPerMs / 1000.0, opsPerMs / baseOpsPerMs);
+		}
+	}
+
+	MemoryManager_SetTrackingMode(MEMORY_TRACKING_LOCKED);
+	if (!MemoryManager_Validate())
+	{
+		syserr("AllocBench: memory manager failed validation");
+		return (EXIT_FAILURE);
+	}
+
+	MemoryManager_Destroy(&memoryManager);
+	return (EXIT_SUCCESS);
+}
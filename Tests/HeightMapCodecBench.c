@@ -0,0 +1,143 @@
+#include "Stdafx.h"
+#include "Terrain/TerrainData.h"
+#include "Terrain/Terrain/HeightMapCodec.h"
+#include <float.h>
+
+#define CODEC_BENCH_DEFAULT_DECODES 2000	// Per repeat, about 137 MB of heights
+#define CODEC_BENCH_REPEATS 3				// Best of, the box is noisy
+
+typedef enum ECodecBenchTile
+{
+	CODEC_BENCH_SMOOTH,						// Rolling hills, what the terrain generator writes
+	CODEC_BENCH_NOISY,						// The same hills with small bumps on every vertex
+	CODEC_BENCH_RANDOM,						// White noise, the worst case for the predictor
+	CODEC_BENCH_FLAT,						// A single height, heightStep 0
+	CODEC_BENCH_TILE_COUNT,
+} ECodecBenchTile;
+
+static const char* s_aTileNames[CODEC_BENCH_TILE_COUNT] = { "smooth", "noisy", "random", "flat" };
+
+static uint32_t CodecBench_Random(uint32_t* pState)
+{
+	// xorshift32, only used for the synthetic heights
+	uint32_t x = *pState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*pState = x;
+	return (x);
+}
+
+static void CodecBench_MakeTile(ECodecBenchTile eTile, float* pHeights)
+{
+	uint32_t seed = 0x9E3779B9;
+	for (int32_t z = 0; z < HEIGHTMAP_RAW_ZSIZE; z++)
+	{
+		for (int32_t x = 0; x < HEIGHTMAP_RAW_XSIZE; x++)
+		{
+			float hills = 40.0f * sinf(x * 0.05f) * cosf(z * 0.04f) + 15.0f * sinf((x + z) * 0.13f) + 60.0f;
+			float noise = (float)(CodecBench_Random(&seed) & 0xFFFF) / 65535.0f;
+			float height = 0.0f;
+			switch (eTile)
+			{
+			case CODEC_BENCH_SMOOTH: height = hills; break;
+			case CODEC_BENCH_NOISY: height = hills + noise * 2.0f; break;
+			case CODEC_BENCH_RANDOM: height = noise * 200.0f; break;
+			default: height = 25.0f; break;
+			}
+			pHeights[z * HEIGHTMAP_RAW_XSIZE + x] = height;
+		}
+	}
+}
+
+/**
+ * Version 2 heightmap codec on synthetic HEIGHTMAP_RAW_XSIZE x HEIGHTMAP_RAW_ZSIZE tiles: compression
+ * ratio against the raw floats, encode time, and decode throughput in GB/s of decoded floats.
+ * Every decode is checked to stay within half a quantization step.
+ *
+ * HeightMapCodecBench [decodes], default 2000 per repeat.
+ */
+int main(int argc, char* argv[])
+{
+	MemoryManager memoryManager;
+	if (!MemoryManager_Initialize(&memoryManager))
+	{
+		syserr("Failed to Initialize Memory Manager");
+		return (EXIT_FAILURE);
+	}
+
+	// Tracking is not what is measured here
+	MemoryManager_SetTrackingLevel(MEMORY_TRACKING_LEVEL_COUNTERS);
+
+	int32_t decodeCount = (argc > 1) ? atoi(argv[1]) : CODEC_BENCH_DEFAULT_DECODES;
+
+	const int32_t cols = HEIGHTMAP_RAW_XSIZE;
+	const int32_t rows = HEIGHTMAP_RAW_ZSIZE;
+	size_t heightCount = (size_t)cols * rows;
+	size_t rawSize = heightCount * sizeof(float);
+	size_t encodedCapacity = HeightMapCodec_GetMaxEncodedSize(cols, rows);
+
+	float* pHeights = engine_new_zero(float, heightCount, MEM_TAG_ENGINE);
+	float* pDecoded = engine_new_zero(float, heightCount, MEM_TAG_ENGINE);
+	uint8_t* pEncoded = (uint8_t*)engine_malloc(encodedCapacity, MEM_TAG_ENGINE);
+	if (!pHeights || !pDecoded || !pEncoded)
+	{
+		syserr("Failed to Allocate the benchmark tiles");
+		return (EXIT_FAILURE);
+	}
+
+	bool bPassed = true;
+
+	syslog("%dx%d tiles, %zu raw bytes, %d decodes", cols, rows, rawSize, decodeCount);
+	syslog("tile      encoded   ratio  encode us  decode GB/s  max error / step");
+	for (int32_t tile = 0; tile < CODEC_BENCH_TILE_COUNT; tile++)
+	{
+		CodecBench_MakeTile((ECodecBenchTile)tile, pHeights);
+
+		double bestEncodeMs = 1e30;
+		double bestDecodeMs = 1e30;
+		size_t encodedSize = 0;
+		for (int32_t repeat = 0; repeat < CODEC_BENCH_REPEATS; repeat++)
+		{
+			double startMs = JobSystem_GetTimeMs();
+			encodedSize = HeightMapCodec_Encode(pHeights, cols, rows, pEncoded, encodedCapacity);
+			double encodeMs = JobSystem_GetTimeMs();
+			for (int32_t i = 0; i < decodeCount; i++)
+			{
+				bPassed = HeightMapCodec_Decode(pEncoded, encodedSize, cols, rows, pDecoded) && bPassed;
+			}
+			double decodeMs = JobSystem_GetTimeMs();
+
+			bestEncodeMs = (encodeMs - startMs < bestEncodeMs) ? encodeMs - startMs : bestEncodeMs;
+			bestDecodeMs = (decodeMs - encodeMs < bestDecodeMs) ? decodeMs - encodeMs : bestDecodeMs;
+		}
+		bPassed = bPassed && encodedSize > 0;
+
+		// Lossy, but never by more than half a step, give or take the float rounding of min + level * step
+		const SHeightMapCodecHeader* pHeader = (const SHeightMapCodecHeader*)pEncoded;
+		float maxError = 0.0f;
+		for (size_t i = 0; i < heightCount; i++)
+		{
+			float error = fabsf(pDecoded[i] - pHeights[i]);
+			bPassed = bPassed && error <= 0.5f * pHeader->heightStep + 4.0f * FLT_EPSILON * fabsf(pHeights[i]);
+			maxError = fmaxf(maxError, error);
+		}
+		float errorSteps = (pHeader->heightStep > 0.0f) ? maxError / pHeader->heightStep : maxError;
+
+		double decodeGBs = (double)rawSize * decodeCount / (bestDecodeMs * 1e6);
+		syslog("%-8s %8zu  %5.2fx  %9.1f  %11.2f  %.3f", s_aTileNames[tile], encodedSize, (double)rawSize / encodedSize, bestEncodeMs * 1000.0, decodeGBs, errorSteps);
+	}
+
+	engine_delete(pEncoded);
+	engine_delete(pDecoded);
+	engine_delete(pHeights);
+
+	MemoryManager_Destroy(&memoryManager);
+
+	if (!bPassed)
+	{
+		syserr("HeightMapCodecBench: a tile failed to round trip within half a step");
+		return (EXIT_FAILURE);
+	}
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,67 @@
+#include "Stdafx.h"
+#include "Core/JobSystem.h"
+
+#define JOB_BENCH_ITEMS 20000
+#define JOB_BENCH_BATCH 16
+#define JOB_BENCH_ITEM_WORK 2000
+#define JOB_BENCH_REPEATS 5
+
+static volatile double s_fBenchSink = 0.0;
+
+static void JobSystemBench_Work(void* pUserData, uint32_t begin, uint32_t end)
+{
+	double sum = 0.0;
+	for (uint32_t i = begin; i < end; i++)
+	{
+		for (uint32_t j = 0; j < JOB_BENCH_ITEM_WORK; j++)
+		{
+			sum += j * 0.5 / (j + 1.0);
+		}
+	}
+	s_fBenchSink = sum;
+}
+
+// Times one CPU-bound ParallelFor per thread count, 1, 2, 4, ... up to argv[1] (default 8)
+int main(int argc, char* argv[])
+{
+	MemoryManager memoryManager;
+	if (!MemoryManager_Initialize(&memoryManager))
+	{
+		syserr("Failed to Initialize Memory Manager");
+		return (EXIT_FAILURE);
+	}
+
+	uint32_t maxThreads = (argc > 1) ? (uint32_t)atoi(argv[1]) : 8;
+	double baseMs = 0.0;
+	for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		// The main thread helps while it waits, so one worker fewer than the thread count.
+		// One thread is the baseline with no job system at all, ParallelFor then runs inline (0 workers would mean one per core)
+		JobSystem jobSystem = NULL;
+		if (threads > 1 && !JobSystem_Initialize(&jobSystem, threads - 1))
+		{
+			syserr("Failed to Initialize Job System");
+			return (EXIT_FAILURE);
+		}
+
+		double startMs = JobSystem_GetTimeMs();
+		for (int32_t i = 0; i < JOB_BENCH_REPEATS; i++)
+		{
+			JobSystem_ParallelFor(JOB_BENCH_ITEMS, JOB_BENCH_BATCH, JobSystemBench_Work, NULL);
+		}
+		double frameMs = (JobSystem_GetTimeMs() - startMs) / JOB_BENCH_REPEATS;
+		if (threads == 1)
+		{
+			baseMs = frameMs;
+		}
+
+		syslog("threads %2u: %8.2f ms  speedup %.2fx", JobSystem_GetThreadCount(), frameMs, baseMs / frameMs);
+		if (jobSystem)
+		{
+			JobSystem_Destroy(&jobSystem);
+		}
+	}
+
+	MemoryManager_Destroy(&memoryManager);
+	return (EXIT_SUCCESS);
+}
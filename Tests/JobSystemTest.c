@@ -0,0 +1,246 @@
+#include "Stdafx.h"
+#include "Core/JobSystem.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#define JOB_TEST_ROUNDS 5
+#define JOB_TEST_FLOOD_COUNT 20000 // Well past one worker deque, pushes go through the overflow queue
+#define JOB_TEST_NEST_DEPTH 10
+#define JOB_TEST_RANGE_COUNT 1000000
+#define JOB_TEST_MAIN_JOBS 100
+#define JOB_TEST_EXTERNAL_THREADS 4
+#define JOB_TEST_EXTERNAL_JOBS 10000
+#define JOB_TEST_RESTARTS 100 // Worker start/stop cycles, more workers in total than the memory manager has thread caches
+
+#define JOB_TEST_CHECK(cond) do { if (!(cond)) { syserr("JobSystemTest: check failed at line %d: %s", __LINE__, #cond); return (false); } } while(0)
+
+typedef struct SNestedJob
+{
+	SJobCounter* pCounter;
+	int32_t depth;
+} SNestedJob;
+
+static volatile int64_t s_iJobSum = 0;
+static volatile int32_t s_iStageIndex = 0;
+static int32_t s_aStageOrder[3];
+static volatile int32_t s_iMainThreadRuns = 0;
+
+static void JobSystemTest_Add(void* pUserData)
+{
+	AeroAtomic_Add64(&s_iJobSum, 1);
+}
+
+static void JobSystemTest_Nested(void* pUserData)
+{
+	SNestedJob* pJob = (SNestedJob*)pUserData;
+	AeroAtomic_Add64(&s_iJobSum, 1);
+	if (pJob->depth <= 0)
+	{
+		return;
+	}
+
+	// Children live on this stack, so wait for them before returning
+	SNestedJob children[2];
+	SJobCounter counter = { 0 };
+	for (int32_t i = 0; i < 2; i++)
+	{
+		children[i].pCounter = pJob->pCounter;
+		children[i].depth = pJob->depth - 1;
+		JobSystem_Submit(JobSystemTest_Nested, &children[i], &counter);
+	}
+	JobSystem_Wait(&counter);
+}
+
+static void JobSystemTest_Stage(void* pUserData)
+{
+	int32_t index = AeroAtomic_Add32(&s_iStageIndex, 1) - 1;
+	s_aStageOrder[index] = (int32_t)(intptr_t)pUserData;
+}
+
+static void JobSystemTest_SumRange(void* pUserData, uint32_t begin, uint32_t end)
+{
+	int64_t sum = 0;
+	for (uint32_t i = begin; i < end; i++)
+	{
+		sum += i;
+	}
+	AeroAtomic_Add64((volatile int64_t*)pUserData, sum);
+}
+
+static void JobSystemTest_OnMainThread(void* pUserData)
+{
+	if (JobSystem_IsMainThread())
+	{
+		AeroAtomic_Add32(&s_iMainThreadRuns, 1);
+	}
+}
+
+static void JobSystemTest_QueueMainThread(void* pUserData)
+{
+	JobSystem_SubmitMainThread(JobSystemTest_OnMainThread, NULL, (SJobCounter*)pUserData);
+}
+
+static void JobSystemTest_Allocate(void* pUserData)
+{
+	void* pBlock = engine_malloc(64, MEM_TAG_ENGINE);
+	engine_free(pBlock);
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI JobSystemTest_ExternalThread(LPVOID pParam)
+#else
+static void* JobSystemTest_ExternalThread(void* pParam)
+#endif
+{
+	SJobCounter counter = { 0 };
+	for (int32_t i = 0; i < JOB_TEST_EXTERNAL_JOBS; i++)
+	{
+		JobSystem_Submit(JobSystemTest_Add, NULL, &counter);
+	}
+	JobSystem_Wait(&counter);
+	MemoryManager_ReleaseThreadCache();
+#if defined(_WIN32) || defined(_WIN64)
+	return (0);
+#else
+	return (NULL);
+#endif
+}
+
+static bool JobSystemTest_Round()
+{
+	// Flood
+	s_iJobSum = 0;
+	SJobCounter floodCounter = { 0 };
+	for (int32_t i = 0; i < JOB_TEST_FLOOD_COUNT; i++)
+	{
+		JobSystem_Submit(JobSystemTest_Add, NULL, &floodCounter);
+	}
+	JobSystem_Wait(&floodCounter);
+	JOB_TEST_CHECK(s_iJobSum == JOB_TEST_FLOOD_COUNT);
+
+	// Jobs submitting and waiting on jobs
+	s_iJobSum = 0;
+	SJobCounter nestedCounter = { 0 };
+	SNestedJob root = { &nestedCounter, JOB_TEST_NEST_DEPTH };
+	JobSystem_Submit(JobSystemTest_Nested, &root, &nestedCounter);
+	JobSystem_Wait(&nestedCounter);
+	JOB_TEST_CHECK(s_iJobSum == (1 << (JOB_TEST_NEST_DEPTH + 1)) - 1);
+
+	// A -> B -> C
+	s_iStageIndex = 0;
+	SJobCounter stageA = { 0 }, stageB = { 0 }, stageC = { 0 };
+	JobSystem_Submit(JobSystemTest_Stage, (void*)1, &stageA);
+	JobSystem_SubmitAfter(&stageA, JobSystemTest_Stage, (void*)2, &stageB);
+	JobSystem_SubmitAfter(&stageB, JobSystemTest_Stage, (void*)3, &stageC);
+	JobSystem_Wait(&stageC);
+	JOB_TEST_CHECK(s_aStageOrder[0] == 1 && s_aStageOrder[1] == 2 && s_aStageOrder[2] == 3);
+
+	// Parallel for
+	volatile int64_t rangeSum = 0;
+	JobSystem_ParallelFor(JOB_TEST_RANGE_COUNT, 1000, JobSystemTest_SumRange, (void*)&rangeSum);
+	JOB_TEST_CHECK(rangeSum == (int64_t)(JOB_TEST_RANGE_COUNT - 1) * JOB_TEST_RANGE_COUNT / 2);
+
+	// Main thread jobs queued from workers
+	s_iMainThreadRuns = 0;
+	SJobCounter mainCounter = { 0 };
+	for (int32_t i = 0; i < JOB_TEST_MAIN_JOBS; i++)
+	{
+		JobSystem_Submit(JobSystemTest_QueueMainThread, &mainCounter, NULL);
+	}
+	while (AeroAtomic_Load32(&s_iMainThreadRuns) < JOB_TEST_MAIN_JOBS)
+	{
+		JobSystem_RunMainThreadJobs(0.0);
+	}
+	JobSystem_Wait(&mainCounter);
+
+	// Submits from threads the job system did not start
+	s_iJobSum = 0;
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE threads[JOB_TEST_EXTERNAL_THREADS];
+	for (int32_t i = 0; i < JOB_TEST_EXTERNAL_THREADS; i++)
+	{
+		threads[i] = CreateThread(NULL, 0, JobSystemTest_ExternalThread, NULL, 0, NULL);
+	}
+	WaitForMultipleObjects(JOB_TEST_EXTERNAL_THREADS, threads, TRUE, INFINITE);
+	for (int32_t i = 0; i < JOB_TEST_EXTERNAL_THREADS; i++)
+	{
+		CloseHandle(threads[i]);
+	}
+#else
+	pthread_t threads[JOB_TEST_EXTERNAL_THREADS];
+	for (int32_t i = 0; i < JOB_TEST_EXTERNAL_THREADS; i++)
+	{
+		pthread_create(&threads[i], NULL, JobSystemTest_ExternalThread, NULL);
+	}
+	for (int32_t i = 0; i < JOB_TEST_EXTERNAL_THREADS; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+#endif
+	JOB_TEST_CHECK(s_iJobSum == JOB_TEST_EXTERNAL_THREADS * JOB_TEST_EXTERNAL_JOBS);
+
+	return (true);
+}
+
+// Workers hand their memory thread cache back on exit, restarting the job system must not run out of cache slots
+static bool JobSystemTest_Restart()
+{
+	MemoryManager_SetTrackingMode(MEMORY_TRACKING_PER_THREAD);
+	for (int32_t i = 0; i < JOB_TEST_RESTARTS; i++)
+	{
+		JobSystem jobSystem;
+		JOB_TEST_CHECK(JobSystem_Initialize(&jobSystem, 3));
+
+		SJobCounter counter = { 0 };
+		for (int32_t j = 0; j < 64; j++)
+		{
+			JobSystem_Submit(JobSystemTest_Allocate, NULL, &counter);
+		}
+		JobSystem_Wait(&counter);
+		JobSystem_Destroy(&jobSystem);
+	}
+
+	JOB_TEST_CHECK(MemoryManager_Validate());
+	MemoryManager_SetTrackingMode(MEMORY_TRACKING_LOCKED);
+	return (true);
+}
+
+int main(int argc, char* argv[])
+{
+	MemoryManager memoryManager;
+	if (!MemoryManager_Initialize(&memoryManager))
+	{
+		syserr("Failed to Initialize Memory Manager");
+		return (EXIT_FAILURE);
+	}
+
+	JobSystem jobSystem;
+	if (!JobSystem_Initialize(&jobSystem, 7))
+	{
+		syserr("Failed to Initialize Job System");
+		return (EXIT_FAILURE);
+	}
+
+	bool bPassed = true;
+	for (int32_t round = 0; round < JOB_TEST_ROUNDS && bPassed; round++)
+	{
+		bPassed = JobSystemTest_Round();
+	}
+
+	SJobSystemStats stats;
+	JobSystem_GetStats(&stats);
+	syslog("JobSystemTest: executed %lld, stolen %lld, overflowed %lld", (long long)stats.jobsExecuted, (long long)stats.jobsStolen, (long long)stats.jobsOverflowed);
+	JobSystem_Destroy(&jobSystem);
+
+	bPassed = bPassed && JobSystemTest_Restart();
+
+	MemoryManager_DumpLeaks();
+	MemoryManager_Destroy(&memoryManager);
+
+	syslog("JobSystemTest: %s", bPassed ? "passed" : "FAILED");
+	return (bPassed ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,260 @@
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // posix_fadvise and fdatasync with CMAKE_C_EXTENSIONS OFF
+#endif
+
+#include "Stdafx.h"
+#include "Terrain/TerrainMap/TerrainMap.h"
+#include "Terrain/TerrainMap/TerrainPack.h"
+#include "Terrain/TerrainPatch.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h>
+#include <unistd.h>
+#define MAP_LOAD_BENCH_CAN_EVICT 1
+#else
+#define MAP_LOAD_BENCH_CAN_EVICT 0
+#endif
+
+#define MAP_LOAD_BENCH_SMALL_MAP "map_new"		// The 2x2 map in the repository
+#define MAP_LOAD_BENCH_LARGE_MAP "LoadBench16"		// Synthetic, created the first time
+#define MAP_LOAD_BENCH_LARGE_SIZE 16
+#define MAP_LOAD_BENCH_REPEATS 3				// Best of, the first load also warms the page cache
+
+// No GL context here, the terrain ring fences are never waited on so dummy syncs are enough
+static GLsync MapLoadBench_FenceSync(GLenum condition, GLbitfield flags)
+{
+	return ((GLsync)1);
+}
+
+static void MapLoadBench_DeleteSync(GLsync sync)
+{
+}
+
+// Drops a file from the page cache, the next read comes from the disk again
+static void MapLoadBench_EvictFile(const char* szPath)
+{
+#if MAP_LOAD_BENCH_CAN_EVICT
+	int fd = open(szPath, O_RDONLY);
+	if (fd < 0)
+	{
+		return;
+	}
+
+	// Dirty pages can't be dropped, freshly created maps are written back first
+	fdatasync(fd);
+	posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+	close(fd);
+#endif
+}
+
+static bool MapLoadBench_EvictMap(char* szMapName, bool bPacked)
+{
+	if (bPacked)
+	{
+		char szPackPath[MAX_STRING_LEN] = { 0 };
+		if (!TerrainPack_GetPath(szMapName, szPackPath, sizeof(szPackPath)))
+		{
+			return (false);
+		}
+		MapLoadBench_EvictFile(szPackPath);
+		return (true);
+	}
+
+	char szMapPath[MAX_STRING_LEN] = { 0 };
+	snprintf(szMapPath, sizeof(szMapPath), "%s%s", terrainMapsFolder, szMapName);
+
+	TerrainMap pTerrainMap = NULL;
+	if (!TerrainMap_Initialize(&pTerrainMap) || !TerrainMap_LoadSettingsFile(pTerrainMap, szMapPath))
+	{
+		TerrainMap_Destroy(&pTerrainMap);
+		return (false);
+	}
+
+	for (int32_t iTerrainZ = 0; iTerrainZ < pTerrainMap->terrainsZCount; iTerrainZ++)
+	{
+		for (int32_t iTerrainX = 0; iTerrainX < pTerrainMap->terrainsXCount; iTerrainX++)
+		{
+			char szTilePath[MAX_STRING_LEN] = { 0 };
+			snprintf(szTilePath, sizeof(szTilePath), "%s/%06d/HeightMap.raw", pTerrainMap->szMapDir, iTerrainZ * 1000 + iTerrainX);
+			MapLoadBench_EvictFile(szTilePath);
+		}
+	}
+
+	TerrainMap_Destroy(&pTerrainMap);
+	return (true);
+}
+
+// bCold drops the map files from the page cache before every load, bPacked tells which files that is
+static bool MapLoadBench_Load(char* szMapName, bool bCold, bool bPacked, double* pBestMs)
+{
+	*pBestMs = 1e30;
+	for (int32_t repeat = 0; repeat < MAP_LOAD_BENCH_REPEATS; repeat++)
+	{
+		if (bCold && !MapLoadBench_EvictMap(szMapName, bPacked))
+		{
+			return (false);
+		}
+
+		TerrainMap pTerrainMap = NULL;
+		if (!TerrainMap_Initialize(&pTerrainMap))
+		{
+			return (false);
+		}
+
+		double startMs = JobSystem_GetTimeMs();
+		bool bLoaded = TerrainMap_LoadMap(pTerrainMap, szMapName);
+		double loadMs = JobSystem_GetTimeMs() - startMs;
+
+		TerrainMap_Destroy(&pTerrainMap);
+		if (!bLoaded)
+		{
+			syserr("Failed to Load Map %s", szMapName);
+			return (false);
+		}
+
+		*pBestMs = (loadMs < *pBestMs) ? loadMs : *pBestMs;
+	}
+
+	return (true);
+}
+
+/**
+ * Whole map load time (TerrainMap_LoadMap), serial with no job system and then built on the job system,
+ * then the packed archive against the folder layout, warm and with the files evicted from the page cache (cold).
+ *
+ * MapLoadBench [mapName ...] [-workers N], run from the repository root. By default the 2x2 map_new
+ * and a synthetic 16x16 map, created under Assets/Maps/ the first time; N = 0 is one worker per core.
+ * A map without a pack is packed for the run and the pack is removed again, an existing pack is put aside
+ * while the folder loads. Cold loads need POSIX_FADV_DONTNEED and are skipped on Windows.
+ */
+int main(int argc, char* argv[])
+{
+	char* szMaps[16] = { 0 };
+	int32_t mapCount = 0;
+	uint32_t workerCount = 0;
+	for (int32_t i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-workers") == 0 && i + 1 < argc)
+		{
+			workerCount = (uint32_t)atoi(argv[++i]);
+		}
+		else if (mapCount < 16)
+		{
+			szMaps[mapCount++] = argv[i];
+		}
+	}
+	if (mapCount == 0)
+	{
+		szMaps[mapCount++] = MAP_LOAD_BENCH_SMALL_MAP;
+		szMaps[mapCount++] = MAP_LOAD_BENCH_LARGE_MAP;
+	}
+
+	MemoryManager memoryManager;
+	if (!MemoryManager_Initialize(&memoryManager))
+	{
+		syserr("Failed to Initialize Memory Manager");
+		return (EXIT_FAILURE);
+	}
+
+	FrameAllocator frameAllocator;
+	if (!FrameAllocator_Initialize(&frameAllocator, FRAME_ARENA_DEFAULT_SIZE))
+	{
+		syserr("Failed to Initialize Frame Allocator");
+		return (EXIT_FAILURE);
+	}
+
+	glad_glFenceSync = MapLoadBench_FenceSync;
+	glad_glDeleteSync = MapLoadBench_DeleteSync;
+
+	char szMapPath[MAX_STRING_LEN] = { 0 };
+	snprintf(szMapPath, sizeof(szMapPath), "%s%s", terrainMapsFolder, MAP_LOAD_BENCH_LARGE_MAP);
+	if (!IsDirectoryExists(szMapPath))
+	{
+		syslog("Creating %dx%d map %s", MAP_LOAD_BENCH_LARGE_SIZE, MAP_LOAD_BENCH_LARGE_SIZE, MAP_LOAD_BENCH_LARGE_MAP);
+		if (!TerrainMap_CreateMap(MAP_LOAD_BENCH_LARGE_MAP, MAP_LOAD_BENCH_LARGE_SIZE, MAP_LOAD_BENCH_LARGE_SIZE))
+		{
+			syserr("Failed to Create Map %s", MAP_LOAD_BENCH_LARGE_MAP);
+			return (EXIT_FAILURE);
+		}
+	}
+
+	double serialMs[16] = { 0 };
+	for (int32_t i = 0; i < mapCount; i++)
+	{
+		if (!MapLoadBench_Load(szMaps[i], false, false, &serialMs[i]))
+		{
+			return (EXIT_FAILURE);
+		}
+	}
+
+	JobSystem jobSystem;
+	if (!JobSystem_Initialize(&jobSystem, workerCount))
+	{
+		syserr("Failed to Initialize Job System");
+		return (EXIT_FAILURE);
+	}
+
+	for (int32_t i = 0; i < mapCount; i++)
+	{
+		double parallelMs = 0.0;
+		if (!MapLoadBench_Load(szMaps[i], false, false, &parallelMs))
+		{
+			return (EXIT_FAILURE);
+		}
+
+		syslog("%-16s serial %9.2f ms  %u threads %9.2f ms  speedup %.2fx", szMaps[i], serialMs[i], JobSystem_GetThreadCount(), parallelMs, serialMs[i] / parallelMs);
+	}
+
+	for (int32_t i = 0; i < mapCount; i++)
+	{
+		char szPackPath[MAX_STRING_LEN] = { 0 };
+		char szAsidePath[MAX_STRING_LEN + 8] = { 0 };
+		if (!TerrainPack_GetPath(szMaps[i], szPackPath, sizeof(szPackPath)))
+		{
+			return (EXIT_FAILURE);
+		}
+		snprintf(szAsidePath, sizeof(szAsidePath), "%s.bench", szPackPath);
+
+		bool bHadPack = TerrainPack_Exists(szMaps[i]);
+		if (!bHadPack && !TerrainPack_PackMap(szMaps[i], false))
+		{
+			syserr("Failed to Pack Map %s", szMaps[i]);
+			return (EXIT_FAILURE);
+		}
+
+		double packWarmMs = 0.0, packColdMs = 0.0, folderWarmMs = 0.0, folderColdMs = 0.0;
+		bool success = MapLoadBench_Load(szMaps[i], false, true, &packWarmMs) && (!MAP_LOAD_BENCH_CAN_EVICT || MapLoadBench_Load(szMaps[i], true, true, &packColdMs));
+
+		// TerrainMap_OpenMap picks the pack whenever it exists
+		if (success && rename(szPackPath, szAsidePath) == 0)
+		{
+			success = MapLoadBench_Load(szMaps[i], false, false, &folderWarmMs) && (!MAP_LOAD_BENCH_CAN_EVICT || MapLoadBench_Load(szMaps[i], true, false, &folderColdMs));
+			rename(szAsidePath, szPackPath);
+		}
+		else
+		{
+			success = false;
+		}
+
+		if (!bHadPack)
+		{
+			remove(szPackPath);
+		}
+		if (!success)
+		{
+			syserr("Failed the pack / folder comparison for %s", szMaps[i]);
+			return (EXIT_FAILURE);
+		}
+
+		syslog("%-16s pack warm %9.2f ms  cold %9.2f ms   folder warm %9.2f ms  cold %9.2f ms", szMaps[i], packWarmMs, packColdMs, folderWarmMs, folderColdMs);
+	}
+
+	TerrainPatch_DestroyPool();
+	TerrainMesh_DestroyPool();
+
+	JobSystem_Destroy(&jobSystem);
+	FrameAllocator_Destroy(&frameAllocator);
+	MemoryManager_Destroy(&memoryManager);
+
+	return (EXIT_SUCCESS);
+}
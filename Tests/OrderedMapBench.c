@@ -0,0 +1,148 @@
+#include "Stdafx.h"
+#include "AeroLib/Map.h"
+
+#define ORDERED_BENCH_KEY_SIZE 16		// 12 char keys plus the terminator, padded
+#define ORDERED_BENCH_MIN_COUNT 1000
+#define ORDERED_BENCH_MAX_COUNT 100000
+#define ORDERED_BENCH_REPEATS 3			// Best of, the box is noisy
+
+static volatile uintptr_t s_iBenchSink = 0;
+
+static uint32_t OrderedMapBench_Random(uint32_t* pState)
+{
+	// xorshift32, only used to shuffle the key order
+	uint32_t x = *pState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*pState = x;
+	return (x);
+}
+
+// Returns false when the map lost a key or the in-order walk is out of order
+static bool OrderedMapBench_Run(const char* pKeys, const uint32_t* pOrder, uint32_t count, double* pInsertMs, double* pFindMs, double* pWalkMs, uint32_t* pHeight)
+{
+	AeroOrderedMap map = NULL;
+	if (!Map_Initialize(&map, MEM_TAG_ENGINE))
+	{
+		syserr("Failed to Initialize Map");
+		return (false);
+	}
+
+	double startMs = JobSystem_GetTimeMs();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Map_Insert(map, pKeys + (size_t)pOrder[i] * ORDERED_BENCH_KEY_SIZE, (void*)(uintptr_t)(pOrder[i] + 1));
+	}
+	double insertMs = JobSystem_GetTimeMs();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		s_iBenchSink += (uintptr_t)Map_Find(map, pKeys + (size_t)pOrder[i] * ORDERED_BENCH_KEY_SIZE);
+	}
+	double findMs = JobSystem_GetTimeMs();
+
+	uint32_t walked = 0;
+	uintptr_t previous = 0;
+	bool bSorted = true;
+	SAeroOrderedMapIterator end = Map_End(map);
+	for (SAeroOrderedMapIterator it = Map_Begin(map); !Map_IterCompare(it, end); Map_IteratorNext(&it))
+	{
+		// Keys are zero padded, so key order is index order
+		bSorted = bSorted && (uintptr_t)it.value > previous;
+		previous = (uintptr_t)it.value;
+		walked++;
+	}
+	double walkMs = JobSystem_GetTimeMs();
+
+	*pInsertMs = insertMs - startMs;
+	*pFindMs = findMs - insertMs;
+	*pWalkMs = walkMs - findMs;
+	*pHeight = Map_Height(map);
+
+	bool bValid = bSorted && walked == count && Map_Count(map) == count;
+	Map_Destroy(&map);
+	return (bValid);
+}
+
+/**
+ * Worst case for an unbalanced tree: keys inserted in sorted order, next to the same keys shuffled.
+ * Reports insert, find and a full in-order walk in ns per key, and the tree height, 1k..argv[1] (default 100k) keys.
+ */
+int main(int argc, char* argv[])
+{
+	MemoryManager memoryManager;
+	if (!MemoryManager_Initialize(&memoryManager))
+	{
+		syserr("Failed to Initialize Memory Manager");
+		return (EXIT_FAILURE);
+	}
+
+	// Tracking is not what is measured here
+	MemoryManager_SetTrackingLevel(MEMORY_TRACKING_LEVEL_COUNTERS);
+
+	uint32_t maxCount = (argc > 1) ? (uint32_t)atoi(argv[1]) : ORDERED_BENCH_MAX_COUNT;
+
+	char* pKeys = (char*)engine_malloc((size_t)maxCount * ORDERED_BENCH_KEY_SIZE, MEM_TAG_ENGINE);
+	uint32_t* pSorted = engine_new_zero(uint32_t, maxCount, MEM_TAG_ENGINE);
+	uint32_t* pShuffled = engine_new_zero(uint32_t, maxCount, MEM_TAG_ENGINE);
+	if (!pKeys || !pSorted || !pShuffled)
+	{
+		syserr("Failed to Allocate %u benchmark keys", maxCount);
+		return (EXIT_FAILURE);
+	}
+
+	for (uint32_t i = 0; i < maxCount; i++)
+	{
+		snprintf(pKeys + (size_t)i * ORDERED_BENCH_KEY_SIZE, ORDERED_BENCH_KEY_SIZE, "key%09u", i);
+		pSorted[i] = i;
+	}
+
+	bool bPassed = true;
+	uint32_t seed = 0x9E3779B9;
+
+	syslog("      keys  order     insert       find       walk  height  (ns/key)");
+	for (uint32_t count = ORDERED_BENCH_MIN_COUNT; count <= maxCount && bPassed; count *= 10)
+	{
+		memcpy(pShuffled, pSorted, count * sizeof(uint32_t));
+		for (uint32_t i = count - 1; i > 0; i--)
+		{
+			uint32_t j = OrderedMapBench_Random(&seed) % (i + 1);
+			uint32_t swap = pShuffled[i];
+			pShuffled[i] = pShuffled[j];
+			pShuffled[j] = swap;
+		}
+
+		static const char* orderNames[] = { "sorted", "random" };
+		const uint32_t* orders[] = { pSorted, pShuffled };
+		for (int32_t order = 0; order < 2 && bPassed; order++)
+		{
+			double best[3] = { 1e30, 1e30, 1e30 };
+			uint32_t height = 0;
+			for (int32_t repeat = 0; repeat < ORDERED_BENCH_REPEATS && bPassed; repeat++)
+			{
+				double times[3];
+				bPassed = OrderedMapBench_Run(pKeys, orders[order], count, &times[0], &times[1], &times[2], &height);
+				for (int32_t i = 0; i < 3; i++)
+				{
+					best[i] = (times[i] < best[i]) ? times[i] : best[i];
+				}
+			}
+
+			double nsPerKey = 1000000.0 / count;
+			syslog("%10u  %-6s %10.1f %10.1f %10.1f  %6u", count, orderNames[order], best[0] * nsPerKey, best[1] * nsPerKey, best[2] * nsPerKey, height);
+		}
+	}
+
+	engine_delete(pShuffled);
+	engine_delete(pSorted);
+	engine_delete(pKeys);
+
+	MemoryManager_Destroy(&memoryManager);
+
+	if (!bPassed)
+	{
+		syserr("OrderedMapBench: the map lost keys or walked them out of order");
+		return (EXIT_FAILURE);
+	}
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,254 @@
+#include "Stdafx.h"
+#include "Math/EngineMath.h"
+#include "Buffers/UniformBufferObject.h"
+#include "Renderer/TerrainCulling.h"
+#include "Renderer/TerrainRenderer.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#define CULL_TEST_SIDE 7				// Slots on each side of the camera grid
+#define CULL_TEST_EMPTY_EVERY 7			// Every 7th slot has no terrain, its commands stay empty
+#define CULL_TEST_INDEX_COUNT 6
+#define CULL_TEST_SKIP 77				// ctest SKIP_RETURN_CODE, no GL 4.5 context on this machine
+
+#define CULL_TEST_CHECK(cond) do { if (!(cond)) { syserr("TerrainCullGPUTest: check failed at line %d: %s", __LINE__, #cond); return (EXIT_FAILURE); } } while(0)
+
+static int TerrainCullGPUTest_CompareIndices(const void* pA, const void* pB)
+{
+	uint32_t a = *(const uint32_t*)pA;
+	uint32_t b = *(const uint32_t*)pB;
+	return ((a > b) - (a < b));
+}
+
+// Headless GL 4.5 core through Mesa's surfaceless platform, llvmpipe when there is no GPU
+static bool TerrainCullGPUTest_CreateContext()
+{
+	EGLDisplay display = eglGetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL) || !eglBindAPI(EGL_OPENGL_API))
+	{
+		return (false);
+	}
+
+	const EGLint contextAttribs[] =
+	{
+		EGL_CONTEXT_MAJOR_VERSION, 4,
+		EGL_CONTEXT_MINOR_VERSION, 5,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttribs);
+	if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+	{
+		return (false);
+	}
+
+	return (gladLoadGLLoader((GLADloadproc)eglGetProcAddress) != 0);
+}
+
+/**
+ * Runs Assets/Shaders/terrain_cull.comp the way TerrainRenderer_CullPatchesGPU does over a grid
+ * of slots, some empty, and checks the compacted list against TerrainPatchBounds_Cull, then that
+ * glMultiDrawElementsIndirectCount draws exactly the commands the shader counted.
+ * Run from the repository root, the shader is loaded from Assets/.
+ */
+int main(int argc, char* argv[])
+{
+	MemoryManager memoryManager;
+	if (!MemoryManager_Initialize(&memoryManager))
+	{
+		syserr("Failed to Initialize Memory Manager");
+		return (EXIT_FAILURE);
+	}
+
+	if (!TerrainCullGPUTest_CreateContext() || !IsGLVersionHigher(4, 5))
+	{
+		syslog("TerrainCullGPUTest: no GL 4.5 context, skipped");
+		return (CULL_TEST_SKIP);
+	}
+	syslog("TerrainCullGPUTest: %s, %s", (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+	CULL_TEST_CHECK(IndirectBufferObject_HasDrawCount());
+
+	const uint32_t slotCount = CULL_TEST_SIDE * CULL_TEST_SIDE;
+	const uint32_t commandCount = slotCount * TERRAIN_PATCH_COUNT;
+
+	GLShader pCullShader = NULL;
+	CULL_TEST_CHECK(Shader_Initialize(&pCullShader, "Terrain Cull Shader"));
+	Shader_SetInjection(pCullShader, true);
+	Shader_AttachShader(pCullShader, "Assets/Shaders/terrain_cull.comp");
+	Shader_LinkProgram(pCullShader);
+
+	ShaderStorageBufferObject pBoundsSSBO = NULL;
+	ShaderStorageBufferObject pCommandsSSBO = NULL;
+	ShaderStorageBufferObject pDrawCountSSBO = NULL;
+	ShaderStorageBufferObject pOccludedSSBO = NULL;
+	IndirectBufferObject pIndirectBuffer = NULL;
+	UniformBufferObject pCameraUBO = NULL;
+	CULL_TEST_CHECK(ShaderStorageBufferObject_Initialize(&pBoundsSSBO, commandCount * sizeof(SPatchGPUBounds), SSBO_BP_CULL_BOUNDS, "Cull Bounds SSBO"));
+	CULL_TEST_CHECK(ShaderStorageBufferObject_Initialize(&pCommandsSSBO, commandCount * sizeof(SIndirectDrawCommand), SSBO_BP_CULL_COMMANDS, "Cull Commands SSBO"));
+	CULL_TEST_CHECK(ShaderStorageBufferObject_Initialize(&pDrawCountSSBO, 5 * sizeof(GLuint), SSBO_BP_CULL_DRAW_COUNT, "Draw Count SSBO"));
+	CULL_TEST_CHECK(ShaderStorageBufferObject_Initialize(&pOccludedSSBO, commandCount * sizeof(GLuint), SSBO_BP_CULL_OCCLUDED, "Occluded SSBO"));
+	CULL_TEST_CHECK(IndirectBufferObject_Initialize(&pIndirectBuffer, commandCount));
+	CULL_TEST_CHECK(UniformBufferObject_Initialize(&pCameraUBO, 4 * sizeof(Matrix4), UBO_BP_CAMERA, "Camera UBO"));
+
+	STerrainPatchBounds patchBounds;
+	CULL_TEST_CHECK(TerrainPatchBounds_Initialize(&patchBounds, commandCount));
+
+	SIndirectDrawCommand* pCommands = engine_new_zero(SIndirectDrawCommand, commandCount, MEM_TAG_RENDERING);
+	SIndirectDrawCommand* pGPUCommands = (SIndirectDrawCommand*)pCommandsSSBO->pBufferData;
+	SPatchGPUBounds* pGPUBounds = (SPatchGPUBounds*)pBoundsSSBO->pBufferData;
+	CULL_TEST_CHECK(pCommands && pGPUCommands && pGPUBounds);
+
+	// Slots laid out around the origin, one terrain each, patch heights vary so the boxes differ
+	uint32_t residentCount = 0;
+	for (uint32_t iSlot = 0; iSlot < slotCount; iSlot++)
+	{
+		int32_t iTerrainX = (int32_t)(iSlot % CULL_TEST_SIDE) - CULL_TEST_SIDE / 2;
+		int32_t iTerrainZ = (int32_t)(iSlot / CULL_TEST_SIDE) - CULL_TEST_SIDE / 2;
+
+		for (uint32_t iPatch = 0; iPatch < TERRAIN_PATCH_COUNT; iPatch++)
+		{
+			uint32_t index = iSlot * TERRAIN_PATCH_COUNT + iPatch;
+			if (iSlot % CULL_TEST_EMPTY_EVERY == 3)
+			{
+				TerrainPatchBounds_SetEmpty(&patchBounds, index);
+				memset(&pGPUCommands[index], 0, sizeof(SIndirectDrawCommand));
+				continue;
+			}
+
+			float fMinX = (float)(iTerrainX * TERRAIN_XSIZE) + (float)((iPatch % PATCH_XCOUNT) * PATCH_XSIZE * ENGINE_CELL_SIZE);
+			float fMinZ = (float)(iTerrainZ * TERRAIN_ZSIZE) + (float)((iPatch / PATCH_XCOUNT) * PATCH_ZSIZE * ENGINE_CELL_SIZE);
+			Vector3 v3Min = Vector3D(fMinX, 0.0f, fMinZ);
+			Vector3 v3Max = Vector3D(fMinX + PATCH_XSIZE * ENGINE_CELL_SIZE, 40.0f + (float)(iPatch % 5), fMinZ + PATCH_ZSIZE * ENGINE_CELL_SIZE);
+			TerrainPatchBounds_Set(&patchBounds, index, v3Min, v3Max);
+
+			SIndirectDrawCommand command = { CULL_TEST_INDEX_COUNT, 1, 0, 0, index };
+			pCommands[index] = command;
+			pGPUCommands[index] = command;
+
+			SPatchGPUBounds gpuBounds = { { v3Min.x, v3Min.y, v3Min.z, 0.0f }, { v3Max.x, v3Max.y, v3Max.z, 0.0f } };
+			pGPUBounds[index] = gpuBounds;
+			residentCount++;
+		}
+	}
+
+	SPersProjInfo projInfo = { 45.0f, 1920.0f, 1080.0f, 0.1f, 10000.0f };
+	Matrix4 viewProjection = Matrix4_Mul(PerspectiveRH(projInfo), LookAtRH(Vector3D(0.0f, 60.0f, 0.0f), Vector3D(300.0f, 0.0f, 200.0f), Vector3D(0.0f, 1.0f, 0.0f)));
+	UniformBufferObject_Update(pCameraUBO, &viewProjection, sizeof(Matrix4), 2 * sizeof(Matrix4), false);
+	UniformBufferObject_Bind(pCameraUBO);
+
+	// CPU reference, TerrainRenderer_CullPatches with TERRAIN_CULL_CPU
+	uint32_t* pExpected = engine_new_zero(uint32_t, commandCount, MEM_TAG_RENDERING);
+	CULL_TEST_CHECK(pExpected);
+	SFrustum frustum = Frustum_FromViewProjection(viewProjection);
+	uint32_t candidateCount = TerrainPatchBounds_Cull(&patchBounds, &frustum, pExpected);
+	uint32_t expectedCount = 0;
+	for (uint32_t i = 0; i < candidateCount; i++)
+	{
+		if (pCommands[pExpected[i]].count > 0)
+		{
+			pExpected[expectedCount++] = pExpected[i];
+		}
+	}
+
+	// Same sequence as TerrainRenderer_CullPatchesGPU, without occlusion
+	static const GLuint zeroCounts[5] = { 0, 0, 0, 0, 0 };
+	ShaderStorageBufferObject_Update(pDrawCountSSBO, zeroCounts, sizeof(zeroCounts), 0, false);
+	ShaderStorageBufferObject_Bind(pBoundsSSBO);
+	ShaderStorageBufferObject_Bind(pCommandsSSBO);
+	ShaderStorageBufferObject_Bind(pDrawCountSSBO);
+	ShaderStorageBufferObject_Bind(pOccludedSSBO);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SSBO_BP_CULL_VISIBLE_COMMANDS, pIndirectBuffer->bufferID);
+	Shader_SetInt(pCullShader, "u_hizLevelCount", 0);
+	Shader_SetInt(pCullShader, "u_cullPass", 0);
+	Shader_UseProgram(pCullShader);
+	glDispatchCompute((commandCount + TERRAIN_CULL_GROUP_SIZE - 1) / TERRAIN_CULL_GROUP_SIZE, 1, 1);
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+	GLuint counts[5] = { 0 };
+	glGetNamedBufferSubData(pDrawCountSSBO->bufferID, 0, sizeof(counts), counts);
+	syslog("TerrainCullGPUTest: %u patches, resident %u/%u, visible cpu %u gpu %u", commandCount, counts[1], residentCount, expectedCount, counts[0]);
+	CULL_TEST_CHECK(counts[1] == residentCount);
+	CULL_TEST_CHECK(counts[0] == expectedCount);
+	CULL_TEST_CHECK(counts[2] == expectedCount * (CULL_TEST_INDEX_COUNT / 3));
+
+	// The shader appends in any order, baseInstance is the patch index
+	SIndirectDrawCommand* pVisible = engine_new_zero(SIndirectDrawCommand, commandCount, MEM_TAG_RENDERING);
+	uint32_t* pVisibleIndices = engine_new_zero(uint32_t, commandCount, MEM_TAG_RENDERING);
+	CULL_TEST_CHECK(pVisible && pVisibleIndices);
+	glGetNamedBufferSubData(pIndirectBuffer->bufferID, 0, counts[0] * sizeof(SIndirectDrawCommand), pVisible);
+	for (uint32_t i = 0; i < counts[0]; i++)
+	{
+		pVisibleIndices[i] = pVisible[i].baseInstance;
+	}
+	qsort(pVisibleIndices, counts[0], sizeof(uint32_t), TerrainCullGPUTest_CompareIndices);
+	CULL_TEST_CHECK(memcmp(pVisibleIndices, pExpected, expectedCount * sizeof(uint32_t)) == 0);
+
+	// The draw takes its count from the buffer, one point per index so the primitives give the commands drawn
+	const char* szVertexSource = "#version 450 core\nvoid main() { gl_Position = vec4(0.0, 0.0, 0.0, 1.0); gl_PointSize = 1.0; }";
+	const char* szFragmentSource = "#version 450 core\nvoid main() { }";
+	GLuint drawProgram = glCreateProgram();
+	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(vertexShader, 1, &szVertexSource, NULL);
+	glShaderSource(fragmentShader, 1, &szFragmentSource, NULL);
+	glCompileShader(vertexShader);
+	glCompileShader(fragmentShader);
+	glAttachShader(drawProgram, vertexShader);
+	glAttachShader(drawProgram, fragmentShader);
+	glLinkProgram(drawProgram);
+	glUseProgram(drawProgram);
+
+	static const GLuint indices[CULL_TEST_INDEX_COUNT] = { 0, 1, 2, 3, 4, 5 };
+	GLuint vao = 0, ebo = 0, fbo = 0;
+	glCreateVertexArrays(1, &vao);
+	glCreateBuffers(1, &ebo);
+	glNamedBufferStorage(ebo, sizeof(indices), indices, 0);
+	glVertexArrayElementBuffer(vao, ebo);
+	glBindVertexArray(vao);
+
+	glCreateFramebuffers(1, &fbo);
+	glNamedFramebufferParameteri(fbo, GL_FRAMEBUFFER_DEFAULT_WIDTH, 4);
+	glNamedFramebufferParameteri(fbo, GL_FRAMEBUFFER_DEFAULT_HEIGHT, 4);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glViewport(0, 0, 4, 4);
+
+	GLuint query = 0;
+	glGenQueries(1, &query);
+	glBeginQuery(GL_PRIMITIVES_GENERATED, query);
+	IndirectBufferObject_DrawCount(pIndirectBuffer, GL_POINTS, pDrawCountSSBO->bufferID, 0, (GLsizei)commandCount);
+	glEndQuery(GL_PRIMITIVES_GENERATED);
+	GLuint primitiveCount = 0;
+	glGetQueryObjectuiv(query, GL_QUERY_RESULT, &primitiveCount);
+	syslog("TerrainCullGPUTest: draw count primitives %u, expected %u", primitiveCount, counts[0] * CULL_TEST_INDEX_COUNT);
+	CULL_TEST_CHECK(primitiveCount == counts[0] * CULL_TEST_INDEX_COUNT);
+
+	GLenum glError = glGetError();
+	CULL_TEST_CHECK(glError == GL_NO_ERROR);
+
+	glDeleteQueries(1, &query);
+	glDeleteFramebuffers(1, &fbo);
+	glDeleteBuffers(1, &ebo);
+	glDeleteVertexArrays(1, &vao);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+	glDeleteProgram(drawProgram);
+
+	engine_delete(pVisibleIndices);
+	engine_delete(pVisible);
+	engine_delete(pExpected);
+	engine_delete(pCommands);
+	TerrainPatchBounds_Destroy(&patchBounds);
+	UniformBufferObject_Destroy(&pCameraUBO);
+	IndirectBufferObject_Destroy(&pIndirectBuffer);
+	ShaderStorageBufferObject_Destroy(&pOccludedSSBO);
+	ShaderStorageBufferObject_Destroy(&pDrawCountSSBO);
+	ShaderStorageBufferObject_Destroy(&pCommandsSSBO);
+	ShaderStorageBufferObject_Destroy(&pBoundsSSBO);
+	Shader_Destroy(&pCullShader);
+
+	MemoryManager_DumpLeaks();
+	MemoryManager_Destroy(&memoryManager);
+
+	syslog("TerrainCullGPUTest: passed");
+	return (EXIT_SUCCESS);
+}
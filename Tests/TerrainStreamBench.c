@@ -0,0 +1,211 @@
+#if !defined(_WIN32) && !defined(_WIN64) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L // nanosleep with CMAKE_C_EXTENSIONS OFF
+#endif
+
+#include "Stdafx.h"
+#include "Terrain/TerrainMap/TerrainMap.h"
+#include "Terrain/TerrainPatch.h"
+#include "Terrain/TerrainStreamer/TerrainStreamer.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define STREAM_BENCH_DEFAULT_MAP "StreamBench"
+#define STREAM_BENCH_DEFAULT_SIZE 32			// Terrains on each side of the synthetic map
+#define STREAM_BENCH_DEFAULT_SPEED 400.0f		// World units per second
+#define STREAM_BENCH_FRAME_MS 16.6
+#define STREAM_BENCH_UPLOAD_MS 2.0				// Same budget the engine gives TerrainManager_UploadLoadedTerrains
+#define STREAM_BENCH_HITCH_MS 4.0
+#define STREAM_BENCH_SETTLE_FRAMES 120			// Frames at the end of the path so pending loads land
+
+// No GL context here, the terrain ring fences are never waited on so dummy syncs are enough
+static GLsync StreamBench_FenceSync(GLenum condition, GLbitfield flags)
+{
+	return ((GLsync)1);
+}
+
+static void StreamBench_DeleteSync(GLsync sync)
+{
+}
+
+static void StreamBench_Sleep(double ms)
+{
+	if (ms <= 0.0)
+	{
+		return;
+	}
+#if defined(_WIN32) || defined(_WIN64)
+	Sleep((DWORD)ms);
+#else
+	struct timespec ts = { 0, (long)(ms * 1000000.0) };
+	nanosleep(&ts, NULL);
+#endif
+}
+
+/**
+ * Flies the camera across a synthetic map at a fixed speed, with a teleport half way,
+ * and reports streaming hitches, holes around the camera and resident terrain memory.
+ *
+ * TerrainStreamBench [mapName] [mapSize] [radius] [speed], run from the repository root,
+ * the map is created under Assets/Maps/ the first time.
+ */
+int main(int argc, char* argv[])
+{
+	char* szMapName = (argc > 1) ? argv[1] : STREAM_BENCH_DEFAULT_MAP;
+	int32_t mapSize = (argc > 2) ? atoi(argv[2]) : STREAM_BENCH_DEFAULT_SIZE;
+	int32_t radius = (argc > 3) ? atoi(argv[3]) : TERRAIN_STREAM_DEFAULT_RADIUS;
+	float speed = (argc > 4) ? (float)atof(argv[4]) : STREAM_BENCH_DEFAULT_SPEED;
+
+	MemoryManager memoryManager;
+	if (!MemoryManager_Initialize(&memoryManager))
+	{
+		syserr("Failed to Initialize Memory Manager");
+		return (EXIT_FAILURE);
+	}
+
+	FrameAllocator frameAllocator;
+	if (!FrameAllocator_Initialize(&frameAllocator, FRAME_ARENA_DEFAULT_SIZE))
+	{
+		syserr("Failed to Initialize Frame Allocator");
+		return (EXIT_FAILURE);
+	}
+
+	JobSystem jobSystem;
+	if (!JobSystem_Initialize(&jobSystem, 0))
+	{
+		syserr("Failed to Initialize Job System");
+		return (EXIT_FAILURE);
+	}
+
+	glad_glFenceSync = StreamBench_FenceSync;
+	glad_glDeleteSync = StreamBench_DeleteSync;
+
+	TerrainMap pTerrainMap = NULL;
+	if (!TerrainMap_Initialize(&pTerrainMap))
+	{
+		return (EXIT_FAILURE);
+	}
+
+	size_t baseUsage = MemoryManager_GetTagUsage(MEM_TAG_TERRAIN);
+	if (!TerrainMap_OpenMap(pTerrainMap, szMapName))
+	{
+		syslog("Creating %dx%d map %s", mapSize, mapSize, szMapName);
+		if (!TerrainMap_CreateMap(szMapName, mapSize, mapSize) || !TerrainMap_OpenMap(pTerrainMap, szMapName))
+		{
+			syserr("Failed to Open Map %s", szMapName);
+			return (EXIT_FAILURE);
+		}
+	}
+	mapSize = pTerrainMap->terrainsXCount;
+
+	TerrainStreamer pStreamer = NULL;
+	if (!TerrainStreamer_Initialize(&pStreamer, pTerrainMap, radius))
+	{
+		return (EXIT_FAILURE);
+	}
+
+	const float deltaTime = (float)(STREAM_BENCH_FRAME_MS / 1000.0);
+	int32_t flyFrames = (int32_t)((TERRAIN_XSIZE * (mapSize - 1)) / (speed * deltaTime));
+	Vector3 v3Camera = Vector3D(TERRAIN_XSIZE * 0.5f, 0.0f, TERRAIN_ZSIZE * mapSize * 0.5f);
+
+	double worstMs = 0.0;
+	int32_t hitchCount = 0;
+	int32_t holeFrames = 0;
+	int64_t holeCount = 0;
+	size_t peakUsage = 0;
+
+	int32_t frameCount = flyFrames + STREAM_BENCH_SETTLE_FRAMES;
+	for (int32_t frame = 0; frame < frameCount; frame++)
+	{
+		FrameAllocator_BeginFrame();
+
+		if (frame == flyFrames / 2)
+		{
+			v3Camera.z = TERRAIN_ZSIZE * mapSize * 0.25f;
+		}
+		if (frame < flyFrames)
+		{
+			v3Camera.x += speed * deltaTime;
+		}
+
+		double startMs = JobSystem_GetTimeMs();
+		TerrainStreamer_Update(pStreamer, v3Camera, deltaTime);
+
+		// Same slot handling as TerrainManager_UploadLoadedTerrains, minus the GL upload
+		double deadline = startMs + STREAM_BENCH_UPLOAD_MS;
+		do
+		{
+			Terrain pTerrain = TerrainMap_PopBuiltTerrain(pTerrainMap);
+			if (!pTerrain)
+			{
+				break;
+			}
+
+			if (TerrainStreamer_AcquireSlot(pStreamer, pTerrain) < 0)
+			{
+				TerrainMap_UnloadTerrain(pTerrainMap, pTerrain->terrainXCoord, pTerrain->terrainZCoord);
+			}
+		} while (JobSystem_GetTimeMs() < deadline);
+
+		double frameMs = JobSystem_GetTimeMs() - startMs;
+		if (frameMs > worstMs)
+		{
+			worstMs = frameMs;
+		}
+		if (frameMs > STREAM_BENCH_HITCH_MS)
+		{
+			hitchCount++;
+		}
+
+		// Holes, terrains right around the camera that are not resident yet
+		int32_t iCameraX = (int32_t)(v3Camera.x / TERRAIN_XSIZE);
+		int32_t iCameraZ = (int32_t)(v3Camera.z / TERRAIN_ZSIZE);
+		int32_t frameHoles = 0;
+		for (int32_t iTerrainZ = iCameraZ - 1; iTerrainZ <= iCameraZ + 1; iTerrainZ++)
+		{
+			for (int32_t iTerrainX = iCameraX - 1; iTerrainX <= iCameraX + 1; iTerrainX++)
+			{
+				if (iTerrainX >= 0 && iTerrainZ >= 0 && iTerrainX < mapSize && iTerrainZ < mapSize && !TerrainMap_GetTerrain(pTerrainMap, iTerrainX, iTerrainZ))
+				{
+					frameHoles++;
+				}
+			}
+		}
+		holeCount += frameHoles;
+		if (frameHoles > 0)
+		{
+			holeFrames++;
+		}
+
+		size_t usage = MemoryManager_GetTagUsage(MEM_TAG_TERRAIN) - baseUsage;
+		if (usage > peakUsage)
+		{
+			peakUsage = usage;
+		}
+
+		StreamBench_Sleep(STREAM_BENCH_FRAME_MS - frameMs);
+	}
+
+	STerrainStreamerStats stats;
+	TerrainStreamer_GetStats(pStreamer, &stats);
+	syslog("map %dx%d, radius %d, speed %.0f u/s, %d frames", mapSize, mapSize, radius, speed, frameCount);
+	syslog("  worst %.3f ms, hitches (> %.0f ms) %d, hole frames %d, holes %lld", worstMs, STREAM_BENCH_HITCH_MS, hitchCount, holeFrames, (long long)holeCount);
+	syslog("  slots %u, resident %u, requests %llu, evictions %llu, dropped %llu", stats.slotCount, stats.residentCount,
+		(unsigned long long)stats.requestCount, (unsigned long long)stats.evictionCount, (unsigned long long)stats.droppedCount);
+	syslog("  peak resident terrain memory %.1f MB", peakUsage / 1048576.0);
+
+	TerrainStreamer_Destroy(&pStreamer);
+	TerrainMap_Destroy(&pTerrainMap);
+
+	TerrainPatch_DestroyPool();
+	TerrainMesh_DestroyPool();
+
+	JobSystem_Destroy(&jobSystem);
+	FrameAllocator_Destroy(&frameAllocator);
+	MemoryManager_Destroy(&memoryManager);
+
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,128 @@
+#include "Stdafx.h"
+#include "Resources/TexturesManager.h"
+
+#define TEXTURES_BENCH_KEY_SIZE 64
+#define TEXTURES_BENCH_DEFAULT_LOOKUPS 1000000
+#define TEXTURES_BENCH_REPEATS 3			// Best of, the box is noisy
+
+static volatile uintptr_t s_iBenchSink = 0;
+
+/**
+ * Fills the manager with MAX_ENGINE_TEXTURES in-memory textures (no GL objects) and times
+ * name lookups, handle lookups, stale handle rejection and the dense walk, in ns per op.
+ *
+ * TexturesManagerBench [lookups], default 1M.
+ */
+int main(int argc, char* argv[])
+{
+	MemoryManager memoryManager;
+	if (!MemoryManager_Initialize(&memoryManager))
+	{
+		syserr("Failed to Initialize Memory Manager");
+		return (EXIT_FAILURE);
+	}
+
+	// Tracking is not what is measured here
+	MemoryManager_SetTrackingLevel(MEMORY_TRACKING_LEVEL_COUNTERS);
+
+	uint32_t lookupCount = (argc > 1) ? (uint32_t)atoi(argv[1]) : TEXTURES_BENCH_DEFAULT_LOOKUPS;
+
+	TexturesManager pTexturesManager = NULL;
+	if (!TexturesManager_Initialize(&pTexturesManager))
+	{
+		return (EXIT_FAILURE);
+	}
+
+	static char szKeys[MAX_ENGINE_TEXTURES][TEXTURES_BENCH_KEY_SIZE];
+	static TextureHandle handles[MAX_ENGINE_TEXTURES];
+	for (uint32_t i = 0; i < MAX_ENGINE_TEXTURES; i++)
+	{
+		snprintf(szKeys[i], sizeof(szKeys[i]), "Assets/Textures/Terrain/texture_%03u.png", i);
+
+		Texture pTexture = NULL;
+		if (!Texture_Initialize(&pTexture))
+		{
+			return (EXIT_FAILURE);
+		}
+
+		handles[i] = TexturesManager_Register(szKeys[i], pTexture);
+		if (handles[i] == TEXTURE_HANDLE_INVALID)
+		{
+			syserr("Failed to Register %s", szKeys[i]);
+			return (EXIT_FAILURE);
+		}
+	}
+
+	// A released and re-registered slot, its old handle has to be rejected
+	TextureHandle staleHandle = handles[0];
+	TexturesManager_Release(&handles[0]);
+	Texture pTexture = NULL;
+	if (!Texture_Initialize(&pTexture))
+	{
+		return (EXIT_FAILURE);
+	}
+	handles[0] = TexturesManager_Register(szKeys[0], pTexture);
+
+	bool bPassed = true;
+	double best[4] = { 1e30, 1e30, 1e30, 1e30 };
+	for (int32_t repeat = 0; repeat < TEXTURES_BENCH_REPEATS; repeat++)
+	{
+		double startMs = JobSystem_GetTimeMs();
+		for (uint32_t i = 0; i < lookupCount; i++)
+		{
+			s_iBenchSink += TexturesManager_Find(szKeys[(i * 37) % MAX_ENGINE_TEXTURES]);
+		}
+		double findMs = JobSystem_GetTimeMs();
+		for (uint32_t i = 0; i < lookupCount; i++)
+		{
+			s_iBenchSink += (uintptr_t)TexturesManager_Get(handles[(i * 37) % MAX_ENGINE_TEXTURES]);
+		}
+		double getMs = JobSystem_GetTimeMs();
+		for (uint32_t i = 0; i < lookupCount; i++)
+		{
+			s_iBenchSink += (uintptr_t)TexturesManager_Get(staleHandle);
+		}
+		double staleMs = JobSystem_GetTimeMs();
+
+		// Dense walk, what GatherResidentHandles does every frame
+		uint32_t walks = lookupCount / MAX_ENGINE_TEXTURES;
+		for (uint32_t walk = 0; walk < walks; walk++)
+		{
+			STextureEntry* pEntries = TexturesManager_GetEntries();
+			uint32_t count = TexturesManager_GetCount();
+			for (uint32_t i = 0; i < count; i++)
+			{
+				s_iBenchSink += pEntries[i].textureID + pEntries[i].isResident;
+			}
+		}
+		double walkMs = JobSystem_GetTimeMs();
+
+		best[0] = (findMs - startMs < best[0]) ? findMs - startMs : best[0];
+		best[1] = (getMs - findMs < best[1]) ? getMs - findMs : best[1];
+		best[2] = (staleMs - getMs < best[2]) ? staleMs - getMs : best[2];
+		best[3] = (walkMs - staleMs < best[3]) ? walkMs - staleMs : best[3];
+	}
+
+	for (uint32_t i = 0; i < MAX_ENGINE_TEXTURES; i++)
+	{
+		bPassed = bPassed && TexturesManager_Find(szKeys[i]) == handles[i] && TexturesManager_Get(handles[i]) != NULL;
+	}
+	bPassed = bPassed && TexturesManager_Get(staleHandle) == NULL && TexturesManager_GetCount() == MAX_ENGINE_TEXTURES;
+
+	double nsPerOp = 1000000.0 / lookupCount;
+	syslog("%u textures, %u lookups (ns/op)", MAX_ENGINE_TEXTURES, lookupCount);
+	syslog("  Find by name      %6.1f", best[0] * nsPerOp);
+	syslog("  Get by handle     %6.1f", best[1] * nsPerOp);
+	syslog("  Get stale handle  %6.1f", best[2] * nsPerOp);
+	syslog("  dense walk        %6.1f per entry", best[3] * nsPerOp);
+
+	TexturesManager_Destroy(&pTexturesManager);
+	MemoryManager_Destroy(&memoryManager);
+
+	if (!bPassed)
+	{
+		syserr("TexturesManagerBench: a lookup returned the wrong texture");
+		return (EXIT_FAILURE);
+	}
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,126 @@
+#include "Stdafx.h"
+#include "Terrain/TerrainMap/TerrainMap.h"
+#include "Terrain/TerrainPatch.h"
+
+#define TRACKING_BENCH_DEFAULT_MAP "TrackingBench"
+#define TRACKING_BENCH_DEFAULT_SIZE 8		// Terrains on each side of the synthetic map
+#define TRACKING_BENCH_REPEATS 3			// Best of, the first load also warms the page cache
+
+// No GL context here, the terrain ring fences are never waited on so dummy syncs are enough
+static GLsync TrackingBench_FenceSync(GLenum condition, GLbitfield flags)
+{
+	return ((GLsync)1);
+}
+
+static void TrackingBench_DeleteSync(GLsync sync)
+{
+}
+
+/**
+ * Loads and unloads a whole map under each memory tracking level, OFF up to MEMORY_TRACKING_MAX_LEVEL,
+ * and reports the load time, the unload time and the live blocks the loaded map holds.
+ *
+ * TrackingLevelBench [mapName] [mapSize], run from the repository root,
+ * the map is created under Assets/Maps/ the first time.
+ */
+int main(int argc, char* argv[])
+{
+	char* szMapName = (argc > 1) ? argv[1] : TRACKING_BENCH_DEFAULT_MAP;
+	int32_t mapSize = (argc > 2) ? atoi(argv[2]) : TRACKING_BENCH_DEFAULT_SIZE;
+
+	MemoryManager memoryManager;
+	if (!MemoryManager_Initialize(&memoryManager))
+	{
+		syserr("Failed to Initialize Memory Manager");
+		return (EXIT_FAILURE);
+	}
+
+	FrameAllocator frameAllocator;
+	if (!FrameAllocator_Initialize(&frameAllocator, FRAME_ARENA_DEFAULT_SIZE))
+	{
+		syserr("Failed to Initialize Frame Allocator");
+		return (EXIT_FAILURE);
+	}
+
+	JobSystem jobSystem;
+	if (!JobSystem_Initialize(&jobSystem, 0))
+	{
+		syserr("Failed to Initialize Job System");
+		return (EXIT_FAILURE);
+	}
+
+	glad_glFenceSync = TrackingBench_FenceSync;
+	glad_glDeleteSync = TrackingBench_DeleteSync;
+
+	char szMapPath[MAX_STRING_LEN] = { 0 };
+	snprintf(szMapPath, sizeof(szMapPath), "%s%s", terrainMapsFolder, szMapName);
+	if (!IsDirectoryExists(szMapPath))
+	{
+		syslog("Creating %dx%d map %s", mapSize, mapSize, szMapName);
+		if (!TerrainMap_CreateMap(szMapName, mapSize, mapSize))
+		{
+			syserr("Failed to Create Map %s", szMapName);
+			return (EXIT_FAILURE);
+		}
+	}
+
+	static const char* levelNames[] = { "off", "counters", "sampled", "full" };
+
+	for (int32_t level = MEMORY_TRACKING_LEVEL_OFF; level <= MEMORY_TRACKING_LEVEL_FULL; level++)
+	{
+		MemoryManager_SetTrackingLevel((EMemoryTrackingLevel)level);
+		if (MemoryManager_GetTrackingLevel() != (EMemoryTrackingLevel)level)
+		{
+			syslog("%-8s  not compiled in (AERO_MEMORY_TRACKING_LEVEL)", levelNames[level]);
+			continue;
+		}
+
+		double bestLoadMs = 1e30;
+		double bestUnloadMs = 1e30;
+		uint64_t liveBlocks = 0;
+		for (int32_t repeat = 0; repeat < TRACKING_BENCH_REPEATS; repeat++)
+		{
+			TerrainMap pTerrainMap = NULL;
+			if (!TerrainMap_Initialize(&pTerrainMap))
+			{
+				return (EXIT_FAILURE);
+			}
+
+			SMemoryStats before;
+			MemoryManager_GetStats(&before);
+
+			double startMs = JobSystem_GetTimeMs();
+			if (!TerrainMap_LoadMap(pTerrainMap, szMapName))
+			{
+				syserr("Failed to Load Map %s", szMapName);
+				return (EXIT_FAILURE);
+			}
+			double loadMs = JobSystem_GetTimeMs() - startMs;
+
+			SMemoryStats after;
+			MemoryManager_GetStats(&after);
+
+			startMs = JobSystem_GetTimeMs();
+			TerrainMap_Destroy(&pTerrainMap);
+			double unloadMs = JobSystem_GetTimeMs() - startMs;
+
+			bestLoadMs = (loadMs < bestLoadMs) ? loadMs : bestLoadMs;
+			bestUnloadMs = (unloadMs < bestUnloadMs) ? unloadMs : bestUnloadMs;
+			liveBlocks = after.allocationCount - before.allocationCount;
+		}
+
+		// OFF counts nothing, the live blocks only show for the tracked levels
+		syslog("%-8s  load %8.2f ms  unload %7.2f ms  live blocks %llu", levelNames[level], bestLoadMs, bestUnloadMs, (unsigned long long)liveBlocks);
+	}
+
+	MemoryManager_SetTrackingLevel(MEMORY_TRACKING_LEVEL_FULL);
+
+	TerrainPatch_DestroyPool();
+	TerrainMesh_DestroyPool();
+
+	JobSystem_Destroy(&jobSystem);
+	FrameAllocator_Destroy(&frameAllocator);
+	MemoryManager_Destroy(&memoryManager);
+
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,141 @@
+#include "Stdafx.h"
+#include "AeroLib/UnorderedMap.h"
+
+#define MAP_BENCH_KEY_SIZE 16		// 12 char keys plus the terminator, padded
+#define MAP_BENCH_MIN_COUNT 1000
+#define MAP_BENCH_MAX_COUNT 1000000
+#define MAP_BENCH_REPEATS 3			// Best of, the box is noisy
+
+static volatile uintptr_t s_iBenchSink = 0;
+
+static uint32_t UnorderedMapBench_Random(uint32_t* pState)
+{
+	// xorshift32, only used to shuffle the lookup order
+	uint32_t x = *pState;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*pState = x;
+	return (x);
+}
+
+static double UnorderedMapBench_Min(double a, double b)
+{
+	return ((a < b) ? a : b);
+}
+
+// String keys, then integer keys, insert / find (shuffled) / remove in ns per op, 1k..argv[1] (default 1M) keys
+int main(int argc, char* argv[])
+{
+	MemoryManager memoryManager;
+	if (!MemoryManager_Initialize(&memoryManager))
+	{
+		syserr("Failed to Initialize Memory Manager");
+		return (EXIT_FAILURE);
+	}
+
+	// Tracking is not what is measured here
+	MemoryManager_SetTrackingLevel(MEMORY_TRACKING_LEVEL_COUNTERS);
+
+	uint32_t maxCount = (argc > 1) ? (uint32_t)atoi(argv[1]) : MAP_BENCH_MAX_COUNT;
+
+	char* pKeys = (char*)engine_malloc((size_t)maxCount * MAP_BENCH_KEY_SIZE, MEM_TAG_ENGINE);
+	uint32_t* pOrder = engine_new_zero(uint32_t, maxCount, MEM_TAG_ENGINE);
+	if (!pKeys || !pOrder)
+	{
+		syserr("Failed to Allocate %u benchmark keys", maxCount);
+		return (EXIT_FAILURE);
+	}
+
+	uint32_t seed = 0x9E3779B9;
+	for (uint32_t i = 0; i < maxCount; i++)
+	{
+		snprintf(pKeys + (size_t)i * MAP_BENCH_KEY_SIZE, MAP_BENCH_KEY_SIZE, "key%09u", i);
+		pOrder[i] = i;
+	}
+
+	syslog("      keys   str insert   str find  str remove   int insert   int find  int remove  (ns/op)");
+	for (uint32_t count = MAP_BENCH_MIN_COUNT; count <= maxCount; count *= 10)
+	{
+		for (uint32_t i = count - 1; i > 0; i--)
+		{
+			uint32_t j = UnorderedMapBench_Random(&seed) % (i + 1);
+			uint32_t swap = pOrder[i];
+			pOrder[i] = pOrder[j];
+			pOrder[j] = swap;
+		}
+
+		double best[6] = { 1e30, 1e30, 1e30, 1e30, 1e30, 1e30 };
+		for (int32_t repeat = 0; repeat < MAP_BENCH_REPEATS; repeat++)
+		{
+			AeroUnorderedMap strMap = NULL;
+			AeroUnorderedMap intMap = NULL;
+			if (!UnorderedMap_Initialize(&strMap, MEM_TAG_ENGINE) || !UnorderedMap_InitializeWithKeys(&intMap, UNORDERED_MAP_KEY_INT, MEM_TAG_ENGINE))
+			{
+				syserr("Failed to Initialize UnorderedMap");
+				return (EXIT_FAILURE);
+			}
+
+			double startMs = JobSystem_GetTimeMs();
+			for (uint32_t i = 0; i < count; i++)
+			{
+				UnorderedMap_Insert(strMap, pKeys + (size_t)i * MAP_BENCH_KEY_SIZE, (void*)(uintptr_t)(i + 1));
+			}
+			double insertMs = JobSystem_GetTimeMs();
+			for (uint32_t i = 0; i < count; i++)
+			{
+				s_iBenchSink += (uintptr_t)UnorderedMap_Find(strMap, pKeys + (size_t)pOrder[i] * MAP_BENCH_KEY_SIZE);
+			}
+			double findMs = JobSystem_GetTimeMs();
+			for (uint32_t i = 0; i < count; i++)
+			{
+				UnorderedMap_Remove(strMap, pKeys + (size_t)pOrder[i] * MAP_BENCH_KEY_SIZE);
+			}
+			double removeMs = JobSystem_GetTimeMs();
+
+			best[0] = UnorderedMapBench_Min(best[0], insertMs - startMs);
+			best[1] = UnorderedMapBench_Min(best[1], findMs - insertMs);
+			best[2] = UnorderedMapBench_Min(best[2], removeMs - findMs);
+
+			startMs = JobSystem_GetTimeMs();
+			for (uint32_t i = 0; i < count; i++)
+			{
+				UnorderedMap_InsertInt(intMap, i, (void*)(uintptr_t)(i + 1));
+			}
+			insertMs = JobSystem_GetTimeMs();
+			for (uint32_t i = 0; i < count; i++)
+			{
+				s_iBenchSink += (uintptr_t)UnorderedMap_FindInt(intMap, pOrder[i]);
+			}
+			findMs = JobSystem_GetTimeMs();
+			for (uint32_t i = 0; i < count; i++)
+			{
+				UnorderedMap_RemoveInt(intMap, pOrder[i]);
+			}
+			removeMs = JobSystem_GetTimeMs();
+
+			best[3] = UnorderedMapBench_Min(best[3], insertMs - startMs);
+			best[4] = UnorderedMapBench_Min(best[4], findMs - insertMs);
+			best[5] = UnorderedMapBench_Min(best[5], removeMs - findMs);
+
+			if (UnorderedMap_Count(strMap) != 0 || UnorderedMap_Count(intMap) != 0)
+			{
+				syserr("UnorderedMapBench: maps are not empty after removing every key");
+				return (EXIT_FAILURE);
+			}
+
+			UnoderedMap_Destroy(&strMap);
+			UnoderedMap_Destroy(&intMap);
+		}
+
+		double nsPerOp = 1000000.0 / count;
+		syslog("%10u %12.1f %10.1f %11.1f %12.1f %10.1f %11.1f", count,
+			best[0] * nsPerOp, best[1] * nsPerOp, best[2] * nsPerOp, best[3] * nsPerOp, best[4] * nsPerOp, best[5] * nsPerOp);
+	}
+
+	engine_delete(pOrder);
+	engine_delete(pKeys);
+
+	MemoryManager_Destroy(&memoryManager);
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,222 @@
+#include "Stdafx.h"
+#include "AeroLib/Vector.h"
+#include "Meshes/TerrainMesh.h"
+
+#define VECTOR_BENCH_PATCHES 64				// One terrain
+#define VECTOR_BENCH_QUADS 16				// Quads per patch side
+#define VECTOR_BENCH_ROW_INDICES (VECTOR_BENCH_QUADS * 6)
+#define VECTOR_BENCH_DEFAULT_TERRAINS 200
+#define VECTOR_BENCH_REPEATS 3				// Best of, the box is noisy
+
+typedef enum EVectorBenchMethod
+{
+	VECTOR_BENCH_ERASED_PUSH,				// Vector_PushBackValue per element, the old path
+	VECTOR_BENCH_ERASED_APPEND,				// Vector_AppendRange per index row
+	VECTOR_BENCH_TYPED_PUSH,				// AeroVector_T_PushBack per element
+	VECTOR_BENCH_TYPED_EMPLACE,				// EmplaceBack for vertices, AppendRange per index row
+	VECTOR_BENCH_METHOD_COUNT,
+} EVectorBenchMethod;
+
+static const char* s_aMethodNames[VECTOR_BENCH_METHOD_COUNT] = { "Vector_PushBackValue", "Vector_AppendRange", "typed PushBack", "typed Emplace/Append" };
+
+static STerrainVertex VectorBench_MakeVertex(int32_t x, int32_t z)
+{
+	STerrainVertex vertex;
+	memset(&vertex, 0, sizeof(vertex));
+#if TERRAIN_COMPACT_VERTEX
+	vertex.gridX = (uint16_t)x;
+	vertex.gridZ = (uint16_t)z;
+#else
+	vertex.v3Position.x = (float)x;
+	vertex.v3Position.z = (float)z;
+#endif
+	return (vertex);
+}
+
+static void VectorBench_MakeIndexRow(uint32_t row, uint32_t* pIndices)
+{
+	for (uint32_t x = 0; x < VECTOR_BENCH_QUADS; x++)
+	{
+		uint32_t topLeft = row * (VECTOR_BENCH_QUADS + 1) + x;
+		uint32_t bottomLeft = topLeft + VECTOR_BENCH_QUADS + 1;
+		uint32_t* pQuad = pIndices + x * 6;
+		pQuad[0] = topLeft;
+		pQuad[1] = bottomLeft;
+		pQuad[2] = topLeft + 1;
+		pQuad[3] = topLeft + 1;
+		pQuad[4] = bottomLeft;
+		pQuad[5] = bottomLeft + 1;
+	}
+}
+
+static uint64_t VectorBench_Checksum(const void* pData, size_t size)
+{
+	const uint8_t* pBytes = (const uint8_t*)pData;
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ pBytes[i]) * 0x100000001b3ULL;
+	}
+	return (hash);
+}
+
+// Fills one patch the way the method would, returns a checksum of what ended up in the vectors when asked
+static uint64_t VectorBench_FillPatch(EVectorBenchMethod eMethod, Vector pVertices, Vector pIndices, SAeroVector_STerrainVertex* pTypedVertices, SAeroVector_uint32_t* pTypedIndices, bool bChecksum)
+{
+	uint32_t row[VECTOR_BENCH_ROW_INDICES];
+	const STerrainVertex* pVertexData = NULL;
+	const uint32_t* pIndexData = NULL;
+	size_t vertexCount = 0;
+	size_t indexCount = 0;
+
+	if (eMethod == VECTOR_BENCH_ERASED_PUSH || eMethod == VECTOR_BENCH_ERASED_APPEND)
+	{
+		Vector_Clear(pVertices);
+		Vector_Clear(pIndices);
+		for (int32_t z = 0; z <= VECTOR_BENCH_QUADS; z++)
+		{
+			for (int32_t x = 0; x <= VECTOR_BENCH_QUADS; x++)
+			{
+				Vector_PushBackValue(pVertices, VectorBench_MakeVertex(x, z));
+			}
+		}
+		for (uint32_t z = 0; z < VECTOR_BENCH_QUADS; z++)
+		{
+			VectorBench_MakeIndexRow(z, row);
+			if (eMethod == VECTOR_BENCH_ERASED_APPEND)
+			{
+				Vector_AppendRange(pIndices, row, VECTOR_BENCH_ROW_INDICES);
+				continue;
+			}
+			for (uint32_t i = 0; i < VECTOR_BENCH_ROW_INDICES; i++)
+			{
+				Vector_PushBackValue(pIndices, row[i]);
+			}
+		}
+		pVertexData = (const STerrainVertex*)Vector_Get(pVertices, 0);
+		pIndexData = (const uint32_t*)Vector_Get(pIndices, 0);
+		vertexCount = pVertices->count;
+		indexCount = pIndices->count;
+	}
+	else
+	{
+		AeroVector_STerrainVertex_Clear(pTypedVertices);
+		AeroVector_uint32_t_Clear(pTypedIndices);
+		for (int32_t z = 0; z <= VECTOR_BENCH_QUADS; z++)
+		{
+			for (int32_t x = 0; x <= VECTOR_BENCH_QUADS; x++)
+			{
+				if (eMethod == VECTOR_BENCH_TYPED_EMPLACE)
+				{
+					*AeroVector_STerrainVertex_EmplaceBack(pTypedVertices) = VectorBench_MakeVertex(x, z);
+					continue;
+				}
+				AeroVector_STerrainVertex_PushBack(pTypedVertices, VectorBench_MakeVertex(x, z));
+			}
+		}
+		for (uint32_t z = 0; z < VECTOR_BENCH_QUADS; z++)
+		{
+			VectorBench_MakeIndexRow(z, row);
+			if (eMethod == VECTOR_BENCH_TYPED_EMPLACE)
+			{
+				AeroVector_uint32_t_AppendRange(pTypedIndices, row, VECTOR_BENCH_ROW_INDICES);
+				continue;
+			}
+			for (uint32_t i = 0; i < VECTOR_BENCH_ROW_INDICES; i++)
+			{
+				AeroVector_uint32_t_PushBack(pTypedIndices, row[i]);
+			}
+		}
+		pVertexData = pTypedVertices->pData;
+		pIndexData = pTypedIndices->pData;
+		vertexCount = pTypedVertices->count;
+		indexCount = pTypedIndices->count;
+	}
+
+	if (!bChecksum)
+	{
+		return (0);
+	}
+	return (VectorBench_Checksum(pVertexData, vertexCount * sizeof(STerrainVertex)) ^ VectorBench_Checksum(pIndexData, indexCount * sizeof(uint32_t)));
+}
+
+/**
+ * Patch mesh fill through the type-erased Vector and the typed vectors, 289 vertices and
+ * 1536 indices per patch, 64 patches per terrain. Reports us per terrain over argv[1] (default 200) terrains.
+ */
+int main(int argc, char* argv[])
+{
+	MemoryManager memoryManager;
+	if (!MemoryManager_Initialize(&memoryManager))
+	{
+		syserr("Failed to Initialize Memory Manager");
+		return (EXIT_FAILURE);
+	}
+
+	// Tracking is not what is measured here
+	MemoryManager_SetTrackingLevel(MEMORY_TRACKING_LEVEL_COUNTERS);
+
+	int32_t terrainCount = (argc > 1) ? atoi(argv[1]) : VECTOR_BENCH_DEFAULT_TERRAINS;
+
+	Vector pVertices = NULL;
+	Vector pIndices = NULL;
+	if (!Vector_Init(&pVertices, sizeof(STerrainVertex), false) || !Vector_Init(&pIndices, sizeof(uint32_t), false))
+	{
+		syserr("Failed to Initialize Vector");
+		return (EXIT_FAILURE);
+	}
+
+	SAeroVector_STerrainVertex typedVertices;
+	SAeroVector_uint32_t typedIndices;
+	AeroVector_STerrainVertex_Init(&typedVertices, MEM_TAG_ENGINE);
+	AeroVector_uint32_t_Init(&typedIndices, MEM_TAG_ENGINE);
+
+	bool bPassed = true;
+	uint64_t referenceChecksum = 0;
+	double baseUs = 0.0;
+
+	for (int32_t method = 0; method < VECTOR_BENCH_METHOD_COUNT; method++)
+	{
+		double bestMs = 1e30;
+		for (int32_t repeat = 0; repeat < VECTOR_BENCH_REPEATS; repeat++)
+		{
+			double startMs = JobSystem_GetTimeMs();
+			for (int32_t terrain = 0; terrain < terrainCount; terrain++)
+			{
+				for (int32_t patch = 0; patch < VECTOR_BENCH_PATCHES; patch++)
+				{
+					VectorBench_FillPatch((EVectorBenchMethod)method, pVertices, pIndices, &typedVertices, &typedIndices, false);
+				}
+			}
+			double elapsedMs = JobSystem_GetTimeMs() - startMs;
+			bestMs = (elapsedMs < bestMs) ? elapsedMs : bestMs;
+		}
+
+		// Every method has to leave the same patch behind
+		uint64_t checksum = VectorBench_FillPatch((EVectorBenchMethod)method, pVertices, pIndices, &typedVertices, &typedIndices, true);
+
+		double usPerTerrain = bestMs * 1000.0 / terrainCount;
+		if (method == 0)
+		{
+			referenceChecksum = checksum;
+			baseUs = usPerTerrain;
+		}
+		bPassed = bPassed && checksum == referenceChecksum;
+
+		syslog("%-22s %9.1f us/terrain  %.2fx", s_aMethodNames[method], usPerTerrain, baseUs / usPerTerrain);
+	}
+
+	AeroVector_uint32_t_Destroy(&typedIndices);
+	AeroVector_STerrainVertex_Destroy(&typedVertices);
+	Vector_Destroy(&pIndices);
+	Vector_Destroy(&pVertices);
+
+	MemoryManager_Destroy(&memoryManager);
+
+	if (!bPassed)
+	{
+		syserr("VectorBench: the methods did not produce the same patches");
+		return (EXIT_FAILURE);
+	}
+	return (EXIT_SUCCESS);
+}
@@ -4,6 +4,8 @@
 #include "PipeLine/Texture.h"
 #include "Terrain/TerrainMap/TerrainMap.h"
 #include "Terrain/Terrain/Terrain.h"
+#include "Terrain/TerrainStreamer/TerrainStreamer.h"
+#include "Renderer/TerrainCulling.h"
 #include "AeroLib/Vector.h"
 #include "Engine.h"
 
@@ -125,7 +127,7 @@ void ImGui_RenderEngineDataUI()
 
 	ImGui::BeginGroup(); // Group 2: Preview & Info
 	{
-		Texture pTex = GetTerrainManager()->terrainTex;
+		Texture pTex = TexturesManager_Get(GetTerrainManager()->terrainTex);
 		if (pTex && glIsTexture(pTex->textureID))
 		{
 			// Draw Checkerboard Background
@@ -227,6 +229,209 @@ void ImGui_RenderEngineDataUI()
 		ImGui::End();
 	}
 	ImGui::Separator();
+
+	ImGui_RenderTerrainRenderingUI();
+	ImGui_RenderMemoryBudgetsUI();
+	ImGui_RenderMemoryCallsitesUI();
+}
+
+/**
+ * @brief Renders the terrain culling and LOD switches with
+ * what they drew last frame.
+ *
+ * The toggles mirror what was last set, the stats show the
+ * cull mode actually used (GPU falls back to the CPU).
+ */
+void ImGui_RenderTerrainRenderingUI()
+{
+	if (!ImGui::CollapsingHeader("Terrain Rendering"))
+	{
+		return;
+	}
+
+	static const char* szCullModeNames[TERRAIN_CULL_MODE_COUNT] = { "None", "CPU", "GPU" };
+	static int32_t iCullMode = TERRAIN_CULL_CPU;
+	static bool bLOD = true;
+	static bool bCDLOD = false;
+	static bool bOcclusion = false;
+
+	ImGui::SetNextItemWidth(150.0f);
+	if (ImGui::Combo("Culling", &iCullMode, szCullModeNames, TERRAIN_CULL_MODE_COUNT))
+	{
+		TerrainManager_SetCullMode(iCullMode);
+	}
+	if (ImGui::Checkbox("Patch LOD", &bLOD))
+	{
+		TerrainManager_SetTerrainLOD(bLOD);
+	}
+	ImGui::SameLine();
+	if (ImGui::Checkbox("CDLOD", &bCDLOD))
+	{
+		TerrainManager_SetTerrainCDLOD(bCDLOD);
+	}
+	ImGui::SameLine();
+	if (ImGui::Checkbox("Occlusion (Hi-Z)", &bOcclusion))
+	{
+		TerrainManager_SetTerrainOcclusion(bOcclusion);
+	}
+
+	STerrainCullStats cullStats;
+	if (TerrainManager_GetCullingStats(&cullStats))
+	{
+		ImGui::Text("Mode: %s%s", szCullModeNames[cullStats.mode], cullStats.bCDLOD ? " (CDLOD)" : "");
+		ImGui::Text("%s drawn: %u / %u resident patches", cullStats.bCDLOD ? "Nodes" : "Patches", cullStats.visibleCount, cullStats.totalCount);
+		ImGui::Text("Triangles: %llu", (unsigned long long)cullStats.triangleCount);
+		ImGui::Text("Cull: %.3f ms", cullStats.cullMs);
+		ImGui::Text("LOD select: %.3f ms (CPU)", cullStats.lodMs);
+		if (bOcclusion)
+		{
+			ImGui::Text("Occluded: %u patches", cullStats.occludedCount);
+			ImGui::Text("Hi-Z build: %.3f ms (GPU)", cullStats.hizBuildMs);
+		}
+	}
+
+	STerrainStreamerStats streamStats;
+	if (TerrainManager_GetStreamingStats(&streamStats))
+	{
+		ImGui::Text("Streaming: %u / %u slots, %u pending", streamStats.residentCount, streamStats.slotCount, streamStats.pendingCount);
+	}
+}
+
+/**
+ * @brief Renders per-tag usage against its budget with the
+ * bytes allocated and freed over the last frame.
+ */
+void ImGui_RenderMemoryBudgetsUI()
+{
+	if (!ImGui::CollapsingHeader("Memory Budgets"))
+	{
+		return;
+	}
+
+	ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable;
+	if (ImGui::BeginTable("##MemoryBudgets", 5, flags))
+	{
+		ImGui::TableSetupColumn("Tag");
+		ImGui::TableSetupColumn("Usage");
+		ImGui::TableSetupColumn("Budget (MB)", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableSetupColumn("+ Frame");
+		ImGui::TableSetupColumn("- Frame");
+		ImGui::TableHeadersRow();
+
+		for (int32_t i = 0; i < MEM_TAG_COUNT; i++)
+		{
+			SMemoryTagFrameStats frame;
+			MemoryManager_GetTagFrameStats((EMemoryTag)i, &frame);
+
+			char usage[16], allocated[16], freed[16];
+			FormatMemorySizeThreadSafe(frame.usage, usage, sizeof(usage));
+			FormatMemorySizeThreadSafe(frame.frameAllocated, allocated, sizeof(allocated));
+			FormatMemorySizeThreadSafe(frame.frameFreed, freed, sizeof(freed));
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn(); ImGui::TextUnformatted(MemoryTagNames[i]);
+			ImGui::TableNextColumn();
+			if (frame.isOverBudget)
+			{
+				ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%s", usage);
+			}
+			else
+			{
+				ImGui::TextUnformatted(usage);
+			}
+
+			// 0 = unlimited
+			ImGui::TableNextColumn();
+			int32_t iBudgetMB = (int32_t)(MemoryManager_GetTagBudget((EMemoryTag)i) / (1024 * 1024));
+			ImGui::PushID(i);
+			ImGui::SetNextItemWidth(-FLT_MIN);
+			if (ImGui::InputInt("##Budget", &iBudgetMB, 16, 256) && iBudgetMB >= 0)
+			{
+				MemoryManager_SetTagBudget((EMemoryTag)i, (size_t)iBudgetMB * 1024 * 1024);
+			}
+			ImGui::PopID();
+
+			ImGui::TableNextColumn(); ImGui::TextUnformatted(allocated);
+			ImGui::TableNextColumn(); ImGui::TextUnformatted(freed);
+		}
+
+		ImGui::EndTable();
+	}
+}
+
+/**
+ * @brief Renders the allocation callsite histogram.
+ *
+ * One row per (file, line, type, tag), sortable by any
+ * column, with a CSV export for offline digging.
+ */
+void ImGui_RenderMemoryCallsitesUI()
+{
+	if (!ImGui::CollapsingHeader("Memory Callsites"))
+	{
+		return;
+	}
+
+	static const char* szSortNames[MEMORY_CALLSITE_SORT_COUNT] = { "Live Bytes", "Live Count", "Total Allocs", "Allocs / Frame" };
+	static int32_t iSort = MEMORY_CALLSITE_SORT_LIVE_BYTES;
+	static int32_t iRowCount = 64;
+	static SMemoryCallsiteStats callsites[256];
+
+	ImGui::SetNextItemWidth(150.0f);
+	ImGui::Combo("Sort By", &iSort, szSortNames, MEMORY_CALLSITE_SORT_COUNT);
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(100.0f);
+	ImGui::SliderInt("Rows", &iRowCount, 8, IM_ARRAYSIZE(callsites));
+	ImGui::SameLine();
+	if (ImGui::Button("Export CSV"))
+	{
+		MemoryManager_ExportCallsitesCSV("memory_callsites.csv", (EMemoryCallsiteSort)iSort);
+	}
+
+	uint32_t count = MemoryManager_GetCallsiteStats(callsites, (uint32_t)iRowCount, (EMemoryCallsiteSort)iSort);
+
+	ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable;
+	if (ImGui::BeginTable("##MemoryCallsites", 7, flags, ImVec2(0.0f, 300.0f)))
+	{
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Callsite", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableSetupColumn("Tag");
+		ImGui::TableSetupColumn("Live");
+		ImGui::TableSetupColumn("Count");
+		ImGui::TableSetupColumn("Allocs");
+		ImGui::TableSetupColumn("Frees");
+		ImGui::TableSetupColumn("Last Frame");
+		ImGui::TableHeadersRow();
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const SMemoryCallsiteStats& callsite = callsites[i];
+
+			// Strip the directories, the full path does not fit
+			const char* szFile = callsite.file ? callsite.file : "?";
+			for (const char* p = szFile; *p; p++)
+			{
+				if (*p == '/' || *p == '\\')
+				{
+					szFile = p + 1;
+				}
+			}
+
+			char liveBytes[16];
+			FormatMemorySizeThreadSafe(callsite.liveBytes, liveBytes, sizeof(liveBytes));
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn(); ImGui::Text("%s:%d %s", szFile, callsite.line, callsite.typeName ? callsite.typeName : "");
+			ImGui::TableNextColumn(); ImGui::TextUnformatted(MemoryTagNames[callsite.tag]);
+			ImGui::TableNextColumn(); ImGui::TextUnformatted(liveBytes);
+			ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)callsite.liveCount);
+			ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)callsite.totalAllocs);
+			ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)callsite.totalFrees);
+			ImGui::TableNextColumn(); ImGui::Text("%llu (avg %.1f)", (unsigned long long)callsite.lastFrameAllocs, callsite.avgFrameAllocs);
+		}
+
+		ImGui::EndTable();
+	}
 }
 
 void ImGui_RenderMapsUI()
@@ -235,6 +440,7 @@ void ImGui_RenderMapsUI()
 	static bool showCreateMapPopup = false;
 	static bool showLoadMapPopup = false;
 	static bool showSaveMapPopup = false;
+	static bool bQuantizePack = true;
 
 	ImVec2 buttonSize(125, 25);
 
@@ -261,6 +467,17 @@ void ImGui_RenderMapsUI()
 	{
 		TerrainManager_SaveMap();
 	}
+
+	ImGui::SameLine();
+	// "Pack Map" converts the map folder into a single packed file
+	if (ImGui::Button("Pack Map", buttonSize))
+	{
+		TerrainManager_PackMap(bQuantizePack);
+	}
+
+	ImGui::SameLine();
+	// 16 bit heights, several times smaller, the map folder keeps the exact ones
+	ImGui::Checkbox("Quantize", &bQuantizePack);
 }
 
 void ImGui_RenderCreateNewMapPopUP(bool* showPopup)
@@ -358,6 +575,8 @@ void ImGui_RenderLoadMapPopUP(bool* showPopup)
 {
 	static const TerrainManager pTerrainManager = GetTerrainManager();
 	static char szMapName[256] = "map_new";
+	static bool bStreaming = false;
+	static int streamRadius = TERRAIN_STREAM_DEFAULT_RADIUS;
 
 	// Always center the popup when appearing
 	ImVec2 center = ImGui::GetMainViewport()->GetCenter();
@@ -368,6 +587,11 @@ void ImGui_RenderLoadMapPopUP(bool* showPopup)
 	{
 		ImGui::TextWrapped("Load Map. write it's name in the text box");
 		ImGui::InputText("Map Name", szMapName, IM_ARRAYSIZE(szMapName));
+		ImGui::Checkbox("Stream Around Camera", &bStreaming);
+		if (bStreaming)
+		{
+			ImGui::SliderInt("Radius (Terrains)", &streamRadius, 1, 8);
+		}
 
 		ImGui::Separator();
 
@@ -383,7 +607,7 @@ void ImGui_RenderLoadMapPopUP(bool* showPopup)
 		// load and Cancel buttons
 		if (ImGui::Button("Load", ImVec2(120, 0)))
 		{
-			if (TerrainManager_LoadMap(szMapName))
+			if ((bStreaming) ? TerrainManager_LoadMapStreaming(szMapName, streamRadius) : TerrainManager_LoadMapAsync(szMapName))
 			{
 				*showPopup = false;
 				ImGui::CloseCurrentPopup();
@@ -398,7 +622,7 @@ void ImGui_RenderLoadMapPopUP(bool* showPopup)
 		// Handle Enter key - only when valid
 		if (ImGui::IsKeyPressed(ImGuiKey_Enter) && !isInvalid)
 		{
-			if (TerrainManager_LoadMap(szMapName))
+			if ((bStreaming) ? TerrainManager_LoadMapStreaming(szMapName, streamRadius) : TerrainManager_LoadMapAsync(szMapName))
 			{
 				*showPopup = false;
 				ImGui::CloseCurrentPopup();
@@ -14,6 +14,7 @@ extern "C" {
 #include "../Terrain/TerrainManager/TerrainManager.h"
 #include "../Math/MathUtils.h"
 #include "../Core/CoreUtils.h"
+#include "../Resources/MemoryManager.h"
 
 #if defined(__cplusplus)
 }
@@ -31,6 +32,9 @@ extern "C" {
 
 	// Sub Windows
 	void ImGui_RenderEngineDataUI();
+	void ImGui_RenderTerrainRenderingUI();
+	void ImGui_RenderMemoryBudgetsUI();
+	void ImGui_RenderMemoryCallsitesUI();
 	void ImGui_RenderMapsUI();
 	void ImGui_RenderCreateNewMapPopUP(bool* showPopup);
 